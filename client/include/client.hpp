@@ -14,6 +14,7 @@
 #include <set>
 #include <utility>
 #include "../../protocol/include/protocol.hpp"
+#include "../../protocol/include/framer.hpp"
 
 namespace BattleshipClient
 {
@@ -44,8 +45,9 @@ namespace BattleshipClient
          * @param nickname Player nickname.
          * @param email Player email address.
          * @param log_path Path to the log file.
+         * @param binary Negotiate the binary wire format instead of using the text grammar.
          */
-        Client(const std::string &server_ip, int server_port, const std::string &nickname, const std::string &email, const std::string &log_path);
+        Client(const std::string &server_ip, int server_port, const std::string &nickname, const std::string &email, const std::string &log_path, bool binary = true);
 
         /**
          * @brief Destructor. Cleans up threads and resources.
@@ -79,6 +81,13 @@ namespace BattleshipClient
         mutable std::ofstream log_file_;             ///< Log file output stream.
         mutable std::mutex log_mutex_;               ///< Mutex for thread-safe logging.
         BattleShipProtocol::Protocol protocol_;      ///< Protocol parser and serializer.
+        BattleShipProtocol::Framer input_;           ///< Received bytes not yet parsed; survives between messages.
+        bool binary_;                                ///< Whether to request the binary wire format.
+        bool send_binary_{false};                    ///< Outgoing messages use the binary format (set before the threads start).
+        mutable std::mutex send_mutex_;              ///< Serializes sends from the input and receive threads.
+        mutable std::string send_buffer_;            ///< Encoding buffer reused by every send (guarded by send_mutex_).
+        uint32_t status_seq_{0};                     ///< Sequence of the last STATUS_DELTA applied.
+        bool awaiting_resync_{false};                ///< A delta was missed; deltas are ignored until the next STATUS.
         std::thread send_thread_;                    ///< Thread handling user input and sending messages.
         std::thread recv_thread_;                    ///< Thread receiving messages from the server.
         std::atomic<bool> running_{false};           ///< Flag indicating if the client is active.
@@ -95,6 +104,21 @@ namespace BattleshipClient
          */
         void connect_to_server();
 
+        /**
+         * @brief Sends HELLO requesting the binary format and status deltas, and switches
+         * outgoing messages to binary.
+         *
+         * Incoming messages switch once the server echoes the HELLO.
+         */
+        void negotiate_protocol();
+
+        /**
+         * @brief Applies a STATUS_DELTA to last_status_, or requests a RESYNC on a sequence gap.
+         * @param delta Received delta.
+         * @return True if the delta was applied.
+         */
+        bool apply_status_delta(const BattleShipProtocol::StatusDeltaData &delta);
+
         /**
          * @brief Sends a message to the server.
          * @param msg Message to send.
@@ -103,6 +127,9 @@ namespace BattleshipClient
 
         /**
          * @brief Receives a message from the server.
+         *
+         * Bytes following the returned frame stay buffered and are returned by the next call.
+         *
          * @return Received Message.
          */
         BattleShipProtocol::Message receive_message();
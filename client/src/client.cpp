@@ -10,12 +10,13 @@
 #include <random>
 #include <array>
 #include <poll.h>
+#include <optional>
 
 namespace BattleshipClient
 {
 
-    Client::Client(const std::string &server_ip, int server_port, const std::string &nickname, const std::string &email, const std::string &log_path)
-        : server_ip_(server_ip), server_port_(server_port), nickname_(nickname), email_(email), client_fd_(-1), running_(false)
+    Client::Client(const std::string &server_ip, int server_port, const std::string &nickname, const std::string &email, const std::string &log_path, bool binary)
+        : server_ip_(server_ip), server_port_(server_port), nickname_(nickname), email_(email), client_fd_(-1), binary_(binary), running_(false)
     {
         server_addr_.sin_family = AF_INET;
         if (inet_pton(AF_INET, server_ip.c_str(), &server_addr_.sin_addr) <= 0)
@@ -48,6 +49,10 @@ namespace BattleshipClient
     {
         connect_to_server();
         reset_state();
+        if (binary_)
+        {
+            negotiate_protocol();
+        }
 
         send_thread_ = std::thread(&Client::send_loop, this);
         recv_thread_ = std::thread(&Client::receive_loop, this);
@@ -71,14 +76,27 @@ namespace BattleshipClient
             close(client_fd_);
             throw ClientError("Failed to connect to server: " + std::string(strerror(errno)));
         }
+        input_.clear();
+        input_.set_mode(BattleShipProtocol::Framer::Mode::LINES);
+        send_binary_ = false;
         log("Connected to server", server_ip_ + ":" + std::to_string(server_port_));
     }
 
+    void Client::negotiate_protocol()
+    {
+        // El HELLO viaja en texto; a partir de él todo lo que enviamos va en binario.
+        send_message({BattleShipProtocol::MessageType::HELLO, BattleShipProtocol::HelloData{BattleShipProtocol::Protocol::BINARY_VERSION, true}});
+        send_binary_ = true;
+        log("Sent HELLO", "Requested binary protocol v" + std::to_string(BattleShipProtocol::Protocol::BINARY_VERSION));
+    }
+
     void Client::reset_state()
     {
         std::lock_guard<std::mutex> lock(state_mutex_);
         shot_history_.clear();
         last_status_ = BattleShipProtocol::StatusData{};
+        status_seq_ = 0;
+        awaiting_resync_ = false;
         player_id_ = -1;
         running_ = true;
     }
@@ -330,10 +348,23 @@ namespace BattleshipClient
                     player_id_cv_.notify_all();
                     break;
                 }
+                case BattleShipProtocol::MessageType::HELLO:
+                {
+                    int version = std::get<BattleShipProtocol::HelloData>(msg.data).version;
+                    if (version != BattleShipProtocol::Protocol::BINARY_VERSION)
+                    {
+                        throw ClientError("Server rejected binary protocol (version " + std::to_string(version) + ")");
+                    }
+                    input_.set_mode(BattleShipProtocol::Framer::Mode::LENGTH_PREFIXED);
+                    log("Received HELLO", "Binary protocol v" + std::to_string(version), "INFO");
+                    break;
+                }
                 case BattleShipProtocol::MessageType::STATUS:
                 {
                     std::lock_guard<std::mutex> lock(state_mutex_);
                     last_status_ = std::get<BattleShipProtocol::StatusData>(msg.data);
+                    status_seq_ = 0;
+                    awaiting_resync_ = false;
                     log("Processing STATUS", "Turn: " + std::string(last_status_.turn == BattleShipProtocol::Turn::YOUR_TURN ? "YOUR_TURN" : "OPPONENT_TURN"));
                     try
                     {
@@ -345,6 +376,23 @@ namespace BattleshipClient
                     }
                     break;
                 }
+                case BattleShipProtocol::MessageType::STATUS_DELTA:
+                {
+                    std::lock_guard<std::mutex> lock(state_mutex_);
+                    if (!apply_status_delta(std::get<BattleShipProtocol::StatusDeltaData>(msg.data)))
+                    {
+                        break;
+                    }
+                    try
+                    {
+                        display_game_state();
+                    }
+                    catch (const std::exception &e)
+                    {
+                        log("display_game_state failed", e.what(), "ERROR");
+                    }
+                    break;
+                }
                 case BattleShipProtocol::MessageType::GAME_OVER:
                 {
                     std::string result = std::get<BattleShipProtocol::GameOverData>(msg.data).winner;
@@ -422,10 +470,58 @@ namespace BattleshipClient
         log("receive_loop terminated", "running_: " + std::string(running_ ? "true" : "false"), "DEBUG");
     }
 
+    bool Client::apply_status_delta(const BattleShipProtocol::StatusDeltaData &delta)
+    {
+        if (awaiting_resync_)
+        {
+            return false;
+        }
+        if (delta.seq != status_seq_ + 1)
+        {
+            // Se perdió una actualización: se pide el estado completo y se ignoran los deltas hasta entonces.
+            log("STATUS_DELTA gap", "Expected " + std::to_string(status_seq_ + 1) + ", got " + std::to_string(delta.seq), "ERROR");
+            awaiting_resync_ = true;
+            send_message({BattleShipProtocol::MessageType::RESYNC, std::monostate{}});
+            return false;
+        }
+        status_seq_ = delta.seq;
+
+        auto apply = [](std::vector<BattleShipProtocol::Cell> &board, const std::vector<BattleShipProtocol::Cell> &changes)
+        {
+            for (const auto &change : changes)
+            {
+                auto it = std::find_if(board.begin(), board.end(), [&](const BattleShipProtocol::Cell &cell)
+                                       { return cell.coordinate == change.coordinate; });
+                if (it != board.end())
+                    it->cellState = change.cellState;
+                else
+                    board.push_back(change);
+            }
+        };
+        apply(last_status_.boardOwn, delta.ownChanges);
+        apply(last_status_.boardOpponent, delta.opponentChanges);
+        last_status_.turn = delta.turn;
+        last_status_.gameState = delta.gameState;
+        last_status_.time_remaining = delta.time_remaining;
+        log("Processing STATUS_DELTA", "Seq: " + std::to_string(delta.seq) + " Turn: " + std::string(delta.turn == BattleShipProtocol::Turn::YOUR_TURN ? "YOUR_TURN" : "OPPONENT_TURN"));
+        return true;
+    }
+
     void Client::send_message(const BattleShipProtocol::Message &msg) const
     {
-        std::string data = protocol_.build_message(msg);
-        ssize_t sent = send(client_fd_, data.c_str(), data.size(), 0);
+        std::lock_guard<std::mutex> lock(send_mutex_);
+        // Se codifica sobre el mismo buffer en cada envío: no se reserva memoria por mensaje.
+        std::string &data = send_buffer_;
+        data.clear();
+        if (send_binary_)
+        {
+            protocol_.build_binary_message(msg, data);
+        }
+        else
+        {
+            protocol_.build_message(msg, data);
+        }
+        ssize_t sent = send(client_fd_, data.data(), data.size(), 0);
         if (sent < 0)
         {
             throw ClientError("Send failed: " + std::string(strerror(errno)));
@@ -438,47 +534,48 @@ namespace BattleshipClient
 
     BattleShipProtocol::Message Client::receive_message()
     {
-        char buffer[4096] = {0};
-        std::string response;
-        ssize_t received;
-
-        while ((received = recv(client_fd_, buffer, sizeof(buffer) - 1, 0)) > 0)
+        std::optional<std::string_view> frame;
+        while (!(frame = input_.next()))
         {
-            response.append(buffer, received);
-            if (response.find('\n') != std::string::npos)
+            if (input_.overflowed())
             {
-                break;
+                throw ClientError("Message exceeds " + std::to_string(input_.capacity()) + " bytes");
             }
+            auto [area, space] = input_.write_area();
+            ssize_t received = recv(client_fd_, area, space, 0);
+            if (received < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw ClientError("Receive failed: " + std::string(strerror(errno)));
+            }
+            if (received == 0)
+            {
+                throw ClientError("Server disconnected");
+            }
+            input_.commit(static_cast<size_t>(received));
         }
 
-        if (received < 0)
-        {
-            throw ClientError("Receive failed: " + std::string(strerror(errno)));
-        }
-        if (received == 0)
-        {
-            throw ClientError("Server disconnected");
-        }
-
-        std::cout << "---------- REALMENTE RECIBIDO ------------ " << std::endl;
-        std::cout << response << std::endl;
-        std::cout << "---------- REALMENTE RECIBIDO------------ " << std::endl;
-
-        log("Raw received", response, "DEBUG");
-
-        size_t newline_pos = response.find('\n');
-        if (newline_pos != std::string::npos)
-        {
-            response = response.substr(0, newline_pos + 1);
-        }
-
+        bool binary = input_.mode() == BattleShipProtocol::Framer::Mode::LENGTH_PREFIXED;
         try
         {
-            return protocol_.parse_message(response);
+            auto msg = binary ? protocol_.parse_binary_message(*frame) : protocol_.parse_message(*frame);
+            if (!binary)
+            {
+                std::string response(*frame);
+                std::cout << "---------- REALMENTE RECIBIDO ------------ " << std::endl;
+                std::cout << response << std::endl;
+                std::cout << "---------- REALMENTE RECIBIDO------------ " << std::endl;
+
+                log("Raw received", response, "DEBUG");
+            }
+            return msg;
         }
         catch (const std::exception &e)
         {
-            log("Failed to parse message", "Message: [" + response + "] Error: " + e.what(), "ERROR");
+            log("Failed to parse message", "Message: [" + (binary ? std::string("<binary>") : std::string(*frame)) + "] Error: " + e.what(), "ERROR");
             throw;
         }
     }
@@ -521,8 +618,8 @@ namespace BattleshipClient
         {
             for (const auto &coord : coords)
             {
-                int row = coord.letter[0] - 'A';
-                int col = coord.number - 1;
+                int row = coord.letter() - 'A';
+                int col = coord.number() - 1;
                 if (row < 0 || row >= 10 || col < 0 || col >= 10)
                     return false;
                 if (occupied[row * 10 + col])
@@ -535,8 +632,8 @@ namespace BattleshipClient
         {
             for (const auto &coord : coords)
             {
-                int row = coord.letter[0] - 'A';
-                int col = coord.number - 1;
+                int row = coord.letter() - 'A';
+                int col = coord.number() - 1;
                 occupied[row * 10 + col] = true;
             }
         };
@@ -615,8 +712,8 @@ namespace BattleshipClient
         {
             for (const auto &coord : coords)
             {
-                int row = coord.letter[0] - 'A';
-                int col = coord.number - 1;
+                int row = coord.letter() - 'A';
+                int col = coord.number() - 1;
                 occupied[row * 10 + col] = true;
             }
         };
@@ -625,8 +722,8 @@ namespace BattleshipClient
         {
             for (const auto &coord : coords)
             {
-                int row = coord.letter[0] - 'A';
-                int col = coord.number - 1;
+                int row = coord.letter() - 'A';
+                int col = coord.number() - 1;
                 if (row < 0 || row >= 10 || col < 0 || col >= 10)
                     return false;
                 if (occupied[row * 10 + col])
@@ -795,7 +892,7 @@ namespace BattleshipClient
                 bool found = false;
                 for (const auto &cell : last_status_.boardOwn)
                 {
-                    if (cell.coordinate.letter == std::string(1, row) && cell.coordinate.number == col)
+                    if (cell.coordinate == BattleShipProtocol::Coordinate(row, col))
                     {
                         switch (cell.cellState)
                         {
@@ -839,7 +936,7 @@ namespace BattleshipClient
                 bool found = false;
                 for (const auto &cell : last_status_.boardOpponent)
                 {
-                    if (cell.coordinate.letter == std::string(1, row) && cell.coordinate.number == col)
+                    if (cell.coordinate == BattleShipProtocol::Coordinate(row, col))
                     {
                         switch (cell.cellState)
                         {
@@ -908,7 +1005,7 @@ namespace BattleshipClient
 
                 for (const auto &cell : last_status_.boardOpponent)
                 {
-                    if (cell.coordinate.letter == letter && cell.coordinate.number == number)
+                    if (cell.coordinate == BattleShipProtocol::Coordinate(letter, number))
                     {
                         switch (cell.cellState)
                         {
@@ -13,9 +13,15 @@ std::string get_env(const std::string& key, const std::string& fallback) {
 int main(int argc, char *argv[])
 {
     dotenv::init();
-    if (argc != 2)
+    bool binary = true;
+    if (argc == 3 && std::string(argv[2]) == "--text")
     {
-        std::cerr << "Usage: ./bsclient </path/to/log.log>\n";
+        // Fuerza la gramática de texto, p. ej. contra servidores sin soporte binario.
+        binary = false;
+    }
+    else if (argc != 2)
+    {
+        std::cerr << "Usage: ./bsclient </path/to/log.log> [--text]\n";
         return 1;
     }
 
@@ -52,7 +58,7 @@ int main(int argc, char *argv[])
 {
     try
     {
-        BattleshipClient::Client client(server_ip, server_port, nickname, email, log_path);
+        BattleshipClient::Client client(server_ip, server_port, nickname, email, log_path, binary);
         client.run();  // Ejecuta una partida completa
         std::cout << "ESTOY EN EL MAIN " << std::endl;
         std::string input;
@@ -0,0 +1,100 @@
+#ifndef LOAD_GENERATOR_HPP
+#define LOAD_GENERATOR_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace BattleshipLoad
+{
+
+    /**
+     * @brief Exception thrown when the load generator cannot be set up.
+     */
+    class LoadError : public std::runtime_error
+    {
+    public:
+        /**
+         * @brief Constructs a LoadError with the specified message.
+         * @param msg Description of the error.
+         */
+        explicit LoadError(const std::string &msg) : std::runtime_error(msg) {}
+    };
+
+    /**
+     * @brief Parameters of a load run.
+     */
+    struct LoadOptions
+    {
+        std::string host = "127.0.0.1";                ///< Server address (IPv4).
+        int port = 8080;                               ///< Server port.
+        unsigned connections = 100;                    ///< Concurrent players (rounded up to an even number).
+        unsigned threads = 1;                          ///< Worker threads, each with its own epoll instance.
+        uint64_t games = 0;                            ///< Matches to complete; 0 runs for the whole duration.
+        std::chrono::milliseconds duration{10000};     ///< Time limit of the run.
+        bool binary = false;                           ///< Negotiate the binary wire format with HELLO|1.
+        bool deltas = false;                           ///< Ask for STATUS_DELTA updates.
+    };
+
+    /**
+     * @brief Results of a load run.
+     */
+    struct LoadReport
+    {
+        uint64_t matches = 0;          ///< Matches that reached GAME_OVER (counted once per match).
+        uint64_t shots = 0;            ///< SHOOT messages answered by the server.
+        uint64_t connections = 0;      ///< Connections opened, including reconnections.
+        uint64_t error_messages = 0;   ///< ERROR messages received.
+        uint64_t connect_failures = 0; ///< Connections refused or reset before the game started.
+        uint64_t disconnects = 0;      ///< Connections closed by the server before GAME_OVER.
+        uint64_t protocol_errors = 0;  ///< Frames that could not be parsed.
+        double seconds = 0;            ///< Wall time of the run.
+        std::vector<uint32_t> turn_latencies_us; ///< Time from SHOOT to the answering status, per shot.
+
+        /**
+         * @brief Returns a percentile of the turn latency.
+         * @param fraction Percentile as a fraction (0.5, 0.99, 0.999).
+         * @return Latency in microseconds, 0 if no shot was measured.
+         */
+        uint32_t latency_percentile(double fraction) const;
+
+        /**
+         * @brief Sum of every error counter.
+         */
+        uint64_t errors() const { return error_messages + connect_failures + disconnects + protocol_errors; }
+    };
+
+    /**
+     * @class LoadGenerator
+     * @brief Headless players that drive complete games against a running server.
+     *
+     * Each worker thread owns an epoll instance and a share of the connections. A player
+     * registers, places a random fleet like bsclient does and answers every YOUR_TURN
+     * status with a shot at a cell it has not tried yet. When its game ends the
+     * connection is replaced by a new one until the run is over.
+     */
+    class LoadGenerator
+    {
+    public:
+        /**
+         * @brief Stores the options of the run.
+         * @param options Target server and load shape.
+         */
+        explicit LoadGenerator(LoadOptions options);
+
+        /**
+         * @brief Runs the load until the game count or the duration is reached.
+         * @return Merged results of every worker.
+         * @throws LoadError if the address is invalid or a worker cannot start.
+         */
+        LoadReport run();
+
+    private:
+        LoadOptions options_; ///< Parameters of the run.
+    };
+
+} // namespace BattleshipLoad
+
+#endif
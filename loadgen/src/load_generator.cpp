@@ -0,0 +1,542 @@
+#include "load_generator.hpp"
+#include "framer.hpp"
+#include "protocol.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <thread>
+
+namespace BattleshipLoad
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+        using BattleShipProtocol::Coordinate;
+        using BattleShipProtocol::Framer;
+        using BattleShipProtocol::GameState;
+        using BattleShipProtocol::Message;
+        using BattleShipProtocol::MessageType;
+        using BattleShipProtocol::Turn;
+
+        constexpr int POLL_INTERVAL_MS = 50;                             ///< Máximo tiempo bloqueado en epoll_wait.
+        constexpr auto RETRY_DELAY = std::chrono::milliseconds(100);     ///< Espera antes de reintentar un connect fallido.
+
+        /**
+         * @brief Estado compartido por todos los workers.
+         */
+        struct Shared
+        {
+            std::atomic<uint64_t> matches{0}; ///< Partidas terminadas entre todos los workers.
+            Clock::time_point deadline;       ///< Fin de la ejecución.
+        };
+
+        /**
+         * @brief Un jugador simulado y su conexión.
+         */
+        struct Player
+        {
+            int fd = -1;                        ///< Socket, -1 mientras está cerrado.
+            bool connecting = false;            ///< connect() todavía en curso.
+            bool writable_armed = false;        ///< EPOLLOUT registrado.
+            bool awaiting = false;              ///< Disparo enviado sin respuesta todavía.
+            bool binary_out = false;            ///< Los mensajes salientes usan el formato binario.
+            Framer input;                       ///< Frames recibidos.
+            std::string output;                 ///< Bytes pendientes de enviar.
+            std::array<uint8_t, 100> targets{}; ///< Orden de disparo de la partida actual.
+            size_t next_target = 0;             ///< Próxima celda de targets.
+            Clock::time_point shot_at;          ///< Momento del último SHOOT.
+            Clock::time_point reopen_at;        ///< Momento de la próxima conexión si fd < 0.
+            bool idle = false;                  ///< No se reabre (fin de la ejecución).
+        };
+
+        /**
+         * @brief Hilo de carga con su propio epoll y su parte de las conexiones.
+         */
+        class Worker
+        {
+        public:
+            Worker(const LoadOptions &options, const sockaddr_in &address, unsigned players, Shared &shared, uint32_t seed)
+                : options_(options), address_(address), shared_(shared), random_(seed)
+            {
+                epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+                if (epoll_fd_ < 0)
+                {
+                    throw LoadError(std::string("epoll_create1 failed: ") + std::strerror(errno));
+                }
+                players_.reserve(players);
+                for (unsigned i = 0; i < players; ++i)
+                {
+                    players_.push_back(std::make_unique<Player>());
+                }
+            }
+
+            ~Worker()
+            {
+                for (auto &player : players_)
+                {
+                    if (player->fd >= 0)
+                    {
+                        ::close(player->fd);
+                    }
+                }
+                ::close(epoll_fd_);
+            }
+
+            void run()
+            {
+                for (auto &player : players_)
+                {
+                    open(*player);
+                }
+                std::array<epoll_event, 256> events;
+                while (!finished())
+                {
+                    int ready = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), POLL_INTERVAL_MS);
+                    if (ready < 0 && errno != EINTR)
+                    {
+                        throw LoadError(std::string("epoll_wait failed: ") + std::strerror(errno));
+                    }
+                    for (int i = 0; i < ready; ++i)
+                    {
+                        handle(*static_cast<Player *>(events[i].data.ptr), events[i].events);
+                    }
+                    reopen_closed();
+                }
+            }
+
+            LoadReport report; ///< Resultados de este worker.
+
+        private:
+            const LoadOptions &options_;
+            sockaddr_in address_;
+            Shared &shared_;
+            std::mt19937 random_;
+            BattleShipProtocol::Protocol protocol_;
+            int epoll_fd_ = -1;
+            std::vector<std::unique_ptr<Player>> players_;
+
+            bool target_reached() const
+            {
+                return options_.games > 0 && shared_.matches.load(std::memory_order_relaxed) >= options_.games;
+            }
+
+            bool finished() const
+            {
+                if (Clock::now() >= shared_.deadline || target_reached())
+                {
+                    return true;
+                }
+                return std::all_of(players_.begin(), players_.end(), [](const auto &player)
+                                   { return player->idle; });
+            }
+
+            void open(Player &player)
+            {
+                player.input.clear();
+                player.input.set_mode(Framer::Mode::LINES);
+                player.output.clear();
+                player.awaiting = false;
+                player.binary_out = false;
+                player.writable_armed = true;
+                std::iota(player.targets.begin(), player.targets.end(), 0);
+                std::shuffle(player.targets.begin(), player.targets.end(), random_);
+                player.next_target = 0;
+
+                player.fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+                if (player.fd < 0)
+                {
+                    throw LoadError(std::string("socket failed: ") + std::strerror(errno));
+                }
+                int one = 1;
+                setsockopt(player.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                ++report.connections;
+                if (::connect(player.fd, reinterpret_cast<const sockaddr *>(&address_), sizeof(address_)) < 0 && errno != EINPROGRESS)
+                {
+                    ++report.connect_failures;
+                    discard(player, RETRY_DELAY);
+                    return;
+                }
+                player.connecting = true;
+                epoll_event event{};
+                event.events = EPOLLIN | EPOLLOUT;
+                event.data.ptr = &player;
+                epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, player.fd, &event);
+
+                if (options_.binary || options_.deltas)
+                {
+                    // El HELLO va en texto; todo lo que se envía después usa el formato pedido.
+                    int version = options_.binary ? BattleShipProtocol::Protocol::BINARY_VERSION : BattleShipProtocol::Protocol::TEXT_VERSION;
+                    send(player, {MessageType::HELLO, BattleShipProtocol::HelloData{version, options_.deltas}});
+                    player.binary_out = options_.binary;
+                }
+            }
+
+            // Cierra el socket y agenda la siguiente conexión del jugador.
+            void discard(Player &player, Clock::duration delay)
+            {
+                if (player.fd >= 0)
+                {
+                    ::close(player.fd);
+                    player.fd = -1;
+                }
+                player.connecting = false;
+                player.reopen_at = Clock::now() + delay;
+            }
+
+            void reopen_closed()
+            {
+                auto now = Clock::now();
+                for (auto &player : players_)
+                {
+                    if (player->fd >= 0 || player->idle || now < player->reopen_at)
+                    {
+                        continue;
+                    }
+                    if (target_reached())
+                    {
+                        player->idle = true;
+                        continue;
+                    }
+                    open(*player);
+                }
+            }
+
+            void handle(Player &player, uint32_t events)
+            {
+                if (player.connecting && (events & (EPOLLOUT | EPOLLERR | EPOLLHUP)))
+                {
+                    int error = 0;
+                    socklen_t length = sizeof(error);
+                    getsockopt(player.fd, SOL_SOCKET, SO_ERROR, &error, &length);
+                    if (error != 0)
+                    {
+                        ++report.connect_failures;
+                        discard(player, RETRY_DELAY);
+                        return;
+                    }
+                    player.connecting = false;
+                }
+                if (events & EPOLLOUT)
+                {
+                    flush(player);
+                }
+                if (player.fd >= 0 && (events & (EPOLLIN | EPOLLERR | EPOLLHUP)))
+                {
+                    receive(player);
+                }
+            }
+
+            void receive(Player &player)
+            {
+                while (player.fd >= 0)
+                {
+                    auto [area, space] = player.input.write_area();
+                    ssize_t received = ::recv(player.fd, area, space, 0);
+                    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                    {
+                        return;
+                    }
+                    if (received < 0 && errno == EINTR)
+                    {
+                        continue;
+                    }
+                    if (received <= 0)
+                    {
+                        ++report.disconnects;
+                        discard(player, RETRY_DELAY);
+                        return;
+                    }
+                    player.input.commit(static_cast<size_t>(received));
+                    while (player.fd >= 0)
+                    {
+                        auto frame = player.input.next();
+                        if (!frame)
+                        {
+                            break;
+                        }
+                        on_frame(player, *frame);
+                    }
+                    if (player.fd >= 0 && player.input.overflowed())
+                    {
+                        ++report.protocol_errors;
+                        discard(player, RETRY_DELAY);
+                    }
+                }
+            }
+
+            void on_frame(Player &player, std::string_view frame)
+            {
+                Message msg;
+                try
+                {
+                    msg = player.input.mode() == Framer::Mode::LENGTH_PREFIXED ? protocol_.parse_binary_message(frame)
+                                                                               : protocol_.parse_message(frame);
+                }
+                catch (const std::exception &)
+                {
+                    ++report.protocol_errors;
+                    discard(player, RETRY_DELAY);
+                    return;
+                }
+
+                switch (msg.type)
+                {
+                case MessageType::HELLO:
+                    if (options_.binary)
+                    {
+                        player.input.set_mode(Framer::Mode::LENGTH_PREFIXED);
+                    }
+                    break;
+                case MessageType::PLAYER_ID:
+                {
+                    auto &id = std::get<BattleShipProtocol::PlayerIdData>(msg.data);
+                    std::string name = "load" + std::to_string(report.connections) + "_" + std::to_string(id.player_id);
+                    send(player, {MessageType::REGISTER, BattleShipProtocol::RegisterData{name, name + "@load.test"}});
+                    send(player, {MessageType::PLACE_SHIPS, random_fleet()});
+                    break;
+                }
+                case MessageType::STATUS:
+                {
+                    auto &status = std::get<BattleShipProtocol::StatusData>(msg.data);
+                    on_status(player, status.turn, status.gameState);
+                    break;
+                }
+                case MessageType::STATUS_DELTA:
+                {
+                    auto &delta = std::get<BattleShipProtocol::StatusDeltaData>(msg.data);
+                    on_status(player, delta.turn, delta.gameState);
+                    break;
+                }
+                case MessageType::GAME_OVER:
+                    if (std::get<BattleShipProtocol::GameOverData>(msg.data).winner == "YOU_WIN")
+                    {
+                        shared_.matches.fetch_add(1, std::memory_order_relaxed);
+                        ++report.matches;
+                    }
+                    discard(player, Clock::duration::zero());
+                    break;
+                case MessageType::ERROR:
+                    ++report.error_messages;
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            void on_status(Player &player, Turn turn, GameState state)
+            {
+                if (player.awaiting)
+                {
+                    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - player.shot_at);
+                    report.turn_latencies_us.push_back(static_cast<uint32_t>(elapsed.count()));
+                    ++report.shots;
+                    player.awaiting = false;
+                }
+                if (turn != Turn::YOUR_TURN || state != GameState::ONGOING || player.next_target >= player.targets.size())
+                {
+                    return;
+                }
+                Coordinate target = Coordinate::from_index(player.targets[player.next_target++]);
+                player.awaiting = true;
+                player.shot_at = Clock::now();
+                send(player, {MessageType::SHOOT, BattleShipProtocol::ShootData{target}});
+            }
+
+            // Colocación aleatoria equivalente a Client::generate_initial_ships.
+            BattleShipProtocol::PlaceShipsData random_fleet()
+            {
+                static const std::array<std::pair<BattleShipProtocol::ShipType, int>, 9> fleet = {{
+                    {BattleShipProtocol::ShipType::PORTAAVIONES, 5},
+                    {BattleShipProtocol::ShipType::BUQUE, 4},
+                    {BattleShipProtocol::ShipType::CRUCERO, 3},
+                    {BattleShipProtocol::ShipType::CRUCERO, 3},
+                    {BattleShipProtocol::ShipType::DESTRUCTOR, 2},
+                    {BattleShipProtocol::ShipType::DESTRUCTOR, 2},
+                    {BattleShipProtocol::ShipType::SUBMARINO, 1},
+                    {BattleShipProtocol::ShipType::SUBMARINO, 1},
+                    {BattleShipProtocol::ShipType::SUBMARINO, 1},
+                }};
+                std::array<bool, 100> occupied{};
+                BattleShipProtocol::PlaceShipsData data;
+                for (const auto &[type, size] : fleet)
+                {
+                    while (true)
+                    {
+                        bool horizontal = std::uniform_int_distribution<>(0, 1)(random_);
+                        int row = std::uniform_int_distribution<>(0, horizontal ? 9 : 10 - size)(random_);
+                        int col = std::uniform_int_distribution<>(0, horizontal ? 10 - size : 9)(random_);
+                        BattleShipProtocol::Ship ship{type, {}};
+                        bool free = true;
+                        for (int i = 0; i < size && free; ++i)
+                        {
+                            int index = (horizontal ? row : row + i) * 10 + (horizontal ? col + i : col);
+                            free = !occupied[index];
+                            ship.coordinates.push_back(Coordinate::from_index(static_cast<uint8_t>(index)));
+                        }
+                        if (!free)
+                        {
+                            continue;
+                        }
+                        for (const auto &coordinate : ship.coordinates)
+                        {
+                            occupied[coordinate.index()] = true;
+                        }
+                        data.ships.push_back(std::move(ship));
+                        break;
+                    }
+                }
+                return data;
+            }
+
+            void send(Player &player, const Message &msg)
+            {
+                // Directo al buffer de salida del jugador, sin un std::string intermedio.
+                if (player.binary_out)
+                {
+                    protocol_.build_binary_message(msg, player.output);
+                }
+                else
+                {
+                    protocol_.build_message(msg, player.output);
+                }
+                if (!player.connecting)
+                {
+                    flush(player);
+                }
+            }
+
+            void flush(Player &player)
+            {
+                while (player.fd >= 0 && !player.connecting && !player.output.empty())
+                {
+                    ssize_t sent = ::send(player.fd, player.output.data(), player.output.size(), MSG_NOSIGNAL);
+                    if (sent < 0 && errno == EINTR)
+                    {
+                        continue;
+                    }
+                    if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                    {
+                        break;
+                    }
+                    if (sent < 0)
+                    {
+                        ++report.disconnects;
+                        discard(player, RETRY_DELAY);
+                        return;
+                    }
+                    player.output.erase(0, static_cast<size_t>(sent));
+                }
+                if (player.fd < 0)
+                {
+                    return;
+                }
+                // EPOLLOUT solo mientras hay algo pendiente (o el connect sigue en curso).
+                bool want_writable = player.connecting || !player.output.empty();
+                if (want_writable != player.writable_armed)
+                {
+                    epoll_event event{};
+                    event.events = EPOLLIN | (want_writable ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+                    event.data.ptr = &player;
+                    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, player.fd, &event);
+                    player.writable_armed = want_writable;
+                }
+            }
+        };
+    }
+
+    uint32_t LoadReport::latency_percentile(double fraction) const
+    {
+        if (turn_latencies_us.empty())
+        {
+            return 0;
+        }
+        // run() entrega las latencias ordenadas.
+        size_t index = std::min(turn_latencies_us.size() - 1, static_cast<size_t>(fraction * turn_latencies_us.size()));
+        return turn_latencies_us[index];
+    }
+
+    LoadGenerator::LoadGenerator(LoadOptions options) : options_(std::move(options))
+    {
+        options_.threads = std::max(1u, options_.threads);
+        options_.connections = std::max(2u, options_.connections + options_.connections % 2);
+    }
+
+    LoadReport LoadGenerator::run()
+    {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(options_.port));
+        if (inet_pton(AF_INET, options_.host.c_str(), &address.sin_addr) != 1)
+        {
+            throw LoadError("Invalid IPv4 address: " + options_.host);
+        }
+
+        Shared shared;
+        auto start = Clock::now();
+        shared.deadline = start + options_.duration;
+
+        // Cada worker recibe un número par de conexiones para que el servidor pueda emparejarlas.
+        unsigned threads = std::min(options_.threads, options_.connections / 2);
+        std::vector<std::unique_ptr<Worker>> workers;
+        unsigned pairs = options_.connections / 2;
+        for (unsigned i = 0; i < threads; ++i)
+        {
+            unsigned share = pairs / threads + (i < pairs % threads ? 1 : 0);
+            workers.push_back(std::make_unique<Worker>(options_, address, share * 2, shared, std::random_device{}()));
+        }
+
+        std::vector<std::thread> running;
+        std::vector<std::exception_ptr> failures(workers.size());
+        for (size_t i = 0; i < workers.size(); ++i)
+        {
+            running.emplace_back([&, i]
+                                 {
+                try
+                {
+                    workers[i]->run();
+                }
+                catch (...)
+                {
+                    failures[i] = std::current_exception();
+                } });
+        }
+        for (auto &thread : running)
+        {
+            thread.join();
+        }
+
+        LoadReport total;
+        total.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        for (size_t i = 0; i < workers.size(); ++i)
+        {
+            if (failures[i])
+            {
+                std::rethrow_exception(failures[i]);
+            }
+            const LoadReport &part = workers[i]->report;
+            total.matches += part.matches;
+            total.shots += part.shots;
+            total.connections += part.connections;
+            total.error_messages += part.error_messages;
+            total.connect_failures += part.connect_failures;
+            total.disconnects += part.disconnects;
+            total.protocol_errors += part.protocol_errors;
+            total.turn_latencies_us.insert(total.turn_latencies_us.end(), part.turn_latencies_us.begin(), part.turn_latencies_us.end());
+        }
+        std::sort(total.turn_latencies_us.begin(), total.turn_latencies_us.end());
+        return total;
+    }
+
+} // namespace BattleshipLoad
@@ -0,0 +1,99 @@
+#include "load_generator.hpp"
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief Convierte un argumento numérico positivo.
+ *
+ * @param value Texto a convertir.
+ * @param what Nombre del parámetro para el mensaje de error.
+ * @return Valor convertido.
+ * @throws std::invalid_argument o std::out_of_range si el valor no es válido.
+ */
+static unsigned long long parse_positive(const std::string& value, const std::string& what) {
+    long long parsed = std::stoll(value);
+    if (parsed <= 0) {
+        throw std::out_of_range(what + " must be positive");
+    }
+    return static_cast<unsigned long long>(parsed);
+}
+
+/**
+ * @brief Punto de entrada del generador de carga.
+ *
+ * @param argc Número de argumentos de la línea de comandos.
+ * @param argv [1] IP, [2] puerto, seguidos de opciones: --connections N, --threads N,
+ *             --games N, --duration SEGUNDOS, --binary y --deltas.
+ * @return 0 si se completó al menos una partida, 1 ante un error de uso, 2 si no terminó ninguna.
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <ip> <port> [--connections N] [--threads N] [--games N] [--duration SECONDS] [--binary] [--deltas]\n";
+        std::cerr << "Example: " << argv[0] << " 127.0.0.1 8080 --connections 2000 --threads 2 --duration 30 --binary\n";
+        return 1;
+    }
+
+    BattleshipLoad::LoadOptions options;
+    options.host = argv[1];
+    try {
+        options.port = std::stoi(argv[2]);
+        if (options.port < 1 || options.port > 65535) {
+            throw std::out_of_range("Port out of valid range (1-65535)");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid port: " << argv[2] << " (" << e.what() << ")\n";
+        return 1;
+    }
+
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg == "--connections" && i + 1 < argc) {
+                options.connections = static_cast<unsigned>(parse_positive(argv[++i], "Connection count"));
+            } else if (arg == "--threads" && i + 1 < argc) {
+                options.threads = static_cast<unsigned>(parse_positive(argv[++i], "Thread count"));
+            } else if (arg == "--games" && i + 1 < argc) {
+                options.games = parse_positive(argv[++i], "Game count");
+            } else if (arg == "--duration" && i + 1 < argc) {
+                double seconds = std::stod(argv[++i]);
+                if (!(seconds > 0)) {
+                    throw std::out_of_range("Duration must be positive");
+                }
+                options.duration = std::chrono::milliseconds(static_cast<long long>(seconds * 1000));
+            } else if (arg == "--binary") {
+                options.binary = true;
+            } else if (arg == "--deltas") {
+                options.deltas = true;
+            } else {
+                std::cerr << "Unknown or incomplete option: " << arg << "\n";
+                return 1;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Invalid value for " << arg << ": " << argv[i] << " (" << e.what() << ")\n";
+            return 1;
+        }
+    }
+
+    BattleshipLoad::LoadReport report;
+    try {
+        BattleshipLoad::LoadGenerator generator(options);
+        report = generator.run();
+    } catch (const std::exception& e) {
+        std::cerr << "Load generator error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "duration:     " << report.seconds << " s\n";
+    std::cout << "connections:  " << report.connections << " opened\n";
+    std::cout << "matches:      " << report.matches << " (" << (report.seconds > 0 ? report.matches / report.seconds : 0.0) << "/s)\n";
+    std::cout << "shots:        " << report.shots << " (" << (report.seconds > 0 ? report.shots / report.seconds : 0.0) << "/s)\n";
+    std::cout << "turn latency: p50 " << report.latency_percentile(0.5) << " us, p99 " << report.latency_percentile(0.99)
+              << " us, p999 " << report.latency_percentile(0.999) << " us\n";
+    std::cout << "errors:       " << report.errors() << " (" << report.error_messages << " ERROR messages, "
+              << report.connect_failures << " connect failures, " << report.disconnects << " disconnects, "
+              << report.protocol_errors << " protocol errors)\n";
+    return report.matches > 0 ? 0 : 2;
+}
@@ -0,0 +1,119 @@
+#ifndef LOG_DUMP_HPP
+#define LOG_DUMP_HPP
+
+#include "game_logic.hpp"
+#include "journal.hpp"
+#include "protocol.hpp"
+#include <array>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace BattleshipLogDump
+{
+
+    /**
+     * @brief What to print from a journal.
+     */
+    struct DumpOptions
+    {
+        uint32_t session = 0; ///< Only this session (0 prints every session).
+        bool status = false;  ///< Print each STATUS event as the full line the text log used to hold.
+    };
+
+    /**
+     * @brief Outcome of a dump.
+     */
+    struct DumpReport
+    {
+        uint64_t records = 0;       ///< Records decoded.
+        uint64_t statuses = 0;      ///< STATUS events printed.
+        uint64_t failed_replays = 0; ///< Sessions whose replay stopped on an inconsistent event.
+        std::string error;          ///< Why decoding stopped early (empty if the whole journal was read).
+    };
+
+    /**
+     * @class JournalDump
+     * @brief Turns a game-event journal back into readable text.
+     *
+     * Every record is printed on one line with its wall-clock time. Sessions are
+     * replayed through GameLogic as their events are read, so a STATUS event can be
+     * expanded into the STATUS or STATUS_DELTA message the player received, formatted
+     * like the "Status sent" lines of the text log.
+     */
+    class JournalDump
+    {
+    public:
+        /**
+         * @brief Stores the options of the dump.
+         * @param options Session filter and STATUS expansion.
+         */
+        explicit JournalDump(DumpOptions options);
+
+        /**
+         * @brief Prints every record of a journal.
+         *
+         * A truncated or corrupt record ends the dump; the records before it are printed.
+         *
+         * @param data Journal contents.
+         * @param out Destination of the text.
+         * @return Counters and the decoding error, if any.
+         */
+        DumpReport dump(std::string_view data, std::ostream &out);
+
+    private:
+        /**
+         * @brief Replay state of one session.
+         */
+        struct SessionReplay
+        {
+            BattleShipProtocol::GameLogic game;                                      ///< Boards rebuilt from the events.
+            std::array<std::string, 3> ip;                                           ///< Client IP per player (index 1 and 2).
+            std::array<std::array<BattleShipProtocol::CellState, 100>, 3> sent_own{};      ///< Own board as last sent.
+            std::array<std::array<BattleShipProtocol::CellState, 100>, 3> sent_opponent{}; ///< Opponent board as last sent.
+            std::array<uint32_t, 3> status_seq{};                                    ///< Sequence of the last STATUS_DELTA.
+            std::string failure;                                                     ///< Set once the replay diverged.
+        };
+
+        DumpOptions options_;                            ///< Parameters of the dump.
+        BattleShipProtocol::Protocol protocol_;          ///< Encoder of the rebuilt messages.
+        std::map<uint32_t, SessionReplay> sessions_;     ///< Sessions since the last JOURNAL_START.
+        uint64_t start_us_ = 0;                          ///< Wall clock of the last JOURNAL_START.
+
+        /**
+         * @brief Applies an event to its session's game.
+         * @param session Replay state.
+         * @param record Event.
+         * @param report Counters to update if the replay fails.
+         */
+        void replay(SessionReplay &session, const BattleShipProtocol::JournalRecord &record, DumpReport &report);
+
+        /**
+         * @brief Rebuilds the message a STATUS event stands for.
+         * @param session Replay state.
+         * @param record STATUS event.
+         * @return STATUS or STATUS_DELTA message.
+         */
+        BattleShipProtocol::Message rebuild_status(SessionReplay &session, const BattleShipProtocol::JournalRecord &record);
+
+        /**
+         * @brief Formats the description of an event (everything after the player).
+         * @param record Event.
+         * @return Readable text.
+         */
+        std::string describe(const BattleShipProtocol::JournalRecord &record) const;
+
+        /**
+         * @brief Formats the wall-clock time of a record.
+         * @param time_us Microseconds since the last JOURNAL_START.
+         * @param micros Append the microseconds.
+         * @return "YYYY-mm-dd HH:MM:SS[.uuuuuu]".
+         */
+        std::string timestamp(uint64_t time_us, bool micros) const;
+    };
+
+} // namespace BattleshipLogDump
+
+#endif
@@ -0,0 +1,281 @@
+#include "log_dump.hpp"
+#include <cstdio>
+#include <ctime>
+#include <exception>
+#include <utility>
+
+namespace BattleshipLogDump
+{
+    namespace
+    {
+        using BattleShipProtocol::CellState;
+        using BattleShipProtocol::JournalEvent;
+        using BattleShipProtocol::JournalRecord;
+        using BattleShipProtocol::Message;
+        using BattleShipProtocol::MessageType;
+        using Phase = BattleShipProtocol::PhaseState::Phase;
+
+        const char *cell_state_name(CellState state)
+        {
+            switch (state)
+            {
+            case CellState::WATER:
+                return "WATER";
+            case CellState::HIT:
+                return "HIT";
+            case CellState::SUNK:
+                return "SUNK";
+            case CellState::SHIP:
+                return "SHIP";
+            case CellState::MISS:
+                return "MISS";
+            }
+            return "?";
+        }
+
+        const char *phase_name(uint8_t phase)
+        {
+            switch (static_cast<Phase>(phase))
+            {
+            case Phase::REGISTRATION:
+                return "REGISTRATION";
+            case Phase::PLACEMENT:
+                return "PLACEMENT";
+            case Phase::PLAYING:
+                return "PLAYING";
+            case Phase::FINISHED:
+                return "FINISHED";
+            }
+            return "?";
+        }
+
+        std::string without_newline(std::string text)
+        {
+            if (!text.empty() && text.back() == '\n')
+            {
+                text.pop_back();
+            }
+            return text;
+        }
+    }
+
+    JournalDump::JournalDump(DumpOptions options) : options_(options) {}
+
+    DumpReport JournalDump::dump(std::string_view data, std::ostream &out)
+    {
+        DumpReport report;
+        BattleShipProtocol::JournalReader reader(data);
+        JournalRecord record;
+        while (true)
+        {
+            try
+            {
+                if (!reader.next(record))
+                {
+                    break;
+                }
+            }
+            catch (const BattleShipProtocol::ProtocolError &e)
+            {
+                report.error = "offset " + std::to_string(reader.offset()) + ": " + e.what();
+                break;
+            }
+            ++report.records;
+
+            if (record.type == JournalEvent::JOURNAL_START)
+            {
+                // Reinicio del servidor: los IDs de sesión vuelven a empezar.
+                start_us_ = record.time_us;
+                sessions_.clear();
+                if (options_.session == 0)
+                {
+                    out << timestamp(0, true) << " journal start\n";
+                }
+                continue;
+            }
+            if (options_.session != 0 && record.session != options_.session)
+            {
+                continue;
+            }
+
+            SessionReplay &session = sessions_[record.session];
+            replay(session, record, report);
+
+            if (record.type == JournalEvent::STATUS)
+            {
+                ++report.statuses;
+                if (options_.status)
+                {
+                    // Misma forma que Server::log: "[INFO] fecha ip query response".
+                    std::string query;
+                    try
+                    {
+                        if (session.failure.empty())
+                        {
+                            query = protocol_.build_message(rebuild_status(session, record));
+                        }
+                    }
+                    catch (const std::exception &e)
+                    {
+                        session.failure = e.what();
+                        ++report.failed_replays;
+                    }
+                    if (!session.failure.empty())
+                    {
+                        query = "<not rebuilt: " + session.failure + ">";
+                    }
+                    const std::string &ip = record.player < session.ip.size() ? session.ip[record.player] : session.ip[0];
+                    out << "[INFO] " << timestamp(record.time_us, false) << ' ' << ip << ' ' << query << " Status sent\n";
+                    continue;
+                }
+            }
+            out << timestamp(record.time_us, true) << " session " << record.session << " player "
+                << static_cast<int>(record.player) << ' ' << describe(record) << '\n';
+        }
+        return report;
+    }
+
+    void JournalDump::replay(SessionReplay &session, const JournalRecord &record, DumpReport &report)
+    {
+        if (!session.failure.empty())
+        {
+            return;
+        }
+        int player = record.player;
+        try
+        {
+            switch (record.type)
+            {
+            case JournalEvent::PLAYER_JOINED:
+                session.ip.at(static_cast<size_t>(player)) = record.text;
+                break;
+            case JournalEvent::REGISTERED:
+                session.game.register_player(player, std::get<BattleShipProtocol::RegisterData>(protocol_.parse_binary_message(record.text).data));
+                break;
+            case JournalEvent::SHIPS_PLACED:
+                session.game.place_ships(player, std::get<BattleShipProtocol::PlaceShipsData>(protocol_.parse_binary_message(record.text).data));
+                break;
+            case JournalEvent::PHASE:
+                if (record.value == static_cast<uint8_t>(Phase::PLACEMENT))
+                    session.game.transition_to_placement();
+                else if (record.value == static_cast<uint8_t>(Phase::PLAYING))
+                    session.game.transition_to_playing();
+                else if (record.value == static_cast<uint8_t>(Phase::FINISHED))
+                    session.game.transition_to_finished();
+                break;
+            case JournalEvent::SHOT:
+                session.game.process_shot(player, BattleShipProtocol::ShootData{record.target});
+                break;
+            case JournalEvent::TURN_TIMEOUT:
+                session.game.skip_turn();
+                break;
+            default:
+                break;
+            }
+        }
+        catch (const std::exception &e)
+        {
+            // Un registro perdido (cola llena) deja la partida inconsistente: se deja de reconstruir.
+            session.failure = e.what();
+            ++report.failed_replays;
+        }
+    }
+
+    Message JournalDump::rebuild_status(SessionReplay &session, const JournalRecord &record)
+    {
+        using BattleShipProtocol::Journal;
+        int player = record.player;
+        int opponent = player == 1 ? 2 : 1;
+        auto turn = (record.value & Journal::STATUS_YOUR_TURN) ? BattleShipProtocol::Turn::YOUR_TURN
+                                                                 : BattleShipProtocol::Turn::OPPONENT_TURN;
+        int time_remaining = static_cast<int>(record.time_remaining);
+        auto &sent_own = session.sent_own.at(static_cast<size_t>(player));
+        auto &sent_opponent = session.sent_opponent.at(static_cast<size_t>(player));
+
+        if (record.value & Journal::STATUS_DELTA)
+        {
+            // Igual que GameSession::send_status_delta: celdas distintas de lo último enviado.
+            BattleShipProtocol::StatusDeltaData delta{++session.status_seq[player], turn, {}, {}, session.game.get_game_state(), time_remaining};
+            for (int i = 0; i < static_cast<int>(sent_own.size()); ++i)
+            {
+                auto own = session.game.cell_state(player, i);
+                if (own != sent_own[i])
+                {
+                    sent_own[i] = own;
+                    delta.ownChanges.push_back({BattleShipProtocol::Coordinate::from_index(static_cast<uint8_t>(i)), own});
+                }
+                auto theirs = session.game.cell_state(opponent, i);
+                if (theirs != sent_opponent[i])
+                {
+                    sent_opponent[i] = theirs;
+                    delta.opponentChanges.push_back({BattleShipProtocol::Coordinate::from_index(static_cast<uint8_t>(i)), theirs});
+                }
+            }
+            return {MessageType::STATUS_DELTA, std::move(delta)};
+        }
+
+        auto status = session.game.get_status(player);
+        for (size_t i = 0; i < sent_own.size() && i < status.boardOwn.size(); ++i)
+        {
+            sent_own[i] = status.boardOwn[i].cellState;
+            sent_opponent[i] = status.boardOpponent[i].cellState;
+        }
+        session.status_seq[player] = 0;
+        return {MessageType::STATUS, BattleShipProtocol::StatusData{turn, std::move(status.boardOwn), std::move(status.boardOpponent),
+                                                                    status.gameState, time_remaining}};
+    }
+
+    std::string JournalDump::describe(const JournalRecord &record) const
+    {
+        switch (record.type)
+        {
+        case JournalEvent::JOURNAL_START:
+            return "JOURNAL_START";
+        case JournalEvent::PLAYER_JOINED:
+            return "JOINED " + record.text;
+        case JournalEvent::REGISTERED:
+        case JournalEvent::SHIPS_PLACED:
+            try
+            {
+                return without_newline(protocol_.build_message(protocol_.parse_binary_message(record.text)));
+            }
+            catch (const std::exception &e)
+            {
+                return std::string(record.type == JournalEvent::REGISTERED ? "REGISTER" : "PLACE_SHIPS") + " <" + e.what() + ">";
+            }
+        case JournalEvent::PHASE:
+            return std::string("PHASE ") + phase_name(record.value);
+        case JournalEvent::SHOT:
+            return "SHOT " + record.target.to_string() + " " + cell_state_name(record.result);
+        case JournalEvent::TURN_TIMEOUT:
+            return "TURN_TIMEOUT";
+        case JournalEvent::STATUS:
+            return std::string("STATUS ") + ((record.value & BattleShipProtocol::Journal::STATUS_DELTA) ? "delta " : "full ") +
+                   ((record.value & BattleShipProtocol::Journal::STATUS_YOUR_TURN) ? "YOUR_TURN " : "OPPONENT_TURN ") +
+                   std::to_string(record.time_remaining) + "s";
+        case JournalEvent::SURRENDER:
+            return "SURRENDER";
+        case JournalEvent::DISCONNECT:
+            return "DISCONNECT " + record.text;
+        case JournalEvent::GAME_OVER:
+            return "GAME_OVER winner";
+        }
+        return "?";
+    }
+
+    std::string JournalDump::timestamp(uint64_t time_us, bool micros) const
+    {
+        uint64_t wall_us = start_us_ + time_us;
+        std::time_t seconds = static_cast<std::time_t>(wall_us / 1000000);
+        std::tm local{};
+        localtime_r(&seconds, &local);
+        char text[40];
+        size_t length = std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &local);
+        if (micros)
+        {
+            std::snprintf(text + length, sizeof(text) - length, ".%06u", static_cast<unsigned>(wall_us % 1000000));
+        }
+        return text;
+    }
+
+} // namespace BattleshipLogDump
@@ -0,0 +1,66 @@
+#include "log_dump.hpp"
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief Punto de entrada del volcador del diario de eventos.
+ *
+ * @param argc Número de argumentos de la línea de comandos.
+ * @param argv [1] ruta del diario, seguida de opciones: --session N y --status.
+ * @return 0 si se leyó el diario completo, 1 ante un error de uso, 2 si estaba truncado o corrupto.
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <journal> [--session N] [--status]\n";
+        std::cerr << "Example: " << argv[0] << " ./logs/server.log.journal --session 3 --status\n";
+        return 1;
+    }
+
+    BattleshipLogDump::DumpOptions options;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg == "--session" && i + 1 < argc) {
+                long long session = std::stoll(argv[++i]);
+                if (session <= 0 || session > UINT32_MAX) {
+                    throw std::out_of_range("Session ID out of range");
+                }
+                options.session = static_cast<uint32_t>(session);
+            } else if (arg == "--status") {
+                options.status = true;
+            } else {
+                std::cerr << "Unknown or incomplete option: " << arg << "\n";
+                return 1;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Invalid value for " << arg << ": " << argv[i] << " (" << e.what() << ")\n";
+            return 1;
+        }
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file) {
+        std::cerr << "Cannot open journal: " << argv[1] << "\n";
+        return 1;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    BattleshipLogDump::JournalDump dump(options);
+    BattleshipLogDump::DumpReport report = dump.dump(data, std::cout);
+    std::cout.flush();
+
+    std::cerr << report.records << " records, " << report.statuses << " statuses";
+    if (report.failed_replays > 0) {
+        std::cerr << ", " << report.failed_replays << " sessions not rebuilt";
+    }
+    std::cerr << "\n";
+    if (!report.error.empty()) {
+        std::cerr << "Journal truncated or corrupt at " << report.error << "\n";
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+#include "../include/game_logic.hpp"
+#include <string>
+#include <vector>
+
+namespace BattleShipProtocol
+{
+    namespace
+    {
+        const std::vector<Ship> FLEET = {
+            {ShipType::PORTAAVIONES, {{"A", 1}, {"A", 2}, {"A", 3}, {"A", 4}, {"A", 5}}},
+            {ShipType::BUQUE, {{"B", 1}, {"B", 2}, {"B", 3}, {"B", 4}}},
+            {ShipType::CRUCERO, {{"C", 1}, {"C", 2}, {"C", 3}}},
+            {ShipType::CRUCERO, {{"D", 1}, {"D", 2}, {"D", 3}}},
+            {ShipType::DESTRUCTOR, {{"E", 1}, {"E", 2}}},
+            {ShipType::DESTRUCTOR, {{"F", 1}, {"F", 2}}},
+            {ShipType::SUBMARINO, {{"G", 1}}},
+            {ShipType::SUBMARINO, {{"H", 1}}},
+            {ShipType::SUBMARINO, {{"I", 1}}}};
+
+        void prepare(GameLogic &game)
+        {
+            game.register_player(1, RegisterData{"one", "one@mail.com"});
+            game.register_player(2, RegisterData{"two", "two@mail.com"});
+            game.place_ships(1, PlaceShipsData{FLEET});
+            game.place_ships(2, PlaceShipsData{FLEET});
+        }
+
+        // Recorre el tablero por filas: cada disparo de la fila A a la I impacta un barco y los hunde todos.
+        std::vector<ShootData> all_cells()
+        {
+            std::vector<ShootData> shots;
+            for (char row = 'A'; row <= 'J'; ++row)
+            {
+                for (int col = 1; col <= 10; ++col)
+                {
+                    shots.push_back(ShootData{Coordinate(row, col)});
+                }
+            }
+            return shots;
+        }
+    }
+
+    // Ambos jugadores disparan a todas las celdas en orden hasta que termina la partida.
+    static void BM_ProcessShot_FullGame(benchmark::State &state)
+    {
+        const std::vector<ShootData> shots = all_cells();
+        int64_t processed = 0;
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            GameLogic game;
+            prepare(game);
+            state.ResumeTiming();
+
+            for (size_t i = 0; i < shots.size() && !game.is_game_over(); ++i)
+            {
+                game.process_shot(1, shots[i]);
+                ++processed;
+                if (!game.is_game_over())
+                {
+                    game.process_shot(2, shots[i]);
+                    ++processed;
+                }
+            }
+            benchmark::DoNotOptimize(game);
+        }
+        state.SetItemsProcessed(processed);
+    }
+    BENCHMARK(BM_ProcessShot_FullGame);
+
+    // Solo impactos: las 22 celdas con barco, incluidos los 9 hundimientos.
+    static void BM_ProcessShot_HitsAndSinks(benchmark::State &state)
+    {
+        std::vector<ShootData> hits;
+        for (const auto &ship : FLEET)
+        {
+            for (const auto &coord : ship.coordinates)
+            {
+                hits.push_back(ShootData{coord});
+            }
+        }
+        int64_t processed = 0;
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            GameLogic game;
+            prepare(game);
+            state.ResumeTiming();
+
+            for (const auto &shot : hits)
+            {
+                game.process_shot(1, shot);
+                if (!game.is_game_over())
+                {
+                    game.skip_turn();
+                }
+                ++processed;
+            }
+            benchmark::DoNotOptimize(game);
+        }
+        state.SetItemsProcessed(processed);
+    }
+    BENCHMARK(BM_ProcessShot_HitsAndSinks);
+
+} // namespace BattleShipProtocol
+
+BENCHMARK_MAIN();
@@ -0,0 +1,182 @@
+#include <benchmark/benchmark.h>
+#include "../include/protocol.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+// Contador global de reservas: cada benchmark lo lee antes y después del bucle medido.
+static std::atomic<size_t> allocations{0};
+
+void *operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+
+namespace BattleShipProtocol
+{
+    namespace
+    {
+        // Tablero de mitad de partida: la flota por filas, impactos en la primera columna, la fila E hundida y agua fallada.
+        std::vector<Cell> full_board()
+        {
+            const int ship_length[10] = {5, 4, 3, 3, 2, 2, 1, 1, 1, 0};
+            std::vector<Cell> board;
+            for (uint8_t index = 0; index < 100; ++index)
+            {
+                int row = index / 10;
+                int col = index % 10;
+                CellState state = CellState::WATER;
+                if (col < ship_length[row])
+                {
+                    state = row == 4 ? CellState::SUNK : (col == 0 ? CellState::HIT : CellState::SHIP);
+                }
+                else if (index % 7 == 0)
+                {
+                    state = CellState::MISS;
+                }
+                board.push_back(Cell{Coordinate::from_index(index), state});
+            }
+            return board;
+        }
+
+        Message sample(MessageType type)
+        {
+            switch (type)
+            {
+            case MessageType::PLAYER_ID:
+                return {type, PlayerIdData{2}};
+            case MessageType::REGISTER:
+                return {type, RegisterData{"PlayerOne", "player1@mail.com"}};
+            case MessageType::PLACE_SHIPS:
+                return {type, PlaceShipsData{{{ShipType::PORTAAVIONES, {{"A", 1}, {"A", 2}, {"A", 3}, {"A", 4}, {"A", 5}}},
+                                              {ShipType::BUQUE, {{"B", 1}, {"B", 2}, {"B", 3}, {"B", 4}}},
+                                              {ShipType::CRUCERO, {{"C", 1}, {"C", 2}, {"C", 3}}},
+                                              {ShipType::CRUCERO, {{"D", 1}, {"D", 2}, {"D", 3}}},
+                                              {ShipType::DESTRUCTOR, {{"E", 1}, {"E", 2}}},
+                                              {ShipType::DESTRUCTOR, {{"F", 1}, {"F", 2}}},
+                                              {ShipType::SUBMARINO, {{"G", 1}}},
+                                              {ShipType::SUBMARINO, {{"H", 1}}},
+                                              {ShipType::SUBMARINO, {{"I", 1}}}}}};
+            case MessageType::SHOOT:
+                return {type, ShootData{{"J", 10}}};
+            case MessageType::STATUS:
+                return {type, StatusData{Turn::YOUR_TURN, full_board(), full_board(), GameState::ONGOING, 25}};
+            case MessageType::SURRENDER:
+            case MessageType::RESYNC:
+                return {type, std::monostate{}};
+            case MessageType::GAME_OVER:
+                return {type, GameOverData{"YOU_WIN"}};
+            case MessageType::ERROR:
+                return {type, ErrorData{400, "Coordinate out of bounds"}};
+            case MessageType::HELLO:
+                return {type, HelloData{Protocol::BINARY_VERSION, true}};
+            case MessageType::STATUS_DELTA:
+                return {type, StatusDeltaData{7, Turn::OPPONENT_TURN, {}, {{{"F", 7}, CellState::MISS}}, GameState::ONGOING, 30}};
+            }
+            return {type, std::monostate{}};
+        }
+
+        const std::vector<std::pair<const char *, MessageType>> TYPES = {
+            {"PLAYER_ID", MessageType::PLAYER_ID},
+            {"REGISTER", MessageType::REGISTER},
+            {"PLACE_SHIPS", MessageType::PLACE_SHIPS},
+            {"SHOOT", MessageType::SHOOT},
+            {"STATUS", MessageType::STATUS},
+            {"SURRENDER", MessageType::SURRENDER},
+            {"GAME_OVER", MessageType::GAME_OVER},
+            {"ERROR", MessageType::ERROR},
+            {"HELLO", MessageType::HELLO},
+            {"STATUS_DELTA", MessageType::STATUS_DELTA},
+            {"RESYNC", MessageType::RESYNC}};
+
+        void report(benchmark::State &state, size_t bytes, size_t allocs_before)
+        {
+            size_t allocs = allocations.load(std::memory_order_relaxed) - allocs_before;
+            state.SetBytesProcessed(static_cast<int64_t>(bytes * state.iterations()));
+            state.counters["bytes/op"] = static_cast<double>(bytes);
+            state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(allocs), benchmark::Counter::kAvgIterations);
+        }
+
+        void BM_Build(benchmark::State &state, MessageType type, bool binary)
+        {
+            Protocol protocol;
+            Message msg = sample(type);
+            size_t bytes = (binary ? protocol.build_binary_message(msg) : protocol.build_message(msg)).size();
+            size_t before = allocations.load(std::memory_order_relaxed);
+            for (auto _ : state)
+            {
+                std::string wire = binary ? protocol.build_binary_message(msg) : protocol.build_message(msg);
+                benchmark::DoNotOptimize(wire);
+            }
+            report(state, bytes, before);
+        }
+
+        void BM_BuildInto(benchmark::State &state, MessageType type, bool binary)
+        {
+            Protocol protocol;
+            Message msg = sample(type);
+            // Un buffer reutilizado, como el Outbox del servidor: solo crece en la primera vuelta.
+            std::string wire;
+            size_t before = allocations.load(std::memory_order_relaxed);
+            for (auto _ : state)
+            {
+                wire.clear();
+                if (binary)
+                    protocol.build_binary_message(msg, wire);
+                else
+                    protocol.build_message(msg, wire);
+                benchmark::DoNotOptimize(wire.data());
+            }
+            report(state, wire.size(), before);
+        }
+
+        void BM_Parse(benchmark::State &state, MessageType type, bool binary)
+        {
+            Protocol protocol;
+            Message msg = sample(type);
+            std::string wire = binary ? protocol.build_binary_message(msg) : protocol.build_message(msg);
+            // El servidor recibe el frame binario sin el prefijo de longitud, ya recortado por el Framer.
+            std::string_view frame = binary ? std::string_view(wire).substr(Protocol::BINARY_HEADER_SIZE) : std::string_view(wire);
+            size_t before = allocations.load(std::memory_order_relaxed);
+            for (auto _ : state)
+            {
+                Message parsed = binary ? protocol.parse_binary_message(frame) : protocol.parse_message(frame);
+                benchmark::DoNotOptimize(parsed);
+            }
+            report(state, frame.size(), before);
+        }
+    }
+} // namespace BattleShipProtocol
+
+int main(int argc, char **argv)
+{
+    using namespace BattleShipProtocol;
+    for (const char *codec : {"Text", "Binary"})
+    {
+        bool binary = std::string(codec) == "Binary";
+        for (const auto &[name, type] : TYPES)
+        {
+            benchmark::RegisterBenchmark((std::string("BM_Build") + codec + "/" + name).c_str(), BM_Build, type, binary);
+            benchmark::RegisterBenchmark((std::string("BM_BuildInto") + codec + "/" + name).c_str(), BM_BuildInto, type, binary);
+            benchmark::RegisterBenchmark((std::string("BM_Parse") + codec + "/" + name).c_str(), BM_Parse, type, binary);
+        }
+    }
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,73 @@
+#ifndef BITBOARD_HPP
+#define BITBOARD_HPP
+
+#include <cstdint>
+
+namespace BattleShipProtocol
+{
+
+    /**
+     * @brief Set of board cells stored as a 128-bit mask.
+     *
+     * Bit i stands for the cell with index i (row * 10 + column - 1), so the 100 cells of
+     * a board fit in two 64-bit words and set operations cost a couple of instructions.
+     */
+    struct Bitboard
+    {
+        uint64_t low = 0;  ///< Cells 0 to 63.
+        uint64_t high = 0; ///< Cells 64 to 127.
+
+        /**
+         * @brief Returns a board with a single cell set.
+         * @param index Cell index (0 to 127).
+         * @return Bitboard containing only that cell.
+         */
+        static constexpr Bitboard cell(uint8_t index) noexcept
+        {
+            return index < 64 ? Bitboard{uint64_t{1} << index, 0}
+                              : Bitboard{0, uint64_t{1} << (index - 64)};
+        }
+
+        /**
+         * @brief Checks whether a cell is set.
+         * @param index Cell index (0 to 127).
+         * @return True if the cell belongs to the set.
+         */
+        constexpr bool test(uint8_t index) const noexcept
+        {
+            return index < 64 ? (low >> index) & 1 : (high >> (index - 64)) & 1;
+        }
+
+        /**
+         * @brief Adds a cell to the set.
+         * @param index Cell index (0 to 127).
+         */
+        constexpr void set(uint8_t index) noexcept { *this |= cell(index); }
+
+        /**
+         * @brief Checks whether the set is empty.
+         * @return True if no cell is set.
+         */
+        constexpr bool empty() const noexcept { return (low | high) == 0; }
+
+        /**
+         * @brief Returns the number of cells in the set.
+         * @return Population count.
+         */
+        constexpr int count() const noexcept { return __builtin_popcountll(low) + __builtin_popcountll(high); }
+
+        constexpr Bitboard operator|(Bitboard other) const noexcept { return {low | other.low, high | other.high}; }
+        constexpr Bitboard operator&(Bitboard other) const noexcept { return {low & other.low, high & other.high}; }
+        constexpr Bitboard &operator|=(Bitboard other) noexcept
+        {
+            low |= other.low;
+            high |= other.high;
+            return *this;
+        }
+        constexpr bool operator==(Bitboard other) const noexcept { return low == other.low && high == other.high; }
+        constexpr bool operator!=(Bitboard other) const noexcept { return !(*this == other); }
+    };
+
+} // namespace BattleShipProtocol
+
+#endif
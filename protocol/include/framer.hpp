@@ -0,0 +1,148 @@
+#ifndef FRAMER_HPP
+#define FRAMER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+namespace BattleShipProtocol
+{
+
+    /**
+     * @brief Splits a byte stream into newline-terminated frames without allocating.
+     *
+     * The framer owns a fixed-size buffer that is allocated once and reused for the whole
+     * connection. Bytes are written at the tail (directly by recv() through write_area(),
+     * or copied with append()) and complete frames are handed out from the head as
+     * std::string_view. Partial frames stay buffered across calls; the unread tail is
+     * moved back to the start of the buffer only when the writer reaches the end, so each
+     * byte is copied at most once per wrap and pipelined input is framed in linear time.
+     *
+     * Frames are either newline-terminated text lines or binary frames introduced by a
+     * 2-byte big-endian length (see Protocol::build_binary_message()); the mode can be
+     * switched between frames when the wire format is negotiated.
+     *
+     * A frame longer than the capacity can never complete: overflowed() reports it so the
+     * owner can drop the connection instead of growing memory without bound.
+     */
+    class Framer
+    {
+    public:
+        /**
+         * @brief How frames are delimited.
+         */
+        enum class Mode
+        {
+            LINES,          ///< Newline-terminated text; frames include the '\n'.
+            LENGTH_PREFIXED ///< 2-byte big-endian length; frames exclude the prefix.
+        };
+
+        /**
+         * @brief Default buffer size; comfortably above the largest text message (~2.3 KB STATUS).
+         */
+        static constexpr size_t DEFAULT_CAPACITY = 8192;
+
+        /**
+         * @brief Creates a framer with a fixed capacity.
+         * @param capacity Maximum number of buffered bytes (and therefore frame length).
+         */
+        explicit Framer(size_t capacity = DEFAULT_CAPACITY);
+
+        /**
+         * @brief Returns the free space at the tail, compacting the buffer if needed.
+         *
+         * Any view returned by next() is invalidated.
+         *
+         * @return Pointer and size of the writable region (size 0 when the buffer is full).
+         */
+        std::pair<char *, size_t> write_area();
+
+        /**
+         * @brief Marks bytes written into write_area() as received.
+         * @param size Number of bytes written.
+         */
+        void commit(size_t size);
+
+        /**
+         * @brief Copies bytes into the buffer.
+         *
+         * Any view returned by next() is invalidated.
+         *
+         * @param data Bytes to copy.
+         * @param size Number of bytes.
+         * @return Number of bytes accepted; less than size only when the buffer is full.
+         */
+        size_t append(const char *data, size_t size);
+
+        /**
+         * @brief Changes how the following frames are delimited.
+         *
+         * Bytes already buffered but not yet returned are framed with the new mode.
+         *
+         * @param mode New framing mode.
+         */
+        void set_mode(Mode mode) noexcept;
+
+        /**
+         * @brief Returns the current framing mode.
+         * @return Framing mode.
+         */
+        Mode mode() const noexcept { return mode_; }
+
+        /**
+         * @brief Extracts the next complete frame.
+         *
+         * In LINES mode the view includes the trailing '\n'; in LENGTH_PREFIXED mode it
+         * holds the bytes after the length prefix. It stays valid until the next call to
+         * write_area(), append() or clear().
+         *
+         * @return The frame, or std::nullopt if no complete frame is buffered.
+         */
+        std::optional<std::string_view> next();
+
+        /**
+         * @brief Checks whether a frame exceeded the capacity.
+         * @return True if the buffer is full and holds no complete line, or a length prefix
+         *         announces a frame larger than the buffer.
+         */
+        bool overflowed() const noexcept;
+
+        /**
+         * @brief Returns the number of buffered bytes not yet returned by next().
+         * @return Buffered bytes.
+         */
+        size_t buffered() const noexcept { return tail_ - head_; }
+
+        /**
+         * @brief Returns the buffer capacity.
+         * @return Capacity in bytes.
+         */
+        size_t capacity() const noexcept { return capacity_; }
+
+        /**
+         * @brief Discards every buffered byte.
+         */
+        void clear() noexcept;
+
+    private:
+        static constexpr size_t LENGTH_PREFIX = 2; ///< Size of the binary length prefix.
+
+        std::unique_ptr<char[]> buffer_; ///< Fixed storage.
+        size_t capacity_;                ///< Size of buffer_.
+        size_t head_ = 0;                ///< Start of the first unreturned byte.
+        size_t scan_ = 0;                ///< Bytes before this offset are known not to contain '\n'.
+        size_t tail_ = 0;                ///< End of the buffered bytes.
+        Mode mode_ = Mode::LINES;        ///< Current framing mode.
+        bool too_long_ = false;          ///< A length prefix exceeded the capacity.
+
+        /**
+         * @brief Moves the unread bytes to the start of the buffer.
+         */
+        void compact() noexcept;
+    };
+
+} // namespace BattleShipProtocol
+
+#endif
@@ -3,9 +3,10 @@
 
 #include "protocol.hpp"
 #include "phase_state.hpp"
+#include "bitboard.hpp"
 #include <array>
+#include <cstdint>
 #include <vector>
-#include <map>
 #include <optional>
 #include <string>
 #include <iostream>
@@ -30,7 +31,8 @@ namespace BattleShipProtocol
      * @brief Main game logic controller for Battleship with two players.
      *
      * Manages player state, game phases, turn-taking, shot processing,
-     * ship placement, and game completion.
+     * ship placement, and game completion. Boards are kept as bitboards indexed by
+     * cell; Cell and Coordinate values are only built when a status is requested.
      */
     class GameLogic
     {
@@ -104,6 +106,12 @@ namespace BattleShipProtocol
          */
         void process_shot(int player_id, const ShootData &shot);
 
+        /**
+         * @brief Passes the turn to the opponent without a shot (turn timeout).
+         * @throws GameLogicError if the game is already over.
+         */
+        void skip_turn();
+
         /**
          * @brief Returns the current game status from the perspective of the player.
          * @param player_id ID of the player requesting the status.
@@ -112,6 +120,33 @@ namespace BattleShipProtocol
          */
         StatusData get_status(int player_id) const;
 
+        /**
+         * @brief Fills a status from the perspective of the player, reusing its boards.
+         *
+         * Same content as get_status(int), but the board vectors keep their capacity, so
+         * a caller that sends a status every turn does not allocate once they are sized.
+         *
+         * @param player_id ID of the player requesting the status.
+         * @param status Status to overwrite; time_remaining is left untouched.
+         * @throws GameLogicError if the player ID is invalid.
+         */
+        void get_status(int player_id, StatusData &status) const;
+
+        /**
+         * @brief Returns the overall game state reported in STATUS messages.
+         * @return ENDED once finished, ONGOING while both fleets are placed, WAITING otherwise.
+         */
+        GameState get_game_state() const;
+
+        /**
+         * @brief Returns the state of one cell of a player's board without copying the board.
+         * @param player_id Owner of the board.
+         * @param index Cell index (row * 10 + column - 1).
+         * @return State of the cell.
+         * @throws GameLogicError if the player ID or index is invalid.
+         */
+        CellState cell_state(int player_id, int index) const;
+
         /**
          * @brief Checks whether the game has finished.
          * @return True if the game is over.
@@ -137,31 +172,73 @@ namespace BattleShipProtocol
 
         static constexpr int BOARD_SIZE = 10; ///< Board dimensions (10x10).
         static constexpr int MAX_PLAYERS = 2; ///< Maximum number of players.
+        static constexpr int FLEET_SIZE = 9;  ///< Ships per player.
 
         /**
          * @brief Represents a player's state in the game.
          */
         struct Player
         {
-            std::string nickname;                            ///< Player's nickname.
-            std::array<Cell, BOARD_SIZE * BOARD_SIZE> board; ///< Player's board.
-            std::vector<Ship> ships;                         ///< Ships placed on the board.
-            bool surrendered = false;                        ///< True if the player surrendered.
-            int ships_remaining = 9;                         ///< Remaining ships (counted by units).
+            std::string nickname;                                   ///< Player's nickname.
+            Bitboard ships;                                         ///< Cells occupied by a ship.
+            Bitboard hits;                                          ///< Ship cells that have been hit.
+            Bitboard misses;                                        ///< Water cells that have been shot.
+            Bitboard sunk;                                          ///< Cells of ships that have been sunk.
+            std::array<Bitboard, FLEET_SIZE> fleet{};               ///< Cells of each placed ship.
+            std::array<uint8_t, FLEET_SIZE> intact{};               ///< Cells of each ship not hit yet.
+            std::array<uint8_t, BOARD_SIZE * BOARD_SIZE> ship_at{}; ///< Ship owning each cell (only read where ships is set).
+            uint8_t fleet_size = 0;                                 ///< Ships placed (0 or FLEET_SIZE).
+            bool surrendered = false;                               ///< True if the player surrendered.
+            int ships_remaining = 9;                                ///< Ships still afloat.
         };
 
-        std::map<int, Player> players_;     ///< Map of player IDs to their state.
-        int current_turn_;                  ///< ID of the player whose turn it is.
-        bool game_over_;                    ///< True if the game has ended.
-        std::optional<std::string> winner_; ///< Winner's nickname if known.
+        std::array<Player, MAX_PLAYERS> players_; ///< Player state, indexed by ID - 1.
+        int current_turn_;                        ///< ID of the player whose turn it is.
+        bool game_over_;                          ///< True if the game has ended.
+        std::optional<std::string> winner_;       ///< Winner's nickname if known.
+
+        /**
+         * @brief Returns the state of a player.
+         * @param player_id ID of the player (1 or 2).
+         * @return Player reference.
+         * @throws GameLogicError if the ID is invalid.
+         */
+        Player &player(int player_id);
+
+        /**
+         * @copydoc player(int)
+         */
+        const Player &player(int player_id) const;
 
         /**
          * @brief Converts a board coordinate into a linear index (0 to 99).
          * @param coord Coordinate to convert.
-         * @return Index in the board array.
+         * @return Index in the bitboards.
          * @throws GameLogicError if coordinate is invalid.
          */
-        int coord_to_index(const Coordinate &coord) const;
+        uint8_t coord_to_index(const Coordinate &coord) const;
+
+        /**
+         * @brief Derives the state of one cell from a player's bitboards.
+         * @param player Owner of the board.
+         * @param index Cell index (0 to 99).
+         * @return State of the cell.
+         */
+        static CellState state_at(const Player &player, uint8_t index) noexcept;
+
+        /**
+         * @brief Builds the 100 cells of a player's board for a STATUS message.
+         * @param player Owner of the board.
+         * @return Cells in index order.
+         */
+        static std::vector<Cell> board_cells(const Player &player);
+
+        /**
+         * @brief Overwrites a vector with the 100 cells of a player's board.
+         * @param player Owner of the board.
+         * @param cells Destination; its capacity is reused.
+         */
+        static void board_cells(const Player &player, std::vector<Cell> &cells);
 
         /**
          * @brief Validates and places ships for a player.
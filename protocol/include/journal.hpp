@@ -0,0 +1,116 @@
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+#include "protocol.hpp"
+#include "phase_state.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace BattleShipProtocol
+{
+
+    /**
+     * @brief Kinds of records in the game-event journal.
+     */
+    enum class JournalEvent : uint8_t
+    {
+        JOURNAL_START = 0, ///< Server start; time_us holds the wall clock (µs since the epoch).
+        PLAYER_JOINED = 1, ///< Player assigned to a session; text holds the client IP.
+        REGISTERED = 2,    ///< Registration accepted; text holds the binary REGISTER frame.
+        SHIPS_PLACED = 3,  ///< Fleet accepted; text holds the binary PLACE_SHIPS frame.
+        PHASE = 4,         ///< Phase change; value holds the new PhaseState::Phase.
+        SHOT = 5,          ///< Shot processed; target and result (state of the cell afterwards).
+        TURN_TIMEOUT = 6,  ///< Player lost the turn without shooting.
+        STATUS = 7,        ///< Status sent to the player; value holds the STATUS_* flags.
+        SURRENDER = 8,     ///< Player surrendered.
+        DISCONNECT = 9,    ///< Player went away; text holds the reason.
+        GAME_OVER = 10     ///< Match finished; player is the winner.
+    };
+
+    /**
+     * @brief One event of the journal.
+     *
+     * Only the fields listed for the event type in JournalEvent are stored; the rest keep
+     * their defaults when a record is read back.
+     */
+    struct JournalRecord
+    {
+        JournalEvent type = JournalEvent::JOURNAL_START; ///< Event kind.
+        uint32_t session = 0;                            ///< Session ID (0 for JOURNAL_START).
+        uint8_t player = 0;                              ///< Player the event refers to (0 if none).
+        uint64_t time_us = 0;                            ///< Microseconds since the last JOURNAL_START.
+        Coordinate target{};                             ///< SHOT target.
+        CellState result = CellState::WATER;             ///< SHOT outcome.
+        uint8_t value = 0;                               ///< PHASE phase or STATUS flags.
+        uint32_t time_remaining = 0;                     ///< STATUS seconds left in the turn.
+        std::string text;                                ///< IP, reason or binary message frame.
+    };
+
+    /**
+     * @brief Encoding of the game-event journal.
+     *
+     * The journal replaces the per-turn STATUS text in the server log. Each record is a
+     * type byte, the session ID and the time as LEB128 varints, a player byte and the
+     * fields of its type, so a shot takes about 10 bytes and a status about 9 where the
+     * text log wrote ~2.3 KB. Boards are not stored: they are rebuilt by replaying the
+     * placements and shots through GameLogic (see bslogdump).
+     */
+    class Journal
+    {
+    public:
+        static constexpr uint8_t STATUS_DELTA = 0x1;     ///< STATUS flag: a STATUS_DELTA was sent.
+        static constexpr uint8_t STATUS_YOUR_TURN = 0x2; ///< STATUS flag: the player had the turn.
+
+        /**
+         * @brief Appends the encoding of a record.
+         * @param out Destination buffer.
+         * @param record Record to encode.
+         * @throws ProtocolError if the type is unknown.
+         */
+        static void append(std::string &out, const JournalRecord &record);
+
+        /**
+         * @brief Returns the payload stored for REGISTERED and SHIPS_PLACED.
+         * @param protocol Protocol used to encode the message.
+         * @param msg Accepted REGISTER or PLACE_SHIPS message.
+         * @return Binary frame of the message without its length prefix.
+         */
+        static std::string message_text(const Protocol &protocol, const Message &msg);
+    };
+
+    /**
+     * @brief Reads the records of a journal held in memory.
+     */
+    class JournalReader
+    {
+    public:
+        /**
+         * @brief Starts reading at the beginning of the data.
+         * @param data Journal contents; must outlive the reader.
+         */
+        explicit JournalReader(std::string_view data) : data_(data) {}
+
+        /**
+         * @brief Decodes the next record.
+         * @param record Receives the record.
+         * @return False at the end of the data.
+         * @throws ProtocolError if the record is truncated or malformed; offset() then
+         *         points at its first byte.
+         */
+        bool next(JournalRecord &record);
+
+        /**
+         * @brief Returns the offset of the next record.
+         */
+        size_t offset() const noexcept { return pos_; }
+
+    private:
+        std::string_view data_; ///< Journal contents.
+        size_t pos_ = 0;        ///< Start of the next record.
+    };
+
+} // namespace BattleShipProtocol
+
+#endif
@@ -1,8 +1,11 @@
 #ifndef PROTOCOL_HPP
 #define PROTOCOL_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <variant>
 #include <vector>
 #include <stdexcept>
@@ -28,14 +31,17 @@ namespace BattleShipProtocol
      */
     enum class MessageType
     {
-        REGISTER,    ///< Player registration
-        PLACE_SHIPS, ///< Ship placement data
-        SHOOT,       ///< Player shot
-        STATUS,      ///< Game status request or response
-        SURRENDER,   ///< Player surrender
-        GAME_OVER,   ///< Game ended notification
-        ERROR,       ///< Error message
-        PLAYER_ID    ///< Assigned player ID
+        REGISTER,     ///< Player registration
+        PLACE_SHIPS,  ///< Ship placement data
+        SHOOT,        ///< Player shot
+        STATUS,       ///< Game status request or response
+        SURRENDER,    ///< Player surrender
+        GAME_OVER,    ///< Game ended notification
+        ERROR,        ///< Error message
+        PLAYER_ID,    ///< Assigned player ID
+        HELLO,        ///< Wire format negotiation
+        STATUS_DELTA, ///< Cells changed since the previous status
+        RESYNC        ///< Request for a full STATUS
     };
 
     /**
@@ -62,7 +68,7 @@ namespace BattleShipProtocol
     /**
      * @brief State of a cell on the board.
      */
-    enum class CellState
+    enum class CellState : uint8_t
     {
         WATER,
         HIT,
@@ -89,6 +95,18 @@ namespace BattleShipProtocol
         int player_id; ///< Assigned player ID (1 or 2)
     };
 
+    /**
+     * @brief Data used to negotiate the wire format.
+     *
+     * A client that sends HELLO writes every later message in the requested format; the
+     * server answers with the same HELLO and switches its own output after the answer.
+     */
+    struct HelloData
+    {
+        int version;         ///< Protocol::TEXT_VERSION or Protocol::BINARY_VERSION
+        bool deltas = false; ///< Client accepts STATUS_DELTA after the first full STATUS
+    };
+
     /**
      * @brief Data used for player registration.
      */
@@ -99,13 +117,84 @@ namespace BattleShipProtocol
     };
 
     /**
-     * @brief Coordinate on the board.
+     * @brief Coordinate on the board packed in one byte.
+     *
+     * The row (0 for 'A') is kept in the high nibble and the column number in the low
+     * nibble, so rows 'A' to 'P' and columns 0 to 15 are representable; anything else is
+     * stored as the off-board coordinate P15. Text only appears at the protocol edge
+     * through letter() and to_string().
      */
     struct Coordinate
     {
-        std::string letter; ///< Row (e.g. "A")
-        int number;         ///< Column (e.g. 5)
+        uint8_t packed = 0; ///< (row << 4) | column
+
+        constexpr Coordinate() = default;
+
+        /**
+         * @brief Packs a row letter and a column number.
+         * @param letter Row (e.g. 'A').
+         * @param number Column (e.g. 5).
+         */
+        constexpr Coordinate(char letter, int number) : packed(pack(letter, number)) {}
+
+        /**
+         * @brief Packs a one-letter row string and a column number.
+         * @param letter Row (e.g. "A"); anything longer than one character is off the board.
+         * @param number Column (e.g. 5).
+         */
+        constexpr Coordinate(std::string_view letter, int number)
+            : packed(letter.size() == 1 ? pack(letter[0], number) : OFF_BOARD) {}
+
+        /**
+         * @brief Builds the coordinate of a board index.
+         * @param index Cell index (row * 10 + column - 1), 0 to 99.
+         * @return Coordinate of the cell.
+         */
+        static constexpr Coordinate from_index(uint8_t index)
+        {
+            return Coordinate(static_cast<char>('A' + index / 10), index % 10 + 1);
+        }
+
+        /**
+         * @brief Returns the row letter.
+         */
+        constexpr char letter() const { return static_cast<char>('A' + (packed >> 4)); }
+
+        /**
+         * @brief Returns the column number.
+         */
+        constexpr int number() const { return packed & 0x0F; }
+
+        /**
+         * @brief Checks whether the coordinate lies on the 10x10 board.
+         */
+        constexpr bool on_board() const { return (packed >> 4) < 10 && number() >= 1 && number() <= 10; }
+
+        /**
+         * @brief Returns the board index (row * 10 + column - 1). Only meaningful if on_board().
+         */
+        constexpr uint8_t index() const { return static_cast<uint8_t>((packed >> 4) * 10 + number() - 1); }
+
+        /**
+         * @brief Formats the coordinate as in the text protocol (e.g. "B7").
+         */
+        std::string to_string() const { return letter() + std::to_string(number()); }
+
+        constexpr bool operator==(Coordinate other) const { return packed == other.packed; }
+        constexpr bool operator!=(Coordinate other) const { return packed != other.packed; }
+
+    private:
+        static constexpr uint8_t OFF_BOARD = 0xFF; ///< P15, used for unrepresentable input.
+
+        static constexpr uint8_t pack(char letter, int number)
+        {
+            return letter >= 'A' && letter <= 'P' && number >= 0 && number <= 15
+                       ? static_cast<uint8_t>(((letter - 'A') << 4) | number)
+                       : OFF_BOARD;
+        }
     };
+    static_assert(sizeof(Coordinate) == 1 && std::is_trivially_copyable_v<Coordinate>,
+                  "Coordinate must stay a single trivially copyable byte");
 
     /**
      * @brief Describes a ship and its position on the board.
@@ -153,6 +242,23 @@ namespace BattleShipProtocol
         int time_remaining;              ///< Remaining time for turn
     };
 
+    /**
+     * @brief Changes to a player's view since the previous STATUS or STATUS_DELTA.
+     *
+     * A full STATUS resets the sequence: the first delta after it carries seq 1 and each
+     * later one increments it. A receiver that sees any other value has missed an update
+     * and should send RESYNC, ignoring deltas until the full STATUS arrives.
+     */
+    struct StatusDeltaData
+    {
+        uint32_t seq;                      ///< Position after the last full STATUS (1-based)
+        Turn turn;                         ///< Indicates whose turn it is
+        std::vector<Cell> ownChanges;      ///< Changed cells of the player's own board
+        std::vector<Cell> opponentChanges; ///< Changed cells of the opponent's board
+        GameState gameState;               ///< Current game status
+        int time_remaining;                ///< Remaining time for turn
+    };
+
     /**
      * @brief Contains the result when the game ends.
      */
@@ -181,7 +287,9 @@ namespace BattleShipProtocol
         ShootData,
         StatusData,
         GameOverData,
-        ErrorData>;
+        ErrorData,
+        HelloData,
+        StatusDeltaData>;
 
     /**
      * @brief Represents a protocol message with type and associated data.
@@ -194,10 +302,20 @@ namespace BattleShipProtocol
 
     /**
      * @brief Provides functions to parse and serialize protocol messages.
+     *
+     * Two wire formats are supported. The text format is the newline-terminated grammar
+     * used by default. The binary format (version 1) frames each message with a 2-byte
+     * big-endian length followed by a 1-byte message type; coordinates take one byte
+     * (row * 10 + column - 1) and boards are packed at 2 bits or a nibble per cell, so a
+     * STATUS takes around 100 bytes instead of ~2.3 KB.
      */
     class Protocol
     {
     public:
+        static constexpr int TEXT_VERSION = 0;            ///< HELLO version selecting the text format.
+        static constexpr int BINARY_VERSION = 1;          ///< HELLO version selecting the binary format.
+        static constexpr size_t BINARY_HEADER_SIZE = 2;   ///< Length prefix of a binary frame.
+
         /**
          * @brief Default constructor.
          */
@@ -217,6 +335,43 @@ namespace BattleShipProtocol
          */
         std::string build_message(const Message &msg) const;
 
+        /**
+         * @brief Serializes a Message at the end of a caller-owned buffer.
+         *
+         * Writes straight into the buffer without temporaries, so reusing one buffer
+         * for every message performs no allocation once it has grown to the largest.
+         *
+         * @param msg The structured message to serialize.
+         * @param out Buffer the message is appended to; left unchanged if this throws.
+         * @throws ProtocolError if the message cannot be represented.
+         */
+        void build_message(const Message &msg, std::string &out) const;
+
+        /**
+         * @brief Parses a binary frame and returns a structured Message object.
+         * @param frame Message type byte and payload, without the length prefix.
+         * @return A structured Message with type and data.
+         * @throws ProtocolError if the frame is truncated or malformed.
+         */
+        Message parse_binary_message(std::string_view frame) const;
+
+        /**
+         * @brief Serializes a structured Message into a binary frame.
+         * @param msg The structured message to serialize.
+         * @return The frame, including its length prefix.
+         * @throws ProtocolError if a field does not fit the binary encoding.
+         */
+        std::string build_binary_message(const Message &msg) const;
+
+        /**
+         * @brief Serializes a Message as a binary frame at the end of a caller-owned buffer.
+         * @param msg The structured message to serialize.
+         * @param out Buffer the frame, including its length prefix, is appended to; left
+         *            unchanged if this throws.
+         * @throws ProtocolError if a field does not fit the binary encoding.
+         */
+        void build_binary_message(const Message &msg, std::string &out) const;
+
     private:
         // --- String to enum/object conversions ---
 
@@ -265,32 +420,55 @@ namespace BattleShipProtocol
         /**
          * @brief Converts MessageType to string.
          */
-        std::string message_type_to_string(MessageType type) const;
+        std::string_view message_type_to_string(MessageType type) const;
 
         /**
          * @brief Converts ShipType to string.
          */
-        std::string ship_type_to_string(ShipType type) const;
+        std::string_view ship_type_to_string(ShipType type) const;
 
         /**
          * @brief Converts Turn to string.
          */
-        std::string turn_to_string(Turn turn) const;
+        std::string_view turn_to_string(Turn turn) const;
 
         /**
          * @brief Converts CellState to string.
          */
-        std::string cell_state_to_string(CellState state) const;
+        std::string_view cell_state_to_string(CellState state) const;
 
         /**
          * @brief Converts GameState to string.
          */
-        std::string game_state_to_string(GameState state) const;
+        std::string_view game_state_to_string(GameState state) const;
+
+        // --- Text serialization into a caller buffer ---
+
+        /**
+         * @brief Appends a message in the text format; build_message() rolls back on error.
+         */
+        void encode_text(const Message &msg, std::string &out) const;
+
+        /**
+         * @brief Appends a comma-separated list of coordinates (e.g. "A1,A2").
+         * @throws ProtocolError if the list is empty or holds a coordinate without a column.
+         */
+        void append_coordinates(std::string &out, const std::vector<Coordinate> &coordinates) const;
+
+        /**
+         * @brief Appends a coordinate (e.g. "B7").
+         */
+        void append_coordinate(std::string &out, const Coordinate &coordinate) const;
+
+        /**
+         * @brief Appends a comma-separated list of cells (e.g. "A1:WATER,A2:HIT").
+         */
+        void append_cells(std::string &out, const std::vector<Cell> &cells) const;
 
         /**
-         * @brief Converts a list of coordinates into a string.
+         * @brief Appends a decimal integer with std::to_chars.
          */
-        std::string coordinates_to_string(const std::vector<Coordinate> &coordinates) const;
+        void append_int(std::string &out, int64_t value) const;
 
         // --- Parsers for specific message data types ---
 
@@ -329,6 +507,16 @@ namespace BattleShipProtocol
          */
         ErrorData parse_error_data(std::string_view data) const;
 
+        /**
+         * @brief Parses HelloData from a string.
+         */
+        HelloData parse_hello_data(std::string_view data) const;
+
+        /**
+         * @brief Parses StatusDeltaData from a string.
+         */
+        StatusDeltaData parse_status_delta_data(std::string_view data) const;
+
         // --- Helpers ---
 
         /**
@@ -337,6 +525,55 @@ namespace BattleShipProtocol
          * @return Vector of Cell objects.
          */
         std::vector<Cell> parse_board_data(std::string_view board_str) const;
+
+        // --- Binary encoding ---
+
+        /**
+         * @brief Converts a board coordinate into its one-byte index.
+         * @throws ProtocolError if the coordinate is outside A1..J10.
+         */
+        uint8_t coordinate_to_index(const Coordinate &coordinate) const;
+
+        /**
+         * @brief Converts a one-byte index back into a coordinate.
+         * @throws ProtocolError if the index is outside 0..99.
+         */
+        Coordinate index_to_coordinate(uint8_t index) const;
+
+        /**
+         * @brief Appends a board, choosing the smallest encoding that can represent it.
+         * @param out Buffer receiving the bytes.
+         * @param board Cells to encode.
+         */
+        void encode_board(std::string &out, const std::vector<Cell> &board) const;
+
+        /**
+         * @brief Appends a binary frame; build_binary_message() rolls back on error.
+         */
+        void encode_binary_frame(const Message &msg, std::string &out) const;
+
+        /**
+         * @brief Appends a list of changed cells as a count and (index, state) pairs.
+         * @param out Buffer receiving the bytes.
+         * @param cells Cells to encode.
+         */
+        void encode_cells(std::string &out, const std::vector<Cell> &cells) const;
+
+        /**
+         * @brief Decodes a list written by encode_cells().
+         * @param data Frame being decoded.
+         * @param pos Read offset, advanced past the list.
+         * @return Decoded cells.
+         */
+        std::vector<Cell> decode_cells(std::string_view data, size_t &pos) const;
+
+        /**
+         * @brief Decodes a board written by encode_board().
+         * @param data Frame being decoded.
+         * @param pos Read offset, advanced past the board.
+         * @return Decoded cells.
+         */
+        std::vector<Cell> decode_board(std::string_view data, size_t &pos) const;
     };
 
 } // namespace BattleShipProtocol
@@ -0,0 +1,114 @@
+#include "framer.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace BattleShipProtocol
+{
+    Framer::Framer(size_t capacity)
+        : buffer_(new char[capacity]), capacity_(capacity) {}
+
+    std::pair<char *, size_t> Framer::write_area()
+    {
+        if (tail_ == capacity_ && head_ > 0)
+        {
+            compact();
+        }
+        return {buffer_.get() + tail_, capacity_ - tail_};
+    }
+
+    void Framer::commit(size_t size)
+    {
+        tail_ = std::min(capacity_, tail_ + size);
+    }
+
+    size_t Framer::append(const char *data, size_t size)
+    {
+        if (capacity_ - tail_ < size && head_ > 0)
+        {
+            compact();
+        }
+        size_t accepted = std::min(size, capacity_ - tail_);
+        std::memcpy(buffer_.get() + tail_, data, accepted);
+        tail_ += accepted;
+        return accepted;
+    }
+
+    void Framer::set_mode(Mode mode) noexcept
+    {
+        mode_ = mode;
+        scan_ = head_;
+        too_long_ = false;
+    }
+
+    std::optional<std::string_view> Framer::next()
+    {
+        const char *base = buffer_.get();
+        if (mode_ == Mode::LENGTH_PREFIXED)
+        {
+            size_t available = tail_ - head_;
+            if (available < LENGTH_PREFIX)
+            {
+                if (available == 0)
+                {
+                    head_ = scan_ = tail_ = 0;
+                }
+                return std::nullopt;
+            }
+            size_t length = (static_cast<size_t>(static_cast<unsigned char>(base[head_])) << 8) |
+                            static_cast<unsigned char>(base[head_ + 1]);
+            if (LENGTH_PREFIX + length > capacity_)
+            {
+                too_long_ = true;
+                return std::nullopt;
+            }
+            if (available < LENGTH_PREFIX + length)
+            {
+                return std::nullopt;
+            }
+            std::string_view frame(base + head_ + LENGTH_PREFIX, length);
+            head_ = scan_ = head_ + LENGTH_PREFIX + length;
+            return frame;
+        }
+
+        // Solo se examinan los bytes nuevos: un frame parcial no se vuelve a recorrer.
+        const void *found = std::memchr(base + scan_, '\n', tail_ - scan_);
+        if (!found)
+        {
+            scan_ = tail_;
+            if (head_ == tail_)
+            {
+                head_ = scan_ = tail_ = 0;
+            }
+            return std::nullopt;
+        }
+        size_t end = static_cast<const char *>(found) - base + 1;
+        std::string_view frame(base + head_, end - head_);
+        head_ = scan_ = end;
+        return frame;
+    }
+
+    bool Framer::overflowed() const noexcept
+    {
+        if (mode_ == Mode::LENGTH_PREFIXED)
+        {
+            return too_long_;
+        }
+        return head_ == 0 && tail_ == capacity_ && scan_ == tail_;
+    }
+
+    void Framer::clear() noexcept
+    {
+        head_ = scan_ = tail_ = 0;
+        too_long_ = false;
+    }
+
+    void Framer::compact() noexcept
+    {
+        size_t remaining = tail_ - head_;
+        std::memmove(buffer_.get(), buffer_.get() + head_, remaining);
+        scan_ -= head_;
+        tail_ = remaining;
+        head_ = 0;
+    }
+
+} // namespace BattleShipProtocol
@@ -2,6 +2,7 @@
 #include "../include/game_logic.hpp"
 #include "../include/protocol.hpp"
 #include <algorithm>
+#include <map>
 #include <sstream>
 #include <iostream>
 
@@ -9,20 +10,27 @@ namespace BattleShipProtocol
 {
     // Lista de inicializacion de miembros. Es mas eficiente de inicializar dentro del cuerpo del constructor porque:
     //  Inicializalos atributos directamente (sin primero crear valores por defecto y luego sobreescribirlos), es obligatoria para incializar referencias, constantes y algunos objetos complejos
-    GameLogic::GameLogic() : state_(), current_turn_(1), game_over_(false)
+    // Los tableros arrancan vacíos: todos los bitboards en cero equivalen a agua.
+    GameLogic::GameLogic() : state_(), players_(), current_turn_(1), game_over_(false)
     {
-        for (int i = 1; i <= MAX_PLAYERS; ++i)
+    }
+
+    GameLogic::Player &GameLogic::player(int player_id)
+    {
+        if (player_id != 1 && player_id != 2)
         {
-            int index = 0;
-            for (char row = 'A'; row <= 'J'; ++row)
-            {
-                for (int col = 1; col <= 10; ++col)
-                {
-                    players_[i].board[index] = Cell{Coordinate{std::string(1, row), col}, CellState::WATER};
-                    ++index;
-                }
-            }
+            throw GameLogicError("Invalid player ID: " + std::to_string(player_id));
+        }
+        return players_[player_id - 1];
+    }
+
+    const GameLogic::Player &GameLogic::player(int player_id) const
+    {
+        if (player_id != 1 && player_id != 2)
+        {
+            throw GameLogicError("Invalid player ID: " + std::to_string(player_id));
         }
+        return players_[player_id - 1];
     }
 
     void GameLogic::register_player(int player_id, const RegisterData &data)
@@ -35,26 +43,26 @@ namespace BattleShipProtocol
         {
             throw GameLogicError("Nickname cannot be emtpy");
         }
-        if (!players_[player_id].nickname.empty())
+        if (!player(player_id).nickname.empty())
         {
             throw GameLogicError("Player " + std::to_string(player_id) + " already registered");
         }
-        players_[player_id].nickname = data.nickname;
+        player(player_id).nickname = data.nickname;
     }
 
     bool GameLogic::are_both_registered() const
     {
-        return !players_.at(1).nickname.empty() && !players_.at(2).nickname.empty();
+        return !players_[0].nickname.empty() && !players_[1].nickname.empty();
     }
 
     bool GameLogic::are_both_ships_placed() const
     {
-        return players_.at(1).ships.size() == 9 && players_.at(2).ships.size() == 9;
+        return players_[0].fleet_size == FLEET_SIZE && players_[1].fleet_size == FLEET_SIZE;
     }
 
     size_t GameLogic::ships_placed(int player_id) const
     {
-        return players_.at(player_id).ships.size();
+        return player(player_id).fleet_size;
     }
 
     // Mensaje del tipo REGISTER|<register-data>
@@ -68,7 +76,7 @@ namespace BattleShipProtocol
         {
             throw GameLogicError("Invalid player ID: " + std::to_string(player_id));
         }
-        if (players_[player_id].ships.size() == 9)
+        if (player(player_id).fleet_size == FLEET_SIZE)
         { // 1+1+2+2+3 según enunciado
             throw GameLogicError("Ships already placed for Player " + std::to_string(player_id));
         }
@@ -76,7 +84,7 @@ namespace BattleShipProtocol
         {
             throw GameLogicError("Both players must be registered before placing ships");
         }
-        validate_and_place_ships(players_[player_id], data.ships);
+        validate_and_place_ships(player(player_id), data.ships);
     }
 
     void GameLogic::process_shot(int player_id, const ShootData &shot)
@@ -98,16 +106,25 @@ namespace BattleShipProtocol
                 if (all_ships_sunk(target_id))
                 {
                     game_over_ = true;
-                    winner_ = players_[player_id].nickname;
+                    winner_ = player(player_id).nickname;
                 }
             }
             else
             {
-                throw GameLogicError("Coordenada ya atacada: " + shot.coordinate.letter + std::to_string(shot.coordinate.number));
+                throw GameLogicError("Coordenada ya atacada: " + shot.coordinate.to_string());
             }
         }
     }
 
+    void GameLogic::skip_turn()
+    {
+        if (game_over_)
+        {
+            throw GameLogicError("Game is already over");
+        }
+        current_turn_ = (current_turn_ == 1) ? 2 : 1;
+    }
+
     /*
     void GameLogic::surrender(int player_id) {
         if (player_id != 1 && player_id != 2) {
@@ -130,24 +147,81 @@ namespace BattleShipProtocol
         }
         StatusData status;
         status.turn = (current_turn_ == player_id) ? Turn::YOUR_TURN : Turn::OPPONENT_TURN;
-        //.begin devuelve un iterador apuntando al primer elemento del array board de player_
-        // Realiza copia del array map usando constructor de rango
-        status.boardOwn = std::vector<Cell>(players_.at(player_id).board.begin(), players_.at(player_id).board.end());
-        status.boardOpponent = std::vector<Cell>(players_.at(player_id == 1 ? 2 : 1).board.begin(), players_.at(player_id == 1 ? 2 : 1).board.end());
+        // Las celdas solo se materializan aquí, en la frontera con el protocolo.
+        status.boardOwn = board_cells(player(player_id));
+        status.boardOpponent = board_cells(player(player_id == 1 ? 2 : 1));
+        status.gameState = get_game_state();
+
+        return status;
+    }
+
+    void GameLogic::get_status(int player_id, StatusData &status) const
+    {
+        if (player_id != 1 && player_id != 2)
+        {
+            throw GameLogicError("Invalid player ID: " + std::to_string(player_id));
+        }
+        status.turn = (current_turn_ == player_id) ? Turn::YOUR_TURN : Turn::OPPONENT_TURN;
+        board_cells(player(player_id), status.boardOwn);
+        board_cells(player(player_id == 1 ? 2 : 1), status.boardOpponent);
+        status.gameState = get_game_state();
+    }
+
+    GameState GameLogic::get_game_state() const
+    {
         if (get_phase() == PhaseState::Phase::FINISHED)
         {
-            status.gameState = BattleShipProtocol::GameState::ENDED;
+            return BattleShipProtocol::GameState::ENDED;
         }
-        else if (are_both_registered() && are_both_ships_placed())
+        if (are_both_registered() && are_both_ships_placed())
         {
-            status.gameState = BattleShipProtocol::GameState::ONGOING;
+            return BattleShipProtocol::GameState::ONGOING;
         }
-        else
+        return BattleShipProtocol::GameState::WAITING;
+    }
+
+    CellState GameLogic::cell_state(int player_id, int index) const
+    {
+        if ((player_id != 1 && player_id != 2) || index < 0 || index >= BOARD_SIZE * BOARD_SIZE)
         {
-            status.gameState = BattleShipProtocol::GameState::WAITING;
+            throw GameLogicError("Invalid cell " + std::to_string(index) + " for player " + std::to_string(player_id));
         }
+        return state_at(players_[player_id - 1], static_cast<uint8_t>(index));
+    }
 
-        return status;
+    // Un disparo deja la celda en exactamente uno de hits o misses; sunk es subconjunto de hits.
+    CellState GameLogic::state_at(const Player &player, uint8_t index) noexcept
+    {
+        if (player.misses.test(index))
+        {
+            return CellState::MISS;
+        }
+        if (player.sunk.test(index))
+        {
+            return CellState::SUNK;
+        }
+        if (player.hits.test(index))
+        {
+            return CellState::HIT;
+        }
+        return player.ships.test(index) ? CellState::SHIP : CellState::WATER;
+    }
+
+    std::vector<Cell> GameLogic::board_cells(const Player &player)
+    {
+        std::vector<Cell> cells;
+        board_cells(player, cells);
+        return cells;
+    }
+
+    void GameLogic::board_cells(const Player &player, std::vector<Cell> &cells)
+    {
+        cells.clear();
+        cells.reserve(BOARD_SIZE * BOARD_SIZE);
+        for (uint8_t index = 0; index < BOARD_SIZE * BOARD_SIZE; ++index)
+        {
+            cells.push_back(Cell{Coordinate::from_index(index), state_at(player, index)});
+        }
     }
 
     bool GameLogic::is_game_over() const noexcept
@@ -166,29 +240,25 @@ namespace BattleShipProtocol
 
     std::string GameLogic::get_player_nickname(int player_id) const
     {
-        auto it = players_.find(player_id);
-        if (it == players_.end())
+        if (player_id != 1 && player_id != 2)
         {
             throw GameLogicError("Player ID not found");
         }
-        return it->second.nickname;
+        return players_[player_id - 1].nickname;
     }
 
     // coord_to_index(shot);
-    int GameLogic::coord_to_index(const Coordinate &coord) const
+    uint8_t GameLogic::coord_to_index(const Coordinate &coord) const
     {
-        // Resta de valores ASCII, row termina siendo una posicion basada en 0
-        int row = coord.letter[0] - 'A';
-        int col = coord.number - 1;
-        if (row < 0 || row >= BOARD_SIZE || col < 0 || col >= BOARD_SIZE)
+        if (!coord.on_board())
         {
             throw GameLogicError(
                 "Coordinate out of bounds: expected format <coord> ::= <letter><number>, "
                 "where <letter> ::= \"A\" to \"J\" and <number> ::= \"1\" to \"10\". "
                 "Received: \"" +
-                coord.letter + std::to_string(coord.number) + "\".");
+                coord.to_string() + "\".");
         }
-        return row * BOARD_SIZE + col;
+        return coord.index();
     }
 
     void GameLogic::validate_and_place_ships(Player &player, const std::vector<Ship> &ships)
@@ -226,70 +296,59 @@ namespace BattleShipProtocol
             }
         }
 
-        // Colocación sin superposición
-        std::array<bool, BOARD_SIZE * BOARD_SIZE> occupied{};
+        // Colocación sin superposición. Se valida todo antes de tocar el tablero del jugador.
+        Player placed;
         for (const auto &ship : ships)
         {
+            uint8_t id = placed.fleet_size++;
             for (const auto &coord : ship.coordinates)
             {
-                int idx = coord_to_index(coord);
-                if (occupied[idx])
+                uint8_t idx = coord_to_index(coord);
+                if (placed.ships.test(idx))
                 {
-                    throw GameLogicError("Ship overlap at " + coord.letter + std::to_string(coord.number));
+                    throw GameLogicError("Ship overlap at " + coord.to_string());
                 }
-                occupied[idx] = true;
-                player.board[idx] = Cell{coord, CellState::SHIP};
+                placed.ships.set(idx);
+                placed.fleet[id].set(idx);
+                placed.ship_at[idx] = id;
             }
+            placed.intact[id] = static_cast<uint8_t>(ship.coordinates.size());
         }
 
-        player.ships = ships;
+        player.ships = placed.ships;
+        player.fleet = placed.fleet;
+        player.intact = placed.intact;
+        player.ship_at = placed.ship_at;
+        player.fleet_size = placed.fleet_size;
     }
 
     bool GameLogic::update_board(int shooter_id, int target_id, const Coordinate &shot)
     {
         try
         {
-            int idx = coord_to_index(shot);
-            auto &target_board = players_[target_id].board;
+            uint8_t idx = coord_to_index(shot);
+            Player &target = player(target_id);
 
             // Verificar si la coordenada ya fue atacada
-            if (target_board[idx].cellState == CellState::HIT ||
-                target_board[idx].cellState == CellState::SUNK ||
-                target_board[idx].cellState == CellState::MISS)
+            if (target.hits.test(idx) || target.misses.test(idx))
             {
                 return false; // Disparo inválido, no se cambia de turno
             }
 
             // Coordenada válida, aplicar el disparo
-            if (target_board[idx].cellState == CellState::SHIP)
+            if (!target.ships.test(idx))
             {
-                target_board[idx].cellState = CellState::HIT;
-
-                // Verificar si se hundió un barco
-                for (auto &ship : players_[target_id].ships)
-                {
-                    bool all_hit = true;
-                    for (const auto &coord : ship.coordinates)
-                    {
-                        if (players_[target_id].board[coord_to_index(coord)].cellState != CellState::HIT)
-                        {
-                            all_hit = false;
-                            break;
-                        }
-                    }
-                    if (all_hit)
-                    {
-                        for (const auto &coord : ship.coordinates)
-                        {
-                            players_[target_id].board[coord_to_index(coord)].cellState = CellState::SUNK;
-                        }
-                        players_[target_id].ships_remaining--;
-                    }
-                }
+                target.misses.set(idx);
+                return true;
             }
-            else if (target_board[idx].cellState == CellState::WATER)
+            target.hits.set(idx);
+
+            // Cada celda de barco se impacta una sola vez, así que el contador llega a cero una única vez
+            uint8_t ship = target.ship_at[idx];
+            if (--target.intact[ship] == 0)
             {
-                target_board[idx].cellState = CellState::MISS;
+                target.sunk |= target.fleet[ship];
+                target.ships_remaining--;
             }
 
             return true; // Disparo válido, puede cambiar de turno
@@ -302,7 +361,7 @@ namespace BattleShipProtocol
     }
     bool GameLogic::all_ships_sunk(int player_id) const
     {
-        return players_.at(player_id).ships_remaining == 0;
+        return player(player_id).ships_remaining == 0;
     }
 
 } // namespace BattleShipProtocol
\ No newline at end of file
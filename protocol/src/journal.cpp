@@ -0,0 +1,164 @@
+#include "../include/journal.hpp"
+
+namespace BattleShipProtocol
+{
+    namespace
+    {
+        void put_varint(std::string &out, uint64_t value)
+        {
+            // LEB128: 7 bits por byte, el bit alto indica que sigue otro byte.
+            while (value >= 0x80)
+            {
+                out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+
+        uint8_t get_u8(std::string_view data, size_t &pos)
+        {
+            if (pos >= data.size())
+            {
+                throw ProtocolError("Truncated journal record");
+            }
+            return static_cast<uint8_t>(data[pos++]);
+        }
+
+        uint64_t get_varint(std::string_view data, size_t &pos)
+        {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                uint8_t byte = get_u8(data, pos);
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                {
+                    return value;
+                }
+            }
+            throw ProtocolError("Journal varint too long");
+        }
+
+        bool has_text(JournalEvent type)
+        {
+            return type == JournalEvent::PLAYER_JOINED || type == JournalEvent::REGISTERED ||
+                   type == JournalEvent::SHIPS_PLACED || type == JournalEvent::DISCONNECT;
+        }
+    }
+
+    void Journal::append(std::string &out, const JournalRecord &record)
+    {
+        if (static_cast<uint8_t>(record.type) > static_cast<uint8_t>(JournalEvent::GAME_OVER))
+        {
+            throw ProtocolError("Unknown journal event: " + std::to_string(static_cast<int>(record.type)));
+        }
+        out.push_back(static_cast<char>(record.type));
+        put_varint(out, record.session);
+        out.push_back(static_cast<char>(record.player));
+        put_varint(out, record.time_us);
+
+        switch (record.type)
+        {
+        case JournalEvent::PHASE:
+            out.push_back(static_cast<char>(record.value));
+            break;
+        case JournalEvent::SHOT:
+            out.push_back(static_cast<char>(record.target.packed));
+            out.push_back(static_cast<char>(record.result));
+            break;
+        case JournalEvent::STATUS:
+            out.push_back(static_cast<char>(record.value));
+            put_varint(out, record.time_remaining);
+            break;
+        default:
+            if (has_text(record.type))
+            {
+                put_varint(out, record.text.size());
+                out.append(record.text);
+            }
+            break;
+        }
+    }
+
+    std::string Journal::message_text(const Protocol &protocol, const Message &msg)
+    {
+        std::string frame;
+        protocol.build_binary_message(msg, frame);
+        frame.erase(0, Protocol::BINARY_HEADER_SIZE);
+        return frame;
+    }
+
+    bool JournalReader::next(JournalRecord &record)
+    {
+        if (pos_ >= data_.size())
+        {
+            return false;
+        }
+        // Se decodifica sobre una copia de la posición: un registro truncado no avanza el lector.
+        size_t pos = pos_;
+        uint8_t type = get_u8(data_, pos);
+        if (type > static_cast<uint8_t>(JournalEvent::GAME_OVER))
+        {
+            throw ProtocolError("Unknown journal event: " + std::to_string(type));
+        }
+
+        record = JournalRecord{};
+        record.type = static_cast<JournalEvent>(type);
+        uint64_t session = get_varint(data_, pos);
+        if (session > UINT32_MAX)
+        {
+            throw ProtocolError("Journal session ID out of range");
+        }
+        record.session = static_cast<uint32_t>(session);
+        record.player = get_u8(data_, pos);
+        record.time_us = get_varint(data_, pos);
+
+        switch (record.type)
+        {
+        case JournalEvent::PHASE:
+            record.value = get_u8(data_, pos);
+            if (record.value > static_cast<uint8_t>(PhaseState::Phase::FINISHED))
+            {
+                throw ProtocolError("Invalid journal phase: " + std::to_string(record.value));
+            }
+            break;
+        case JournalEvent::SHOT:
+        {
+            record.target.packed = get_u8(data_, pos);
+            uint8_t result = get_u8(data_, pos);
+            if (result > static_cast<uint8_t>(CellState::MISS))
+            {
+                throw ProtocolError("Invalid journal shot result: " + std::to_string(result));
+            }
+            record.result = static_cast<CellState>(result);
+            break;
+        }
+        case JournalEvent::STATUS:
+        {
+            record.value = get_u8(data_, pos);
+            uint64_t time_remaining = get_varint(data_, pos);
+            if (time_remaining > UINT32_MAX)
+            {
+                throw ProtocolError("Journal turn time out of range");
+            }
+            record.time_remaining = static_cast<uint32_t>(time_remaining);
+            break;
+        }
+        default:
+            if (has_text(record.type))
+            {
+                uint64_t size = get_varint(data_, pos);
+                if (size > data_.size() - pos)
+                {
+                    throw ProtocolError("Truncated journal record");
+                }
+                record.text.assign(data_.substr(pos, size));
+                pos += size;
+            }
+            break;
+        }
+        pos_ = pos;
+        return true;
+    }
+
+} // namespace BattleShipProtocol
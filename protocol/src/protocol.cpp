@@ -3,9 +3,37 @@
 #include <charconv> // Necesario para std::from_chars
 #include <iostream>
 #include <stdexcept>
+#include <iterator>
 
 namespace BattleShipProtocol
 {
+    namespace
+    {
+        // Nombres del protocolo de texto, indexados por el valor del enum.
+        constexpr std::string_view MESSAGE_TYPE_NAMES[] = {"REGISTER", "PLACE_SHIPS", "SHOOT", "STATUS", "SURRENDER", "GAME_OVER",
+                                                           "ERROR", "PLAYER_ID", "HELLO", "STATUS_DELTA", "RESYNC"};
+        constexpr std::string_view SHIP_TYPE_NAMES[] = {"PORTAAVIONES", "BUQUE", "CRUCERO", "DESTRUCTOR", "SUBMARINO"};
+        constexpr std::string_view TURN_NAMES[] = {"YOUR_TURN", "OPPONENT_TURN"};
+        constexpr std::string_view CELL_STATE_NAMES[] = {"WATER", "HIT", "SUNK", "SHIP", "MISS"};
+        constexpr std::string_view GAME_STATE_NAMES[] = {"ONGOING", "WAITING", "ENDED"};
+
+        static_assert(static_cast<size_t>(MessageType::RESYNC) + 1 == std::size(MESSAGE_TYPE_NAMES));
+        static_assert(static_cast<size_t>(ShipType::SUBMARINO) + 1 == std::size(SHIP_TYPE_NAMES));
+        static_assert(static_cast<size_t>(Turn::OPPONENT_TURN) + 1 == std::size(TURN_NAMES));
+        static_assert(static_cast<size_t>(CellState::MISS) + 1 == std::size(CELL_STATE_NAMES));
+        static_assert(static_cast<size_t>(GameState::ENDED) + 1 == std::size(GAME_STATE_NAMES));
+
+        template <size_t N>
+        std::string_view table_name(const std::string_view (&names)[N], size_t index, const char *type)
+        {
+            if (index >= N)
+            {
+                throw ProtocolError(std::string("Unknown ") + type + " value encountered");
+            }
+            return names[index];
+        }
+    }
+
     Message Protocol::parse_message(std::string_view raw_message) const
     {
 
@@ -53,6 +81,15 @@ namespace BattleShipProtocol
         case MessageType::ERROR:
             msg.data = parse_error_data(type_data);
             break;
+        case MessageType::HELLO:
+            msg.data = parse_hello_data(type_data);
+            break;
+        case MessageType::STATUS_DELTA:
+            msg.data = parse_status_delta_data(type_data);
+            break;
+        case MessageType::RESYNC:
+            msg.data = std::monostate{};
+            break;
         default:
             break;
         }
@@ -77,6 +114,12 @@ namespace BattleShipProtocol
             return MessageType::GAME_OVER;
         if (type_str == "ERROR")
             return MessageType::ERROR;
+        if (type_str == "HELLO")
+            return MessageType::HELLO;
+        if (type_str == "STATUS_DELTA")
+            return MessageType::STATUS_DELTA;
+        if (type_str == "RESYNC")
+            return MessageType::RESYNC;
         throw ProtocolError("Invalid type:" + std::string(type_str));
     }
 
@@ -260,30 +303,26 @@ namespace BattleShipProtocol
         return coordinates;
     }
 
-    std::string Protocol::coordinates_to_string(const std::vector<Coordinate> &coordinates) const
+    void Protocol::append_coordinates(std::string &out, const std::vector<Coordinate> &coordinates) const
     {
         if (coordinates.empty())
         {
             throw ProtocolError("Cannot serialize an empty list of coordinates");
         }
 
-        std::ostringstream oss;
-
         for (size_t i = 0; i < coordinates.size(); ++i)
         {
             const auto &coord = coordinates[i];
-            if (coord.letter.empty() || coord.number <= 0)
+            if (coord.number() <= 0)
             {
                 throw ProtocolError("Invalid coordinate found while converting to string");
             }
-            oss << coord.letter << coord.number;
-            if (i != coordinates.size() - 1)
+            if (i != 0)
             {
-                oss << ",";
+                out += ',';
             }
+            append_coordinate(out, coord);
         }
-
-        return oss.str();
     }
 
     Coordinate Protocol::string_to_coordinate(std::string_view coor) const
@@ -292,7 +331,6 @@ namespace BattleShipProtocol
         {
             throw ProtocolError("Invalid coordinate format. Expected format: <Letter><Number>");
         }
-        Coordinate coordinate;
         char letter = coor.front();
         int number;
 
@@ -326,15 +364,18 @@ namespace BattleShipProtocol
         std::errc::result_out_of_range: El número es demasiado grande para int.
 
         */
-        auto [ptr, ec] = std::from_chars(coor.substr(1, coor.length() - 1).data(), coor.substr(1, coor.length() - 1).data() + coor.substr(1, coor.length() - 1).size(), number);
+        auto [ptr, ec] = std::from_chars(coor.data() + 1, coor.data() + coor.size(), number);
         if (ec != std::errc())
         {
             throw ProtocolError("Invalid number: " + std::string(coor));
         }
+        // La coordenada se empaqueta en un byte: fila 'A'-'P' y columna 0-15
+        if (letter < 'A' || letter > 'P' || number < 0 || number > 15)
+        {
+            throw ProtocolError("Coordinate out of range: " + std::string(coor));
+        }
 
-        coordinate.letter = letter;
-        coordinate.number = number;
-        return coordinate;
+        return Coordinate(letter, number);
     }
 
     ShootData Protocol::parse_shoot_data(std::string_view data) const
@@ -558,110 +599,106 @@ namespace BattleShipProtocol
         return error_data;
     }
 
-    std::string Protocol::message_type_to_string(MessageType type) const
+    HelloData Protocol::parse_hello_data(std::string_view data) const
     {
-        switch (type)
+        // Eliminar el '\n'
+        if (!data.empty() && data.back() == '\n')
         {
-        case MessageType::PLAYER_ID:
-            return "PLAYER_ID";
-        case MessageType::REGISTER:
-            return "REGISTER";
-        case MessageType::PLACE_SHIPS:
-            return "PLACE_SHIPS";
-        case MessageType::SHOOT:
-            return "SHOOT";
-        case MessageType::STATUS:
-            return "STATUS";
-        case MessageType::SURRENDER:
-            return "SURRENDER";
-        case MessageType::GAME_OVER:
-            return "GAME_OVER";
-        case MessageType::ERROR:
-            return "ERROR";
-        default:
-            throw ProtocolError("Unknown MessageType value encountered");
+            data.remove_suffix(1);
+        }
+        else
+        {
+            throw ProtocolError("Invalid message format: missing end delimiter");
         }
-    }
 
-    std::string Protocol::ship_type_to_string(ShipType type) const
-    {
-        switch (type)
+        HelloData hello{};
+        auto delim = data.find(',');
+        std::string_view version_str = data.substr(0, delim);
+        auto [ptr, ec] = std::from_chars(version_str.data(), version_str.data() + version_str.size(), hello.version);
+        if (ec != std::errc() || ptr != version_str.data() + version_str.size())
         {
-        case ShipType::PORTAAVIONES:
-            return "PORTAAVIONES";
-        case ShipType::BUQUE:
-            return "BUQUE";
-        case ShipType::CRUCERO:
-            return "CRUCERO";
-        case ShipType::DESTRUCTOR:
-            return "DESTRUCTOR";
-        case ShipType::SUBMARINO:
-            return "SUBMARINO";
-        default:
-            throw ProtocolError("Unknown ShipType value encountered");
+            throw ProtocolError("Invalid protocol version: " + std::string(version_str));
+        }
+        if (delim != std::string_view::npos)
+        {
+            if (data.substr(delim + 1) != "DELTA")
+            {
+                throw ProtocolError("Invalid HELLO option: " + std::string(data.substr(delim + 1)));
+            }
+            hello.deltas = true;
         }
+        return hello;
     }
 
-    std::string Protocol::turn_to_string(Turn turn) const
+    StatusDeltaData Protocol::parse_status_delta_data(std::string_view data) const
     {
-        switch (turn)
+        if (!data.empty() && data.back() == '\n')
         {
-        case Turn::YOUR_TURN:
-            return "YOUR_TURN";
-        case Turn::OPPONENT_TURN:
-            return "OPPONENT_TURN";
-        default:
-            throw ProtocolError("Unknown Turn value encountered");
+            data.remove_suffix(1);
+        }
+        else
+        {
+            throw ProtocolError("Invalid message format: missing end delimiter");
         }
-    }
 
-    std::string Protocol::cell_state_to_string(CellState state) const
-    {
-        switch (state)
+        // Mismo orden que STATUS, precedido por el número de secuencia.
+        StatusDeltaData delta{};
+        size_t end = data.find(';');
+        if (end == std::string_view::npos)
+            throw ProtocolError("Missing seq delimiter in STATUS_DELTA data");
+        std::string_view seq_str = data.substr(0, end);
+        auto [ptr, ec] = std::from_chars(seq_str.data(), seq_str.data() + seq_str.size(), delta.seq);
+        if (ec != std::errc() || ptr != seq_str.data() + seq_str.size())
         {
-        case CellState::WATER:
-            return "WATER";
-        case CellState::HIT:
-            return "HIT";
-        case CellState::SUNK:
-            return "SUNK";
-        case CellState::SHIP:
-            return "SHIP";
-        case CellState::MISS:
-            return "MISS";
-        default:
-            throw ProtocolError("Unknown CellState value encountered");
+            throw ProtocolError("Invalid seq in STATUS_DELTA data: " + std::string(seq_str));
         }
+
+        StatusData status = parse_status_data(std::string(data.substr(end + 1)) + "\n");
+        delta.turn = status.turn;
+        delta.ownChanges = std::move(status.boardOwn);
+        delta.opponentChanges = std::move(status.boardOpponent);
+        delta.gameState = status.gameState;
+        delta.time_remaining = status.time_remaining;
+        return delta;
     }
 
-    std::string Protocol::game_state_to_string(GameState state) const
+    std::string_view Protocol::message_type_to_string(MessageType type) const
     {
-        switch (state)
-        {
-        case GameState::ONGOING:
-            return "ONGOING";
-        case GameState::WAITING:
-            return "WAITING";
-        case GameState::ENDED:
-            return "ENDED";
-        default:
-            throw ProtocolError("Unknown GameState value encountered");
-        }
+        return table_name(MESSAGE_TYPE_NAMES, static_cast<size_t>(type), "MessageType");
     }
 
-    /*
-    std::ostringstream oss;
+    std::string_view Protocol::ship_type_to_string(ShipType type) const
+    {
+        return table_name(SHIP_TYPE_NAMES, static_cast<size_t>(type), "ShipType");
+    }
 
-    std::ostringstream es un stream de salida para construir cadenas eficientemente.
+    std::string_view Protocol::turn_to_string(Turn turn) const
+    {
+        return table_name(TURN_NAMES, static_cast<size_t>(turn), "Turn");
+    }
 
-    Actúa como un buffer en memoria, evitando concatenaciones costosas con std::string.
+    std::string_view Protocol::cell_state_to_string(CellState state) const
+    {
+        return table_name(CELL_STATE_NAMES, static_cast<size_t>(state), "CellState");
+    }
+
+    std::string_view Protocol::game_state_to_string(GameState state) const
+    {
+        return table_name(GAME_STATE_NAMES, static_cast<size_t>(state), "GameState");
+    }
+
+    /*
+    build_message(msg, out) escribe el mensaje directamente al final de out.
 
     case MessageType::PLACE_SHIPS: {
-    oss << "PLACE_SHIPS|";
+    out += "PLACE_SHIPS|";
 
     Detecta del tipo del mensaje, por lo que debe formatearse con la estructura segun BNF
 
-    Se escribe el prefijo "PLACE_SHIPS|" en el ostringstream, que será la cabecera del mensaje.
+    Se escribe el prefijo "PLACE_SHIPS|" en el buffer, que será la cabecera del mensaje.
+    Los enums salen de tablas constexpr de std::string_view y los números de std::to_chars:
+    ninguno crea un std::string temporal, así que un buffer reutilizado no reserva memoria
+    una vez que tiene la capacidad del mensaje más largo.
 
     std::get<PlaceShipsData>(msg.data):
     Extrae el valor almacenado en msg.data suponiendo que es de tipo PlaceShipsData.
@@ -679,89 +716,167 @@ namespace BattleShipProtocol
 
     std::string Protocol::build_message(const Message &msg) const
     {
-        std::ostringstream oss;
+        std::string out;
+        build_message(msg, out);
+        return out;
+    }
+
+    void Protocol::build_message(const Message &msg, std::string &out) const
+    {
+        size_t start = out.size();
+        try
+        {
+            encode_text(msg, out);
+        }
+        catch (...)
+        {
+            // Un mensaje a medias corrompería lo que el llamador ya tenía en el buffer.
+            out.resize(start);
+            throw;
+        }
+    }
+
+    void Protocol::encode_text(const Message &msg, std::string &out) const
+    {
         switch (msg.type)
         {
         case MessageType::PLAYER_ID:
         {
-            oss << "PLAYER_ID|";
+            out += "PLAYER_ID|";
             const auto &data = std::get<PlayerIdData>(msg.data);
-            oss << data.player_id;
+            append_int(out, data.player_id);
             break;
         }
         case MessageType::REGISTER:
         {
-            oss << "REGISTER|";
+            out += "REGISTER|";
             const auto &data = std::get<RegisterData>(msg.data);
-            oss << data.nickname << "," << data.email;
+            out += data.nickname;
+            out += ',';
+            out += data.email;
             break;
         }
         case MessageType::PLACE_SHIPS:
         {
-            oss << "PLACE_SHIPS|";
+            out += "PLACE_SHIPS|";
             const auto &data = std::get<PlaceShipsData>(msg.data);
             for (size_t i = 0; i < data.ships.size(); ++i)
             {
-                oss << ship_type_to_string(data.ships[i].type) << ":" << coordinates_to_string(data.ships[i].coordinates);
+                out += ship_type_to_string(data.ships[i].type);
+                out += ':';
+                append_coordinates(out, data.ships[i].coordinates);
                 if (i < data.ships.size() - 1)
                 {
-                    oss << ";";
+                    out += ';';
                 }
             }
             break;
         }
         case MessageType::SHOOT:
         {
-            oss << "SHOOT|";
+            out += "SHOOT|";
             const auto &data = std::get<ShootData>(msg.data);
-            oss << data.coordinate.letter << data.coordinate.number;
+            append_coordinate(out, data.coordinate);
             break;
         }
         case MessageType::STATUS:
         {
-            oss << "STATUS|";
+            out += "STATUS|";
             const auto &data = std::get<StatusData>(msg.data);
-            oss << turn_to_string(data.turn) << ";";
-            for (size_t i = 0; i < data.boardOwn.size(); i++)
-            {
-                oss << data.boardOwn[i].coordinate.letter << data.boardOwn[i].coordinate.number << ":" << cell_state_to_string(data.boardOwn[i].cellState);
-                if (i < data.boardOwn.size() - 1)
-                    oss << ",";
-            }
-            oss << ";";
-            for (size_t i = 0; i < data.boardOpponent.size(); i++)
-            {
-                oss << data.boardOpponent[i].coordinate.letter << data.boardOpponent[i].coordinate.number << ":" << cell_state_to_string(data.boardOpponent[i].cellState);
-                if (i < data.boardOpponent.size() - 1)
-                    oss << ",";
-            }
-            oss << ";";
-            oss << game_state_to_string(data.gameState);
-            oss << ";";
-            oss << data.time_remaining;
+            out += turn_to_string(data.turn);
+            out += ';';
+            append_cells(out, data.boardOwn);
+            out += ';';
+            append_cells(out, data.boardOpponent);
+            out += ';';
+            out += game_state_to_string(data.gameState);
+            out += ';';
+            append_int(out, data.time_remaining);
             break;
         }
         case MessageType::SURRENDER:
         {
-            oss << "SURRENDER|";
+            out += "SURRENDER|";
             break;
         }
         case MessageType::GAME_OVER:
         {
-            oss << "GAME_OVER|";
+            out += "GAME_OVER|";
             const auto &data = std::get<GameOverData>(msg.data);
-            oss << data.winner;
+            out += data.winner;
             break;
         }
         case MessageType::ERROR:
         {
-            oss << "ERROR|";
+            out += "ERROR|";
             const auto &data = std::get<ErrorData>(msg.data);
-            oss << data.code << ',' << data.description;
+            append_int(out, data.code);
+            out += ',';
+            out += data.description;
             break;
         }
+        case MessageType::HELLO:
+        {
+            out += "HELLO|";
+            const auto &data = std::get<HelloData>(msg.data);
+            append_int(out, data.version);
+            if (data.deltas)
+            {
+                out += ",DELTA";
+            }
+            break;
+        }
+        case MessageType::STATUS_DELTA:
+        {
+            out += "STATUS_DELTA|";
+            const auto &data = std::get<StatusDeltaData>(msg.data);
+            append_int(out, data.seq);
+            out += ';';
+            out += turn_to_string(data.turn);
+            out += ';';
+            append_cells(out, data.ownChanges);
+            out += ';';
+            append_cells(out, data.opponentChanges);
+            out += ';';
+            out += game_state_to_string(data.gameState);
+            out += ';';
+            append_int(out, data.time_remaining);
+            break;
         }
-        oss << "\n";
-        return oss.str();
+        case MessageType::RESYNC:
+        {
+            out += "RESYNC|";
+            break;
+        }
+        }
+        out += '\n';
     }
-}
\ No newline at end of file
+
+    void Protocol::append_int(std::string &out, int64_t value) const
+    {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, result.ptr);
+    }
+
+    void Protocol::append_coordinate(std::string &out, const Coordinate &coordinate) const
+    {
+        out += coordinate.letter();
+        append_int(out, coordinate.number());
+    }
+
+    void Protocol::append_cells(std::string &out, const std::vector<Cell> &cells) const
+    {
+        for (size_t i = 0; i < cells.size(); i++)
+        {
+            if (i != 0)
+            {
+                out += ',';
+            }
+            append_coordinate(out, cells[i].coordinate);
+            out += ':';
+            out += cell_state_to_string(cells[i].cellState);
+        }
+    }
+
+} // namespace BattleShipProtocol
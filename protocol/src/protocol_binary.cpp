@@ -0,0 +1,558 @@
+#include "../include/protocol.hpp"
+#include <algorithm>
+
+namespace BattleShipProtocol
+{
+    namespace
+    {
+        constexpr size_t BOARD_CELLS = 100;     ///< Cells of a full board (A1..J10).
+        constexpr size_t MAX_FRAME = 0xFFFF;    ///< Largest length the prefix can carry.
+
+        /**
+         * @brief Board layouts of the binary format.
+         */
+        enum BoardFormat : uint8_t
+        {
+            BOARD_EMPTY = 0,  ///< No cells.
+            BOARD_2BIT = 1,   ///< 100 cells in board order, 2 bits each (no SHIP cells).
+            BOARD_NIBBLE = 2, ///< 100 cells in board order, 4 bits each.
+            BOARD_SPARSE = 3  ///< Count followed by (index, state) pairs.
+        };
+
+        constexpr uint8_t HELLO_DELTAS = 0x1;   ///< HELLO flag requesting STATUS_DELTA.
+
+        // Estados representables con 2 bits: un tablero sin barcos visibles.
+        constexpr CellState TWO_BIT_STATES[4] = {CellState::WATER, CellState::HIT, CellState::SUNK, CellState::MISS};
+
+        uint8_t message_type_to_byte(MessageType type)
+        {
+            switch (type)
+            {
+            case MessageType::PLAYER_ID:
+                return 1;
+            case MessageType::REGISTER:
+                return 2;
+            case MessageType::PLACE_SHIPS:
+                return 3;
+            case MessageType::SHOOT:
+                return 4;
+            case MessageType::STATUS:
+                return 5;
+            case MessageType::SURRENDER:
+                return 6;
+            case MessageType::GAME_OVER:
+                return 7;
+            case MessageType::ERROR:
+                return 8;
+            case MessageType::HELLO:
+                return 9;
+            case MessageType::STATUS_DELTA:
+                return 10;
+            case MessageType::RESYNC:
+                return 11;
+            }
+            throw ProtocolError("Unknown MessageType value encountered");
+        }
+
+        MessageType byte_to_message_type(uint8_t code)
+        {
+            switch (code)
+            {
+            case 1:
+                return MessageType::PLAYER_ID;
+            case 2:
+                return MessageType::REGISTER;
+            case 3:
+                return MessageType::PLACE_SHIPS;
+            case 4:
+                return MessageType::SHOOT;
+            case 5:
+                return MessageType::STATUS;
+            case 6:
+                return MessageType::SURRENDER;
+            case 7:
+                return MessageType::GAME_OVER;
+            case 8:
+                return MessageType::ERROR;
+            case 9:
+                return MessageType::HELLO;
+            case 10:
+                return MessageType::STATUS_DELTA;
+            case 11:
+                return MessageType::RESYNC;
+            }
+            throw ProtocolError("Invalid binary message type: " + std::to_string(code));
+        }
+
+        void put_u8(std::string &out, unsigned value)
+        {
+            out.push_back(static_cast<char>(value & 0xFF));
+        }
+
+        void put_u16(std::string &out, unsigned value)
+        {
+            put_u8(out, value >> 8);
+            put_u8(out, value);
+        }
+
+        void put_string(std::string &out, const std::string &value, const char *field)
+        {
+            if (value.size() > 0xFF)
+            {
+                throw ProtocolError(std::string(field) + " exceeds 255 bytes");
+            }
+            put_u8(out, static_cast<unsigned>(value.size()));
+            out.append(value);
+        }
+
+        uint8_t get_u8(std::string_view data, size_t &pos)
+        {
+            if (pos >= data.size())
+            {
+                throw ProtocolError("Truncated binary message");
+            }
+            return static_cast<uint8_t>(data[pos++]);
+        }
+
+        uint16_t get_u16(std::string_view data, size_t &pos)
+        {
+            uint16_t high = get_u8(data, pos);
+            return static_cast<uint16_t>((high << 8) | get_u8(data, pos));
+        }
+
+        std::string get_string(std::string_view data, size_t &pos)
+        {
+            size_t size = get_u8(data, pos);
+            if (data.size() - pos < size)
+            {
+                throw ProtocolError("Truncated binary message");
+            }
+            std::string value(data.substr(pos, size));
+            pos += size;
+            return value;
+        }
+
+        CellState byte_to_cell_state(unsigned value)
+        {
+            if (value > static_cast<unsigned>(CellState::MISS))
+            {
+                throw ProtocolError("Invalid cell state: " + std::to_string(value));
+            }
+            return static_cast<CellState>(value);
+        }
+    }
+
+    uint8_t Protocol::coordinate_to_index(const Coordinate &coordinate) const
+    {
+        if (!coordinate.on_board())
+        {
+            throw ProtocolError("Coordinate outside the board: " + coordinate.to_string());
+        }
+        return coordinate.index();
+    }
+
+    Coordinate Protocol::index_to_coordinate(uint8_t index) const
+    {
+        if (index >= BOARD_CELLS)
+        {
+            throw ProtocolError("Invalid cell index: " + std::to_string(index));
+        }
+        return Coordinate::from_index(index);
+    }
+
+    void Protocol::encode_board(std::string &out, const std::vector<Cell> &board) const
+    {
+        if (board.empty())
+        {
+            put_u8(out, BOARD_EMPTY);
+            return;
+        }
+
+        // Los formatos densos exigen el tablero completo en orden A1..J10, como lo produce GameLogic.
+        bool dense = board.size() == BOARD_CELLS;
+        bool has_ship = false;
+        for (size_t i = 0; i < board.size(); ++i)
+        {
+            uint8_t index = coordinate_to_index(board[i].coordinate);
+            dense = dense && index == i;
+            has_ship = has_ship || board[i].cellState == CellState::SHIP;
+        }
+
+        if (dense && !has_ship)
+        {
+            put_u8(out, BOARD_2BIT);
+            for (size_t i = 0; i < BOARD_CELLS; i += 4)
+            {
+                unsigned packed = 0;
+                for (size_t j = 0; j < 4; ++j)
+                {
+                    unsigned code = 0;
+                    while (TWO_BIT_STATES[code] != board[i + j].cellState)
+                        ++code;
+                    packed |= code << (6 - 2 * j);
+                }
+                put_u8(out, packed);
+            }
+        }
+        else if (dense)
+        {
+            put_u8(out, BOARD_NIBBLE);
+            for (size_t i = 0; i < BOARD_CELLS; i += 2)
+            {
+                put_u8(out, (static_cast<unsigned>(board[i].cellState) << 4) | static_cast<unsigned>(board[i + 1].cellState));
+            }
+        }
+        else
+        {
+            put_u8(out, BOARD_SPARSE);
+            encode_cells(out, board);
+        }
+    }
+
+    void Protocol::encode_cells(std::string &out, const std::vector<Cell> &cells) const
+    {
+        if (cells.size() > 0xFF)
+        {
+            throw ProtocolError("Cell list exceeds 255 cells");
+        }
+        put_u8(out, static_cast<unsigned>(cells.size()));
+        for (const auto &cell : cells)
+        {
+            put_u8(out, coordinate_to_index(cell.coordinate));
+            put_u8(out, static_cast<unsigned>(cell.cellState));
+        }
+    }
+
+    std::vector<Cell> Protocol::decode_cells(std::string_view data, size_t &pos) const
+    {
+        uint8_t count = get_u8(data, pos);
+        std::vector<Cell> cells;
+        cells.reserve(count);
+        for (uint8_t i = 0; i < count; ++i)
+        {
+            Coordinate coordinate = index_to_coordinate(get_u8(data, pos));
+            cells.push_back({coordinate, byte_to_cell_state(get_u8(data, pos))});
+        }
+        return cells;
+    }
+
+    std::vector<Cell> Protocol::decode_board(std::string_view data, size_t &pos) const
+    {
+        std::vector<Cell> board;
+        uint8_t format = get_u8(data, pos);
+        switch (format)
+        {
+        case BOARD_EMPTY:
+            break;
+        case BOARD_2BIT:
+            board.reserve(BOARD_CELLS);
+            for (size_t i = 0; i < BOARD_CELLS; i += 4)
+            {
+                uint8_t packed = get_u8(data, pos);
+                for (size_t j = 0; j < 4; ++j)
+                {
+                    board.push_back({index_to_coordinate(static_cast<uint8_t>(i + j)), TWO_BIT_STATES[(packed >> (6 - 2 * j)) & 0x3]});
+                }
+            }
+            break;
+        case BOARD_NIBBLE:
+            board.reserve(BOARD_CELLS);
+            for (size_t i = 0; i < BOARD_CELLS; i += 2)
+            {
+                uint8_t packed = get_u8(data, pos);
+                board.push_back({index_to_coordinate(static_cast<uint8_t>(i)), byte_to_cell_state(packed >> 4)});
+                board.push_back({index_to_coordinate(static_cast<uint8_t>(i + 1)), byte_to_cell_state(packed & 0xF)});
+            }
+            break;
+        case BOARD_SPARSE:
+            board = decode_cells(data, pos);
+            break;
+        default:
+            throw ProtocolError("Invalid board format: " + std::to_string(format));
+        }
+        return board;
+    }
+
+    std::string Protocol::build_binary_message(const Message &msg) const
+    {
+        std::string out;
+        build_binary_message(msg, out);
+        return out;
+    }
+
+    void Protocol::build_binary_message(const Message &msg, std::string &out) const
+    {
+        size_t start = out.size();
+        try
+        {
+            encode_binary_frame(msg, out);
+        }
+        catch (...)
+        {
+            // Un frame a medias corrompería lo que el llamador ya tenía en el buffer.
+            out.resize(start);
+            throw;
+        }
+    }
+
+    void Protocol::encode_binary_frame(const Message &msg, std::string &out) const
+    {
+        // El prefijo de longitud se rellena al final, cuando se conoce el tamaño.
+        size_t start = out.size();
+        out.append(BINARY_HEADER_SIZE, '\0');
+        put_u8(out, message_type_to_byte(msg.type));
+
+        switch (msg.type)
+        {
+        case MessageType::PLAYER_ID:
+        {
+            const auto &data = std::get<PlayerIdData>(msg.data);
+            if (data.player_id < 0 || data.player_id > 0xFF)
+            {
+                throw ProtocolError("Player ID out of range: " + std::to_string(data.player_id));
+            }
+            put_u8(out, static_cast<unsigned>(data.player_id));
+            break;
+        }
+        case MessageType::REGISTER:
+        {
+            const auto &data = std::get<RegisterData>(msg.data);
+            put_string(out, data.nickname, "Nickname");
+            put_string(out, data.email, "Email");
+            break;
+        }
+        case MessageType::PLACE_SHIPS:
+        {
+            const auto &data = std::get<PlaceShipsData>(msg.data);
+            if (data.ships.size() > 0xFF)
+            {
+                throw ProtocolError("Too many ships in PLACE_SHIPS");
+            }
+            put_u8(out, static_cast<unsigned>(data.ships.size()));
+            for (const auto &ship : data.ships)
+            {
+                if (ship.coordinates.size() > 0xFF)
+                {
+                    throw ProtocolError("Too many coordinates for one ship");
+                }
+                put_u8(out, static_cast<unsigned>(ship.type));
+                put_u8(out, static_cast<unsigned>(ship.coordinates.size()));
+                for (const auto &coordinate : ship.coordinates)
+                {
+                    put_u8(out, coordinate_to_index(coordinate));
+                }
+            }
+            break;
+        }
+        case MessageType::SHOOT:
+        {
+            const auto &data = std::get<ShootData>(msg.data);
+            put_u8(out, coordinate_to_index(data.coordinate));
+            break;
+        }
+        case MessageType::STATUS:
+        {
+            const auto &data = std::get<StatusData>(msg.data);
+            put_u8(out, static_cast<unsigned>(data.turn) | (static_cast<unsigned>(data.gameState) << 1));
+            put_u16(out, static_cast<unsigned>(std::min(std::max(data.time_remaining, 0), 0xFFFF)));
+            encode_board(out, data.boardOwn);
+            encode_board(out, data.boardOpponent);
+            break;
+        }
+        case MessageType::SURRENDER:
+            break;
+        case MessageType::GAME_OVER:
+        {
+            const auto &data = std::get<GameOverData>(msg.data);
+            put_string(out, data.winner, "Winner");
+            break;
+        }
+        case MessageType::ERROR:
+        {
+            const auto &data = std::get<ErrorData>(msg.data);
+            if (data.code < 0 || data.code > 0xFFFF)
+            {
+                throw ProtocolError("Error code out of range: " + std::to_string(data.code));
+            }
+            put_u16(out, static_cast<unsigned>(data.code));
+            put_string(out, data.description, "Description");
+            break;
+        }
+        case MessageType::HELLO:
+        {
+            const auto &data = std::get<HelloData>(msg.data);
+            put_u8(out, static_cast<unsigned>(data.version));
+            put_u8(out, data.deltas ? HELLO_DELTAS : 0);
+            break;
+        }
+        case MessageType::STATUS_DELTA:
+        {
+            const auto &data = std::get<StatusDeltaData>(msg.data);
+            put_u16(out, data.seq >> 16);
+            put_u16(out, data.seq & 0xFFFF);
+            put_u8(out, static_cast<unsigned>(data.turn) | (static_cast<unsigned>(data.gameState) << 1));
+            put_u16(out, static_cast<unsigned>(std::min(std::max(data.time_remaining, 0), 0xFFFF)));
+            encode_cells(out, data.ownChanges);
+            encode_cells(out, data.opponentChanges);
+            break;
+        }
+        case MessageType::RESYNC:
+            break;
+        }
+
+        size_t length = out.size() - start - BINARY_HEADER_SIZE;
+        if (length > MAX_FRAME)
+        {
+            throw ProtocolError("Binary message exceeds " + std::to_string(MAX_FRAME) + " bytes");
+        }
+        out[start] = static_cast<char>(length >> 8);
+        out[start + 1] = static_cast<char>(length & 0xFF);
+    }
+
+    Message Protocol::parse_binary_message(std::string_view frame) const
+    {
+        size_t pos = 0;
+        Message msg;
+        msg.type = byte_to_message_type(get_u8(frame, pos));
+
+        switch (msg.type)
+        {
+        case MessageType::PLAYER_ID:
+            msg.data = PlayerIdData{get_u8(frame, pos)};
+            break;
+        case MessageType::REGISTER:
+        {
+            RegisterData data;
+            data.nickname = get_string(frame, pos);
+            data.email = get_string(frame, pos);
+            if (data.nickname.empty())
+            {
+                throw ProtocolError("Nickname field cannot be empty");
+            }
+            if (data.email.empty())
+            {
+                throw ProtocolError("Email field cannot be empty");
+            }
+            msg.data = std::move(data);
+            break;
+        }
+        case MessageType::PLACE_SHIPS:
+        {
+            PlaceShipsData data;
+            uint8_t count = get_u8(frame, pos);
+            if (count == 0)
+            {
+                throw ProtocolError("No valid ships parsed from PLACE_SHIPS data");
+            }
+            data.ships.reserve(count);
+            for (uint8_t i = 0; i < count; ++i)
+            {
+                uint8_t type = get_u8(frame, pos);
+                if (type > static_cast<uint8_t>(ShipType::SUBMARINO))
+                {
+                    throw ProtocolError("Invalid ship type: " + std::to_string(type));
+                }
+                uint8_t size = get_u8(frame, pos);
+                if (size == 0)
+                {
+                    throw ProtocolError("No coordinates provided for ship");
+                }
+                Ship ship{static_cast<ShipType>(type), {}};
+                ship.coordinates.reserve(size);
+                for (uint8_t j = 0; j < size; ++j)
+                {
+                    ship.coordinates.push_back(index_to_coordinate(get_u8(frame, pos)));
+                }
+                data.ships.push_back(std::move(ship));
+            }
+            msg.data = std::move(data);
+            break;
+        }
+        case MessageType::SHOOT:
+            msg.data = ShootData{index_to_coordinate(get_u8(frame, pos))};
+            break;
+        case MessageType::STATUS:
+        {
+            StatusData data{};
+            uint8_t flags = get_u8(frame, pos);
+            unsigned game_state = (flags >> 1) & 0x3;
+            if ((flags & ~0x7) != 0 || game_state > static_cast<unsigned>(GameState::ENDED))
+            {
+                throw ProtocolError("Invalid STATUS flags: " + std::to_string(flags));
+            }
+            data.turn = static_cast<Turn>(flags & 0x1);
+            data.gameState = static_cast<GameState>(game_state);
+            data.time_remaining = get_u16(frame, pos);
+            data.boardOwn = decode_board(frame, pos);
+            data.boardOpponent = decode_board(frame, pos);
+            msg.data = std::move(data);
+            break;
+        }
+        case MessageType::SURRENDER:
+            msg.data = std::monostate{};
+            break;
+        case MessageType::GAME_OVER:
+        {
+            std::string winner = get_string(frame, pos);
+            if (winner.empty())
+            {
+                throw ProtocolError("Game over data cannot be empty");
+            }
+            msg.data = GameOverData{std::move(winner)};
+            break;
+        }
+        case MessageType::ERROR:
+        {
+            ErrorData data;
+            data.code = get_u16(frame, pos);
+            data.description = get_string(frame, pos);
+            if (data.description.empty())
+            {
+                throw ProtocolError("Description is empty");
+            }
+            msg.data = std::move(data);
+            break;
+        }
+        case MessageType::HELLO:
+        {
+            HelloData data{get_u8(frame, pos)};
+            uint8_t flags = get_u8(frame, pos);
+            if ((flags & ~HELLO_DELTAS) != 0)
+            {
+                throw ProtocolError("Invalid HELLO flags: " + std::to_string(flags));
+            }
+            data.deltas = (flags & HELLO_DELTAS) != 0;
+            msg.data = data;
+            break;
+        }
+        case MessageType::STATUS_DELTA:
+        {
+            StatusDeltaData data{};
+            uint32_t high = get_u16(frame, pos);
+            data.seq = (high << 16) | get_u16(frame, pos);
+            uint8_t flags = get_u8(frame, pos);
+            unsigned game_state = (flags >> 1) & 0x3;
+            if ((flags & ~0x7) != 0 || game_state > static_cast<unsigned>(GameState::ENDED))
+            {
+                throw ProtocolError("Invalid STATUS_DELTA flags: " + std::to_string(flags));
+            }
+            data.turn = static_cast<Turn>(flags & 0x1);
+            data.gameState = static_cast<GameState>(game_state);
+            data.time_remaining = get_u16(frame, pos);
+            data.ownChanges = decode_cells(frame, pos);
+            data.opponentChanges = decode_cells(frame, pos);
+            msg.data = std::move(data);
+            break;
+        }
+        case MessageType::RESYNC:
+            msg.data = std::monostate{};
+            break;
+        }
+
+        if (pos != frame.size())
+        {
+            throw ProtocolError("Unexpected trailing bytes in binary message");
+        }
+        return msg;
+    }
+}
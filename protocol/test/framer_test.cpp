@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include "../include/framer.hpp"
+#include <cstring>
+#include <string>
+
+namespace BattleShipProtocol
+{
+    class FramerTest : public ::testing::Test
+    {
+    protected:
+        Framer framer{64};
+
+        void feed(const std::string &data)
+        {
+            ASSERT_EQ(framer.append(data.data(), data.size()), data.size());
+        }
+    };
+
+    TEST_F(FramerTest, EmptyBufferYieldsNothing)
+    {
+        EXPECT_FALSE(framer.next().has_value());
+        EXPECT_EQ(framer.buffered(), 0u);
+        EXPECT_FALSE(framer.overflowed());
+    }
+
+    TEST_F(FramerTest, PipelinedFramesInOneAppend)
+    {
+        feed("REGISTER|a,b\nSHOOT|1,A,1\nSHOOT|1,B,2\n");
+
+        auto first = framer.next();
+        ASSERT_TRUE(first.has_value());
+        EXPECT_EQ(*first, "REGISTER|a,b\n");
+
+        auto second = framer.next();
+        ASSERT_TRUE(second.has_value());
+        EXPECT_EQ(*second, "SHOOT|1,A,1\n");
+
+        auto third = framer.next();
+        ASSERT_TRUE(third.has_value());
+        EXPECT_EQ(*third, "SHOOT|1,B,2\n");
+
+        EXPECT_FALSE(framer.next().has_value());
+        EXPECT_EQ(framer.buffered(), 0u);
+    }
+
+    TEST_F(FramerTest, PartialFrameIsKeptAcrossCalls)
+    {
+        feed("SHOOT|1,");
+        EXPECT_FALSE(framer.next().has_value());
+        EXPECT_EQ(framer.buffered(), 8u);
+
+        feed("C,3\nSURR");
+        auto frame = framer.next();
+        ASSERT_TRUE(frame.has_value());
+        EXPECT_EQ(*frame, "SHOOT|1,C,3\n");
+        EXPECT_FALSE(framer.next().has_value());
+
+        feed("ENDER|1\n");
+        frame = framer.next();
+        ASSERT_TRUE(frame.has_value());
+        EXPECT_EQ(*frame, "SURRENDER|1\n");
+    }
+
+    TEST_F(FramerTest, CompactsWhenTheTailReachesTheEnd)
+    {
+        // 40 bytes de frames completos más un frame parcial, luego un append que no cabe al final.
+        feed(std::string(39, 'x') + "\n" + "PART");
+        ASSERT_TRUE(framer.next().has_value());
+        EXPECT_FALSE(framer.next().has_value());
+
+        std::string rest = std::string(40, 'y') + "\n";
+        feed(rest);
+        auto frame = framer.next();
+        ASSERT_TRUE(frame.has_value());
+        EXPECT_EQ(*frame, "PART" + rest);
+    }
+
+    TEST_F(FramerTest, WriteAreaAndCommitReceiveInPlace)
+    {
+        auto [area, space] = framer.write_area();
+        ASSERT_EQ(space, 64u);
+        const char data[] = "LOGIN|x\nLOG";
+        std::memcpy(area, data, sizeof(data) - 1);
+        framer.commit(sizeof(data) - 1);
+
+        auto frame = framer.next();
+        ASSERT_TRUE(frame.has_value());
+        EXPECT_EQ(*frame, "LOGIN|x\n");
+        EXPECT_FALSE(framer.next().has_value());
+        EXPECT_EQ(framer.buffered(), 3u);
+    }
+
+    TEST_F(FramerTest, EmptyBufferRewindsToTheStart)
+    {
+        feed(std::string(60, 'z') + "\n");
+        ASSERT_TRUE(framer.next().has_value());
+        EXPECT_FALSE(framer.next().has_value());
+
+        auto [area, space] = framer.write_area();
+        (void)area;
+        EXPECT_EQ(space, 64u);
+    }
+
+    TEST_F(FramerTest, FrameLongerThanCapacityOverflows)
+    {
+        std::string huge(100, 'a');
+        EXPECT_EQ(framer.append(huge.data(), huge.size()), 64u);
+        EXPECT_FALSE(framer.next().has_value());
+        EXPECT_TRUE(framer.overflowed());
+
+        framer.clear();
+        EXPECT_FALSE(framer.overflowed());
+        EXPECT_EQ(framer.buffered(), 0u);
+    }
+
+    TEST_F(FramerTest, LengthPrefixedFramesExcludeThePrefix)
+    {
+        framer.set_mode(Framer::Mode::LENGTH_PREFIXED);
+        feed(std::string("\x00\x03" "abc" "\x00\x02" "de" "\x00", 10));
+
+        auto first = framer.next();
+        ASSERT_TRUE(first.has_value());
+        EXPECT_EQ(*first, "abc");
+        auto second = framer.next();
+        ASSERT_TRUE(second.has_value());
+        EXPECT_EQ(*second, "de");
+        EXPECT_FALSE(framer.next().has_value());
+
+        feed(std::string("\x01" "f", 2));
+        auto third = framer.next();
+        ASSERT_TRUE(third.has_value());
+        EXPECT_EQ(*third, "f");
+    }
+
+    TEST_F(FramerTest, SwitchingModeKeepsBufferedBytes)
+    {
+        // Un HELLO en texto seguido, en el mismo envío, del primer frame binario.
+        feed(std::string("HELLO|1\n" "\x00\x02" "\x04\x1a", 12));
+        auto hello = framer.next();
+        ASSERT_TRUE(hello.has_value());
+        EXPECT_EQ(*hello, "HELLO|1\n");
+
+        framer.set_mode(Framer::Mode::LENGTH_PREFIXED);
+        auto frame = framer.next();
+        ASSERT_TRUE(frame.has_value());
+        EXPECT_EQ(*frame, std::string("\x04\x1a", 2));
+    }
+
+    TEST_F(FramerTest, LengthPrefixLargerThanCapacityOverflows)
+    {
+        framer.set_mode(Framer::Mode::LENGTH_PREFIXED);
+        feed(std::string("\x01\x00", 2));
+        EXPECT_FALSE(framer.next().has_value());
+        EXPECT_TRUE(framer.overflowed());
+    }
+
+    TEST_F(FramerTest, FullBufferWithFrameIsNotOverflow)
+    {
+        feed(std::string(63, 'a') + "\n");
+        EXPECT_FALSE(framer.overflowed());
+        ASSERT_TRUE(framer.next().has_value());
+        EXPECT_FALSE(framer.overflowed());
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -154,12 +154,120 @@ namespace BattleShipProtocol
         EXPECT_EQ(p2_status.turn, Turn::YOUR_TURN);
     }
 
+    TEST_F(GameLogicTest, SkipTurn_PassesTurnToOpponent)
+    {
+        prepare_game_ready_for_shots();
+        game_logic.skip_turn();
+
+        EXPECT_EQ(game_logic.get_status(1).turn, Turn::OPPONENT_TURN);
+        EXPECT_EQ(game_logic.get_status(2).turn, Turn::YOUR_TURN);
+        EXPECT_NO_THROW(game_logic.process_shot(2, ShootData{{"A", 1}}));
+        EXPECT_EQ(game_logic.get_status(1).turn, Turn::YOUR_TURN);
+    }
+
     TEST_F(GameLogicTest, ProcessShot_InvalidCoordinate_Throws)
     {
         prepare_game_ready_for_shots();
         ShootData shot{{"Z", 99}};
         EXPECT_THROW(game_logic.process_shot(1, shot), GameLogicError);
     }
+
+    TEST_F(GameLogicTest, CellState_MatchesStatusWithoutCopyingBoards)
+    {
+        EXPECT_EQ(game_logic.get_game_state(), GameState::WAITING);
+        prepare_game_ready_for_shots();
+        EXPECT_EQ(game_logic.get_game_state(), GameState::ONGOING);
+
+        game_logic.process_shot(1, ShootData{{"J", 10}});
+        EXPECT_EQ(game_logic.cell_state(2, 99), CellState::MISS);
+        EXPECT_EQ(game_logic.cell_state(2, 0), CellState::SHIP);
+        EXPECT_EQ(game_logic.cell_state(1, 99), CellState::WATER);
+
+        StatusData status = game_logic.get_status(1);
+        for (int i = 0; i < 100; ++i)
+        {
+            EXPECT_EQ(game_logic.cell_state(1, i), status.boardOwn[i].cellState);
+            EXPECT_EQ(game_logic.cell_state(2, i), status.boardOpponent[i].cellState);
+        }
+        EXPECT_THROW(game_logic.cell_state(3, 0), GameLogicError);
+        EXPECT_THROW(game_logic.cell_state(1, 100), GameLogicError);
+    }
+
+    TEST_F(GameLogicTest, GetStatusInto_ReusesBoards)
+    {
+        prepare_game_ready_for_shots();
+        StatusData status{};
+        game_logic.get_status(1, status);
+        const Cell *own = status.boardOwn.data();
+
+        game_logic.process_shot(1, ShootData{{"J", 10}});
+        game_logic.get_status(1, status);
+        StatusData fresh = game_logic.get_status(1);
+
+        EXPECT_EQ(status.boardOwn.data(), own);
+        ASSERT_EQ(status.boardOpponent.size(), 100u);
+        EXPECT_EQ(status.turn, fresh.turn);
+        EXPECT_EQ(status.gameState, fresh.gameState);
+        for (int i = 0; i < 100; ++i)
+        {
+            EXPECT_EQ(status.boardOwn[i].cellState, fresh.boardOwn[i].cellState);
+            EXPECT_EQ(status.boardOpponent[i].cellState, fresh.boardOpponent[i].cellState);
+        }
+        EXPECT_THROW(game_logic.get_status(3, status), GameLogicError);
+    }
+
+    TEST_F(GameLogicTest, ProcessShot_SinkingMarksOnlyThatShip)
+    {
+        prepare_game_ready_for_shots();
+        game_logic.process_shot(1, ShootData{{"E", 1}});
+        game_logic.skip_turn();
+        EXPECT_EQ(game_logic.cell_state(2, 40), CellState::HIT);
+
+        game_logic.process_shot(1, ShootData{{"E", 2}});
+        EXPECT_EQ(game_logic.cell_state(2, 40), CellState::SUNK);
+        EXPECT_EQ(game_logic.cell_state(2, 41), CellState::SUNK);
+        EXPECT_EQ(game_logic.cell_state(2, 50), CellState::SHIP);
+        EXPECT_FALSE(game_logic.is_game_over());
+
+        game_logic.skip_turn();
+        EXPECT_THROW(game_logic.process_shot(1, ShootData{{"E", 2}}), GameLogicError);
+    }
+
+    TEST_F(GameLogicTest, ProcessShot_SinkingTheWholeFleetEndsTheGame)
+    {
+        prepare_game_ready_for_shots();
+        const std::vector<Coordinate> targets = {
+            {"A", 1}, {"A", 2}, {"A", 3}, {"A", 4}, {"A", 5}, {"B", 1}, {"B", 2}, {"B", 3}, {"B", 4},
+            {"C", 1}, {"C", 2}, {"C", 3}, {"D", 1}, {"D", 2}, {"D", 3}, {"E", 1}, {"E", 2},
+            {"F", 1}, {"F", 2}, {"G", 1}, {"H", 1}, {"I", 1}};
+        for (const auto &target : targets)
+        {
+            ASSERT_FALSE(game_logic.is_game_over());
+            game_logic.process_shot(1, ShootData{target});
+            if (!game_logic.is_game_over())
+            {
+                game_logic.skip_turn();
+            }
+        }
+        EXPECT_TRUE(game_logic.is_game_over());
+        EXPECT_EQ(game_logic.get_game_over_result().winner, "PlayerOne");
+    }
+
+    TEST(BitboardTest, SetTestAndCountAcrossBothWords)
+    {
+        Bitboard board;
+        EXPECT_TRUE(board.empty());
+        board.set(0);
+        board.set(63);
+        board.set(64);
+        board.set(99);
+        EXPECT_EQ(board.count(), 4);
+        EXPECT_TRUE(board.test(63));
+        EXPECT_TRUE(board.test(64));
+        EXPECT_FALSE(board.test(65));
+        EXPECT_EQ(board & Bitboard::cell(99), Bitboard::cell(99));
+        EXPECT_TRUE((board & Bitboard::cell(98)).empty());
+    }
 } // namespace BattleShipProtocol
 
 int main(int argc, char **argv)
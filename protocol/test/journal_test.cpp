@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include "../include/journal.hpp"
+#include <string>
+
+namespace BattleShipProtocol
+{
+    class JournalTest : public ::testing::Test
+    {
+    protected:
+        Protocol protocol;
+
+        static JournalRecord event(JournalEvent type, uint32_t session, uint8_t player, uint64_t time_us)
+        {
+            JournalRecord record;
+            record.type = type;
+            record.session = session;
+            record.player = player;
+            record.time_us = time_us;
+            return record;
+        }
+
+        static std::string encode(const JournalRecord &record)
+        {
+            std::string out;
+            Journal::append(out, record);
+            return out;
+        }
+    };
+
+    TEST_F(JournalTest, RoundTripsEveryEventType)
+    {
+        std::string data;
+        Journal::append(data, event(JournalEvent::JOURNAL_START, 0, 0, 1760000000123456ull));
+
+        auto joined = event(JournalEvent::PLAYER_JOINED, 7, 1, 10);
+        joined.text = "10.0.0.1";
+        Journal::append(data, joined);
+
+        auto registered = event(JournalEvent::REGISTERED, 7, 2, 20);
+        registered.text = Journal::message_text(protocol, {MessageType::REGISTER, RegisterData{"PlayerTwo", "p2@mail.com"}});
+        Journal::append(data, registered);
+
+        auto phase = event(JournalEvent::PHASE, 7, 0, 30);
+        phase.value = static_cast<uint8_t>(PhaseState::Phase::PLAYING);
+        Journal::append(data, phase);
+
+        auto shot = event(JournalEvent::SHOT, 7, 1, 40);
+        shot.target = Coordinate('J', 10);
+        shot.result = CellState::SUNK;
+        Journal::append(data, shot);
+
+        auto status = event(JournalEvent::STATUS, 7, 2, 50);
+        status.value = Journal::STATUS_DELTA | Journal::STATUS_YOUR_TURN;
+        status.time_remaining = 300;
+        Journal::append(data, status);
+
+        auto disconnect = event(JournalEvent::DISCONNECT, 7, 1, 60);
+        disconnect.text = "Client disconnected";
+        Journal::append(data, disconnect);
+        Journal::append(data, event(JournalEvent::GAME_OVER, 70000, 2, 1ull << 40));
+
+        JournalReader reader(data);
+        JournalRecord record;
+        ASSERT_TRUE(reader.next(record));
+        EXPECT_EQ(record.type, JournalEvent::JOURNAL_START);
+        EXPECT_EQ(record.time_us, 1760000000123456ull);
+
+        ASSERT_TRUE(reader.next(record));
+        EXPECT_EQ(record.type, JournalEvent::PLAYER_JOINED);
+        EXPECT_EQ(record.session, 7u);
+        EXPECT_EQ(record.player, 1);
+        EXPECT_EQ(record.text, "10.0.0.1");
+
+        ASSERT_TRUE(reader.next(record));
+        EXPECT_EQ(record.type, JournalEvent::REGISTERED);
+        auto msg = protocol.parse_binary_message(record.text);
+        ASSERT_EQ(msg.type, MessageType::REGISTER);
+        EXPECT_EQ(std::get<RegisterData>(msg.data).nickname, "PlayerTwo");
+
+        ASSERT_TRUE(reader.next(record));
+        EXPECT_EQ(record.type, JournalEvent::PHASE);
+        EXPECT_EQ(record.value, static_cast<uint8_t>(PhaseState::Phase::PLAYING));
+
+        ASSERT_TRUE(reader.next(record));
+        EXPECT_EQ(record.type, JournalEvent::SHOT);
+        EXPECT_EQ(record.target, Coordinate('J', 10));
+        EXPECT_EQ(record.result, CellState::SUNK);
+        EXPECT_EQ(record.time_us, 40u);
+
+        ASSERT_TRUE(reader.next(record));
+        EXPECT_EQ(record.type, JournalEvent::STATUS);
+        EXPECT_EQ(record.value, Journal::STATUS_DELTA | Journal::STATUS_YOUR_TURN);
+        EXPECT_EQ(record.time_remaining, 300u);
+
+        ASSERT_TRUE(reader.next(record));
+        EXPECT_EQ(record.type, JournalEvent::DISCONNECT);
+        EXPECT_EQ(record.text, "Client disconnected");
+
+        ASSERT_TRUE(reader.next(record));
+        EXPECT_EQ(record.type, JournalEvent::GAME_OVER);
+        EXPECT_EQ(record.session, 70000u);
+        EXPECT_EQ(record.time_us, 1ull << 40);
+
+        EXPECT_FALSE(reader.next(record));
+        EXPECT_EQ(reader.offset(), data.size());
+    }
+
+    TEST_F(JournalTest, TurnRecordsStayCompact)
+    {
+        // Un turno son un disparo y dos estados; el log de texto escribía ~2.3 KB por estado.
+        auto shot = event(JournalEvent::SHOT, 1234, 1, 3600ull * 1000000);
+        shot.target = Coordinate('C', 4);
+        shot.result = CellState::HIT;
+        auto status = event(JournalEvent::STATUS, 1234, 2, 3600ull * 1000000);
+        status.time_remaining = 30;
+
+        EXPECT_LE(encode(shot).size(), 12u);
+        EXPECT_LE(encode(status).size(), 12u);
+    }
+
+    TEST_F(JournalTest, TruncatedRecordThrowsWithoutAdvancing)
+    {
+        auto joined = event(JournalEvent::PLAYER_JOINED, 1, 1, 5);
+        joined.text = "127.0.0.1";
+        std::string first = encode(event(JournalEvent::TURN_TIMEOUT, 1, 2, 1));
+        std::string data = first + encode(joined);
+        data.pop_back();
+
+        JournalReader reader(data);
+        JournalRecord record;
+        ASSERT_TRUE(reader.next(record));
+        EXPECT_THROW(reader.next(record), ProtocolError);
+        EXPECT_EQ(reader.offset(), first.size());
+    }
+
+    TEST_F(JournalTest, UnknownEventThrows)
+    {
+        std::string data("\x7F\x01\x01\x00", 4);
+        JournalReader reader(data);
+        JournalRecord record;
+        EXPECT_THROW(reader.next(record), ProtocolError);
+
+        EXPECT_THROW(encode(event(static_cast<JournalEvent>(0x7F), 1, 1, 0)), ProtocolError);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -96,8 +96,8 @@ namespace BattleShipProtocol
             ASSERT_EQ(place_ships_data.ships[i].coordinates.size(), expected_ships[i].coordinates.size());
             for (size_t j = 0; j < expected_ships[i].coordinates.size(); ++j)
             {
-                EXPECT_EQ(place_ships_data.ships[i].coordinates[j].letter, expected_ships[i].coordinates[j].letter) << "Ship " << i << ", coord " << j;
-                EXPECT_EQ(place_ships_data.ships[i].coordinates[j].number, expected_ships[i].coordinates[j].number) << "Ship " << i << ", coord " << j;
+                EXPECT_EQ(place_ships_data.ships[i].coordinates[j].letter(), expected_ships[i].coordinates[j].letter()) << "Ship " << i << ", coord " << j;
+                EXPECT_EQ(place_ships_data.ships[i].coordinates[j].number(), expected_ships[i].coordinates[j].number()) << "Ship " << i << ", coord " << j;
             }
         }
     }
@@ -136,10 +136,10 @@ namespace BattleShipProtocol
         ASSERT_EQ(data.ships.size(), 1);
         ASSERT_EQ(data.ships[0].type, ShipType::BUQUE);
         ASSERT_EQ(data.ships[0].coordinates.size(), 2);
-        EXPECT_EQ(data.ships[0].coordinates[0].letter, "A");
-        EXPECT_EQ(data.ships[0].coordinates[0].number, 1);
-        EXPECT_EQ(data.ships[0].coordinates[1].letter, "A");
-        EXPECT_EQ(data.ships[0].coordinates[1].number, 2);
+        EXPECT_EQ(data.ships[0].coordinates[0].letter(), 'A');
+        EXPECT_EQ(data.ships[0].coordinates[0].number(), 1);
+        EXPECT_EQ(data.ships[0].coordinates[1].letter(), 'A');
+        EXPECT_EQ(data.ships[0].coordinates[1].number(), 2);
     }
 
     TEST_F(ProtocolTest, ParseMessage_Shoot_ValidCoordinates)
@@ -147,15 +147,15 @@ namespace BattleShipProtocol
         struct TestCase
         {
             std::string input;
-            std::string expected_letter;
+            char expected_letter;
             int expected_number;
         };
 
         std::vector<TestCase> test_cases = {
-            {"SHOOT|A1\n", "A", 1},
-            {"SHOOT|B5\n", "B", 5},
-            {"SHOOT|J10\n", "J", 10},
-            {"SHOOT|H7\n", "H", 7}};
+            {"SHOOT|A1\n", 'A', 1},
+            {"SHOOT|B5\n", 'B', 5},
+            {"SHOOT|J10\n", 'J', 10},
+            {"SHOOT|H7\n", 'H', 7}};
 
         for (const auto &test : test_cases)
         {
@@ -163,8 +163,8 @@ namespace BattleShipProtocol
             EXPECT_EQ(msg.type, BattleShipProtocol::MessageType::SHOOT);
 
             const auto &shoot_data = std::get<BattleShipProtocol::ShootData>(msg.data);
-            EXPECT_EQ(shoot_data.coordinate.letter, test.expected_letter) << "Failed for input: " << test.input;
-            EXPECT_EQ(shoot_data.coordinate.number, test.expected_number) << "Failed for input: " << test.input;
+            EXPECT_EQ(shoot_data.coordinate.letter(), test.expected_letter) << "Failed for input: " << test.input;
+            EXPECT_EQ(shoot_data.coordinate.number(), test.expected_number) << "Failed for input: " << test.input;
         }
     }
 
@@ -185,10 +185,10 @@ namespace BattleShipProtocol
         ASSERT_EQ(data.ships.size(), 1);
         EXPECT_EQ(data.ships[0].type, ShipType::BUQUE);
         ASSERT_EQ(data.ships[0].coordinates.size(), 2);
-        EXPECT_EQ(data.ships[0].coordinates[0].letter, "A");
-        EXPECT_EQ(data.ships[0].coordinates[0].number, 1);
-        EXPECT_EQ(data.ships[0].coordinates[1].letter, "A");
-        EXPECT_EQ(data.ships[0].coordinates[1].number, 2);
+        EXPECT_EQ(data.ships[0].coordinates[0].letter(), 'A');
+        EXPECT_EQ(data.ships[0].coordinates[0].number(), 1);
+        EXPECT_EQ(data.ships[0].coordinates[1].letter(), 'A');
+        EXPECT_EQ(data.ships[0].coordinates[1].number(), 2);
     }
 
     TEST_F(ProtocolTest, ParseMessage_Shoot_EmptyCoordinate)
@@ -221,6 +221,31 @@ namespace BattleShipProtocol
         EXPECT_THROW(protocol.parse_message("SHOOT|$@\n"), BattleShipProtocol::ProtocolError);
     }
 
+    TEST_F(ProtocolTest, ParseMessage_Shoot_CoordinateThatDoesNotFitInOneByteThrows)
+    {
+        EXPECT_THROW(protocol.parse_message("SHOOT|Z1\n"), ProtocolError);
+        EXPECT_THROW(protocol.parse_message("SHOOT|A16\n"), ProtocolError);
+        // Fuera del tablero pero representable: lo rechaza la lógica del juego, no el parser.
+        EXPECT_EQ(std::get<ShootData>(protocol.parse_message("SHOOT|K11\n").data).coordinate.to_string(), "K11");
+    }
+
+    TEST(CoordinateTest, PacksRowAndColumnInOneByte)
+    {
+        static_assert(sizeof(Coordinate) == 1);
+        static_assert(sizeof(Cell) == 2);
+        for (uint8_t index = 0; index < 100; ++index)
+        {
+            Coordinate coordinate = Coordinate::from_index(index);
+            EXPECT_TRUE(coordinate.on_board());
+            EXPECT_EQ(coordinate.index(), index);
+        }
+        EXPECT_EQ(Coordinate("J", 10).to_string(), "J10");
+        EXPECT_EQ(Coordinate('B', 7), Coordinate("B", 7));
+        EXPECT_FALSE(Coordinate("Z", 99).on_board());
+        EXPECT_FALSE(Coordinate("AB", 1).on_board());
+        EXPECT_FALSE(Coordinate('A', 0).on_board());
+    }
+
     TEST_F(ProtocolTest, ParseMessage_Surrender)
     {
         Message msg = protocol.parse_message("SURRENDER|");
@@ -230,7 +255,7 @@ namespace BattleShipProtocol
 
     TEST_F(ProtocolTest, ParseMessage_Status_LongMessage_ParsesCorrectly)
     {
-        BattleShipProtocol::Message msg = protocol.parse_message("STATUS|OPPONENT_TURN;A1:SHIP,A2:SHIP,A3:SHIP,A4:SHIP,A5:SHIP,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,B1:SHIP,B2:SHIP,B3:SHIP,B4:SHIP,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,C1:SHIP,C2:SHIP,C3:SHIP,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,D1:SHIP,D2:SHIP,D3:SHIP,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,E1:SHIP,E2:SHIP,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,F1:SHIP,F2:SHIP,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,G1:SHIP,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,H1:SHIP,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,I1:SHIP,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER;A1:SHIP,A2:SHIP,A3:SHIP,A4:SHIP,A5:SHIP,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,B1:SHIP,B2:SHIP,B3:SHIP,B4:SHIP,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,C1:SHIP,C2:SHIP,C3:SHIP,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,D1:SHIP,D2:SHIP,D3:SHIP,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,E1:SHIP,E2:SHIP,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,F1:SHIP,F2:SHIP,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,G1:SHIP,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,H1:SHIP,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,I1:SHIP,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER,X1:WATER;ONGOING;25\n");
+        BattleShipProtocol::Message msg = protocol.parse_message("STATUS|OPPONENT_TURN;A1:SHIP,A2:SHIP,A3:SHIP,A4:SHIP,A5:SHIP,A6:WATER,A7:WATER,A8:WATER,A9:WATER,A10:WATER,B1:SHIP,B2:SHIP,B3:SHIP,B4:SHIP,B5:WATER,B6:WATER,B7:WATER,B8:WATER,B9:WATER,B10:WATER,C1:SHIP,C2:SHIP,C3:SHIP,C4:WATER,C5:WATER,C6:WATER,C7:WATER,C8:WATER,C9:WATER,C10:WATER,D1:SHIP,D2:SHIP,D3:SHIP,D4:WATER,D5:WATER,D6:WATER,D7:WATER,D8:WATER,D9:WATER,D10:WATER,E1:SHIP,E2:SHIP,E3:WATER,E4:WATER,E5:WATER,E6:WATER,E7:WATER,E8:WATER,E9:WATER,E10:WATER,F1:SHIP,F2:SHIP,F3:WATER,F4:WATER,F5:WATER,F6:WATER,F7:WATER,F8:WATER,F9:WATER,F10:WATER,G1:SHIP,G2:WATER,G3:WATER,G4:WATER,G5:WATER,G6:WATER,G7:WATER,G8:WATER,G9:WATER,G10:WATER,H1:SHIP,H2:WATER,H3:WATER,H4:WATER,H5:WATER,H6:WATER,H7:WATER,H8:WATER,H9:WATER,H10:WATER,I1:SHIP,I2:WATER,I3:WATER,I4:WATER,I5:WATER,I6:WATER,I7:WATER,I8:WATER,I9:WATER,I10:WATER,J1:WATER,J2:WATER,J3:WATER,J4:WATER,J5:WATER,J6:WATER,J7:WATER,J8:WATER,J9:WATER,J10:WATER;A1:SHIP,A2:SHIP,A3:SHIP,A4:SHIP,A5:SHIP,A6:WATER,A7:WATER,A8:WATER,A9:WATER,A10:WATER,B1:SHIP,B2:SHIP,B3:SHIP,B4:SHIP,B5:WATER,B6:WATER,B7:WATER,B8:WATER,B9:WATER,B10:WATER,C1:SHIP,C2:SHIP,C3:SHIP,C4:WATER,C5:WATER,C6:WATER,C7:WATER,C8:WATER,C9:WATER,C10:WATER,D1:SHIP,D2:SHIP,D3:SHIP,D4:WATER,D5:WATER,D6:WATER,D7:WATER,D8:WATER,D9:WATER,D10:WATER,E1:SHIP,E2:SHIP,E3:WATER,E4:WATER,E5:WATER,E6:WATER,E7:WATER,E8:WATER,E9:WATER,E10:WATER,F1:SHIP,F2:SHIP,F3:WATER,F4:WATER,F5:WATER,F6:WATER,F7:WATER,F8:WATER,F9:WATER,F10:WATER,G1:SHIP,G2:WATER,G3:WATER,G4:WATER,G5:WATER,G6:WATER,G7:WATER,G8:WATER,G9:WATER,G10:WATER,H1:SHIP,H2:WATER,H3:WATER,H4:WATER,H5:WATER,H6:WATER,H7:WATER,H8:WATER,H9:WATER,H10:WATER,I1:SHIP,I2:WATER,I3:WATER,I4:WATER,I5:WATER,I6:WATER,I7:WATER,I8:WATER,I9:WATER,I10:WATER,J1:WATER,J2:WATER,J3:WATER,J4:WATER,J5:WATER,J6:WATER,J7:WATER,J8:WATER,J9:WATER,J10:WATER;ONGOING;25\n");
 
         EXPECT_EQ(msg.type, BattleShipProtocol::MessageType::STATUS);
 
@@ -243,21 +268,21 @@ namespace BattleShipProtocol
         ASSERT_EQ(status_data.boardOpponent.size(), 100);
 
         // Verificar algunas celdas clave en boardOwn
-        EXPECT_EQ(status_data.boardOwn[0].coordinate.letter, "A");
-        EXPECT_EQ(status_data.boardOwn[0].coordinate.number, 1);
+        EXPECT_EQ(status_data.boardOwn[0].coordinate.letter(), 'A');
+        EXPECT_EQ(status_data.boardOwn[0].coordinate.number(), 1);
         EXPECT_EQ(status_data.boardOwn[0].cellState, BattleShipProtocol::CellState::SHIP);
 
-        EXPECT_EQ(status_data.boardOwn[5].coordinate.letter, "X");
-        EXPECT_EQ(status_data.boardOwn[5].coordinate.number, 1);
+        EXPECT_EQ(status_data.boardOwn[5].coordinate.letter(), 'A');
+        EXPECT_EQ(status_data.boardOwn[5].coordinate.number(), 6);
         EXPECT_EQ(status_data.boardOwn[5].cellState, BattleShipProtocol::CellState::WATER);
 
         // Verificar algunas celdas clave en boardOpponent
-        EXPECT_EQ(status_data.boardOpponent[0].coordinate.letter, "A");
-        EXPECT_EQ(status_data.boardOpponent[0].coordinate.number, 1);
+        EXPECT_EQ(status_data.boardOpponent[0].coordinate.letter(), 'A');
+        EXPECT_EQ(status_data.boardOpponent[0].coordinate.number(), 1);
         EXPECT_EQ(status_data.boardOpponent[0].cellState, BattleShipProtocol::CellState::SHIP);
 
-        EXPECT_EQ(status_data.boardOpponent[10].coordinate.letter, "B");
-        EXPECT_EQ(status_data.boardOpponent[10].coordinate.number, 1);
+        EXPECT_EQ(status_data.boardOpponent[10].coordinate.letter(), 'B');
+        EXPECT_EQ(status_data.boardOpponent[10].coordinate.number(), 1);
         EXPECT_EQ(status_data.boardOpponent[10].cellState, BattleShipProtocol::CellState::SHIP);
         EXPECT_EQ(status_data.time_remaining, 25);
     }
@@ -274,18 +299,18 @@ namespace BattleShipProtocol
 
         // Verificar celdas propias
         ASSERT_EQ(status_data.boardOwn.size(), 2);
-        EXPECT_EQ(status_data.boardOwn[0].coordinate.letter, "A");
-        EXPECT_EQ(status_data.boardOwn[0].coordinate.number, 1);
+        EXPECT_EQ(status_data.boardOwn[0].coordinate.letter(), 'A');
+        EXPECT_EQ(status_data.boardOwn[0].coordinate.number(), 1);
         EXPECT_EQ(status_data.boardOwn[0].cellState, BattleShipProtocol::CellState::SHIP);
 
-        EXPECT_EQ(status_data.boardOwn[1].coordinate.letter, "A");
-        EXPECT_EQ(status_data.boardOwn[1].coordinate.number, 2);
+        EXPECT_EQ(status_data.boardOwn[1].coordinate.letter(), 'A');
+        EXPECT_EQ(status_data.boardOwn[1].coordinate.number(), 2);
         EXPECT_EQ(status_data.boardOwn[1].cellState, BattleShipProtocol::CellState::WATER);
 
         // Verificar celdas del oponente
         ASSERT_EQ(status_data.boardOpponent.size(), 2);
-        EXPECT_EQ(status_data.boardOpponent[0].coordinate.letter, "B");
-        EXPECT_EQ(status_data.boardOpponent[0].coordinate.number, 1);
+        EXPECT_EQ(status_data.boardOpponent[0].coordinate.letter(), 'B');
+        EXPECT_EQ(status_data.boardOpponent[0].coordinate.number(), 1);
         EXPECT_EQ(status_data.boardOpponent[0].cellState, BattleShipProtocol::CellState::HIT);
         EXPECT_EQ(status_data.time_remaining, 12);
     }
@@ -302,13 +327,13 @@ namespace BattleShipProtocol
         EXPECT_EQ(status_data.gameState, BattleShipProtocol::GameState::WAITING);
 
         ASSERT_EQ(status_data.boardOwn.size(), 1);
-        EXPECT_EQ(status_data.boardOwn[0].coordinate.letter, "A");
-        EXPECT_EQ(status_data.boardOwn[0].coordinate.number, 1);
+        EXPECT_EQ(status_data.boardOwn[0].coordinate.letter(), 'A');
+        EXPECT_EQ(status_data.boardOwn[0].coordinate.number(), 1);
         EXPECT_EQ(status_data.boardOwn[0].cellState, BattleShipProtocol::CellState::WATER);
 
         ASSERT_EQ(status_data.boardOpponent.size(), 1);
-        EXPECT_EQ(status_data.boardOpponent[0].coordinate.letter, "B");
-        EXPECT_EQ(status_data.boardOpponent[0].coordinate.number, 1);
+        EXPECT_EQ(status_data.boardOpponent[0].coordinate.letter(), 'B');
+        EXPECT_EQ(status_data.boardOpponent[0].coordinate.number(), 1);
         EXPECT_EQ(status_data.boardOpponent[0].cellState, BattleShipProtocol::CellState::SHIP);
         EXPECT_EQ(status_data.time_remaining, 18);
     }
@@ -341,13 +366,13 @@ namespace BattleShipProtocol
         EXPECT_EQ(status_data.gameState, BattleShipProtocol::GameState::ONGOING);
 
         ASSERT_EQ(status_data.boardOwn.size(), 3);
-        EXPECT_EQ(status_data.boardOwn[0].coordinate.letter, "A");
-        EXPECT_EQ(status_data.boardOwn[0].coordinate.number, 1);
+        EXPECT_EQ(status_data.boardOwn[0].coordinate.letter(), 'A');
+        EXPECT_EQ(status_data.boardOwn[0].coordinate.number(), 1);
         EXPECT_EQ(status_data.boardOwn[0].cellState, BattleShipProtocol::CellState::SHIP);
 
         ASSERT_EQ(status_data.boardOpponent.size(), 2);
-        EXPECT_EQ(status_data.boardOpponent[0].coordinate.letter, "C");
-        EXPECT_EQ(status_data.boardOpponent[0].coordinate.number, 1);
+        EXPECT_EQ(status_data.boardOpponent[0].coordinate.letter(), 'C');
+        EXPECT_EQ(status_data.boardOpponent[0].coordinate.number(), 1);
         EXPECT_EQ(status_data.boardOpponent[0].cellState, BattleShipProtocol::CellState::WATER);
         EXPECT_EQ(status_data.time_remaining, 10);
     }
@@ -527,6 +552,220 @@ namespace BattleShipProtocol
         EXPECT_EQ(protocol.build_message(msg), "ERROR|500,Internal server error\n");
     }
 
+    // HELLO
+    TEST_F(ProtocolTest, ParseAndBuildMessage_Hello)
+    {
+        Message msg = protocol.parse_message("HELLO|1\n");
+        EXPECT_EQ(msg.type, MessageType::HELLO);
+        EXPECT_EQ(std::get<HelloData>(msg.data).version, Protocol::BINARY_VERSION);
+        EXPECT_EQ(protocol.build_message(msg), "HELLO|1\n");
+        EXPECT_THROW(protocol.parse_message("HELLO|x\n"), ProtocolError);
+
+        Message deltas = protocol.parse_message("HELLO|1,DELTA\n");
+        EXPECT_TRUE(std::get<HelloData>(deltas.data).deltas);
+        EXPECT_EQ(protocol.build_message(deltas), "HELLO|1,DELTA\n");
+        EXPECT_THROW(protocol.parse_message("HELLO|1,FOO\n"), ProtocolError);
+    }
+
+    // STATUS_DELTA y RESYNC
+    TEST_F(ProtocolTest, ParseAndBuildMessage_StatusDelta)
+    {
+        std::string raw = "STATUS_DELTA|7;OPPONENT_TURN;;C4:SUNK,C5:SUNK;ONGOING;29\n";
+        Message msg = protocol.parse_message(raw);
+        ASSERT_EQ(msg.type, MessageType::STATUS_DELTA);
+        const auto &delta = std::get<StatusDeltaData>(msg.data);
+        EXPECT_EQ(delta.seq, 7u);
+        EXPECT_EQ(delta.turn, Turn::OPPONENT_TURN);
+        EXPECT_TRUE(delta.ownChanges.empty());
+        ASSERT_EQ(delta.opponentChanges.size(), 2u);
+        EXPECT_EQ(delta.opponentChanges[1].coordinate.letter(), 'C');
+        EXPECT_EQ(delta.opponentChanges[1].coordinate.number(), 5);
+        EXPECT_EQ(delta.opponentChanges[1].cellState, CellState::SUNK);
+        EXPECT_EQ(delta.time_remaining, 29);
+        EXPECT_EQ(protocol.build_message(msg), raw);
+
+        EXPECT_THROW(protocol.parse_message("STATUS_DELTA|x;YOUR_TURN;;;ONGOING;1\n"), ProtocolError);
+        EXPECT_EQ(protocol.parse_message("RESYNC|\n").type, MessageType::RESYNC);
+        EXPECT_EQ(protocol.build_message({MessageType::RESYNC, std::monostate{}}), "RESYNC|\n");
+    }
+
+    // Formato binario: se quita el prefijo de longitud como lo hace el Framer.
+    std::string_view binary_payload(const std::string &frame)
+    {
+        return std::string_view(frame).substr(Protocol::BINARY_HEADER_SIZE);
+    }
+
+    std::vector<Cell> full_board(CellState state)
+    {
+        std::vector<Cell> board;
+        for (char row = 'A'; row <= 'J'; ++row)
+            for (int col = 1; col <= 10; ++col)
+                board.push_back({{std::string(1, row), col}, state});
+        return board;
+    }
+
+    TEST_F(ProtocolTest, BinaryMessage_LengthPrefixAndTypeByte)
+    {
+        std::string frame = protocol.build_binary_message({MessageType::SHOOT, ShootData{{"C", 7}}});
+        ASSERT_EQ(frame.size(), 4u);
+        EXPECT_EQ(frame[0], 0);
+        EXPECT_EQ(frame[1], 2);
+        EXPECT_EQ(static_cast<uint8_t>(frame[3]), 26); // C7 -> 2 * 10 + 6
+
+        Message msg = protocol.parse_binary_message(binary_payload(frame));
+        EXPECT_EQ(msg.type, MessageType::SHOOT);
+        EXPECT_EQ(std::get<ShootData>(msg.data).coordinate.letter(), 'C');
+        EXPECT_EQ(std::get<ShootData>(msg.data).coordinate.number(), 7);
+    }
+
+    TEST_F(ProtocolTest, BinaryMessage_RegisterAndPlaceShipsRoundTrip)
+    {
+        Message reg = protocol.parse_binary_message(binary_payload(
+            protocol.build_binary_message({MessageType::REGISTER, RegisterData{"ana", "ana@x.com"}})));
+        EXPECT_EQ(std::get<RegisterData>(reg.data).nickname, "ana");
+        EXPECT_EQ(std::get<RegisterData>(reg.data).email, "ana@x.com");
+
+        PlaceShipsData ships{{{ShipType::DESTRUCTOR, {{"J", 9}, {"J", 10}}}, {ShipType::SUBMARINO, {{"A", 1}}}}};
+        Message place = protocol.parse_binary_message(binary_payload(
+            protocol.build_binary_message({MessageType::PLACE_SHIPS, ships})));
+        const auto &parsed = std::get<PlaceShipsData>(place.data);
+        ASSERT_EQ(parsed.ships.size(), 2u);
+        EXPECT_EQ(parsed.ships[0].type, ShipType::DESTRUCTOR);
+        ASSERT_EQ(parsed.ships[0].coordinates.size(), 2u);
+        EXPECT_EQ(parsed.ships[0].coordinates[1].letter(), 'J');
+        EXPECT_EQ(parsed.ships[0].coordinates[1].number(), 10);
+        EXPECT_EQ(parsed.ships[1].type, ShipType::SUBMARINO);
+    }
+
+    TEST_F(ProtocolTest, BinaryMessage_StatusIsCompactAndRoundTrips)
+    {
+        StatusData data;
+        data.turn = Turn::OPPONENT_TURN;
+        data.boardOwn = full_board(CellState::WATER);
+        data.boardOwn[0].cellState = CellState::SHIP;
+        data.boardOwn[1].cellState = CellState::HIT;
+        data.boardOwn[99].cellState = CellState::MISS;
+        data.boardOpponent = full_board(CellState::WATER);
+        data.boardOpponent[42].cellState = CellState::SUNK;
+        data.gameState = GameState::ONGOING;
+        data.time_remaining = 27;
+
+        Message msg{MessageType::STATUS, data};
+        std::string frame = protocol.build_binary_message(msg);
+        // Prefijo + tipo + flags + tiempo + tablero propio en nibbles + tablero rival en 2 bits.
+        EXPECT_EQ(frame.size(), 2u + 1 + 1 + 2 + (1 + 50) + (1 + 25));
+        EXPECT_LT(frame.size(), protocol.build_message(msg).size() / 20);
+
+        Message parsed = protocol.parse_binary_message(binary_payload(frame));
+        EXPECT_EQ(protocol.build_message(parsed), protocol.build_message(msg));
+    }
+
+    TEST_F(ProtocolTest, BinaryMessage_PartialBoardUsesSparseEncoding)
+    {
+        StatusData data{Turn::YOUR_TURN, {{{"A", 1}, CellState::SHIP}, {{"A", 2}, CellState::HIT}}, {}, GameState::WAITING, 0};
+        Message msg{MessageType::STATUS, data};
+
+        Message parsed = protocol.parse_binary_message(binary_payload(protocol.build_binary_message(msg)));
+        EXPECT_EQ(protocol.build_message(parsed), "STATUS|YOUR_TURN;A1:SHIP,A2:HIT;;WAITING;0\n");
+    }
+
+    TEST_F(ProtocolTest, BinaryMessage_OtherTypesRoundTrip)
+    {
+        std::vector<Message> messages = {
+            {MessageType::PLAYER_ID, PlayerIdData{2}},
+            {MessageType::SURRENDER, std::monostate{}},
+            {MessageType::GAME_OVER, GameOverData{"YOU_WIN"}},
+            {MessageType::ERROR, ErrorData{400, "Opponent disconnected"}},
+            {MessageType::HELLO, HelloData{Protocol::BINARY_VERSION}},
+            {MessageType::HELLO, HelloData{Protocol::BINARY_VERSION, true}},
+            {MessageType::RESYNC, std::monostate{}}};
+        for (const auto &msg : messages)
+        {
+            Message parsed = protocol.parse_binary_message(binary_payload(protocol.build_binary_message(msg)));
+            EXPECT_EQ(protocol.build_message(parsed), protocol.build_message(msg));
+        }
+    }
+
+    TEST_F(ProtocolTest, BinaryMessage_StatusDeltaIsTiny)
+    {
+        StatusDeltaData delta{70000, Turn::YOUR_TURN, {{{"B", 3}, CellState::HIT}}, {}, GameState::ONGOING, 30};
+        Message msg{MessageType::STATUS_DELTA, delta};
+
+        std::string frame = protocol.build_binary_message(msg);
+        // Prefijo + tipo + seq + flags + tiempo + una celda propia + lista rival vacía.
+        EXPECT_EQ(frame.size(), 2u + 1 + 4 + 1 + 2 + (1 + 2) + 1);
+
+        Message parsed = protocol.parse_binary_message(binary_payload(frame));
+        EXPECT_EQ(std::get<StatusDeltaData>(parsed.data).seq, 70000u);
+        EXPECT_EQ(protocol.build_message(parsed), "STATUS_DELTA|70000;YOUR_TURN;B3:HIT;;ONGOING;30\n");
+    }
+
+    TEST_F(ProtocolTest, BinaryMessage_MalformedFramesThrow)
+    {
+        EXPECT_THROW(protocol.parse_binary_message(""), ProtocolError);
+        EXPECT_THROW(protocol.parse_binary_message(std::string_view("\x63", 1)), ProtocolError);      // tipo desconocido
+        EXPECT_THROW(protocol.parse_binary_message(std::string_view("\x04", 1)), ProtocolError);      // SHOOT truncado
+        EXPECT_THROW(protocol.parse_binary_message(std::string_view("\x04\x64", 2)), ProtocolError);  // índice 100
+        EXPECT_THROW(protocol.parse_binary_message(std::string_view("\x04\x01\x02", 3)), ProtocolError); // bytes sobrantes
+        EXPECT_THROW(protocol.build_binary_message({MessageType::SHOOT, ShootData{{"K", 1}}}), ProtocolError);
+    }
+
+    TEST_F(ProtocolTest, BuildIntoBuffer_AppendsSameBytesAsBuildMessage)
+    {
+        std::vector<Message> messages = {
+            {MessageType::PLAYER_ID, PlayerIdData{2}},
+            {MessageType::SHOOT, ShootData{{"J", 10}}},
+            {MessageType::ERROR, ErrorData{400, "Esperado SHOOT"}},
+            {MessageType::HELLO, HelloData{1, true}},
+            {MessageType::STATUS_DELTA, StatusDeltaData{7, Turn::OPPONENT_TURN, {{{"B", 3}, CellState::HIT}}, {}, GameState::ONGOING, 12}}};
+
+        std::string text = "prefix";
+        std::string binary = "prefix";
+        std::string expected_text = "prefix";
+        std::string expected_binary = "prefix";
+        for (const auto &msg : messages)
+        {
+            protocol.build_message(msg, text);
+            protocol.build_binary_message(msg, binary);
+            expected_text += protocol.build_message(msg);
+            expected_binary += protocol.build_binary_message(msg);
+        }
+        EXPECT_EQ(text, expected_text);
+        EXPECT_EQ(binary, expected_binary);
+    }
+
+    TEST_F(ProtocolTest, BuildIntoBuffer_LeavesBufferUntouchedOnError)
+    {
+        std::string buffer = "SHOOT|A1\n";
+        Ship broken{ShipType::BUQUE, {}};
+        EXPECT_THROW(protocol.build_message({MessageType::PLACE_SHIPS, PlaceShipsData{{broken}}}, buffer), ProtocolError);
+        EXPECT_EQ(buffer, "SHOOT|A1\n");
+        EXPECT_THROW(protocol.build_binary_message({MessageType::SHOOT, ShootData{{"K", 1}}}, buffer), ProtocolError);
+        EXPECT_EQ(buffer, "SHOOT|A1\n");
+    }
+
+    TEST_F(ProtocolTest, BuildIntoBuffer_ReusedBufferKeepsItsMemory)
+    {
+        StatusData status{Turn::YOUR_TURN, {}, {}, GameState::ONGOING, 30};
+        for (uint8_t i = 0; i < 100; ++i)
+        {
+            status.boardOwn.push_back({Coordinate::from_index(i), CellState::WATER});
+            status.boardOpponent.push_back({Coordinate::from_index(i), CellState::MISS});
+        }
+        Message msg{MessageType::STATUS, status};
+
+        std::string buffer;
+        protocol.build_message(msg, buffer);
+        const char *memory = buffer.data();
+        for (int i = 0; i < 3; ++i)
+        {
+            buffer.clear();
+            protocol.build_message(msg, buffer);
+            EXPECT_EQ(buffer.data(), memory);
+        }
+        EXPECT_EQ(buffer, protocol.build_message(msg));
+    }
+
 }
 int main(int argc, char **argv)
 {
@@ -0,0 +1,44 @@
+#ifndef ALLOC_STATS_HPP
+#define ALLOC_STATS_HPP
+
+#include <cstdint>
+
+namespace BattleshipServer
+{
+
+    /**
+     * @brief Heap allocation counters of the process.
+     *
+     * alloc_stats.cpp replaces the global operator new and delete, including the
+     * std::align_val_t forms used by over-aligned types, with versions that count every
+     * call before forwarding to malloc (posix_memalign when aligned) and free. The counts are kept per
+     * thread as well as for the whole process, so a caller can attribute the
+     * allocations of a piece of work by reading thread_allocations() before and after
+     * running it on one thread.
+     */
+    namespace AllocStats
+    {
+        /**
+         * @brief Totals since the process started.
+         */
+        struct Totals
+        {
+            uint64_t allocations = 0; ///< Calls to operator new (plain, array, nothrow and aligned forms).
+            uint64_t frees = 0;       ///< Calls to operator delete with a non-null pointer.
+            uint64_t bytes = 0;       ///< Bytes requested from operator new.
+        };
+
+        /**
+         * @brief Returns the allocations made so far by the calling thread.
+         */
+        uint64_t thread_allocations() noexcept;
+
+        /**
+         * @brief Returns the process-wide totals.
+         */
+        Totals totals() noexcept;
+    }
+
+} // namespace BattleshipServer
+
+#endif
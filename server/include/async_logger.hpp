@@ -0,0 +1,142 @@
+#ifndef ASYNC_LOGGER_HPP
+#define ASYNC_LOGGER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace BattleshipServer
+{
+
+    /**
+     * @brief Settings of the asynchronous logger.
+     */
+    struct LoggerOptions
+    {
+        std::chrono::milliseconds flush_interval{100}; ///< Longest time a line waits before it is written.
+        size_t buffer_bytes = 256 * 1024;              ///< Queue capacity per producer thread (rounded up to a power of two).
+        bool echo_stdout = false;                      ///< Also write every batch to standard output (--log-stdout).
+        bool report_drops = true;                      ///< Append a WARN line after dropped lines (off for binary streams).
+    };
+
+    /**
+     * @class AsyncLogger
+     * @brief Log writer that keeps formatting and I/O off the calling threads.
+     *
+     * Every thread that logs gets its own single-producer ring of bytes, registered
+     * the first time it logs. A line is formatted into a thread-local buffer and copied
+     * into the ring without taking a lock. A background thread drains every ring
+     * each flush interval, or earlier once a ring is half full, and writes the batch
+     * with one write() per destination. When a ring is full the line is dropped and
+     * counted; the writer reports the drops in the log itself.
+     *
+     * Lines from one thread keep their order. Lines from different threads are
+     * written one ring after the other within a batch.
+     */
+    class AsyncLogger
+    {
+    public:
+        /**
+         * @brief Starts the writer thread.
+         * @param fd Open descriptor of the log file. The logger takes ownership and closes it.
+         * @param options Flush interval, queue size and stdout echo.
+         */
+        explicit AsyncLogger(int fd, const LoggerOptions &options = {});
+
+        /**
+         * @brief Writes every queued line, stops the writer and closes the descriptor.
+         */
+        ~AsyncLogger();
+
+        AsyncLogger(const AsyncLogger &) = delete;
+        AsyncLogger &operator=(const AsyncLogger &) = delete;
+
+        /**
+         * @brief Queues a line in the server log format: "[LEVEL] date time ip query response".
+         * @param level Severity (INFO, ERROR, ...).
+         * @param client_ip Client address.
+         * @param query Message or event being logged.
+         * @param response Outcome or detail.
+         */
+        void log(std::string_view level, std::string_view client_ip, std::string_view query, std::string_view response);
+
+        /**
+         * @brief Queues a preformatted line. A trailing newline is added.
+         * @param line Text of the line.
+         */
+        void write(std::string_view line);
+
+        /**
+         * @brief Queues a binary record as is. Records are never split or interleaved.
+         * @param record Encoded record.
+         */
+        void append(std::string_view record);
+
+        /**
+         * @brief Blocks until every line queued before the call has been written.
+         */
+        void flush();
+
+        /**
+         * @brief Returns the number of lines dropped because a queue was full.
+         */
+        uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Returns the number of lines and records accepted so far, including drop reports.
+         */
+        uint64_t written() const noexcept { return written_.load(std::memory_order_relaxed); }
+
+    private:
+        class Ring;
+
+        int fd_;                                      ///< Log file.
+        LoggerOptions options_;                       ///< Startup settings.
+        uint64_t id_;                                 ///< Key of this logger in the thread-local ring cache.
+        std::vector<std::unique_ptr<Ring>> rings_;    ///< One ring per producer thread.
+        std::mutex rings_mutex_;                      ///< Guards rings_ (registration and draining).
+        std::atomic<uint64_t> dropped_{0};            ///< Lines dropped on full rings.
+        std::atomic<uint64_t> written_{0};            ///< Lines and records accepted.
+        uint64_t reported_drops_ = 0;                 ///< Drops already reported in the log (writer only).
+        std::atomic<bool> wake_pending_{false};       ///< A producer asked for an early drain.
+        bool stopping_ = false;                       ///< Set by the destructor (guarded by wake_mutex_).
+        uint64_t flush_requested_ = 0;                ///< flush() calls so far (guarded by wake_mutex_).
+        uint64_t flush_completed_ = 0;                ///< flush() requests served (guarded by wake_mutex_).
+        std::mutex wake_mutex_;                       ///< Guards the writer's sleep.
+        std::condition_variable wake_;                ///< Wakes the writer.
+        std::condition_variable flushed_;             ///< Wakes flush() callers.
+        std::string batch_;                           ///< Bytes collected by the writer for one write().
+        std::thread writer_;                          ///< Background writer.
+
+        /**
+         * @brief Returns the ring of the calling thread, registering one on first use.
+         */
+        Ring &local_ring();
+
+        /**
+         * @brief Copies a complete line or record into the caller's ring or counts it as dropped.
+         * @param bytes Line including its newline, or an encoded record.
+         */
+        void enqueue(std::string_view bytes);
+
+        /**
+         * @brief Body of the writer thread.
+         */
+        void writer_loop();
+
+        /**
+         * @brief Moves every queued line into batch_ and writes it out.
+         */
+        void drain();
+    };
+
+} // namespace BattleshipServer
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef CONNECTION_HPP
+#define CONNECTION_HPP
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "event_loop.hpp"
+#include "../../protocol/include/framer.hpp"
+
+namespace BattleshipServer
+{
+
+    /**
+     * @class Connection
+     * @brief Client socket driven by an EventLoop.
+     *
+     * Incoming bytes are split into newline-terminated frames by a fixed-size Framer and
+     * handed to the line callback as views into that buffer, so every frame of pipelined
+     * input is delivered and nothing is copied or allocated per message. A frame that does
+     * not fit the buffer closes the connection. Outgoing data is queued and written by the
+     * backend as the socket accepts it.
+     *
+     * The loop keeps the connection alive while it has I/O in progress, so owners may
+     * drop their reference at any time after calling close(). Connections are created with
+     * EventLoop::make_connection() and must only be used from the loop thread.
+     */
+    class Connection : public std::enable_shared_from_this<Connection>
+    {
+    public:
+        /**
+         * @brief Callback invoked for every complete frame, including the trailing '\n'.
+         *
+         * The view is only valid during the call.
+         */
+        using LineHandler = std::function<void(std::string_view line)>;
+
+        /**
+         * @brief Callback invoked once when the peer disconnects or an I/O error occurs.
+         */
+        using CloseHandler = std::function<void(const std::string &reason)>;
+
+        /**
+         * @brief Destructor. Closes the socket if it is still open.
+         */
+        virtual ~Connection();
+
+        Connection(const Connection &) = delete;
+        Connection &operator=(const Connection &) = delete;
+
+        /**
+         * @brief Installs the callbacks and starts receiving.
+         * @param on_line Frame callback.
+         * @param on_close Disconnect callback.
+         */
+        void open(LineHandler on_line, CloseHandler on_close);
+
+        /**
+         * @brief Queues data for sending.
+         * @param data Bytes to send.
+         */
+        virtual void send(std::string_view data) = 0;
+
+        /**
+         * @brief Closes the connection once the pending output has been flushed.
+         *
+         * No callback is invoked after this call.
+         */
+        virtual void close() = 0;
+
+        /**
+         * @brief Changes how the following incoming frames are delimited.
+         *
+         * Called from the line callback when the wire format is negotiated; frames already
+         * buffered behind the current one are delimited with the new mode.
+         *
+         * @param mode New framing mode.
+         */
+        void set_framing(BattleShipProtocol::Framer::Mode mode) noexcept { input_.set_mode(mode); }
+
+        /**
+         * @brief Returns the socket file descriptor (-1 once closed).
+         * @return File descriptor.
+         */
+        int fd() const noexcept { return fd_; }
+
+        /**
+         * @brief Checks whether the connection is still usable for sending.
+         * @return True until close() is called or the peer goes away.
+         */
+        bool is_open() const noexcept { return fd_ >= 0 && !closing_; }
+
+    protected:
+        /**
+         * @brief Takes ownership of an accepted socket.
+         * @param fd Client socket.
+         */
+        explicit Connection(int fd);
+
+        /**
+         * @brief Registers the socket with the backend. Called by open().
+         */
+        virtual void start() = 0;
+
+        /**
+         * @brief Copies received bytes into the framer and dispatches every complete frame.
+         * @param data Received bytes.
+         * @param size Number of bytes.
+         */
+        void deliver(const char *data, size_t size);
+
+        /**
+         * @brief Dispatches every complete frame buffered in input_.
+         *
+         * Used after receiving directly into input_.write_area(). Shuts the connection
+         * down if a frame exceeds the buffer.
+         */
+        void dispatch_frames();
+
+        /**
+         * @brief Closes the socket immediately, notifying the close handler once.
+         * @param reason Reason passed to the close handler.
+         */
+        virtual void shutdown(const std::string &reason) = 0;
+
+        /**
+         * @brief Invokes the close handler unless close() was requested by the owner.
+         * @param reason Reason passed to the close handler.
+         */
+        void notify_closed(const std::string &reason);
+
+        int fd_;                          ///< Client socket.
+        bool closing_ = false;            ///< True once close() was requested or the socket failed.
+        BattleShipProtocol::Framer input_; ///< Bytes received but not yet dispatched.
+
+    private:
+        LineHandler on_line_;   ///< Frame callback.
+        CloseHandler on_close_; ///< Disconnect callback.
+    };
+
+} // namespace BattleshipServer
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef EPOLL_LOOP_HPP
+#define EPOLL_LOOP_HPP
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "event_loop.hpp"
+#include "connection.hpp"
+
+namespace BattleshipServer
+{
+
+    /**
+     * @class EpollLoop
+     * @brief EventLoop backed by edge-triggered epoll.
+     */
+    class EpollLoop : public EventLoop
+    {
+    public:
+        /**
+         * @brief Creates the epoll instance and registers the internal descriptors.
+         * @throws ServerError if epoll cannot be initialized.
+         */
+        EpollLoop();
+
+        /**
+         * @brief Closes the epoll descriptor.
+         */
+        ~EpollLoop() override;
+
+        void watch(int fd, uint32_t events, EventHandler handler) override;
+        void unwatch(int fd) override;
+        void accept_on(int listen_fd, AcceptHandler handler) override;
+        void stop_accepting(int listen_fd, StoppedHandler stopped) override;
+        std::shared_ptr<Connection> make_connection(int fd) override;
+        void run() override;
+
+    private:
+        /**
+         * @brief Registration of a watched descriptor. Its address is stored in epoll_event::data.
+         */
+        struct Watch
+        {
+            int fd;               ///< Watched descriptor.
+            EventHandler handler; ///< Readiness callback.
+            bool active;          ///< False once unwatched; pending events are ignored.
+        };
+
+        /**
+         * @brief Listening socket registered with accept_on().
+         */
+        struct Acceptor
+        {
+            int fd;                ///< Listening socket.
+            AcceptHandler handler; ///< Accept callback.
+            AcceptRetry retry;     ///< Backoff after a failed accept.
+        };
+
+        int epoll_fd_;                                          ///< epoll instance.
+        std::unordered_map<int, std::unique_ptr<Watch>> watches_; ///< Active registrations by descriptor.
+        std::unordered_map<int, std::shared_ptr<Acceptor>> acceptors_; ///< Listeners by descriptor.
+        std::vector<std::unique_ptr<Watch>> retired_;           ///< Registrations released after the current batch.
+
+        /**
+         * @brief Accepts until the backlog is empty, or schedules a retry if accepting fails.
+         * @param acceptor Listener to drain.
+         */
+        void drain_accepts(const std::shared_ptr<Acceptor> &acceptor);
+    };
+
+    /**
+     * @class EpollConnection
+     * @brief Connection that reads and writes with non-blocking syscalls on epoll readiness.
+     *
+     * Outgoing data is written directly when the socket accepts it and buffered until
+     * EPOLLOUT otherwise.
+     */
+    class EpollConnection : public Connection
+    {
+    public:
+        /**
+         * @brief Wraps an accepted socket.
+         * @param loop Loop that will drive the socket.
+         * @param fd Accepted client socket.
+         */
+        EpollConnection(EpollLoop &loop, int fd);
+
+        void send(std::string_view data) override;
+        void close() override;
+
+    protected:
+        void start() override;
+        void shutdown(const std::string &reason) override;
+
+    private:
+        EpollLoop &loop_;    ///< Owning event loop.
+        std::string output_; ///< Bytes waiting for EPOLLOUT.
+
+        /**
+         * @brief Handles readiness events from the loop.
+         * @param events Epoll event mask.
+         */
+        void handle_events(uint32_t events);
+
+        /**
+         * @brief Reads straight into the framer until EAGAIN and dispatches complete frames.
+         */
+        void handle_read();
+
+        /**
+         * @brief Writes as much of the pending output as the socket accepts.
+         * @return False if the socket failed.
+         */
+        bool flush();
+    };
+
+} // namespace BattleshipServer
+
+#endif
@@ -0,0 +1,266 @@
+#ifndef EVENT_LOOP_HPP
+#define EVENT_LOOP_HPP
+
+#include <sys/epoll.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "timer_wheel.hpp"
+
+namespace BattleshipServer
+{
+
+    class Connection;
+
+    /**
+     * @brief Kernel interface used by the event loops for socket I/O.
+     */
+    enum class IoBackend
+    {
+        EPOLL,   ///< Edge-triggered epoll readiness with non-blocking send/recv.
+        IO_URING ///< io_uring completions: multishot accept/recv, provided buffers, batched submits.
+    };
+
+    /**
+     * @brief Parses a backend name ("epoll" or "io_uring").
+     * @param name Backend name as given on the command line.
+     * @return Matching backend.
+     * @throws ServerError if the name is unknown.
+     */
+    IoBackend io_backend_from_string(const std::string &name);
+
+    /**
+     * @brief Returns the command line name of a backend.
+     * @param backend Backend to convert.
+     * @return "epoll" or "io_uring".
+     */
+    std::string io_backend_to_string(IoBackend backend);
+
+    /**
+     * @class EventLoop
+     * @brief Single-threaded reactor that multiplexes many sockets.
+     *
+     * Concrete loops (EpollLoop, UringLoop) differ in how they talk to the kernel, but all
+     * callbacks they invoke run on the loop thread. Work coming from other threads is
+     * handed over with post(), which wakes the loop through an eventfd. Timers live in a
+     * TimerWheel and a single one-shot timerfd is armed for the next expiry, so an idle
+     * loop does not wake up.
+     */
+    class EventLoop
+    {
+    public:
+        /**
+         * @brief Callback invoked with the readiness mask (EPOLLIN, EPOLLOUT, ...) of a descriptor.
+         */
+        using EventHandler = std::function<void(uint32_t events)>;
+
+        /**
+         * @brief Callback invoked with every socket accepted on a listening descriptor,
+         *        or with -errno when accepting starts failing.
+         *
+         * After a failure the backend retries on a backoff timer instead of spinning on the
+         * connections left in the backlog; the same error is reported again only after an
+         * accept has succeeded.
+         */
+        using AcceptHandler = std::function<void(int client_fd)>;
+
+        /**
+         * @brief Callback invoked once a stopped listener can deliver no more sockets.
+         */
+        using StoppedHandler = std::function<void()>;
+
+        /**
+         * @brief Creates an event loop for the requested backend.
+         * @param backend Kernel interface to use.
+         * @return New event loop.
+         * @throws ServerError if the backend is not available on this kernel.
+         */
+        static std::unique_ptr<EventLoop> create(IoBackend backend);
+
+        /**
+         * @brief Closes the internal descriptors.
+         */
+        virtual ~EventLoop();
+
+        EventLoop(const EventLoop &) = delete;
+        EventLoop &operator=(const EventLoop &) = delete;
+
+        /**
+         * @brief Starts watching a descriptor for readiness.
+         *
+         * Handlers must drain the descriptor (read/accept until EAGAIN) each time they run.
+         * A backend that can no longer poll the descriptor calls the handler once with
+         * EPOLLERR and stops watching it.
+         *
+         * @param fd Descriptor to watch. It should already be non-blocking.
+         * @param events Epoll event mask (EPOLLIN, EPOLLOUT, ...).
+         * @param handler Callback invoked from the loop thread when the descriptor is ready.
+         */
+        virtual void watch(int fd, uint32_t events, EventHandler handler) = 0;
+
+        /**
+         * @brief Stops watching a descriptor. Events already fetched for it are discarded.
+         * @param fd Descriptor to remove. The descriptor itself is not closed.
+         */
+        virtual void unwatch(int fd) = 0;
+
+        /**
+         * @brief Accepts connections on a non-blocking listening socket.
+         * @param listen_fd Listening socket.
+         * @param handler Callback receiving each accepted (non-blocking) client socket.
+         */
+        virtual void accept_on(int listen_fd, AcceptHandler handler) = 0;
+
+        /**
+         * @brief Stops accepting on a listening socket passed to accept_on(). Must be called from the loop thread.
+         *
+         * Connections not yet accepted stay in the socket's backlog. The socket itself is
+         * not closed. A backend that accepts asynchronously may still hand sockets accepted
+         * before the stop to the AcceptHandler; stopped runs on the loop thread after the
+         * last of them, so nothing reaches the handler once it has run.
+         *
+         * @param listen_fd Listening socket.
+         * @param stopped Callback run once no more sockets can be delivered (may be empty).
+         */
+        virtual void stop_accepting(int listen_fd, StoppedHandler stopped) = 0;
+
+        /**
+         * @brief Wraps an accepted client socket in a Connection driven by this loop.
+         * @param fd Client socket. Ownership passes to the connection.
+         * @return New, not yet opened, connection.
+         */
+        virtual std::shared_ptr<Connection> make_connection(int fd) = 0;
+
+        /**
+         * @brief Runs the loop on the calling thread until stop() is called.
+         */
+        virtual void run() = 0;
+
+        /**
+         * @brief Queues a task to run on the loop thread. Safe to call from any thread.
+         * @param task Task to execute.
+         */
+        void post(std::function<void()> task);
+
+        /**
+         * @brief Handle of a timer scheduled with run_after(). 0 means "no timer".
+         */
+        using TimerId = TimerWheel::TimerId;
+
+        /**
+         * @brief Schedules a one-shot callback on the loop thread. Must be called from the loop thread.
+         * @param delay Time until the callback runs (millisecond precision).
+         * @param fn Callback to invoke.
+         * @return Handle to pass to cancel_timer().
+         */
+        TimerId run_after(std::chrono::milliseconds delay, std::function<void()> fn);
+
+        /**
+         * @brief Cancels a timer that has not fired yet. Must be called from the loop thread.
+         * @param id Handle returned by run_after(). Stale handles are ignored.
+         * @return True if the timer was pending.
+         */
+        bool cancel_timer(TimerId id);
+
+        /**
+         * @brief Asks the loop to return from run(). Safe to call from any thread.
+         */
+        void stop();
+
+        /**
+         * @brief Checks whether the caller is running on the loop thread.
+         * @return True if called from inside run().
+         */
+        bool in_loop_thread() const noexcept { return loop_thread_ == std::this_thread::get_id(); }
+
+    protected:
+        /**
+         * @brief Creates the wakeup eventfd and the timer timerfd.
+         * @throws ServerError if any of the descriptors cannot be created.
+         */
+        EventLoop();
+
+        /**
+         * @brief Watches the wakeup and timer descriptors. Called by the derived constructor.
+         */
+        void watch_internal_fds();
+
+        /**
+         * @brief Retry state of a listener whose accepts are failing (EMFILE, ENFILE, ENOBUFS, ...).
+         */
+        struct AcceptRetry
+        {
+            TimerId timer = 0;                  ///< Pending retry (0 if none).
+            std::chrono::milliseconds delay{0}; ///< Delay of the last retry (0 while accepts succeed).
+            int error = 0;                      ///< errno last reported (0 while accepts succeed).
+
+            /**
+             * @brief Resets the backoff after a successful accept.
+             */
+            void succeeded() noexcept
+            {
+                delay = std::chrono::milliseconds{0};
+                error = 0;
+            }
+        };
+
+        static constexpr std::chrono::milliseconds ACCEPT_RETRY_MIN{10};   ///< First retry after a failed accept.
+        static constexpr std::chrono::milliseconds ACCEPT_RETRY_MAX{1000}; ///< Cap of the doubling retry delay.
+
+        /**
+         * @brief Schedules the next accept attempt of a failing listener. Must be called from the loop thread.
+         *
+         * Does nothing if a retry is already pending. Otherwise the delay doubles from
+         * ACCEPT_RETRY_MIN up to ACCEPT_RETRY_MAX, and the error reaches the handler only if
+         * it differs from the one last reported.
+         *
+         * @param retry Retry state of the listener. Must outlive the timer or cancel it.
+         * @param error errno of the failed accept.
+         * @param handler Accept handler of the listener.
+         * @param resume Restarts accepting on the listener when the timer fires.
+         */
+        void defer_accept(AcceptRetry &retry, int error, const AcceptHandler &handler, std::function<void()> resume);
+
+        /**
+         * @brief Arms the timerfd for the next wheel expiry. Called by run() after each batch.
+         */
+        void rearm_timer();
+
+        int wakeup_fd_;                    ///< eventfd used by post() and stop().
+        int timer_fd_;                     ///< One-shot timerfd armed for the next timer.
+        std::atomic<bool> running_{false}; ///< Loop running flag.
+        std::thread::id loop_thread_;      ///< Thread currently inside run().
+
+    private:
+        std::vector<std::function<void()>> pending_;   ///< Tasks queued by post().
+        std::vector<std::function<void()>> draining_;  ///< Tasks being run by run_pending() (loop thread).
+        std::mutex pending_mutex_;                     ///< Mutex for the task queue.
+        TimerWheel timers_;                            ///< Pending timers, in CLOCK_MONOTONIC milliseconds.
+        uint64_t armed_expiry_ = 0;                    ///< Expiry the timerfd is armed for (0 = disarmed).
+
+        /**
+         * @brief Runs every task queued with post().
+         */
+        void run_pending();
+
+        /**
+         * @brief Fires the expired timers.
+         */
+        void run_timers();
+
+        /**
+         * @brief Returns the CLOCK_MONOTONIC time in milliseconds.
+         * @return Current time.
+         */
+        static uint64_t now_ms();
+    };
+
+} // namespace BattleshipServer
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef FLOW_HPP
+#define FLOW_HPP
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+namespace BattleshipServer
+{
+
+    /**
+     * @class Flow
+     * @brief Coroutine that runs a session's state machine as straight-line code.
+     *
+     * A Flow is created suspended and runs only when it is started or when one of the
+     * awaitables it is waiting on resumes it, always on the thread that does so. A Flow
+     * can co_await another Flow: the inner one runs in place and the outer one resumes
+     * where it left off when it ends, rethrowing its exception if it had one. While
+     * suspended, a flow costs its coroutine frame and nothing else; destroying the
+     * outermost Flow releases the frames of every Flow it is awaiting.
+     */
+    class Flow
+    {
+    public:
+        /**
+         * @brief Coroutine state shared by the frame and its Flow object.
+         */
+        struct promise_type
+        {
+            std::coroutine_handle<> continuation; ///< Flow awaiting this one (null for the outermost).
+            std::exception_ptr error;             ///< Exception that ended the coroutine.
+
+            Flow get_return_object() noexcept { return Flow(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { error = std::current_exception(); }
+
+            /**
+             * @brief Hands control back to the awaiting Flow, or to whoever resumed the outermost one.
+             */
+            struct FinalAwaiter
+            {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> self) noexcept
+                {
+                    auto next = self.promise().continuation;
+                    return next ? next : std::noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+
+            FinalAwaiter final_suspend() noexcept { return {}; }
+        };
+
+        Flow() = default;
+
+        Flow(Flow &&other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+
+        Flow &operator=(Flow &&other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                handle_ = std::exchange(other.handle_, {});
+            }
+            return *this;
+        }
+
+        Flow(const Flow &) = delete;
+        Flow &operator=(const Flow &) = delete;
+
+        /**
+         * @brief Destroys the frame, wherever the coroutine is suspended.
+         */
+        ~Flow() { reset(); }
+
+        /**
+         * @brief Runs the coroutine up to its first suspension.
+         * @throws Whatever the coroutine threw if it ended before suspending.
+         */
+        void start()
+        {
+            handle_.resume();
+            rethrow();
+        }
+
+        /**
+         * @brief Rethrows the exception that ended the coroutine, if any.
+         *
+         * Called after resuming a Flow it awaits, since the exception surfaces in the
+         * outermost frame and not in the resumer.
+         */
+        void rethrow() const
+        {
+            if (handle_ && handle_.done() && handle_.promise().error)
+            {
+                std::rethrow_exception(handle_.promise().error);
+            }
+        }
+
+        /**
+         * @brief Returns true if the coroutine ran to its end.
+         */
+        bool done() const noexcept { return !handle_ || handle_.done(); }
+
+        bool await_ready() const noexcept { return done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            handle_.promise().continuation = awaiting;
+            return handle_;
+        }
+
+        void await_resume() const
+        {
+            if (handle_ && handle_.promise().error)
+            {
+                std::rethrow_exception(handle_.promise().error);
+            }
+        }
+
+    private:
+        std::coroutine_handle<promise_type> handle_; ///< Owned frame (null once moved from).
+
+        explicit Flow(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+        void reset() noexcept
+        {
+            if (handle_)
+            {
+                handle_.destroy();
+                handle_ = {};
+            }
+        }
+    };
+
+} // namespace BattleshipServer
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef HDR_HISTOGRAM_HPP
+#define HDR_HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace BattleshipServer
+{
+
+    /**
+     * @class HdrHistogram
+     * @brief Fixed-memory histogram with constant relative precision (HDR layout).
+     *
+     * Values are counted in buckets that double in width, each split into 64 linear
+     * sub-buckets, so any value is stored with an error below 1/64 (about 1.6%) of
+     * itself. Values from 0 to MAX_VALUE (2^36 - 1, about 68.7 s in nanoseconds) fit
+     * in COUNTS counters; larger values are clamped to MAX_VALUE. Recording is a shift,
+     * a count-leading-zeros and one increment, with no allocation.
+     *
+     * Counters are atomics written with relaxed loads and stores: one thread records,
+     * any thread may read or merge_into() at the same time and sees a slightly older
+     * state. Merging the histograms of several threads gives the histogram of all the
+     * samples, with the same precision.
+     */
+    class HdrHistogram
+    {
+    public:
+        static constexpr unsigned SUB_BUCKET_BITS = 7;                                 ///< log2 of the sub-buckets of a bucket.
+        static constexpr unsigned SUB_BUCKET_HALF = 1u << (SUB_BUCKET_BITS - 1);       ///< Sub-buckets each bucket after the first adds.
+        static constexpr unsigned MAX_VALUE_BITS = 36;                                 ///< Bits of the largest value kept.
+        static constexpr uint64_t MAX_VALUE = (uint64_t(1) << MAX_VALUE_BITS) - 1;     ///< Largest value kept; larger ones are clamped.
+        static constexpr size_t COUNTS = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 2) * SUB_BUCKET_HALF; ///< Number of counters.
+
+        /**
+         * @brief Counts one sample. Only one thread may record into a histogram.
+         * @param value Sample (clamped to MAX_VALUE).
+         */
+        void record(uint64_t value) noexcept;
+
+        /**
+         * @brief Adds every sample of this histogram to another one.
+         *
+         * The target must not be recorded into by another thread meanwhile.
+         *
+         * @param target Histogram receiving the samples.
+         */
+        void merge_into(HdrHistogram &target) const noexcept;
+
+        /**
+         * @brief Forgets every sample. No thread may record meanwhile.
+         */
+        void reset() noexcept;
+
+        /**
+         * @brief Returns the number of samples.
+         */
+        uint64_t count() const noexcept { return total_.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Returns the sum of the samples as recorded (after clamping).
+         */
+        uint64_t sum() const noexcept { return sum_.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Returns the largest sample (exact), or 0 without samples.
+         */
+        uint64_t max() const noexcept { return max_.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Returns the mean of the samples, or 0 without samples.
+         */
+        double mean() const noexcept;
+
+        /**
+         * @brief Returns the value below or at which a percentage of the samples fall.
+         *
+         * The result is the highest value of the sub-bucket holding that sample (never
+         * above max()), so it overstates the exact percentile by less than 1/64.
+         *
+         * @param percentile Percentage in [0, 100] (99.9 for p99.9).
+         * @return Value at the percentile, or 0 without samples.
+         */
+        uint64_t value_at_percentile(double percentile) const noexcept;
+
+        /**
+         * @brief Returns the number of samples in the sub-buckets up to the one holding a value.
+         * @param value Upper bound (its sub-bucket is included whole).
+         */
+        uint64_t count_at_or_below(uint64_t value) const noexcept;
+
+        /**
+         * @brief Returns the counter a value is recorded in.
+         * @param value Sample (at most MAX_VALUE).
+         */
+        static size_t index_of(uint64_t value) noexcept;
+
+        /**
+         * @brief Returns the smallest value recorded in a counter.
+         * @param index Counter index.
+         */
+        static uint64_t lowest_equivalent(size_t index) noexcept;
+
+        /**
+         * @brief Returns the largest value recorded in a counter.
+         * @param index Counter index.
+         */
+        static uint64_t highest_equivalent(size_t index) noexcept;
+
+    private:
+        std::array<std::atomic<uint64_t>, COUNTS> counts_{}; ///< Samples per sub-bucket.
+        std::atomic<uint64_t> total_{0};                     ///< Number of samples.
+        std::atomic<uint64_t> sum_{0};                       ///< Sum of the samples.
+        std::atomic<uint64_t> max_{0};                       ///< Largest sample.
+    };
+
+} // namespace BattleshipServer
+
+#endif
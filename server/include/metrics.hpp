@@ -0,0 +1,200 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "hdr_histogram.hpp"
+#include "../../protocol/include/protocol.hpp"
+#include "../../protocol/include/phase_state.hpp"
+
+namespace BattleshipServer
+{
+
+    /**
+     * @brief Monotonic event counters of the server.
+     */
+    enum class Counter : uint8_t
+    {
+        SESSIONS_STARTED,  ///< Sessions created for a pair of clients.
+        SESSIONS_FINISHED, ///< Sessions whose last strand task ran.
+        PARSE_ERRORS,      ///< Frames that could not be parsed (the session ends).
+        TURN_TIMEOUTS,     ///< Turns lost because the player did not shoot in time.
+        DISCONNECTS,       ///< Players that went away before the match ended.
+        COUNT              ///< Number of counters.
+    };
+
+    /**
+     * @brief Processing stages whose latency is recorded.
+     */
+    enum class Stage : uint8_t
+    {
+        PARSE,         ///< Parsing a received frame (event loop).
+        GAME_LOGIC,    ///< Running one strand task of the state machine (workers).
+        SEND,          ///< Handing the messages of one Outbox to the connections (event loop).
+        STRAND_WAIT,   ///< From posting a strand task to a worker starting it (scheduling delay).
+        PROCESS_SHOT,  ///< GameLogic::process_shot() of one shot.
+        GET_STATUS,    ///< Building the STATUS or STATUS_DELTA of one player.
+        BUILD_MESSAGE, ///< Encoding one outgoing message.
+        TURN,          ///< From a SHOOT frame arriving to both STATUS messages handed to the sockets.
+        COUNT          ///< Number of stages.
+    };
+
+    /**
+     * @class Metrics
+     * @brief Counters, gauges and latency histograms of the server, sharded per thread.
+     *
+     * Every thread that records something gets its own Shard, registered the first time
+     * it records and found again through a thread-local cache, the same way AsyncLogger
+     * hands out its rings. A shard is written only by its thread, with relaxed loads and
+     * stores on its own cache lines, so recording never contends with another thread and
+     * never locks. A read sums every shard; values are exact once the writers are quiet
+     * and at most a few events behind while they run.
+     *
+     * Stage latencies go to an HdrHistogram per shard: fixed memory, about 1.6%
+     * precision from nanoseconds to a minute, merged on read so percentiles up to
+     * p99.9 cover every thread. render() writes the Prometheus text exposition format.
+     */
+    class Metrics
+    {
+    public:
+        static constexpr size_t MESSAGE_TYPES = static_cast<size_t>(BattleShipProtocol::MessageType::RESYNC) + 1; ///< Labels of the message counters.
+        static constexpr size_t PHASES = static_cast<size_t>(BattleShipProtocol::PhaseState::Phase::FINISHED) + 1; ///< Labels of the phase gauge.
+        static constexpr size_t COUNTERS = static_cast<size_t>(Counter::COUNT);                                  ///< Number of Counter values.
+        static constexpr size_t STAGES = static_cast<size_t>(Stage::COUNT);                                      ///< Number of Stage values.
+
+        /**
+         * @brief Upper bounds, in microseconds, of the Prometheus buckets rendered from the latency histograms.
+         */
+        static constexpr std::array<uint64_t, 16> LATENCY_BOUNDS_US = {1, 2, 5, 10, 20, 50, 100, 200, 500,
+                                                                       1000, 2000, 5000, 10000, 50000, 100000, 1000000};
+
+        Metrics();
+        ~Metrics();
+
+        Metrics(const Metrics &) = delete;
+        Metrics &operator=(const Metrics &) = delete;
+
+        /**
+         * @brief Adds to a counter.
+         * @param counter Counter to increase.
+         * @param amount Increment.
+         */
+        void add(Counter counter, uint64_t amount = 1);
+
+        /**
+         * @brief Counts a message received from a player.
+         * @param type Type of the parsed message.
+         * @param bytes Bytes of the frame on the wire.
+         */
+        void message_in(BattleShipProtocol::MessageType type, size_t bytes);
+
+        /**
+         * @brief Counts a message sent to a player.
+         * @param type Type of the message.
+         * @param bytes Bytes of the encoded message.
+         */
+        void message_out(BattleShipProtocol::MessageType type, size_t bytes);
+
+        /**
+         * @brief Counts one more session in a phase of the phase gauge.
+         * @param phase Phase a session entered.
+         */
+        void enter_phase(BattleShipProtocol::PhaseState::Phase phase);
+
+        /**
+         * @brief Counts one session less in a phase of the phase gauge.
+         *
+         * May run on another thread than the matching enter_phase(): the gauge is the
+         * sum over every shard.
+         *
+         * @param phase Phase a session left.
+         */
+        void leave_phase(BattleShipProtocol::PhaseState::Phase phase);
+
+        /**
+         * @brief Records the duration of one pass through a stage in the caller's HdrHistogram.
+         * @param stage Stage measured.
+         * @param elapsed Time spent (nanosecond resolution, up to about 68 s).
+         */
+        void observe(Stage stage, std::chrono::nanoseconds elapsed);
+
+        /**
+         * @brief Returns the sum of a counter over every shard.
+         */
+        uint64_t counter(Counter counter) const;
+
+        /**
+         * @brief Returns the messages and bytes received (inbound) or sent for one type.
+         * @param type Message type.
+         * @param inbound True for received messages, false for sent ones.
+         * @return Pair of message count and byte count.
+         */
+        std::pair<uint64_t, uint64_t> messages(BattleShipProtocol::MessageType type, bool inbound) const;
+
+        /**
+         * @brief Returns the number of sessions currently in a phase.
+         */
+        int64_t sessions_in(BattleShipProtocol::PhaseState::Phase phase) const;
+
+        /**
+         * @brief Merges the latency histograms of every shard for a stage.
+         * @param stage Stage to read.
+         * @param out Empty histogram receiving the samples, in nanoseconds.
+         */
+        void histogram(Stage stage, HdrHistogram &out) const;
+
+        /**
+         * @brief Summarizes the latencies of a stage: count, mean, p50, p90, p99, p99.9 and max.
+         * @param stage Stage to summarize.
+         * @return Text such as "count=880 mean=12.1us p50=10.9us ... max=1.2ms".
+         */
+        std::string latency_summary(Stage stage) const;
+
+        /**
+         * @brief Returns the label of a stage ("parse", "turn", ...).
+         */
+        static std::string_view stage_name(Stage stage) noexcept;
+
+        /**
+         * @brief Returns the label of a phase ("registration", "placement", "playing", "finished").
+         */
+        static std::string_view phase_name(BattleShipProtocol::PhaseState::Phase phase) noexcept;
+
+        /**
+         * @brief Appends every metric in the Prometheus text format.
+         * @param out Buffer the metrics are appended to.
+         */
+        void render(std::string &out) const;
+
+        /**
+         * @brief Appends one gauge that is not sharded (its owner reads it) in the Prometheus text format.
+         * @param out Buffer the gauge is appended to.
+         * @param name Metric name.
+         * @param help Description.
+         * @param value Current value.
+         */
+        static void render_gauge(std::string &out, std::string_view name, std::string_view help, int64_t value);
+
+    private:
+        struct Shard;
+
+        uint64_t id_;                                ///< Key of these metrics in the thread-local shard cache.
+        std::vector<std::unique_ptr<Shard>> shards_; ///< One shard per recording thread.
+        mutable std::mutex shards_mutex_;            ///< Guards shards_ (registration and reads).
+
+        /**
+         * @brief Returns the shard of the calling thread, registering one on first use.
+         */
+        Shard &local_shard();
+    };
+
+} // namespace BattleshipServer
+
+#endif
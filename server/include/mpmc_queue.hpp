@@ -0,0 +1,150 @@
+#ifndef MPMC_QUEUE_HPP
+#define MPMC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace BattleshipServer
+{
+
+    /**
+     * @class MpmcQueue
+     * @brief Bounded lock-free queue for any number of producers and consumers.
+     *
+     * Array of cells with a sequence number each (Vyukov's bounded MPMC queue). A
+     * producer claims a slot with one compare-and-swap on the enqueue position and
+     * publishes it by advancing the cell's sequence; a consumer does the same on the
+     * dequeue position. Producers and consumers only meet on the cell they share, so
+     * neither side waits for the other and neither takes a lock.
+     *
+     * @tparam T Element type; must be default constructible and move assignable.
+     */
+    template <typename T>
+    class MpmcQueue
+    {
+    public:
+        /**
+         * @brief Allocates the cells.
+         * @param capacity Maximum number of queued elements, rounded up to a power of two (at least 2).
+         */
+        explicit MpmcQueue(size_t capacity)
+        {
+            size_t size = 2;
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+            mask_ = size - 1;
+            cells_ = std::make_unique<Cell[]>(size);
+            for (size_t i = 0; i < size; ++i)
+            {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MpmcQueue(const MpmcQueue &) = delete;
+        MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+        /**
+         * @brief Appends an element unless the queue is full.
+         * @param value Element; moved from only if the push succeeds.
+         * @return False if the queue is full.
+         */
+        bool try_push(T &&value)
+        {
+            size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+            Cell *cell;
+            while (true)
+            {
+                cell = &cells_[pos & mask_];
+                size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+                if (diff == 0)
+                {
+                    // Celda libre en esta vuelta: se reclama avanzando la posición de escritura.
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    // La celda aún guarda el elemento de la vuelta anterior: cola llena.
+                    return false;
+                }
+                else
+                {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            cell->value = std::move(value);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Removes the oldest element unless the queue is empty.
+         * @param value Receives the element.
+         * @return False if the queue is empty.
+         */
+        bool try_pop(T &value)
+        {
+            size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+            Cell *cell;
+            while (true)
+            {
+                cell = &cells_[pos & mask_];
+                size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+                if (diff == 0)
+                {
+                    if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = dequeue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            value = std::move(cell->value);
+            // La celda queda libre para la escritura de la vuelta siguiente.
+            cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Returns the maximum number of queued elements.
+         */
+        size_t capacity() const noexcept { return mask_ + 1; }
+
+    private:
+        /**
+         * @brief Slot of the ring.
+         *
+         * sequence == position: free for the producer of that position;
+         * sequence == position + 1: holds the element for its consumer.
+         */
+        struct Cell
+        {
+            std::atomic<size_t> sequence{0}; ///< Turn of the cell.
+            T value{};                       ///< Stored element.
+        };
+
+        std::unique_ptr<Cell[]> cells_;              ///< Ring of cells.
+        size_t mask_ = 0;                            ///< Capacity - 1.
+        alignas(64) std::atomic<size_t> enqueue_pos_{0}; ///< Next position to write (own cache line).
+        alignas(64) std::atomic<size_t> dequeue_pos_{0}; ///< Next position to read (own cache line).
+    };
+
+} // namespace BattleshipServer
+
+#endif
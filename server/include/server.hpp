@@ -2,18 +2,38 @@
 #define SERVER_HPP
 
 #include <sys/socket.h>
+#include <sys/types.h>
 #include <netinet/in.h>
 #include <string>
 #include <memory>
-#include <fstream>
 #include <thread>
 #include <mutex>
-#include <queue>
 #include <atomic>
 #include <map>
+#include <unordered_map>
 #include <functional>
+#include <deque>
+#include <vector>
+#include <chrono>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <list>
+#include <memory_resource>
+#include "event_loop.hpp"
+#include "connection.hpp"
+#include "async_logger.hpp"
+#include "worker_pool.hpp"
+#include "mpmc_queue.hpp"
+#include "slot_map.hpp"
+#include "slab_pool.hpp"
+#include "metrics.hpp"
+#ifdef BATTLESHIP_COROUTINES
+#include "flow.hpp"
+#endif
 #include "../../protocol/include/protocol.hpp"
 #include "../../protocol/include/game_logic.hpp"
+#include "../../protocol/include/journal.hpp"
 
 namespace BattleshipServer
 {
@@ -35,21 +55,109 @@ namespace BattleshipServer
     /**
      * @class GameSession
      * @brief Manages a single Battleship game session between two players.
+     *
+     * The session is split between two threads of control. Its sockets and turn timer
+     * belong to the EventLoop it is bound to: the loop frames and parses what players
+     * send and switches the framing on HELLO. The state machine runs as tasks on a
+     * Strand of the shared WorkerPool: every parsed message, disconnection and timer
+     * expiry is posted there and dispatched according to the current PhaseState::Phase,
+     * so the session's events stay serialized without a lock while the game work of
+     * many sessions is balanced across the workers.
+     *
+     * A strand task does not touch the sockets. It collects what it sends, journals and
+     * schedules in an Outbox, which is handed back to the loop in one post() when the
+     * task ends.
+     *
+     * Built with BATTLESHIP_COROUTINES (C++20), the phases are written as one Flow
+     * coroutine that awaits each player's messages with receive() instead of being
+     * dispatched per message; the flow is resumed by the same strand tasks.
+     *
+     * Memory: sessions come from a shared SlabPool and embed their GameLogic. What the
+     * strand allocates while the match runs (player slots, inboxes, Outbox buffers)
+     * comes from a per-session arena that starts inside the session object and is
+     * released in one piece with it. Outboxes and status buffers are reused from turn
+     * to turn, so a match in progress rarely reaches the global heap.
      */
     class GameSession
     {
     public:
+        /**
+         * @brief Logging callback with signature (client_ip, query, response, level).
+         */
+        using LogFn = std::function<void(const std::string &, const std::string &, const std::string &, const std::string &)>;
+
+        /**
+         * @brief Journal callback; the session fills in type, session, player and payload, the callee the time.
+         *
+         * Invoked on the loop thread, so one session's records keep their order.
+         */
+        using JournalFn = std::function<void(BattleShipProtocol::JournalRecord &)>;
+
+        /**
+         * @brief Completion callback, invoked once by the last task of the session's strand.
+         *
+         * Neither the loop nor the workers use the session after it returns, so the
+         * callee may hand the session to another thread for destruction.
+         */
+        using FinishedFn = std::function<void()>;
+
+        /**
+         * @brief What the admin socket can read or do on a live session.
+         */
+        enum class AdminRequest : uint8_t
+        {
+            SUMMARY,  ///< One line: phase, players, turns played and age of the current turn.
+            BOARDS,   ///< Both boards as GameLogic holds them, one row per line.
+            TERMINATE ///< Tell both players and end the match.
+        };
+
+        /**
+         * @brief Receives the text of an admin request. Runs on a worker.
+         */
+        using AdminReply = std::function<void(std::string text)>;
+
+        /**
+         * @brief Default time a player has to shoot before losing the turn.
+         */
+        static constexpr std::chrono::milliseconds DEFAULT_TURN_TIMEOUT{30000};
+
         /**
          * @brief Constructs a new GameSession with a unique session ID.
          * @param session_id Unique identifier for the session.
+         * @param loop Event loop that drives the session sockets.
+         * @param pool Workers that run the session state machine.
+         * @param metrics Server metrics the session records its traffic, phases and stage latencies in.
+         * @param turn_timeout Time each player has to shoot in this match.
          */
-        explicit GameSession(int session_id);
+        GameSession(int session_id, EventLoop &loop, WorkerPool &pool, Metrics &metrics,
+                    std::chrono::milliseconds turn_timeout = DEFAULT_TURN_TIMEOUT);
 
         /**
-         * @brief Destructor. Ensures the session thread is joined.
+         * @brief Destructor. Releases the connections still held by the session.
          */
         ~GameSession();
 
+        GameSession(const GameSession &) = delete;
+        GameSession &operator=(const GameSession &) = delete;
+
+        /**
+         * @brief Takes the memory of a session from the session SlabPool.
+         * @param size Size of the object (sizeof(GameSession)).
+         */
+        static void *operator new(size_t size);
+
+        /**
+         * @brief Returns the memory of a session to the session SlabPool.
+         * @param ptr Session memory.
+         * @param size Size of the object.
+         */
+        static void operator delete(void *ptr, size_t size) noexcept;
+
+        /**
+         * @brief Returns the pool that sessions are allocated from.
+         */
+        static SlabPool &memory_pool();
+
         /**
          * @brief Adds a player to the game session.
          * @param player_id ID of the player (1 or 2).
@@ -59,12 +167,17 @@ namespace BattleshipServer
         void add_player(int player_id, int client_fd, const std::string &client_ip);
 
         /**
-         * @brief Starts the game session thread.
+         * @brief Starts the session on its event loop and sends PLAYER_ID to both players.
+         *
+         * With a journal, shots, phase changes and statuses are recorded there and the
+         * text log no longer carries a full STATUS per turn.
+         *
          * @param protocol Reference to the game protocol.
          * @param log_fn Logging function for game events.
+         * @param journal_fn Game-event journal (empty to log every status as text).
+         * @param finished_fn Completion callback (may be empty).
          */
-        void start(const BattleShipProtocol::Protocol &protocol,
-                   std::function<void(const std::string &, const std::string &, const std::string &, const std::string &)> log_fn);
+        void start(const BattleShipProtocol::Protocol &protocol, LogFn log_fn, JournalFn journal_fn = {}, FinishedFn finished_fn = {});
 
         /**
          * @brief Gets the IP address of a given player.
@@ -87,6 +200,9 @@ namespace BattleshipServer
 
         /**
          * @brief Checks if the session is finished.
+         *
+         * Set by the last task of the strand, right before the completion callback runs.
+         *
          * @return True if finished, false otherwise.
          */
         bool is_finished() const noexcept { return finished_; }
@@ -98,44 +214,453 @@ namespace BattleshipServer
          */
         int get_client_fd(int player_id) const;
 
+        /**
+         * @brief Returns the event loop that drives the session sockets.
+         */
+        EventLoop &loop() const noexcept { return loop_; }
+
+        /**
+         * @brief Answers an admin request on the session strand, between two game events.
+         *
+         * Must be called on the session's loop thread. Posted from there, the task runs
+         * before the final strand task of the session, so the session is still alive.
+         *
+         * @param request What to read or do.
+         * @param reply Receives the answer; not called if this returns false.
+         * @return False if the session already closed its connections.
+         */
+        bool admin(AdminRequest request, AdminReply reply);
+
     private:
-        int session_id_;                                                                                                 ///< Unique ID for the session.
-        std::map<int, std::pair<int, std::string>> players_;                                                             ///< Map of player ID to (socket, IP).
-        std::unique_ptr<BattleShipProtocol::GameLogic> game_;                                                            ///< Game logic handler.
-        std::thread session_thread_;                                                                                     ///< Thread running the game session.
-        std::atomic<bool> finished_{false};                                                                              ///< Flag to indicate if the session is over.
-        BattleShipProtocol::Protocol protocol_;                                                                          ///< Communication protocol.
-        std::function<void(const std::string &, const std::string &, const std::string &, const std::string &)> log_fn_; ///< Logging function.
-        std::chrono::time_point<std::chrono::steady_clock> turn_start_time_;                                             ///< Start time of current turn.
-        static constexpr int TURN_TIMEOUT_SECONDS = 30;                                                                  ///< Timeout for player turn in seconds.
+        /**
+         * @brief Bytes of the session arena kept inside the session object.
+         *
+         * Enough for both player slots, their inboxes and a few Outboxes; a session that
+         * needs more continues in blocks taken from the heap.
+         */
+        static constexpr size_t ARENA_BYTES = 4096;
+
+        /**
+         * @brief Message waiting in a player's inbox, with the arrival of its frame.
+         */
+        struct Queued
+        {
+            BattleShipProtocol::Message msg;                 ///< Parsed message.
+            std::chrono::steady_clock::time_point received;  ///< When its frame was read on the loop.
+        };
 
         /**
-         * @brief Main loop for handling the game session.
+         * @brief Per-player connection state.
          *
-         * This function runs the core game logic between the two players. It handles turns,
-         * communication, timeouts, and game flow using the provided protocol and logs each interaction.
+         * fd, connection and binary_in belong to the loop thread; the rest to the strand.
+         */
+        struct PlayerSlot
+        {
+            /**
+             * @brief Creates an empty slot whose inbox grows in the session arena.
+             * @param arena Session memory resource.
+             */
+            explicit PlayerSlot(std::pmr::memory_resource *arena) : inbox(arena) {}
+
+            int fd = -1;                                            ///< Client socket.
+            std::string ip;                                         ///< Client IP address.
+            std::shared_ptr<Connection> connection;                 ///< Non-blocking socket wrapper.
+            bool binary_in = false;                                 ///< Frames from the player use the binary format.
+            std::pmr::deque<Queued> inbox;                          ///< Messages waiting for the player's phase or turn.
+            bool binary_out = false;                                ///< Messages to the player use the binary format.
+            bool deltas = false;                                    ///< Player accepts STATUS_DELTA.
+            bool status_synced = false;                             ///< A full STATUS was sent since the last RESYNC.
+            uint32_t status_seq = 0;                                ///< Sequence of the last STATUS_DELTA sent.
+            std::array<BattleShipProtocol::CellState, 100> sent_own{};      ///< Own board as last sent.
+            std::array<BattleShipProtocol::CellState, 100> sent_opponent{}; ///< Opponent board as last sent.
+            BattleShipProtocol::StatusData status{};                ///< Last full STATUS built; its boards are reused.
+            BattleShipProtocol::StatusDeltaData delta{};            ///< Last STATUS_DELTA built; its vectors are reused.
+        };
+
+        /**
+         * @brief Encoded message of an Outbox: a slice of Outbox::data.
+         */
+        struct Send
+        {
+            int player;    ///< Destination player.
+            size_t offset; ///< First byte in Outbox::data.
+            size_t length; ///< Bytes of the message.
+        };
+
+        /**
+         * @brief Effects of a strand task that must be applied on the loop thread.
          *
-         * @param protocol Reference to the communication protocol used for parsing and sending messages.
-         * @param log_fn Callback function to log events with signature (client_ip, query, response, level).
+         * Allocated in the session arena and recycled: the loop clears an applied Outbox
+         * and hands it back through spare_outboxes_, keeping the capacity of its buffers.
+         * Messages are encoded straight into data, one after the other.
          */
-        void run_session(const BattleShipProtocol::Protocol &protocol,
-                         std::function<void(const std::string &, const std::string &, const std::string &, const std::string &)> log_fn);
+        struct Outbox
+        {
+            /**
+             * @brief Creates an empty Outbox whose vectors grow in the session arena.
+             * @param arena Session memory resource.
+             */
+            explicit Outbox(std::pmr::memory_resource *arena) : sends(arena), journal(arena), turns_started(arena) {}
+
+            std::string data;                                            ///< Encoded messages, back to back.
+            std::pmr::vector<Send> sends;                                ///< Messages in data, in order.
+            std::pmr::vector<BattleShipProtocol::JournalRecord> journal; ///< Journal records, in order.
+            bool rearm_timer = false;                                    ///< Replace the turn timer with one for timer_deadline.
+            uint64_t turn_generation = 0;                                ///< Turn the timer belongs to.
+            std::chrono::steady_clock::time_point timer_deadline;        ///< When the turn timer fires.
+            std::pmr::vector<std::chrono::steady_clock::time_point> turns_started; ///< Arrival of each SHOOT whose STATUS messages are here.
+            bool close = false;                                          ///< Close both connections and finish.
+            Outbox *next = nullptr;                                      ///< Link while the Outbox is spare.
+
+            bool empty() const noexcept { return sends.empty() && journal.empty() && !rearm_timer && !close; }
 
+            /**
+             * @brief Empties the Outbox, keeping the capacity of its vectors.
+             */
+            void clear() noexcept
+            {
+                data.clear();
+                sends.clear();
+                journal.clear();
+                rearm_timer = false;
+                turns_started.clear();
+                close = false;
+            }
+        };
+
+        int session_id_;                                                     ///< Unique ID for the session.
+        EventLoop &loop_;                                                    ///< Loop that owns the session sockets.
+        std::shared_ptr<Strand> strand_;                                     ///< Serializes the state machine on the pool.
+        Metrics &metrics_;                                                   ///< Server metrics (sharded per thread).
+        BattleShipProtocol::PhaseState::Phase metered_phase_ = BattleShipProtocol::PhaseState::Phase::REGISTRATION; ///< Phase the session counts in (strand).
+        alignas(std::max_align_t) std::array<std::byte, ARENA_BYTES> arena_buffer_; ///< First block of the arena.
+        std::pmr::monotonic_buffer_resource arena_;                          ///< Session arena; released with the session.
+        std::pmr::unsynchronized_pool_resource pool_;                        ///< Reuses freed arena blocks; used by the strand only.
+        std::pmr::list<Outbox> outboxes_;                                    ///< Every Outbox of the session (strand).
+        Outbox *outbox_;                                                     ///< Output of the running strand task.
+        Outbox *free_outboxes_ = nullptr;                                    ///< Spare Outboxes already taken by the strand.
+        std::atomic<Outbox *> spare_outboxes_{nullptr};                      ///< Outboxes the loop has applied and cleared.
+        std::pmr::map<int, PlayerSlot> players_;                             ///< Map of player ID to connection state.
+        BattleShipProtocol::GameLogic game_;                                 ///< Game logic handler.
+        std::atomic<bool> finished_{false};                                  ///< Flag to indicate if the session is over.
+        bool ending_ = false;                                                ///< True once finish() was called (strand).
+        BattleShipProtocol::Protocol protocol_;                              ///< Communication protocol.
+        LogFn log_fn_;                                                       ///< Logging function.
+        JournalFn journal_fn_;                                               ///< Game-event journal (may be empty).
+        FinishedFn finished_fn_;                                             ///< Completion callback (may be empty).
+        int current_player_ = 1;                                             ///< Player whose turn it is during PLAYING.
+        uint64_t turn_generation_ = 0;                                       ///< Incremented every turn; tells stale timeouts apart (strand).
+        std::chrono::milliseconds turn_timeout_;                             ///< Turn time of this match.
+        EventLoop::TimerId turn_timer_ = 0;                                  ///< Pending turn timeout on the loop timer wheel (loop thread).
+        bool closed_ = false;                                                ///< The loop applied the Outbox that closes the session (loop thread).
+        std::chrono::time_point<std::chrono::steady_clock> turn_deadline_;   ///< Deadline of the current turn.
+        std::chrono::time_point<std::chrono::steady_clock> timer_deadline_;  ///< Deadline the turn timer was last armed for (strand).
+        std::chrono::steady_clock::time_point received_;                     ///< Arrival of the frame whose message is being handled (strand).
+        uint64_t strand_allocations_ = 0;                                    ///< Heap allocations made by the session's strand tasks (strand).
+        uint64_t loop_allocations_ = 0;                                      ///< Heap allocations made by the session's loop callbacks (loop thread).
+#ifdef BATTLESHIP_COROUTINES
         /**
-         * @brief Sends a protocol message to a specific client.
-         * @param client_fd File descriptor of the client's socket.
-         * @param msg Message object to be sent.
-         * @param protocol Reference to the protocol handler used for serialization.
+         * @brief What a receive() resumes the flow with.
          */
-        void send_message(int client_fd, const BattleShipProtocol::Message &msg,
-                          const BattleShipProtocol::Protocol &protocol) const;
+        struct Inbound
+        {
+            int player = 0;                    ///< Sending player, or 0 if the deadline passed first.
+            BattleShipProtocol::Message msg;   ///< Message taken from the player's inbox.
+        };
 
         /**
-         * @brief Receives all pending messages from a client.
-         * @param client_fd File descriptor of the client socket.
-         * @return Vector of parsed protocol messages.
+         * @brief Awaitable returned by receive().
+         *
+         * Completes at once if one of the players already has a queued message. Once the
+         * session is ending it never completes: the flow stays parked until the session
+         * is destroyed, which releases its frame.
+         */
+        struct Receive
+        {
+            GameSession &session; ///< Session whose inboxes are awaited.
+            unsigned players;     ///< Bit per player (1 << id) whose messages are accepted.
+            bool timed;           ///< The turn timer may complete the wait.
+
+            bool await_ready() { return !session.ending_ && session.take(players); }
+            void await_suspend(std::coroutine_handle<> flow);
+            Inbound await_resume() { return std::move(session.resumed_); }
+        };
+
+        Flow flow_;                                                          ///< Phases of the match (strand).
+        std::coroutine_handle<> waiter_;                                     ///< Suspended receive() of the flow, if any.
+        unsigned waiting_players_ = 0;                                       ///< Players the suspended receive() accepts.
+        bool waiting_timed_ = false;                                         ///< The suspended receive() has a deadline.
+        Inbound resumed_;                                                    ///< Value handed to the resumed receive().
+#endif
+
+        /**
+         * @brief Opens both connections and schedules the greeting. Runs on the loop thread.
+         */
+        void begin();
+
+        /**
+         * @brief Sends the PLAYER_ID messages. Runs on the strand.
+         */
+        void greet();
+
+        /**
+         * @brief Posts a task to the strand; the task's Outbox is flushed when it returns.
+         * @param task State machine work (any callable; stored in the strand task as is).
+         */
+        template <typename Task>
+        void dispatch(Task &&task);
+
+        /**
+         * @brief Moves the session to its current phase in the phase gauge. Runs on the strand after each task.
+         */
+        void meter_phase();
+
+        /**
+         * @brief Hands the Outbox of the finished strand task to the loop thread.
+         */
+        void flush_output();
+
+        /**
+         * @brief Returns a spare Outbox, or a new one if the loop has not returned any. Runs on the strand.
+         */
+        Outbox *next_outbox();
+
+        /**
+         * @brief Clears an applied Outbox and returns it to the strand. Runs on the loop thread.
+         * @param outbox Outbox that apply_output() is done with.
+         */
+        void recycle_output(Outbox &outbox);
+
+        /**
+         * @brief Applies an Outbox on the loop thread: journal, sends, turn timer and close.
+         * @param outbox Output of one strand task.
+         */
+        void apply_output(Outbox &outbox);
+
+        /**
+         * @brief Records a game event of this session in the journal, if there is one.
+         * @param record Event; the session ID is filled in here.
+         */
+        void journal(BattleShipProtocol::JournalRecord record);
+
+        /**
+         * @brief Parses a frame received from a player and posts it to the strand. Runs on the loop thread.
+         *
+         * A supported HELLO switches the framing here, before the next buffered frame is cut.
+         *
+         * @param player_id ID of the sending player.
+         * @param line Raw frame: a text line including the trailing '\n', or a binary frame
+         *             without its length prefix once the player negotiated the binary format.
+         */
+        void on_line(int player_id, std::string_view line);
+
+        /**
+         * @brief Body of on_line(), whose heap allocations on_line() counts.
+         * @param player_id ID of the sending player.
+         * @param line Raw frame.
+         */
+        void parse_line(int player_id, std::string_view line);
+
+        /**
+         * @brief Feeds a parsed message to the state machine. Runs on the strand.
+         * @param player_id ID of the sending player.
+         * @param msg Parsed message.
+         * @param received When the loop started parsing the frame (start of the turn round trip).
+         */
+        void on_message(int player_id, BattleShipProtocol::Message &msg, std::chrono::steady_clock::time_point received);
+
+        /**
+         * @brief Switches a player's output format after a HELLO.
+         *
+         * The loop already reads the player's later frames in the requested format; once
+         * the HELLO is echoed back, everything sent to the player uses it as well.
+         * Unsupported versions end the session.
+         *
+         * @param player_id ID of the sending player.
+         * @param hello Requested version.
+         */
+        void negotiate(int player_id, const BattleShipProtocol::HelloData &hello);
+
+        /**
+         * @brief Processes the queued messages that the current phase allows.
+         *
+         * Messages that arrive ahead of the player's phase or turn stay in the inbox
+         * until the state machine catches up with them. With coroutines this resumes
+         * the flow if it waits for one of the queued messages.
+         */
+        void process_inboxes();
+
+#ifdef BATTLESHIP_COROUTINES
+        /**
+         * @brief Whole match: registration, placement and playing, in order.
+         * @return Flow started by the first strand task of the session.
+         */
+        Flow run_flow();
+
+        /**
+         * @brief Waits for both players to register.
+         */
+        Flow registration();
+
+        /**
+         * @brief Waits for both players to place their ships, then starts the first turn.
+         */
+        Flow placement();
+
+        /**
+         * @brief Takes one shot per turn until the match ends, passing turns that expire.
+         */
+        Flow playing();
+
+        /**
+         * @brief Awaits the next message from one of the given players.
+         * @param players Bit per player (1 << id).
+         * @return Awaitable resolving to the sender and the message.
+         */
+        Receive receive(unsigned players);
+
+        /**
+         * @brief Awaits the next message from one of the given players or the deadline, whichever comes first.
+         * @param players Bit per player (1 << id).
+         * @param deadline Time at which the wait resolves with player 0; arms the turn timer.
+         * @return Awaitable resolving to the sender and the message, or to player 0.
+         */
+        Receive receive(unsigned players, std::chrono::steady_clock::time_point deadline);
+
+        /**
+         * @brief Moves the first queued message of the lowest accepted player into resumed_.
+         * @param players Bit per player (1 << id).
+         * @return False if none of them has a queued message.
+         */
+        bool take(unsigned players);
+
+        /**
+         * @brief Resumes the suspended receive() with resumed_.
+         * @throws Whatever ended the flow while it ran.
+         */
+        void resume_flow();
+#endif
+
+        /**
+         * @brief Handles one message from a player during REGISTRATION.
+         * @param player_id ID of the sending player.
+         * @param msg Parsed message.
+         */
+        void handle_registration(int player_id, const BattleShipProtocol::Message &msg);
+
+        /**
+         * @brief Handles one message from a player during PLACEMENT.
+         * @param player_id ID of the sending player.
+         * @param msg Parsed message.
+         */
+        void handle_placement(int player_id, const BattleShipProtocol::Message &msg);
+
+        /**
+         * @brief Handles one message from the current player during PLAYING.
+         * @param player_id ID of the sending player.
+         * @param msg Parsed message.
+         */
+        void handle_playing(int player_id, const BattleShipProtocol::Message &msg);
+
+        /**
+         * @brief Gives the turn to a player and arms the turn timeout.
+         * @param player_id Player whose turn starts.
+         */
+        void start_turn(int player_id);
+
+        /**
+         * @brief Arms the turn timer for a deadline unless it is already armed for it.
+         * @param deadline Time at which on_turn_timeout() is posted to the strand.
          */
-        std::vector<BattleShipProtocol::Message> receive_messages(int client_fd) const;
+        void arm_timer(std::chrono::steady_clock::time_point deadline);
+
+        /**
+         * @brief Handles the expiry of the turn timer. Posted by the loop timer.
+         * @param generation Timer the expiry belongs to; later timers ignore it.
+         */
+        void on_turn_timeout(uint64_t generation);
+
+        /**
+         * @brief Passes the expired turn to the opponent and sends both players the status.
+         */
+        void expire_turn();
+
+        /**
+         * @brief Sends the current game status to a player.
+         *
+         * Players that negotiated deltas get a full STATUS first (and after each RESYNC)
+         * and a STATUS_DELTA with only the changed cells afterwards.
+         *
+         * @param player_id Player receiving the status.
+         */
+        void send_status(int player_id);
+
+        /**
+         * @brief Sends the cells that changed since the last status sent to a player.
+         * @param player_id Player receiving the delta.
+         * @param turn Turn from the player's point of view.
+         * @param time_remaining Seconds left in the current turn.
+         */
+        void send_status_delta(int player_id, BattleShipProtocol::Turn turn, int time_remaining);
+
+        /**
+         * @brief Records a status sent to a player in the journal.
+         * @param player_id Player that received the status.
+         * @param delta True for a STATUS_DELTA, false for a full STATUS.
+         * @param turn Turn from the player's point of view.
+         * @param time_remaining Seconds left in the current turn.
+         */
+        void journal_status(int player_id, bool delta, BattleShipProtocol::Turn turn, int time_remaining);
+
+        /**
+         * @brief Announces the result of the match and ends the session.
+         * @param winner_id ID of the winning player.
+         */
+        void end_game(int winner_id);
+
+        /**
+         * @brief Handles a player disconnection and notifies the opponent.
+         * @param player_id ID of the player that went away.
+         * @param reason Description of the disconnection.
+         */
+        void handle_disconnect(int player_id, const std::string &reason);
+
+        /**
+         * @brief Closes the sockets and marks the session finished once the loop and the strand are done with it.
+         */
+        void finish();
+
+        /**
+         * @brief Builds the answer to an admin request, acting on it if needed. Runs on the strand.
+         * @param request What to read or do.
+         * @return Text for the admin client, without the final status line.
+         */
+        std::string admin_text(AdminRequest request);
+
+        /**
+         * @brief Encodes a protocol message in the player's wire format and queues it in the Outbox.
+         * @param player_id ID of the destination player.
+         * @param msg Message object to be sent.
+         */
+        void send_message(int player_id, const BattleShipProtocol::Message &msg);
+    };
+
+    /**
+     * @brief Startup settings of the server that are not part of the listening address.
+     */
+    struct ServerOptions
+    {
+        unsigned event_loops = 0;                                                ///< Number of event loops, each an acceptor shard (0 uses one per core).
+        int backlog = SOMAXCONN;                                                  ///< Pending-connection queue of each shard's listener.
+        IoBackend backend = IoBackend::EPOLL;                                     ///< Kernel interface used by the event loops.
+        std::chrono::milliseconds turn_timeout = GameSession::DEFAULT_TURN_TIMEOUT; ///< Turn time given to new matches.
+        unsigned workers = 0;                                                     ///< Threads running the session state machines (0 uses one per core).
+        LoggerOptions logging;                                                    ///< Flush interval and queue size of the log writer.
+        std::string journal_path;                                                 ///< Binary game-event journal; empty keeps every STATUS in the text log.
+        int metrics_port = 0;                                                     ///< Port on 127.0.0.1 serving GET /metrics (0 disables it).
+        std::chrono::seconds stats_interval{60};                                  ///< Period of the latency summaries in the log (0 leaves only SIGUSR1).
+        std::string admin_path;                                                   ///< Unix-domain socket of the admin commands; empty disables it.
+        std::string inherit_path;                                                 ///< Admin socket of a running server whose listeners are taken over; empty binds the port.
     };
 
     /**
@@ -150,8 +675,14 @@ namespace BattleshipServer
          * @param ip IP address to bind.
          * @param port Port to bind.
          * @param log_path File path to write logs.
+         * @param options Event loop and worker counts, I/O backend, turn time and logging.
+         * @throws ServerError if the address, log or journal file, or backend cannot be used.
+         *
+         * Blocks SIGUSR1 and SIGTERM in the calling thread before starting any thread, so every
+         * server thread inherits the mask and the signals are only read from a signalfd by the
+         * first loop: SIGUSR1 logs the latency summaries, SIGTERM starts a drain().
          */
-        Server(const std::string &ip, int port, const std::string &log_path);
+        Server(const std::string &ip, int port, const std::string &log_path, const ServerOptions &options = {});
 
         /**
          * @brief Destructor. Cleans up resources and closes sockets.
@@ -160,52 +691,317 @@ namespace BattleshipServer
 
         /**
          * @brief Starts the server's main loop.
+         *
+         * With ServerOptions::inherit_path set, first takes the listeners over from the
+         * server running there (see take_over()) instead of binding the port.
+         * Returns once a drain has finished, or when the event loops are stopped.
+         * @throws ServerError if the port cannot be bound or the takeover fails.
          */
         void run();
 
+        /**
+         * @brief Starts a graceful drain. Safe to call from any thread.
+         *
+         * The listeners stop accepting; clients already accepted are still paired and an
+         * odd one left without an opponent is turned away. Running sessions play on. When
+         * the last session is reclaimed the event loops stop and run() returns. Calling it
+         * again has no further effect.
+         */
+        void drain();
+
     private:
-        int server_fd_;                                        ///< Server socket file descriptor.
+        /**
+         * @brief Accepted client waiting for an opponent.
+         */
+        struct PendingClient
+        {
+            int fd = -1;      ///< Client socket.
+            std::string ip;   ///< Client IP address.
+            size_t shard = 0; ///< Event loop that accepted the client.
+        };
+
+        /**
+         * @brief Clients that can wait for pairing at once; further accepts are refused.
+         */
+        static constexpr size_t MATCHMAKING_CAPACITY = 4096;
+
+        /**
+         * @brief Time a metrics client has to finish its request headers before it is disconnected.
+         */
+        static constexpr std::chrono::milliseconds METRICS_READ_TIMEOUT{5000};
+
+        std::vector<int> listen_fds_;                          ///< SO_REUSEPORT listener of each event loop, by index.
+        int metrics_fd_ = -1;                                  ///< Listener of the metrics endpoint (-1 if disabled).
+        int signal_fd_ = -1;                                   ///< signalfd receiving SIGUSR1 (latency dump on demand) and SIGTERM (drain).
+        int admin_fd_ = -1;                                    ///< Listener of the admin socket (-1 if disabled).
         struct sockaddr_in address_;                           ///< Socket address structure.
         std::string ip_;                                       ///< Server IP address.
         int port_;                                             ///< Server port number.
-        mutable std::ofstream log_file_;                       ///< Output stream for logging.
-        mutable std::mutex log_mutex_;                         ///< Mutex for thread-safe logging.
+        std::unique_ptr<AsyncLogger> logger_;                  ///< Asynchronous writer of the log file.
+        std::unique_ptr<AsyncLogger> journal_;                 ///< Asynchronous writer of the event journal (may be null).
+        std::chrono::steady_clock::time_point journal_start_;  ///< Time origin of the journal records.
         BattleShipProtocol::Protocol protocol_;                ///< Protocol handler instance.
-        std::map<int, std::unique_ptr<GameSession>> sessions_; ///< Active game sessions.
-        std::mutex sessions_mutex_;                            ///< Mutex for session map.
-        std::queue<int> pending_clients_;                      ///< Queue of clients waiting for a session.
-        std::mutex pending_mutex_;                             ///< Mutex for pending client queue.
+        Metrics metrics_;                                      ///< Counters and histograms recorded by every thread.
+        /**
+         * @brief Entry of the completion stack: a session whose strand is done.
+         */
+        struct Completion
+        {
+            SlotMap<std::unique_ptr<GameSession>>::Key key; ///< Slot of the session.
+            Completion *next;                               ///< Entry pushed before this one.
+        };
+
+        SlotMap<std::unique_ptr<GameSession>> sessions_;       ///< Active game sessions, O(1) insert and remove.
+        std::unordered_map<int, SlotMap<std::unique_ptr<GameSession>>::Key> session_keys_; ///< Slot of each session by session ID, for the admin commands.
+        std::mutex sessions_mutex_;                            ///< Guards sessions_ and session_keys_; held only for O(1) operations.
+        std::atomic<Completion *> finished_sessions_{nullptr}; ///< Lock-free stack of sessions to reclaim.
+        MpmcQueue<PendingClient> matchmaking_{MATCHMAKING_CAPACITY}; ///< Accepted clients not yet paired (lock-free).
+        std::atomic<size_t> queued_clients_{0};                ///< Clients pushed and not yet taken by the pairing task.
+        PendingClient waiting_client_;                         ///< Client paired with the next one (pairing task only).
         std::atomic<bool> running_{true};                      ///< Server running flag.
-        int next_session_id_{1};                               ///< Counter for assigning session IDs.
+        std::atomic<bool> draining_{false};                    ///< Set by begin_drain(): the listeners stop accepting.
+        std::atomic<bool> drain_settled_{false};               ///< Set once the last accepted client is paired, handed off or turned away.
+        std::weak_ptr<Connection> heir_;                       ///< Admin connection of the server taking the listeners over (set by begin_drain()).
+        bool handing_off_ = false;                             ///< The drain started by begin_drain() hands the listeners to heir_.
+        ino_t admin_inode_ = 0;                                ///< Inode of the admin socket file this server bound.
+        int next_session_id_{1};                               ///< Counter for assigning session IDs (pairing task only).
+        std::vector<std::unique_ptr<EventLoop>> loops_;        ///< Event loops; each accepts on its own listener and owns the sessions it starts.
+        std::vector<std::thread> loop_threads_;                ///< Threads running the event loops.
+        std::unique_ptr<WorkerPool> workers_;                  ///< Threads running the session state machines.
+        ServerOptions options_;                                ///< Startup settings.
 
         /**
-         * @brief Creates the server socket.
+         * @brief Creates a listening socket that shares the port with the other shards (SO_REUSEPORT).
          * @return Socket file descriptor.
          */
         int create_socket();
 
         /**
-         * @brief Binds the server socket to the specified address and port.
+         * @brief Binds a listening socket to the specified address and port.
+         * @param fd Socket returned by create_socket().
          */
-        void bind_socket();
+        void bind_socket(int fd);
 
         /**
-         * @brief Starts listening for incoming connections.
+         * @brief Starts listening for incoming connections with the configured backlog.
+         * @param fd Bound socket.
          */
-        void listen_connections();
+        void listen_connections(int fd);
 
         /**
-         * @brief Accepts client connections and enqueues them for session pairing.
+         * @brief Opens the metrics listener on 127.0.0.1 at the configured port.
+         * @return Listening socket.
+         * @throws ServerError if the port cannot be bound.
+         */
+        int open_metrics_listener();
+
+        /**
+         * @brief Serves one HTTP client of the metrics endpoint. Runs on the first event loop.
+         *
+         * Reads the request line and headers, answers GET /metrics with the Prometheus
+         * text format and closes the connection. A client that has not finished its
+         * headers within METRICS_READ_TIMEOUT is disconnected.
+         *
+         * @param client_fd Accepted socket, or -errno if accepting failed.
+         */
+        void on_metrics_client(int client_fd);
+
+        /**
+         * @brief Builds the HTTP response to a request of the metrics endpoint.
+         * @param request Request line ("GET /metrics HTTP/1.1").
+         * @return Status line, headers and body.
+         */
+        std::string metrics_response(std::string_view request);
+
+        /**
+         * @brief Renders the server gauges and every recorded metric in the Prometheus text format.
+         */
+        std::string render_metrics();
+
+        /**
+         * @brief Opens the admin listener at options_.admin_path, replacing a stale socket file.
+         * @return Listening socket, readable and writable by the server's user only.
+         * @throws ServerError if the path is too long, is not a socket, or cannot be bound.
+         */
+        int open_admin_listener();
+
+        /**
+         * @brief Serves one client of the admin socket. Runs on the first event loop.
+         *
+         * Each line is one command; each answer ends with a line starting with "OK" or
+         * "ERR". Commands: sessions, boards ID, end ID, trace [SPEC], drain, handoff, help, quit.
+         *
+         * @param client_fd Accepted socket, or -errno if accepting failed.
          */
-        void accept_clients();
+        void on_admin_client(int client_fd);
 
         /**
-         * @brief Cleans up finished game sessions.
+         * @brief Runs one admin command. Runs on the first event loop.
+         * @param client Connection the answer goes to.
+         * @param line Command line, with or without its line ending.
          */
-        void cleanup_finished_sessions();
+        void admin_command(const std::weak_ptr<Connection> &client, std::string_view line);
 
         /**
-         * @brief Logs a message to the log file with a given log level.
+         * @brief Sends an answer to an admin client if it is still connected. Safe to call from any thread.
+         * @param client Admin connection.
+         * @param text Answer, ending with its status line.
+         */
+        void admin_send(const std::weak_ptr<Connection> &client, std::string text);
+
+        /**
+         * @brief Passes an admin request to a session through its loop and strand.
+         *
+         * The session is looked up again by key on its loop, so a session reclaimed in
+         * between is reported as gone instead of being touched.
+         *
+         * @param key Key of the session in sessions_.
+         * @param loop Loop of the session.
+         * @param request What to read or do.
+         * @param reply Receives the answer, or an empty text if the session is gone.
+         */
+        void admin_session(SlotMap<std::unique_ptr<GameSession>>::Key key, EventLoop &loop,
+                           GameSession::AdminRequest request, GameSession::AdminReply reply);
+
+        /**
+         * @brief Answers "sessions": one summary line per session, ordered by session ID.
+         * @param client Admin connection.
+         */
+        void admin_list(const std::weak_ptr<Connection> &client);
+
+        /**
+         * @brief Starts a drain, optionally handing the listeners to another server. Safe to call from any thread.
+         *
+         * Every listener stops accepting. Once the last one can deliver no more clients
+         * (with io_uring, after the final CQE of its cancelled accept), a marker is queued
+         * behind the accepted clients, so the pairing task reaches it only after pairing
+         * them, and then settle_drain() runs on the first loop with the client left
+         * without an opponent.
+         *
+         * @param heir Admin connection of the server taking over, or empty for a plain drain.
+         * @return False if a drain was already under way.
+         */
+        bool begin_drain(const std::weak_ptr<Connection> &heir);
+
+        /**
+         * @brief Hands the listeners to the heir, or turns the leftover client away on a plain drain. Runs on the first event loop.
+         *
+         * If the heir has gone away or the handoff fails, the drain is cancelled with
+         * resume_accepting() and the heir is answered "ERR handoff failed".
+         *
+         * @param leftover Accepted client left without an opponent (fd -1 if none).
+         */
+        void settle_drain(PendingClient leftover);
+
+        /**
+         * @brief Cancels a drain whose handoff failed: accepts on every listener again and requeues the leftover client. Runs on the first event loop.
+         * @param leftover Accepted client left without an opponent (fd -1 if none).
+         */
+        void resume_accepting(PendingClient leftover);
+
+        /**
+         * @brief Accepts clients on listen_fds_[index] with the loop that serves it. Runs on that loop, or before the loops start.
+         * @param index Listener index; loop index % loops_.size() serves it.
+         */
+        void accept_clients(size_t index);
+
+        /**
+         * @brief Sends the listeners, the metrics listener and the leftover client to the heir. Runs on the first event loop.
+         *
+         * One sendmsg() carries the line "OK handoff L M C" (listeners, metrics listeners,
+         * clients) and the descriptors as SCM_RIGHTS, in that order. Connections still in
+         * the listeners' accept queues move with them, so no connect is refused.
+         *
+         * @param heir Admin connection of the new server.
+         * @param leftover Client left without an opponent (fd -1 if none); closed here once sent.
+         * @return False if sendmsg() failed; the metrics listener is accepting again and the leftover client is kept.
+         */
+        bool hand_off(Connection &heir, PendingClient &leftover);
+
+        /**
+         * @brief Takes the listeners over from the server at options_.inherit_path. Runs before the loops start.
+         *
+         * Sends "handoff" to that server's admin socket and waits for its descriptors.
+         * Listeners are checked to be bound to this server's port and stored in
+         * listen_fds_; the metrics listener is kept if it matches options_.metrics_port.
+         *
+         * @param clients Receives the accepted clients the old server could not pair.
+         * @throws ServerError if the server cannot be reached or refuses the handoff.
+         */
+        void take_over(std::vector<int> &clients);
+
+        /**
+         * @brief Stops the event loops if a drain has settled and no session is left. Safe to call from any thread.
+         */
+        void finish_drain();
+
+        /**
+         * @brief Writes one STATS line per stage to the log: count, mean, p50, p90, p99, p99.9 and max.
+         *
+         * Percentiles are cumulative since the server started. Runs on the first event loop,
+         * every stats_interval and whenever the process receives SIGUSR1.
+         */
+        void dump_latencies();
+
+        /**
+         * @brief Arms the next periodic latency dump. Runs on the first event loop.
+         */
+        void schedule_latency_dump();
+
+        /**
+         * @brief Drains the pending signals of signal_fd_: dumps the latencies on SIGUSR1, drains on SIGTERM. Runs on the first event loop.
+         */
+        void on_signal();
+
+        /**
+         * @brief Queues an accepted client for matchmaking.
+         *
+         * Runs on the accepting shard's loop for every socket accepted by the backend.
+         * It only pushes the client into the lock-free matchmaking queue and schedules
+         * the pairing task, so accepting never waits for a session to be set up.
+         *
+         * @param shard Index of the loop whose listener accepted the client.
+         * @param client_fd Accepted socket, or -errno if accepting failed.
+         */
+        void on_client_accepted(size_t shard, int client_fd);
+
+        /**
+         * @brief Pairs the queued clients into sessions. Runs as a task on the workers.
+         *
+         * At most one pairing task exists at a time: the accept that finds no queued
+         * client schedules it, and it runs until it has taken every client counted in
+         * queued_clients_. An odd client waits in waiting_client_ for the next one. The
+         * drain marker (fd -1) hands the odd client to settle_drain() instead.
+         */
+        void pair_clients();
+
+        /**
+         * @brief Creates a session for two paired clients and starts it on the shard that accepted player 1.
+         * @param first Player 1.
+         * @param second Player 2.
+         */
+        void start_session(PendingClient &first, PendingClient &second);
+
+        /**
+         * @brief Queues a finished session for reclamation. Called from the session's last strand task.
+         *
+         * The session is pushed onto a lock-free completion stack; the push that finds
+         * the stack empty submits a reclaim task to the workers.
+         *
+         * @param key Slot of the session.
+         */
+        void on_session_finished(SlotMap<std::unique_ptr<GameSession>>::Key key);
+
+        /**
+         * @brief Takes every queued completion and destroys those sessions. Runs on the workers.
+         *
+         * Each session leaves the table under sessions_mutex_ in O(1); its destructor
+         * runs after the lock is released.
+         */
+        void reclaim_sessions();
+
+        /**
+         * @brief Queues a message for the log file with a given log level. Does not block on I/O.
          * @param client_ip Client IP address.
          * @param query Original request or action.
          * @param response Server response or outcome.
@@ -213,6 +1009,12 @@ namespace BattleshipServer
          */
         void log(const std::string &client_ip, const std::string &query,
                  const std::string &response, const std::string &level = "INFO") const;
+
+        /**
+         * @brief Stamps a game event with the time since the journal start and queues it.
+         * @param record Event filled in by a session.
+         */
+        void journal(BattleShipProtocol::JournalRecord &record) const;
     };
 
 } // namespace BattleshipServer
@@ -0,0 +1,81 @@
+#ifndef SLAB_POOL_HPP
+#define SLAB_POOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace BattleshipServer
+{
+
+    /**
+     * @class SlabPool
+     * @brief Thread-safe pool of fixed-size blocks carved out of large slabs.
+     *
+     * Blocks are handed out from a free list and returned to it, so a steady stream
+     * of objects of one type reuses the same memory instead of going through the
+     * general-purpose heap each time. A new slab is allocated only when every block
+     * is in use; slabs are released when the pool is destroyed.
+     */
+    class SlabPool
+    {
+    public:
+        /**
+         * @brief Creates an empty pool.
+         * @param block_size Size of each block in bytes (rounded up to the maximum alignment).
+         * @param blocks_per_slab Blocks allocated together when the pool runs out.
+         */
+        SlabPool(size_t block_size, size_t blocks_per_slab);
+
+        SlabPool(const SlabPool &) = delete;
+        SlabPool &operator=(const SlabPool &) = delete;
+
+        /**
+         * @brief Returns a free block, allocating a new slab if there is none.
+         * @return Block of block_size() bytes, aligned to alignof(std::max_align_t).
+         * @throws std::bad_alloc if a new slab cannot be allocated.
+         */
+        void *allocate();
+
+        /**
+         * @brief Returns a block to the pool.
+         * @param block Block obtained from allocate() of this pool.
+         */
+        void deallocate(void *block) noexcept;
+
+        /**
+         * @brief Returns the size of the blocks.
+         */
+        size_t block_size() const noexcept { return block_size_; }
+
+        /**
+         * @brief Returns the number of blocks handed out and not returned.
+         */
+        size_t in_use() const;
+
+        /**
+         * @brief Returns the number of blocks in all slabs.
+         */
+        size_t capacity() const;
+
+    private:
+        /**
+         * @brief Link stored in a free block.
+         */
+        struct FreeBlock
+        {
+            FreeBlock *next; ///< Next free block.
+        };
+
+        size_t block_size_;                                ///< Bytes per block.
+        size_t blocks_per_slab_;                           ///< Blocks per slab.
+        mutable std::mutex mutex_;                         ///< Guards the fields below.
+        FreeBlock *free_ = nullptr;                        ///< Free list, most recently returned first.
+        std::vector<std::unique_ptr<std::byte[]>> slabs_;  ///< Every slab allocated.
+        size_t in_use_ = 0;                                ///< Blocks handed out.
+    };
+
+} // namespace BattleshipServer
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef SLOT_MAP_HPP
+#define SLOT_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace BattleshipServer
+{
+
+    /**
+     * @class SlotMap
+     * @brief Dense table of values addressed by generation-tagged keys.
+     *
+     * Insertion reuses the most recently freed slot and removal returns the slot to the
+     * free list, both in O(1) without rehashing or rebalancing. A key carries the
+     * generation of its slot, so a key kept after its value was removed no longer finds
+     * anything, even once the slot holds a new value. Not synchronized: the owner
+     * serializes access.
+     *
+     * @tparam T Value type; must be default constructible and movable.
+     */
+    template <typename T>
+    class SlotMap
+    {
+    public:
+        /**
+         * @brief Handle of a stored value: generation in the high 32 bits, slot in the low 32. Never 0.
+         */
+        using Key = uint64_t;
+
+        /**
+         * @brief Stores a value.
+         * @param value Value to store.
+         * @return Key that finds it until it is removed.
+         */
+        Key insert(T value)
+        {
+            uint32_t index;
+            if (free_.empty())
+            {
+                index = static_cast<uint32_t>(slots_.size());
+                slots_.emplace_back();
+            }
+            else
+            {
+                index = free_.back();
+                free_.pop_back();
+            }
+            Slot &slot = slots_[index];
+            slot.value = std::move(value);
+            slot.occupied = true;
+            ++size_;
+            return (static_cast<Key>(slot.generation) << 32) | index;
+        }
+
+        /**
+         * @brief Returns the value of a key.
+         * @param key Key returned by insert().
+         * @return Pointer to the value, or nullptr if the key was removed.
+         */
+        T *find(Key key)
+        {
+            Slot *slot = slot_of(key);
+            return slot ? &slot->value : nullptr;
+        }
+
+        /**
+         * @brief Moves a value out of the map and frees its slot.
+         * @param key Key returned by insert().
+         * @param value Receives the value.
+         * @return False if the key was already removed.
+         */
+        bool take(Key key, T &value)
+        {
+            Slot *slot = slot_of(key);
+            if (!slot)
+            {
+                return false;
+            }
+            value = std::move(slot->value);
+            slot->value = T{};
+            slot->occupied = false;
+            // Las claves anteriores del slot dejan de encontrarlo; 0 se salta para que ninguna clave valga 0.
+            if (++slot->generation == 0)
+            {
+                slot->generation = 1;
+            }
+            free_.push_back(static_cast<uint32_t>(key & 0xffffffffu));
+            --size_;
+            return true;
+        }
+
+        /**
+         * @brief Returns the number of stored values.
+         */
+        size_t size() const noexcept { return size_; }
+
+        /**
+         * @brief Visits every stored value in slot order.
+         * @param fn Called as fn(key, value) for each value; must not insert or take.
+         */
+        template <typename Fn>
+        void for_each(Fn &&fn)
+        {
+            for (size_t index = 0; index < slots_.size(); ++index)
+            {
+                Slot &slot = slots_[index];
+                if (slot.occupied)
+                {
+                    fn((static_cast<Key>(slot.generation) << 32) | index, slot.value);
+                }
+            }
+        }
+
+    private:
+        /**
+         * @brief Storage of one value.
+         */
+        struct Slot
+        {
+            T value{};               ///< Stored value (default-constructed while free).
+            uint32_t generation = 1; ///< Bumped on every removal.
+            bool occupied = false;   ///< The slot holds a value.
+        };
+
+        std::vector<Slot> slots_;    ///< Slots, by index.
+        std::vector<uint32_t> free_; ///< Indices of free slots, most recently freed last.
+        size_t size_ = 0;            ///< Occupied slots.
+
+        Slot *slot_of(Key key)
+        {
+            size_t index = static_cast<size_t>(key & 0xffffffffu);
+            if (index >= slots_.size())
+            {
+                return nullptr;
+            }
+            Slot &slot = slots_[index];
+            return slot.occupied && slot.generation == static_cast<uint32_t>(key >> 32) ? &slot : nullptr;
+        }
+    };
+
+} // namespace BattleshipServer
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace BattleshipServer
+{
+
+    /**
+     * @class TimerWheel
+     * @brief Hierarchical timing wheel with millisecond resolution.
+     *
+     * Four levels of 64 slots cover deadlines up to 2^24 ms (about 4.6 hours) ahead; later
+     * deadlines wait in an overflow list. Timers live in a slab and are linked into their
+     * slot, so schedule() and cancel() are O(1). Each level keeps a bitmap of occupied
+     * slots, which lets next_expiry() and advance() jump straight to the next slot that
+     * needs work instead of stepping through idle milliseconds.
+     *
+     * Not thread-safe: a wheel belongs to one EventLoop.
+     */
+    class TimerWheel
+    {
+    public:
+        /**
+         * @brief Handle of a scheduled timer. 0 is never returned and can mean "no timer".
+         */
+        using TimerId = uint64_t;
+
+        /**
+         * @brief Callback invoked when a timer expires.
+         */
+        using Callback = std::function<void()>;
+
+        /**
+         * @brief Creates an empty wheel.
+         * @param now_ms Current time in milliseconds on the caller's clock.
+         */
+        explicit TimerWheel(uint64_t now_ms = 0);
+
+        /**
+         * @brief Schedules a callback.
+         * @param deadline_ms Expiry time. Deadlines in the past fire on the next advance().
+         * @param callback Callback to invoke.
+         * @return Handle for cancel().
+         */
+        TimerId schedule(uint64_t deadline_ms, Callback callback);
+
+        /**
+         * @brief Cancels a timer that has not fired yet.
+         * @param id Handle returned by schedule(). Stale handles are ignored.
+         * @return True if the timer was pending.
+         */
+        bool cancel(TimerId id);
+
+        /**
+         * @brief Fires every timer whose deadline is not after now_ms, in deadline order.
+         *
+         * Callbacks may schedule and cancel timers.
+         *
+         * @param now_ms Current time in milliseconds.
+         * @return Number of timers fired.
+         */
+        size_t advance(uint64_t now_ms);
+
+        /**
+         * @brief Returns when advance() next has work to do.
+         *
+         * This is the earliest deadline, or earlier if a higher level slot must be
+         * redistributed first; arming a one-shot timer for it never misses an expiry.
+         *
+         * @return Time in milliseconds, or std::nullopt if no timer is pending.
+         */
+        std::optional<uint64_t> next_expiry() const;
+
+        /**
+         * @brief Returns the number of pending timers.
+         * @return Pending timers.
+         */
+        size_t size() const noexcept { return size_; }
+
+        /**
+         * @brief Returns the time the wheel has advanced to.
+         * @return Time in milliseconds.
+         */
+        uint64_t now() const noexcept { return current_; }
+
+    private:
+        static constexpr unsigned LEVELS = 4;        ///< Number of wheel levels.
+        static constexpr unsigned SLOT_BITS = 6;     ///< log2 of slots per level.
+        static constexpr unsigned SLOTS = 1u << SLOT_BITS; ///< Slots per level.
+        static constexpr uint32_t NIL = UINT32_MAX;  ///< Null node index.
+        static constexpr unsigned OVERFLOW_SLOT = LEVELS * SLOTS; ///< List index of the overflow list.
+
+        /**
+         * @brief Slab entry of a timer.
+         */
+        struct Node
+        {
+            uint64_t deadline = 0;   ///< Expiry time.
+            Callback callback;       ///< Callback; empty while the node is free.
+            uint32_t prev = NIL;     ///< Previous node in the slot list.
+            uint32_t next = NIL;     ///< Next node in the slot list (or free list).
+            uint32_t list = NIL;     ///< Slot list holding the node, NIL when free.
+            uint32_t generation = 0; ///< Bumped on release to invalidate old handles.
+        };
+
+        std::vector<Node> nodes_;                         ///< Timer slab.
+        uint32_t free_head_ = NIL;                        ///< First free slab entry.
+        std::array<uint32_t, LEVELS * SLOTS + 1> heads_;  ///< Slot list heads, plus the overflow list.
+        std::array<uint64_t, LEVELS> occupied_{};         ///< Bitmap of non-empty slots per level.
+        uint64_t current_;                                ///< Time the wheel has advanced to.
+        size_t size_ = 0;                                 ///< Pending timers.
+
+        /**
+         * @brief Links a node into the slot matching its deadline relative to current_.
+         * @param index Node index.
+         */
+        void insert(uint32_t index);
+
+        /**
+         * @brief Unlinks a node from its slot list.
+         * @param index Node index.
+         */
+        void unlink(uint32_t index);
+
+        /**
+         * @brief Re-inserts every node of a slot list (cascade to lower levels).
+         * @param list Slot list index.
+         */
+        void redistribute(unsigned list);
+
+        /**
+         * @brief Returns a node to the free list and invalidates its handle.
+         * @param index Node index.
+         */
+        void release(uint32_t index);
+    };
+
+} // namespace BattleshipServer
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @brief Trace categories compiled into the server: bit N keeps TraceCategory N.
+ *
+ * Set from CMake (BATTLESHIP_TRACE_MASK). A category whose bit is clear compiles
+ * every BATTLESHIP_TRACE of it down to nothing.
+ */
+#ifndef BATTLESHIP_TRACE_MASK
+#define BATTLESHIP_TRACE_MASK 0xFF
+#endif
+
+namespace BattleshipServer
+{
+    class AsyncLogger;
+
+    /**
+     * @brief Subsystem a trace line belongs to.
+     */
+    enum class TraceCategory : uint8_t
+    {
+        SESSION = 0, ///< Phases, registrations, placements, disconnections and session errors.
+        WIRE = 1,    ///< Every message received from or sent to a player.
+        TIMER = 2    ///< Turn timeouts.
+    };
+
+    /**
+     * @brief Verbosity of a trace line; a category prints the lines at or below its level.
+     */
+    enum class TraceLevel : uint8_t
+    {
+        OFF = 0,   ///< Nothing (only as a category level).
+        ERROR = 1, ///< Failures the session recovers from or ends on.
+        INFO = 2,  ///< Notable game events.
+        DEBUG = 3  ///< Every step and every message.
+    };
+
+    /**
+     * @brief Leveled trace lines routed through the server log.
+     *
+     * Each category has a runtime level held in an atomic. BATTLESHIP_TRACE checks it
+     * with one relaxed load before evaluating any argument, so a disabled line costs a
+     * load and a branch and formats nothing. Enabled lines are formatted into a
+     * thread-local buffer and queued in the AsyncLogger installed with set_sink(), with
+     * the level as the log line's type and the category as its event; with no sink they
+     * go to standard error. Every category starts at ERROR.
+     */
+    namespace Trace
+    {
+        constexpr size_t CATEGORY_COUNT = 3; ///< Number of TraceCategory values.
+
+        /**
+         * @brief Runtime level of each category, indexed by TraceCategory.
+         */
+        inline std::atomic<uint8_t> levels[CATEGORY_COUNT] = {static_cast<uint8_t>(TraceLevel::ERROR),
+                                                               static_cast<uint8_t>(TraceLevel::ERROR),
+                                                               static_cast<uint8_t>(TraceLevel::ERROR)};
+
+        /**
+         * @brief Returns true if the category is compiled in (BATTLESHIP_TRACE_MASK).
+         */
+        constexpr bool compiled(TraceCategory category)
+        {
+            return ((BATTLESHIP_TRACE_MASK) >> static_cast<unsigned>(category)) & 1u;
+        }
+
+        /**
+         * @brief Returns true if lines of this category and level are printed.
+         */
+        inline bool enabled(TraceCategory category, TraceLevel level) noexcept
+        {
+            return compiled(category) &&
+                   levels[static_cast<size_t>(category)].load(std::memory_order_relaxed) >= static_cast<uint8_t>(level);
+        }
+
+        /**
+         * @brief Sets the runtime level of one category.
+         */
+        void set_level(TraceCategory category, TraceLevel level) noexcept;
+
+        /**
+         * @brief Sets the runtime level of every category.
+         */
+        void set_level(TraceLevel level) noexcept;
+
+        /**
+         * @brief Returns the runtime level of a category.
+         */
+        TraceLevel level(TraceCategory category) noexcept;
+
+        /**
+         * @brief Applies a level specification.
+         *
+         * Either a single level for every category ("debug") or a comma-separated list
+         * of category=level pairs ("wire=debug,session=info"). Names are lowercase.
+         *
+         * @param spec Specification.
+         * @throws std::invalid_argument if a category or level is unknown.
+         */
+        void configure(std::string_view spec);
+
+        /**
+         * @brief Returns the name of a category ("session", "wire", "timer").
+         */
+        std::string_view category_name(TraceCategory category) noexcept;
+
+        /**
+         * @brief Returns the name of a level ("off", "error", "info", "debug").
+         */
+        std::string_view level_name(TraceLevel level) noexcept;
+
+        /**
+         * @brief Routes trace lines to a logger, or back to standard error with nullptr.
+         * @param logger Logger that outlives every trace line written while it is installed.
+         */
+        void set_sink(AsyncLogger *logger) noexcept;
+
+        /**
+         * @brief Writes a formatted line to the sink. Called by BATTLESHIP_TRACE once the level check passed.
+         */
+        void emit(TraceCategory category, TraceLevel level, std::string_view text);
+
+        /**
+         * @brief Appends one argument of a trace line.
+         */
+        template <typename T>
+        void append(std::string &out, const T &value)
+        {
+            if constexpr (std::is_same_v<T, char>)
+            {
+                out += value;
+            }
+            else if constexpr (std::is_same_v<T, bool>)
+            {
+                out += value ? "true" : "false";
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                char digits[24];
+                auto result = std::to_chars(digits, digits + sizeof(digits), value);
+                out.append(digits, result.ptr);
+            }
+            else
+            {
+                out += std::string_view(value);
+            }
+        }
+
+        /**
+         * @brief Formats the arguments into a thread-local buffer and emits the line.
+         */
+        template <typename... Args>
+        void write(TraceCategory category, TraceLevel level, const Args &...args)
+        {
+            thread_local std::string line;
+            line.clear();
+            (append(line, args), ...);
+            emit(category, level, line);
+        }
+    }
+
+} // namespace BattleshipServer
+
+/**
+ * @brief Writes a trace line if its category is compiled in and enabled at the level.
+ *
+ * The arguments (strings, characters and integers, concatenated) are evaluated only
+ * when the line is printed. Example: BATTLESHIP_TRACE(SESSION, DEBUG, "Jugador ", id, " registrado").
+ */
+#define BATTLESHIP_TRACE(category, level, ...)                                                                  \
+    do                                                                                                          \
+    {                                                                                                           \
+        if (::BattleshipServer::Trace::enabled(::BattleshipServer::TraceCategory::category,                     \
+                                               ::BattleshipServer::TraceLevel::level))                          \
+            ::BattleshipServer::Trace::write(::BattleshipServer::TraceCategory::category,                       \
+                                             ::BattleshipServer::TraceLevel::level, __VA_ARGS__);               \
+    } while (0)
+
+#endif
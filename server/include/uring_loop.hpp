@@ -0,0 +1,293 @@
+#ifndef URING_LOOP_HPP
+#define URING_LOOP_HPP
+
+#include <linux/io_uring.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "event_loop.hpp"
+#include "connection.hpp"
+
+namespace BattleshipServer
+{
+
+    class UringConnection;
+
+    /**
+     * @class UringLoop
+     * @brief EventLoop backed by io_uring, driven through the raw syscalls.
+     *
+     * Listening sockets use a multishot accept and client sockets a multishot recv that
+     * picks its memory from a ring of provided buffers owned by the loop, so an idle
+     * connection holds no receive buffer. Submissions produced while handling a batch of
+     * completions are queued in the SQ ring and handed to the kernel with a single
+     * io_uring_enter() call that also waits for the next completions.
+     */
+    class UringLoop : public EventLoop
+    {
+    public:
+        /**
+         * @brief Target of a completion. Its address is stored in io_uring_sqe::user_data.
+         */
+        struct Completion
+        {
+            virtual ~Completion() = default;
+
+            /**
+             * @brief Handles one CQE.
+             * @param res Result of the operation (negative errno on failure).
+             * @param flags CQE flags (IORING_CQE_F_MORE, IORING_CQE_F_BUFFER, ...).
+             */
+            virtual void complete(int res, uint32_t flags) = 0;
+        };
+
+        /**
+         * @brief Creates the ring, registers the provided buffers and the internal descriptors.
+         * @throws ServerError if io_uring or one of the required features is unavailable.
+         */
+        UringLoop();
+
+        /**
+         * @brief Tears down the ring. Operations still in flight are cancelled by the kernel.
+         */
+        ~UringLoop() override;
+
+        void watch(int fd, uint32_t events, EventHandler handler) override;
+        void unwatch(int fd) override;
+        void accept_on(int listen_fd, AcceptHandler handler) override;
+        void stop_accepting(int listen_fd, StoppedHandler stopped) override;
+        std::shared_ptr<Connection> make_connection(int fd) override;
+        void run() override;
+
+        /**
+         * @brief Queues a multishot recv that selects buffers from the provided buffer ring.
+         * @param fd Socket to read from.
+         * @param target Completion receiving the data.
+         */
+        void prepare_recv(int fd, Completion *target);
+
+        /**
+         * @brief Queues a send. The data must stay valid until the completion arrives.
+         * @param fd Socket to write to.
+         * @param data Bytes to send.
+         * @param size Number of bytes.
+         * @param target Completion receiving the result.
+         */
+        void prepare_send(int fd, const char *data, size_t size, Completion *target);
+
+        /**
+         * @brief Queues the cancellation of every request targeting a completion.
+         * @param target Completion whose requests must be cancelled.
+         */
+        void prepare_cancel(Completion *target);
+
+        /**
+         * @brief Returns the provided buffer selected by a recv completion.
+         * @param flags CQE flags carrying the buffer id.
+         * @return Buffer start.
+         */
+        const char *selected_buffer(uint32_t flags) const;
+
+        /**
+         * @brief Returns a provided buffer to the kernel once its data has been consumed.
+         * @param flags CQE flags carrying the buffer id.
+         */
+        void recycle_buffer(uint32_t flags);
+
+        /**
+         * @brief Parks a connection whose multishot recv stopped with ENOBUFS.
+         *
+         * Parked connections get their recv re-armed after the batch in which buffers go
+         * back to the ring, or after BUFFER_RETRY if none is recycled meanwhile.
+         *
+         * @param connection Connection waiting for a buffer.
+         */
+        void wait_for_buffers(const std::shared_ptr<UringConnection> &connection);
+
+        /**
+         * @brief Keeps a connection alive while it has requests in flight.
+         * @param connection Connection to retain.
+         */
+        void retain(std::shared_ptr<UringConnection> connection);
+
+        /**
+         * @brief Drops the reference taken by retain() once the current batch is done.
+         * @param connection Connection to release.
+         */
+        void release(UringConnection *connection);
+
+    private:
+        struct Watch;
+        struct Acceptor;
+
+        static constexpr unsigned RING_ENTRIES = 256;   ///< SQ size (the CQ is twice as large).
+        static constexpr unsigned BUFFER_COUNT = 256;   ///< Provided buffers per loop (power of two).
+        static constexpr unsigned BUFFER_SIZE = 4096;   ///< Size of each provided buffer.
+        static constexpr uint16_t BUFFER_GROUP = 0;     ///< Buffer group id used by recv.
+        static constexpr std::chrono::milliseconds BUFFER_RETRY{1}; ///< Fallback re-arm of connections parked on ENOBUFS.
+
+        int ring_fd_ = -1;                              ///< io_uring instance.
+        void *ring_ptr_ = nullptr;                      ///< Mapping of the SQ and CQ rings.
+        size_t ring_size_ = 0;                          ///< Size of ring_ptr_.
+        struct io_uring_sqe *sqes_ = nullptr;           ///< Mapping of the SQE array.
+        size_t sqes_size_ = 0;                          ///< Size of sqes_.
+        unsigned *sq_head_ = nullptr;                   ///< Kernel-owned SQ head.
+        unsigned *sq_tail_ = nullptr;                   ///< SQ tail published to the kernel.
+        unsigned *sq_array_ = nullptr;                  ///< SQ index array.
+        unsigned sq_mask_ = 0;                          ///< SQ ring mask.
+        unsigned sq_entries_ = 0;                       ///< SQ ring size.
+        unsigned sqe_tail_ = 0;                         ///< Local SQ tail, including unsubmitted SQEs.
+        unsigned sqe_submitted_ = 0;                    ///< SQ tail already consumed by the kernel.
+        unsigned *cq_head_ = nullptr;                   ///< CQ head owned by the loop.
+        unsigned *cq_tail_ = nullptr;                   ///< Kernel-owned CQ tail.
+        unsigned cq_mask_ = 0;                          ///< CQ ring mask.
+        struct io_uring_cqe *cqes_ = nullptr;           ///< CQE array.
+        struct io_uring_buf_ring *buf_ring_ = nullptr;  ///< Provided buffer ring shared with the kernel.
+        size_t buf_ring_size_ = 0;                      ///< Size of buf_ring_.
+        uint16_t buf_tail_ = 0;                         ///< Local tail of the provided buffer ring.
+        std::vector<char> buffers_;                     ///< Memory behind the provided buffers.
+        bool buffers_recycled_ = false;                 ///< A buffer went back to the ring during the current batch.
+        std::vector<std::weak_ptr<UringConnection>> starved_; ///< Connections parked by wait_for_buffers().
+        TimerId starved_retry_ = 0;                     ///< Fallback timer of the parked connections.
+
+        std::unordered_map<int, std::unique_ptr<Watch>> watches_;           ///< Active poll registrations by descriptor.
+        std::unordered_map<Watch *, std::unique_ptr<Watch>> cancelled_;     ///< Unwatched registrations waiting for their last CQE.
+        std::vector<std::unique_ptr<Acceptor>> acceptors_;                  ///< Multishot accepts.
+        std::unordered_map<UringConnection *, std::shared_ptr<UringConnection>> connections_; ///< Connections with requests in flight.
+        std::vector<std::unique_ptr<Watch>> retired_watches_;               ///< Registrations freed after the current batch.
+        std::vector<std::shared_ptr<UringConnection>> retired_connections_; ///< Connections released after the current batch.
+
+        /**
+         * @brief Returns a zeroed SQE, submitting the queued ones first if the ring is full.
+         * @param target Completion stored in user_data (nullptr for fire-and-forget requests).
+         * @return SQE to fill.
+         */
+        struct io_uring_sqe *get_sqe(Completion *target);
+
+        /**
+         * @brief Hands the queued SQEs to the kernel, optionally waiting for completions.
+         * @param wait_nr Number of completions to wait for.
+         */
+        void submit(unsigned wait_nr);
+
+        /**
+         * @brief Dispatches every available CQE.
+         */
+        void reap();
+
+        /**
+         * @brief Queues a multishot poll for a watched descriptor.
+         * @param watch Registration to arm.
+         */
+        void arm_poll(Watch *watch);
+
+        /**
+         * @brief Queues a multishot accept.
+         * @param acceptor Listening socket registration.
+         */
+        void arm_accept(Acceptor *acceptor);
+
+        /**
+         * @brief Stops watching a descriptor whose poll failed. The registration is freed after the current batch.
+         * @param watch Registration to drop.
+         */
+        void drop(Watch *watch);
+
+        /**
+         * @brief Re-arms the recv of every connection parked by wait_for_buffers().
+         */
+        void resume_starved();
+
+        /**
+         * @brief Frees an unwatched registration once its last CQE has arrived.
+         * @param watch Registration to free.
+         */
+        void retire(Watch *watch);
+
+        /**
+         * @brief Unmaps the rings and closes the ring descriptor.
+         */
+        void teardown();
+    };
+
+    /**
+     * @class UringConnection
+     * @brief Connection whose reads and writes are io_uring requests.
+     *
+     * A single multishot recv stays armed for the lifetime of the socket. Outgoing data is
+     * accumulated while a send is in flight and written with one request per batch.
+     */
+    class UringConnection : public Connection
+    {
+    public:
+        /**
+         * @brief Wraps an accepted socket.
+         * @param loop Loop that will drive the socket.
+         * @param fd Accepted client socket.
+         */
+        UringConnection(UringLoop &loop, int fd);
+
+        void send(std::string_view data) override;
+        void close() override;
+
+        /**
+         * @brief Re-arms the multishot recv stopped by ENOBUFS. Does nothing if it is armed or the socket is closed.
+         */
+        void resume_recv();
+
+    protected:
+        void start() override;
+        void shutdown(const std::string &reason) override;
+
+    private:
+        /**
+         * @brief Routes a completion to a member function of the connection.
+         */
+        struct Request : UringLoop::Completion
+        {
+            UringConnection *owner;                         ///< Connection that issued the request.
+            void (UringConnection::*handler)(int, uint32_t); ///< Member handling the result.
+
+            Request(UringConnection *o, void (UringConnection::*h)(int, uint32_t)) : owner(o), handler(h) {}
+            void complete(int res, uint32_t flags) override { (owner->*handler)(res, flags); }
+        };
+
+        UringLoop &loop_;             ///< Owning event loop.
+        Request recv_request_;        ///< Multishot recv target.
+        Request send_request_;        ///< Send target.
+        bool recv_armed_ = false;     ///< True while the multishot recv may still post CQEs.
+        bool send_in_flight_ = false; ///< True while a send has not completed.
+        std::string output_;          ///< Bytes queued while a send is in flight.
+        std::string sending_;         ///< Bytes owned by the send in flight.
+        size_t sending_offset_ = 0;   ///< Bytes of sending_ already written.
+
+        /**
+         * @brief Handles a recv CQE.
+         * @param res Bytes received or negative errno.
+         * @param flags CQE flags.
+         */
+        void on_recv(int res, uint32_t flags);
+
+        /**
+         * @brief Handles a send CQE.
+         * @param res Bytes sent or negative errno.
+         * @param flags CQE flags.
+         */
+        void on_send(int res, uint32_t flags);
+
+        /**
+         * @brief Submits the next chunk of pending output if no send is in flight.
+         */
+        void flush();
+
+        /**
+         * @brief Lets the loop drop the connection once no request is in flight.
+         */
+        void release_if_idle();
+    };
+
+} // namespace BattleshipServer
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace BattleshipServer
+{
+
+    /**
+     * @class WorkerPool
+     * @brief Fixed set of threads that run tasks, balanced by work stealing.
+     *
+     * Every worker owns a deque. A task submitted from a worker goes to the back of that
+     * worker's deque and the owner pops from the back, so follow-up work stays on a warm
+     * cache. Tasks submitted from other threads (the event loops) are spread round-robin.
+     * A worker whose deque is empty steals from the front of the others before going to
+     * sleep, so a burst of work on one worker is picked up by the idle ones.
+     */
+    class WorkerPool
+    {
+    public:
+        /**
+         * @brief Unit of work.
+         */
+        using Task = std::function<void()>;
+
+        /**
+         * @brief Starts the workers.
+         * @param workers Number of threads (0 uses one per core).
+         */
+        explicit WorkerPool(unsigned workers = 0);
+
+        /**
+         * @brief Stops and joins the workers. Tasks still queued are dropped.
+         */
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool &) = delete;
+        WorkerPool &operator=(const WorkerPool &) = delete;
+
+        /**
+         * @brief Queues a task. Safe to call from any thread.
+         * @param task Task to run on some worker.
+         */
+        void submit(Task task);
+
+        /**
+         * @brief Stops the workers after the tasks they are running; idempotent.
+         */
+        void stop();
+
+        /**
+         * @brief Returns the number of worker threads.
+         */
+        size_t size() const noexcept { return workers_.size(); }
+
+        /**
+         * @brief Returns how many tasks were taken from another worker's deque.
+         */
+        uint64_t steals() const noexcept { return steals_.load(std::memory_order_relaxed); }
+
+    private:
+        /**
+         * @brief Per-thread state.
+         */
+        struct Worker
+        {
+            std::mutex mutex;       ///< Guards tasks (owner and thieves).
+            std::deque<Task> tasks; ///< Owner works at the back, thieves at the front.
+            std::thread thread;     ///< Worker thread.
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers_; ///< Workers, indexed by position.
+        std::atomic<size_t> next_{0};                  ///< Round-robin target of external submits.
+        std::atomic<uint64_t> pending_{0};             ///< Tasks queued and not yet taken.
+        std::atomic<unsigned> sleeping_{0};            ///< Workers waiting for work.
+        std::atomic<uint64_t> steals_{0};              ///< Tasks taken from another worker.
+        std::atomic<bool> stopping_{false};            ///< Set by stop().
+        std::mutex sleep_mutex_;                       ///< Guards the sleep of idle workers.
+        std::condition_variable wake_;                 ///< Wakes idle workers.
+
+        /**
+         * @brief Body of a worker thread.
+         * @param index Position of the worker.
+         */
+        void worker_loop(size_t index);
+
+        /**
+         * @brief Takes a task from the back of the worker's own deque.
+         * @param index Position of the worker.
+         * @param task Receives the task.
+         * @return False if the deque is empty.
+         */
+        bool pop_local(size_t index, Task &task);
+
+        /**
+         * @brief Takes a task from the front of another worker's deque.
+         * @param index Position of the thief.
+         * @param task Receives the task.
+         * @return False if every other deque is empty.
+         */
+        bool steal(size_t index, Task &task);
+    };
+
+    /**
+     * @class Strand
+     * @brief Runs the tasks posted to it one at a time, in order, on a WorkerPool.
+     *
+     * A strand is scheduled on the pool only while it has tasks, and at most once, so
+     * its tasks never overlap even though they may run on different workers; each task
+     * sees everything the previous one wrote. Independent strands run in parallel
+     * without sharing a lock. Strands are held by shared_ptr so a task may release the
+     * owner of the strand while it runs.
+     */
+    class Strand : public std::enable_shared_from_this<Strand>
+    {
+    public:
+        /**
+         * @brief Creates an idle strand.
+         * @param pool Pool that runs the tasks; must outlive the strand's tasks.
+         */
+        explicit Strand(WorkerPool &pool) : pool_(pool) {}
+
+        /**
+         * @brief Queues a task behind the ones already posted. Safe to call from any thread.
+         * @param task Task to run.
+         */
+        void post(WorkerPool::Task task);
+
+    private:
+        /**
+         * @brief Tasks taken per turn on a worker before the strand yields to other work.
+         */
+        static constexpr size_t BATCH = 64;
+
+        WorkerPool &pool_;                   ///< Pool that runs the strand.
+        std::mutex mutex_;                   ///< Guards queue_ and scheduled_.
+        std::deque<WorkerPool::Task> queue_; ///< Tasks not yet run.
+        bool scheduled_ = false;             ///< The strand is queued on or running in the pool.
+
+        /**
+         * @brief Runs queued tasks on a worker, then reschedules itself if more arrived.
+         */
+        void run();
+    };
+
+} // namespace BattleshipServer
+
+#endif
@@ -0,0 +1,126 @@
+#include "alloc_stats.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace BattleshipServer
+{
+    namespace
+    {
+        // Tipos triviales: el acceso no pasa por un guard de inicialización, válido incluso al crear o destruir hilos.
+        thread_local uint64_t thread_count = 0;
+        std::atomic<uint64_t> total_allocations{0};
+        std::atomic<uint64_t> total_frees{0};
+        std::atomic<uint64_t> total_bytes{0};
+
+        void *counted_malloc(std::size_t size)
+        {
+            ++thread_count;
+            total_allocations.fetch_add(1, std::memory_order_relaxed);
+            total_bytes.fetch_add(size, std::memory_order_relaxed);
+            return std::malloc(size == 0 ? 1 : size);
+        }
+
+        // Tipos alignas(64) (shards de métricas, anillos del logger, celdas de la cola): posix_memalign, liberable con free.
+        void *counted_aligned_malloc(std::size_t size, std::size_t alignment)
+        {
+            ++thread_count;
+            total_allocations.fetch_add(1, std::memory_order_relaxed);
+            total_bytes.fetch_add(size, std::memory_order_relaxed);
+            void *ptr = nullptr;
+            if (posix_memalign(&ptr, std::max(alignment, sizeof(void *)), size == 0 ? 1 : size) != 0)
+            {
+                return nullptr;
+            }
+            return ptr;
+        }
+
+        void counted_free(void *ptr) noexcept
+        {
+            if (ptr != nullptr)
+            {
+                total_frees.fetch_add(1, std::memory_order_relaxed);
+                std::free(ptr);
+            }
+        }
+    }
+
+    namespace AllocStats
+    {
+        uint64_t thread_allocations() noexcept
+        {
+            return thread_count;
+        }
+
+        Totals totals() noexcept
+        {
+            return Totals{total_allocations.load(std::memory_order_relaxed),
+                          total_frees.load(std::memory_order_relaxed),
+                          total_bytes.load(std::memory_order_relaxed)};
+        }
+    }
+
+} // namespace BattleshipServer
+
+// Las formas de arreglo y nothrow de operator new de la biblioteca estándar delegan en estas dos;
+// las de delete se reemplazan todas para que ninguna libere por otro camino.
+void *operator new(std::size_t size)
+{
+    void *ptr = BattleshipServer::counted_malloc(size);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    void *ptr = BattleshipServer::counted_aligned_malloc(size, static_cast<std::size_t>(alignment));
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    BattleshipServer::counted_free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    BattleshipServer::counted_free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    BattleshipServer::counted_free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    BattleshipServer::counted_free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    BattleshipServer::counted_free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    BattleshipServer::counted_free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+    BattleshipServer::counted_free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    BattleshipServer::counted_free(ptr);
+}
@@ -0,0 +1,276 @@
+#include "async_logger.hpp"
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+namespace BattleshipServer
+{
+    namespace
+    {
+        // Identificadores únicos: una dirección de logger puede reutilizarse, un id no.
+        std::atomic<uint64_t> next_logger_id{1};
+
+        size_t round_up_pow2(size_t value)
+        {
+            size_t result = 1;
+            while (result < value)
+            {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        void write_all(int fd, const std::string &data)
+        {
+            size_t offset = 0;
+            while (offset < data.size())
+            {
+                ssize_t written = ::write(fd, data.data() + offset, data.size() - offset);
+                if (written < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (written <= 0)
+                {
+                    return;
+                }
+                offset += static_cast<size_t>(written);
+            }
+        }
+
+        // La fecha solo se vuelve a formatear cuando cambia el segundo.
+        std::string_view timestamp()
+        {
+            thread_local std::time_t cached = -1;
+            thread_local char text[32];
+            thread_local size_t length = 0;
+            std::time_t now = std::time(nullptr);
+            if (now != cached)
+            {
+                std::tm local{};
+                localtime_r(&now, &local);
+                length = std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &local);
+                cached = now;
+            }
+            return std::string_view(text, length);
+        }
+    }
+
+    /**
+     * @brief Single-producer single-consumer ring of bytes holding complete lines.
+     */
+    class AsyncLogger::Ring
+    {
+    public:
+        explicit Ring(size_t capacity) : capacity_(capacity), data_(new char[capacity]) {}
+
+        /**
+         * @brief Copies a line into the ring (producer side).
+         * @param line Complete line.
+         * @param used Receives the bytes in use after the push.
+         * @return False if the line does not fit.
+         */
+        bool push(std::string_view line, size_t &used)
+        {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            size_t head = head_.load(std::memory_order_acquire);
+            if (capacity_ - (tail - head) < line.size())
+            {
+                return false;
+            }
+            size_t offset = tail & (capacity_ - 1);
+            size_t first = std::min(line.size(), capacity_ - offset);
+            std::memcpy(data_.get() + offset, line.data(), first);
+            std::memcpy(data_.get(), line.data() + first, line.size() - first);
+            tail_.store(tail + line.size(), std::memory_order_release);
+            used = tail + line.size() - head;
+            return true;
+        }
+
+        /**
+         * @brief Appends every published byte to out and frees it (consumer side).
+         * @param out Destination buffer.
+         */
+        void drain_into(std::string &out)
+        {
+            size_t head = head_.load(std::memory_order_relaxed);
+            size_t tail = tail_.load(std::memory_order_acquire);
+            if (head == tail)
+            {
+                return;
+            }
+            size_t offset = head & (capacity_ - 1);
+            size_t size = tail - head;
+            size_t first = std::min(size, capacity_ - offset);
+            out.append(data_.get() + offset, first);
+            out.append(data_.get(), size - first);
+            head_.store(tail, std::memory_order_release);
+        }
+
+        size_t capacity() const noexcept { return capacity_; }
+
+    private:
+        const size_t capacity_;              ///< Power of two.
+        std::unique_ptr<char[]> data_;       ///< Storage.
+        alignas(64) std::atomic<size_t> head_{0}; ///< Next byte to drain (consumer).
+        alignas(64) std::atomic<size_t> tail_{0}; ///< End of the published bytes (producer).
+    };
+
+    AsyncLogger::AsyncLogger(int fd, const LoggerOptions &options)
+        : fd_(fd), options_(options), id_(next_logger_id.fetch_add(1))
+    {
+        options_.buffer_bytes = round_up_pow2(std::max<size_t>(options_.buffer_bytes, 4096));
+        // Un intervalo nulo convertiría al escritor en una espera activa.
+        options_.flush_interval = std::max(options_.flush_interval, std::chrono::milliseconds(1));
+        batch_.reserve(options_.buffer_bytes);
+        writer_ = std::thread([this]
+                              { writer_loop(); });
+    }
+
+    AsyncLogger::~AsyncLogger()
+    {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        writer_.join();
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+    }
+
+    void AsyncLogger::log(std::string_view level, std::string_view client_ip, std::string_view query, std::string_view response)
+    {
+        // Buffer por hilo: tras la primera línea larga no vuelve a reservar memoria.
+        thread_local std::string line;
+        line.clear();
+        line += '[';
+        line += level;
+        line += "] ";
+        line += timestamp();
+        line += ' ';
+        line += client_ip;
+        line += ' ';
+        line += query;
+        line += ' ';
+        line += response;
+        line += '\n';
+        enqueue(line);
+    }
+
+    void AsyncLogger::write(std::string_view text)
+    {
+        thread_local std::string line;
+        line.assign(text);
+        line += '\n';
+        enqueue(line);
+    }
+
+    void AsyncLogger::append(std::string_view record)
+    {
+        enqueue(record);
+    }
+
+    void AsyncLogger::flush()
+    {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        uint64_t ticket = ++flush_requested_;
+        wake_.notify_one();
+        while (flush_completed_ < ticket)
+        {
+            flushed_.wait_for(lock, options_.flush_interval);
+        }
+    }
+
+    AsyncLogger::Ring &AsyncLogger::local_ring()
+    {
+        // Caché por hilo de (logger, ring); el id evita confundir un logger destruido con uno nuevo.
+        thread_local std::vector<std::pair<uint64_t, Ring *>> cache;
+        for (const auto &[id, ring] : cache)
+        {
+            if (id == id_)
+            {
+                return *ring;
+            }
+        }
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings_.push_back(std::make_unique<Ring>(options_.buffer_bytes));
+        cache.emplace_back(id_, rings_.back().get());
+        return *rings_.back();
+    }
+
+    void AsyncLogger::enqueue(std::string_view bytes)
+    {
+        Ring &ring = local_ring();
+        size_t used = 0;
+        if (!ring.push(bytes, used))
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        written_.fetch_add(1, std::memory_order_relaxed);
+        // Medio ring ocupado: se adelanta el drenaje sin esperar al intervalo.
+        if (used > ring.capacity() / 2 && !wake_pending_.exchange(true, std::memory_order_acq_rel))
+        {
+            wake_.notify_one();
+        }
+    }
+
+    void AsyncLogger::writer_loop()
+    {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        while (true)
+        {
+            wake_.wait_for(lock, options_.flush_interval, [&]
+                           { return stopping_ || flush_requested_ != flush_completed_ ||
+                                    wake_pending_.load(std::memory_order_acquire); });
+            bool stop = stopping_;
+            uint64_t requested = flush_requested_;
+            lock.unlock();
+
+            wake_pending_.store(false, std::memory_order_release);
+            drain();
+
+            lock.lock();
+            flush_completed_ = requested;
+            flushed_.notify_all();
+            if (stop)
+            {
+                return;
+            }
+        }
+    }
+
+    void AsyncLogger::drain()
+    {
+        batch_.clear();
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            for (auto &ring : rings_)
+            {
+                ring->drain_into(batch_);
+            }
+        }
+        uint64_t drops = dropped_.load(std::memory_order_relaxed);
+        if (drops != reported_drops_ && options_.report_drops)
+        {
+            batch_ += "[WARN] Logger dropped " + std::to_string(drops - reported_drops_) + " lines (queue full)\n";
+            reported_drops_ = drops;
+            written_.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (batch_.empty())
+        {
+            return;
+        }
+        write_all(fd_, batch_);
+        if (options_.echo_stdout)
+        {
+            write_all(STDOUT_FILENO, batch_);
+        }
+    }
+
+} // namespace BattleshipServer
@@ -0,0 +1,66 @@
+#include "connection.hpp"
+#include <unistd.h>
+
+namespace BattleshipServer
+{
+    Connection::Connection(int fd) : fd_(fd) {}
+
+    Connection::~Connection()
+    {
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+    }
+
+    void Connection::open(LineHandler on_line, CloseHandler on_close)
+    {
+        on_line_ = std::move(on_line);
+        on_close_ = std::move(on_close);
+        start();
+    }
+
+    void Connection::deliver(const char *data, size_t size)
+    {
+        while (size > 0 && fd_ >= 0 && !closing_)
+        {
+            size_t accepted = input_.append(data, size);
+            data += accepted;
+            size -= accepted;
+            dispatch_frames();
+            if (accepted == 0)
+            {
+                break;
+            }
+        }
+    }
+
+    void Connection::dispatch_frames()
+    {
+        while (fd_ >= 0 && !closing_)
+        {
+            auto frame = input_.next();
+            if (!frame)
+            {
+                break;
+            }
+            on_line_(*frame);
+        }
+        if (fd_ >= 0 && !closing_ && input_.overflowed())
+        {
+            shutdown("Frame exceeds " + std::to_string(input_.capacity()) + " bytes");
+        }
+    }
+
+    void Connection::notify_closed(const std::string &reason)
+    {
+        // Tras close() el dueño ya no espera notificaciones.
+        bool notify = !closing_;
+        closing_ = true;
+        if (notify && on_close_)
+        {
+            on_close_(reason);
+        }
+    }
+
+} // namespace BattleshipServer
@@ -0,0 +1,261 @@
+#include "epoll_loop.hpp"
+#include "server.hpp"
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+namespace BattleshipServer
+{
+    EpollLoop::EpollLoop()
+    {
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd_ < 0)
+        {
+            throw ServerError("epoll_create1 failed: " + std::string(strerror(errno)));
+        }
+        watch_internal_fds();
+    }
+
+    EpollLoop::~EpollLoop()
+    {
+        close(epoll_fd_);
+    }
+
+    void EpollLoop::watch(int fd, uint32_t events, EventHandler handler)
+    {
+        auto entry = std::make_unique<Watch>(Watch{fd, std::move(handler), true});
+        struct epoll_event ev{};
+        ev.events = events | EPOLLET;
+        ev.data.ptr = entry.get();
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) < 0)
+        {
+            throw ServerError("epoll_ctl ADD failed: " + std::string(strerror(errno)));
+        }
+        watches_[fd] = std::move(entry);
+    }
+
+    void EpollLoop::unwatch(int fd)
+    {
+        auto it = watches_.find(fd);
+        if (it == watches_.end())
+        {
+            return;
+        }
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+        it->second->active = false;
+        // El registro puede estar referenciado por eventos del lote actual; se libera al terminar el lote.
+        retired_.push_back(std::move(it->second));
+        watches_.erase(it);
+    }
+
+    void EpollLoop::accept_on(int listen_fd, AcceptHandler handler)
+    {
+        auto acceptor = std::make_shared<Acceptor>(Acceptor{listen_fd, std::move(handler), {}});
+        acceptors_[listen_fd] = acceptor;
+        watch(listen_fd, EPOLLIN, [this, acceptor](uint32_t)
+              { drain_accepts(acceptor); });
+    }
+
+    void EpollLoop::drain_accepts(const std::shared_ptr<Acceptor> &acceptor)
+    {
+        while (true)
+        {
+            int client_fd = accept4(acceptor->fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (client_fd < 0)
+            {
+                if (errno == EINTR || errno == ECONNABORTED)
+                    continue;
+                // EAGAIN: la cola de conexiones quedó vacía, se espera el siguiente flanco.
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    return;
+                // Con el listener edge-triggered no llegará otro flanco por lo que ya está en la cola: se reintenta con un timer.
+                defer_accept(acceptor->retry, errno, acceptor->handler, [this, acceptor]
+                             { drain_accepts(acceptor); });
+                return;
+            }
+            acceptor->retry.succeeded();
+            acceptor->handler(client_fd);
+        }
+    }
+
+    void EpollLoop::stop_accepting(int listen_fd, StoppedHandler stopped)
+    {
+        // accept_on() es un watch más: basta con quitarlo; acepta de forma síncrona, así que no queda nada en vuelo.
+        unwatch(listen_fd);
+        auto it = acceptors_.find(listen_fd);
+        if (it != acceptors_.end())
+        {
+            if (it->second->retry.timer != 0)
+                cancel_timer(it->second->retry.timer);
+            acceptors_.erase(it);
+        }
+        if (stopped)
+            stopped();
+    }
+
+    std::shared_ptr<Connection> EpollLoop::make_connection(int fd)
+    {
+        return std::make_shared<EpollConnection>(*this, fd);
+    }
+
+    void EpollLoop::run()
+    {
+        loop_thread_ = std::this_thread::get_id();
+        running_ = true;
+
+        constexpr int MAX_EVENTS = 256;
+        struct epoll_event events[MAX_EVENTS];
+
+        while (running_)
+        {
+            rearm_timer();
+            int n = epoll_wait(epoll_fd_, events, MAX_EVENTS, -1);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw ServerError("epoll_wait failed: " + std::string(strerror(errno)));
+            }
+
+            for (int i = 0; i < n; ++i)
+            {
+                auto *entry = static_cast<Watch *>(events[i].data.ptr);
+                if (entry->active)
+                {
+                    entry->handler(events[i].events);
+                }
+            }
+            retired_.clear();
+        }
+    }
+
+    EpollConnection::EpollConnection(EpollLoop &loop, int fd) : Connection(fd), loop_(loop) {}
+
+    void EpollConnection::start()
+    {
+        int flags = fcntl(fd_, F_GETFL, 0);
+        fcntl(fd_, F_SETFL, flags | O_NONBLOCK);
+
+        // El handler retiene la conexión mientras el loop la vigila.
+        auto self = std::static_pointer_cast<EpollConnection>(shared_from_this());
+        loop_.watch(fd_, EPOLLIN | EPOLLOUT | EPOLLRDHUP, [self](uint32_t events)
+                    { self->handle_events(events); });
+    }
+
+    void EpollConnection::send(std::string_view data)
+    {
+        if (fd_ < 0 || closing_)
+        {
+            return;
+        }
+        output_.append(data.data(), data.size());
+        if (!flush())
+        {
+            shutdown("Send failed: " + std::string(strerror(errno)));
+        }
+    }
+
+    void EpollConnection::close()
+    {
+        if (fd_ < 0)
+        {
+            return;
+        }
+        closing_ = true;
+        if (output_.empty())
+        {
+            shutdown("Closed");
+        }
+    }
+
+    void EpollConnection::handle_events(uint32_t events)
+    {
+        if (events & EPOLLOUT)
+        {
+            if (!flush())
+            {
+                shutdown("Send failed: " + std::string(strerror(errno)));
+                return;
+            }
+            if (closing_ && output_.empty())
+            {
+                shutdown("Closed");
+                return;
+            }
+        }
+        if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+        {
+            handle_read();
+        }
+    }
+
+    void EpollConnection::handle_read()
+    {
+        while (fd_ >= 0)
+        {
+            if (closing_)
+            {
+                // El dueño ya no quiere mensajes: se drena el socket solo para detectar el cierre.
+                input_.clear();
+            }
+            auto [area, space] = input_.write_area();
+            ssize_t received = recv(fd_, area, space, 0);
+            if (received > 0)
+            {
+                input_.commit(static_cast<size_t>(received));
+                dispatch_frames();
+                continue;
+            }
+            if (received == 0)
+            {
+                shutdown("Client disconnected");
+                return;
+            }
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                shutdown("Receive failed: " + std::string(strerror(errno)));
+            }
+            return;
+        }
+    }
+
+    bool EpollConnection::flush()
+    {
+        size_t total_sent = 0;
+        while (total_sent < output_.size())
+        {
+            ssize_t sent = ::send(fd_, output_.data() + total_sent, output_.size() - total_sent, MSG_NOSIGNAL);
+            if (sent < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    break;
+                return false;
+            }
+            total_sent += sent;
+        }
+        output_.erase(0, total_sent);
+        return true;
+    }
+
+    void EpollConnection::shutdown(const std::string &reason)
+    {
+        if (fd_ < 0)
+        {
+            return;
+        }
+        loop_.unwatch(fd_);
+        ::close(fd_);
+        fd_ = -1;
+        output_.clear();
+        notify_closed(reason);
+    }
+
+} // namespace BattleshipServer
@@ -0,0 +1,174 @@
+#include "event_loop.hpp"
+#include "epoll_loop.hpp"
+#include "uring_loop.hpp"
+#include "server.hpp"
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <ctime>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+namespace BattleshipServer
+{
+    IoBackend io_backend_from_string(const std::string &name)
+    {
+        if (name == "epoll")
+            return IoBackend::EPOLL;
+        if (name == "io_uring" || name == "uring")
+            return IoBackend::IO_URING;
+        throw ServerError("Unknown I/O backend: " + name + " (expected epoll or io_uring)");
+    }
+
+    std::string io_backend_to_string(IoBackend backend)
+    {
+        return backend == IoBackend::IO_URING ? "io_uring" : "epoll";
+    }
+
+    std::unique_ptr<EventLoop> EventLoop::create(IoBackend backend)
+    {
+        switch (backend)
+        {
+        case IoBackend::IO_URING:
+            return std::make_unique<UringLoop>();
+        case IoBackend::EPOLL:
+        default:
+            return std::make_unique<EpollLoop>();
+        }
+    }
+
+    EventLoop::EventLoop()
+    {
+        wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeup_fd_ < 0)
+        {
+            throw ServerError("eventfd failed: " + std::string(strerror(errno)));
+        }
+
+        timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (timer_fd_ < 0)
+        {
+            close(wakeup_fd_);
+            throw ServerError("timerfd_create failed: " + std::string(strerror(errno)));
+        }
+        timers_ = TimerWheel(now_ms());
+    }
+
+    EventLoop::~EventLoop()
+    {
+        close(timer_fd_);
+        close(wakeup_fd_);
+    }
+
+    void EventLoop::watch_internal_fds()
+    {
+        watch(wakeup_fd_, EPOLLIN, [this](uint32_t)
+              {
+                  uint64_t value;
+                  while (read(wakeup_fd_, &value, sizeof(value)) > 0)
+                  {
+                  }
+                  run_pending(); });
+        watch(timer_fd_, EPOLLIN, [this](uint32_t)
+              {
+                  uint64_t expirations;
+                  while (read(timer_fd_, &expirations, sizeof(expirations)) > 0)
+                  {
+                  }
+                  run_timers(); });
+    }
+
+    void EventLoop::post(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex_);
+            pending_.push_back(std::move(task));
+        }
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeup_fd_, &one, sizeof(one));
+        (void)ignored;
+    }
+
+    EventLoop::TimerId EventLoop::run_after(std::chrono::milliseconds delay, std::function<void()> fn)
+    {
+        uint64_t delay_ms = delay.count() > 0 ? static_cast<uint64_t>(delay.count()) : 0;
+        return timers_.schedule(now_ms() + delay_ms, std::move(fn));
+    }
+
+    bool EventLoop::cancel_timer(TimerId id)
+    {
+        return timers_.cancel(id);
+    }
+
+    void EventLoop::defer_accept(AcceptRetry &retry, int error, const AcceptHandler &handler, std::function<void()> resume)
+    {
+        if (retry.timer != 0)
+        {
+            return;
+        }
+        // Las conexiones siguen en la cola: reintentar ya volvería a fallar, se espera cada vez el doble.
+        retry.delay = retry.delay.count() == 0 ? ACCEPT_RETRY_MIN : std::min(retry.delay * 2, ACCEPT_RETRY_MAX);
+        retry.timer = run_after(retry.delay, [&retry, resume = std::move(resume)]
+                                {
+                                    retry.timer = 0;
+                                    resume(); });
+        if (error != retry.error)
+        {
+            retry.error = error;
+            handler(-error);
+        }
+    }
+
+    void EventLoop::rearm_timer()
+    {
+        auto next = timers_.next_expiry();
+        uint64_t expiry = next ? std::max<uint64_t>(*next, 1) : 0;
+        if (expiry == armed_expiry_)
+        {
+            return;
+        }
+        // Un único timerfd one-shot con el próximo vencimiento (0 lo desarma).
+        struct itimerspec spec{};
+        spec.it_value.tv_sec = static_cast<time_t>(expiry / 1000);
+        spec.it_value.tv_nsec = static_cast<long>((expiry % 1000) * 1000000);
+        timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+        armed_expiry_ = expiry;
+    }
+
+    void EventLoop::stop()
+    {
+        running_ = false;
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeup_fd_, &one, sizeof(one));
+        (void)ignored;
+    }
+
+    void EventLoop::run_pending()
+    {
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex_);
+            draining_.swap(pending_);
+        }
+        for (auto &task : draining_)
+        {
+            task();
+        }
+        // Los dos vectores se intercambian en cada vuelta y conservan su capacidad: post() no reserva memoria.
+        draining_.clear();
+    }
+
+    void EventLoop::run_timers()
+    {
+        armed_expiry_ = 0;
+        timers_.advance(now_ms());
+    }
+
+    uint64_t EventLoop::now_ms()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000 + static_cast<uint64_t>(ts.tv_nsec) / 1000000;
+    }
+
+} // namespace BattleshipServer
@@ -0,0 +1,128 @@
+#include "hdr_histogram.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace BattleshipServer
+{
+    namespace
+    {
+        // Un solo escritor por histograma: basta leer y guardar, sin operaciones atómicas de lectura-escritura.
+        void bump(std::atomic<uint64_t> &value, uint64_t amount) noexcept
+        {
+            value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        // Cubo (potencia de dos) y sub-cubo de un valor: los valores menores que 128 van uno por contador.
+        unsigned bucket_of(uint64_t value) noexcept
+        {
+            constexpr uint64_t SUB_BUCKET_MASK = (uint64_t(1) << HdrHistogram::SUB_BUCKET_BITS) - 1;
+            unsigned pow2_ceiling = 64 - static_cast<unsigned>(__builtin_clzll(value | SUB_BUCKET_MASK));
+            return pow2_ceiling - HdrHistogram::SUB_BUCKET_BITS;
+        }
+    }
+
+    size_t HdrHistogram::index_of(uint64_t value) noexcept
+    {
+        unsigned bucket = bucket_of(value);
+        size_t sub_bucket = static_cast<size_t>(value >> bucket);
+        // El primer cubo ocupa 128 contadores; cada uno de los siguientes, solo su mitad superior.
+        return ((static_cast<size_t>(bucket) + 1) << (SUB_BUCKET_BITS - 1)) + sub_bucket - SUB_BUCKET_HALF;
+    }
+
+    uint64_t HdrHistogram::lowest_equivalent(size_t index) noexcept
+    {
+        size_t bucket = index >> (SUB_BUCKET_BITS - 1);
+        size_t sub_bucket = (index & (SUB_BUCKET_HALF - 1)) + SUB_BUCKET_HALF;
+        if (bucket == 0)
+        {
+            return sub_bucket - SUB_BUCKET_HALF;
+        }
+        return static_cast<uint64_t>(sub_bucket) << (bucket - 1);
+    }
+
+    uint64_t HdrHistogram::highest_equivalent(size_t index) noexcept
+    {
+        size_t bucket = index >> (SUB_BUCKET_BITS - 1);
+        uint64_t width = bucket == 0 ? 1 : uint64_t(1) << (bucket - 1);
+        return lowest_equivalent(index) + width - 1;
+    }
+
+    void HdrHistogram::record(uint64_t value) noexcept
+    {
+        value = std::min(value, MAX_VALUE);
+        bump(counts_[index_of(value)], 1);
+        bump(total_, 1);
+        bump(sum_, value);
+        if (value > max_.load(std::memory_order_relaxed))
+        {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    void HdrHistogram::merge_into(HdrHistogram &target) const noexcept
+    {
+        for (size_t i = 0; i < COUNTS; ++i)
+        {
+            uint64_t samples = counts_[i].load(std::memory_order_relaxed);
+            if (samples != 0)
+            {
+                bump(target.counts_[i], samples);
+            }
+        }
+        bump(target.total_, total_.load(std::memory_order_relaxed));
+        bump(target.sum_, sum_.load(std::memory_order_relaxed));
+        target.max_.store(std::max(target.max(), max()), std::memory_order_relaxed);
+    }
+
+    void HdrHistogram::reset() noexcept
+    {
+        for (auto &count : counts_)
+        {
+            count.store(0, std::memory_order_relaxed);
+        }
+        total_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    double HdrHistogram::mean() const noexcept
+    {
+        uint64_t samples = count();
+        return samples == 0 ? 0.0 : static_cast<double>(sum()) / static_cast<double>(samples);
+    }
+
+    uint64_t HdrHistogram::value_at_percentile(double percentile) const noexcept
+    {
+        uint64_t samples = count();
+        if (samples == 0)
+        {
+            return 0;
+        }
+        percentile = std::clamp(percentile, 0.0, 100.0);
+        // Posición (1..count) de la muestra buscada: p99.9 de 1000 muestras es la número 999.
+        uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(samples)));
+        rank = std::clamp<uint64_t>(rank, 1, samples);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < COUNTS; ++i)
+        {
+            seen += counts_[i].load(std::memory_order_relaxed);
+            if (seen >= rank)
+            {
+                return std::min(highest_equivalent(i), max());
+            }
+        }
+        return max();
+    }
+
+    uint64_t HdrHistogram::count_at_or_below(uint64_t value) const noexcept
+    {
+        size_t last = index_of(std::min(value, MAX_VALUE));
+        uint64_t samples = 0;
+        for (size_t i = 0; i <= last; ++i)
+        {
+            samples += counts_[i].load(std::memory_order_relaxed);
+        }
+        return samples;
+    }
+
+} // namespace BattleshipServer
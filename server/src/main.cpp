@@ -1,9 +1,26 @@
 // ~/universidad/telematica/test/server/src/main.cpp
 #include "server.hpp"
+#include "trace.hpp"
 #include <iostream>
 #include <cstdlib>
 #include <stdexcept>
 
+/**
+ * @brief Convierte un argumento numérico no negativo.
+ *
+ * @param value Texto a convertir.
+ * @param what Nombre del parámetro para el mensaje de error.
+ * @return Valor convertido.
+ * @throws std::invalid_argument o std::out_of_range si el valor no es válido.
+ */
+static unsigned parse_count(const std::string& value, const std::string& what) {
+    int parsed = std::stoi(value);
+    if (parsed < 0) {
+        throw std::out_of_range(what + " cannot be negative");
+    }
+    return static_cast<unsigned>(parsed);
+}
+
 /**
  * @brief Punto de entrada principal para el servidor de Batalla Naval.
  *
@@ -11,14 +28,26 @@
  * proporcionados por la línea de comandos.
  *
  * @param argc Número de argumentos de la línea de comandos.
- * @param argv Array de argumentos: [0] nombre del programa, [1] IP, [2] puerto, [3] ruta de log.
+ * @param argv Array de argumentos: [0] nombre del programa, [1] IP, [2] puerto, [3] ruta de log,
+ *             seguidos de opciones: --loops N (shards de aceptación; 0 usa uno por núcleo; también se acepta N suelto),
+ *             --backlog N (cola de conexiones pendientes de cada listener),
+ *             --workers N (hilos de las sesiones; 0 usa uno por núcleo),
+ *             --backend epoll|io_uring, --turn-time SEGUNDOS (admite decimales),
+ *             --log-flush-ms MS, --log-buffer-kb KB (cola de log por hilo),
+ *             --log-stdout (copia el log también a la salida estándar),
+ *             --trace NIVEL|categoría=nivel,... (trazas de depuración, por ejemplo wire=debug),
+ *             --metrics-port PUERTO (métricas Prometheus en http://127.0.0.1:PUERTO/metrics),
+ *             --stats-interval SEGUNDOS (percentiles de latencia en el log; 0 solo con SIGUSR1),
+ *             --admin-socket RUTA (socket Unix de administración: sesiones, tableros, trazas, drenado),
+ *             --inherit-from RUTA (toma los sockets de escucha del servidor con ese socket de administración) y
+ *             --journal RUTA|none (diario binario de eventos; por defecto <log>.journal).
  * @return 0 si la ejecución es exitosa, 1 si hay un error.
  */
 int main(int argc, char* argv[]) {
     // Verificar el número correcto de argumentos
-    if (argc != 4) {
-        std::cerr << "Usage: " << argv[0] << " <ip> <port> </path/log.log>\n";
-        std::cerr << "Example: " << argv[0] << " 0.0.0.0 8080 ./logs/server.log\n";
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " <ip> <port> </path/log.log> [--loops N] [--backlog N] [--workers N] [--backend epoll|io_uring] [--turn-time SECONDS] [--log-flush-ms MS] [--log-buffer-kb KB] [--log-stdout] [--trace LEVEL|CATEGORY=LEVEL,...] [--metrics-port PORT] [--stats-interval SECONDS] [--admin-socket PATH] [--inherit-from PATH] [--journal PATH|none]\n";
+        std::cerr << "Example: " << argv[0] << " 0.0.0.0 8080 ./logs/server.log --loops 4 --backend io_uring --turn-time 30\n";
         return 1;
     }
 
@@ -36,9 +65,68 @@ int main(int argc, char* argv[]) {
     }
     std::string log_path = argv[3];
 
+    BattleshipServer::ServerOptions options;
+    options.journal_path = log_path + ".journal";
+    for (int i = 4; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg == "--loops" && i + 1 < argc) {
+                options.event_loops = parse_count(argv[++i], "Event loop count");
+            } else if (arg == "--backlog" && i + 1 < argc) {
+                unsigned backlog = parse_count(argv[++i], "Listen backlog");
+                if (backlog == 0) {
+                    throw std::out_of_range("Listen backlog must be positive");
+                }
+                options.backlog = static_cast<int>(backlog);
+            } else if (arg == "--workers" && i + 1 < argc) {
+                options.workers = parse_count(argv[++i], "Worker count");
+            } else if (arg == "--backend" && i + 1 < argc) {
+                options.backend = BattleshipServer::io_backend_from_string(argv[++i]);
+            } else if (arg == "--turn-time" && i + 1 < argc) {
+                double seconds = std::stod(argv[++i]);
+                if (!(seconds > 0)) {
+                    throw std::out_of_range("Turn time must be positive");
+                }
+                options.turn_timeout = std::chrono::milliseconds(static_cast<long long>(seconds * 1000));
+            } else if (arg == "--log-flush-ms" && i + 1 < argc) {
+                options.logging.flush_interval = std::chrono::milliseconds(parse_count(argv[++i], "Log flush interval"));
+            } else if (arg == "--log-buffer-kb" && i + 1 < argc) {
+                options.logging.buffer_bytes = static_cast<size_t>(parse_count(argv[++i], "Log buffer size")) * 1024;
+            } else if (arg == "--log-stdout") {
+                options.logging.echo_stdout = true;
+            } else if (arg == "--trace" && i + 1 < argc) {
+                BattleshipServer::Trace::configure(argv[++i]);
+            } else if (arg == "--metrics-port" && i + 1 < argc) {
+                unsigned metrics_port = parse_count(argv[++i], "Metrics port");
+                if (metrics_port < 1 || metrics_port > 65535) {
+                    throw std::out_of_range("Port out of valid range (1-65535)");
+                }
+                options.metrics_port = static_cast<int>(metrics_port);
+            } else if (arg == "--stats-interval" && i + 1 < argc) {
+                options.stats_interval = std::chrono::seconds(parse_count(argv[++i], "Stats interval"));
+            } else if (arg == "--admin-socket" && i + 1 < argc) {
+                options.admin_path = argv[++i];
+            } else if (arg == "--inherit-from" && i + 1 < argc) {
+                options.inherit_path = argv[++i];
+            } else if (arg == "--journal" && i + 1 < argc) {
+                std::string path = argv[++i];
+                options.journal_path = path == "none" ? "" : path;
+            } else if (i == 4 && !arg.empty() && arg[0] != '-') {
+                // Forma anterior: el cuarto argumento es el número de event loops.
+                options.event_loops = parse_count(arg, "Event loop count");
+            } else {
+                std::cerr << "Unknown or incomplete option: " << arg << "\n";
+                return 1;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Invalid value for " << arg << ": " << argv[i] << " (" << e.what() << ")\n";
+            return 1;
+        }
+    }
+
     // Iniciar el servidor
     try {
-        BattleshipServer::Server server(ip, port, log_path);
+        BattleshipServer::Server server(ip, port, log_path, options);
         server.run();
     } catch (const BattleshipServer::ServerError& e) {
         std::cerr << "Server error: " << e.what() << std::endl;
@@ -0,0 +1,329 @@
+#include "metrics.hpp"
+#include <algorithm>
+#include <charconv>
+
+namespace BattleshipServer
+{
+    namespace
+    {
+        // Identificadores únicos: una dirección de Metrics puede reutilizarse, un id no.
+        std::atomic<uint64_t> next_metrics_id{1};
+
+        constexpr std::string_view MESSAGE_TYPE_LABELS[] = {"REGISTER", "PLACE_SHIPS", "SHOOT", "STATUS", "SURRENDER", "GAME_OVER",
+                                                            "ERROR", "PLAYER_ID", "HELLO", "STATUS_DELTA", "RESYNC"};
+        static_assert(std::size(MESSAGE_TYPE_LABELS) == Metrics::MESSAGE_TYPES);
+
+        constexpr std::string_view PHASE_LABELS[] = {"registration", "placement", "playing", "finished"};
+        static_assert(std::size(PHASE_LABELS) == Metrics::PHASES);
+
+        constexpr std::string_view STAGE_LABELS[] = {"parse", "game_logic", "send", "strand_wait", "process_shot",
+                                                     "get_status", "build_message", "turn"};
+        static_assert(std::size(STAGE_LABELS) == Metrics::STAGES);
+
+        struct CounterInfo
+        {
+            std::string_view name;
+            std::string_view help;
+        };
+
+        constexpr CounterInfo COUNTER_INFO[] = {
+            {"battleship_sessions_started_total", "Sessions created for a pair of clients."},
+            {"battleship_sessions_finished_total", "Sessions that finished and were handed back for reclamation."},
+            {"battleship_parse_errors_total", "Frames from players that could not be parsed."},
+            {"battleship_turn_timeouts_total", "Turns lost because the player did not shoot in time."},
+            {"battleship_disconnects_total", "Players that went away before their match ended."}};
+        static_assert(std::size(COUNTER_INFO) == Metrics::COUNTERS);
+
+        // Solo escribe el hilo dueño del shard: basta leer y guardar, sin operaciones atómicas de lectura-escritura.
+        template <typename T, typename U>
+        void bump(std::atomic<T> &value, U amount) noexcept
+        {
+            value.store(value.load(std::memory_order_relaxed) + static_cast<T>(amount), std::memory_order_relaxed);
+        }
+
+        void append_number(std::string &out, uint64_t value)
+        {
+            char digits[24];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            out.append(digits, result.ptr);
+        }
+
+        void append_number(std::string &out, int64_t value)
+        {
+            char digits[24];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            out.append(digits, result.ptr);
+        }
+
+        void append_number(std::string &out, double value)
+        {
+            char digits[32];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            out.append(digits, result.ptr);
+        }
+
+        void append_header(std::string &out, std::string_view name, std::string_view help, std::string_view type)
+        {
+            out.append("# HELP ").append(name).append(" ").append(help).append("\n");
+            out.append("# TYPE ").append(name).append(" ").append(type).append("\n");
+        }
+
+        // Cubos acumulativos de Prometheus a partir del histograma HDR, con la etiqueta dada (o sin ella).
+        void append_histogram(std::string &out, std::string_view name, std::string_view label, const HdrHistogram &histogram)
+        {
+            auto series = [&](std::string_view suffix)
+            {
+                out.append(name).append(suffix);
+                if (!label.empty())
+                    out.append("{").append(label);
+            };
+            for (uint64_t bound_us : Metrics::LATENCY_BOUNDS_US)
+            {
+                series("_bucket");
+                out.append(label.empty() ? "{le=\"" : ",le=\"");
+                append_number(out, static_cast<double>(bound_us) / 1e6);
+                out.append("\"} ");
+                append_number(out, histogram.count_at_or_below(bound_us * 1000));
+                out += '\n';
+            }
+            series("_bucket");
+            out.append(label.empty() ? "{le=\"+Inf\"} " : ",le=\"+Inf\"} ");
+            append_number(out, histogram.count());
+            out += '\n';
+            series("_sum");
+            out.append(label.empty() ? " " : "} ");
+            append_number(out, static_cast<double>(histogram.sum()) / 1e9);
+            out += '\n';
+            series("_count");
+            out.append(label.empty() ? " " : "} ");
+            append_number(out, histogram.count());
+            out += '\n';
+        }
+
+        void append_duration(std::string &out, std::string_view name, uint64_t ns)
+        {
+            out.append(name).append("=");
+            char digits[32];
+            auto result = ns >= 1000000 ? std::to_chars(digits, digits + sizeof(digits), static_cast<double>(ns) / 1e6, std::chars_format::fixed, 2)
+                                        : std::to_chars(digits, digits + sizeof(digits), static_cast<double>(ns) / 1e3, std::chars_format::fixed, 1);
+            out.append(digits, result.ptr);
+            out.append(ns >= 1000000 ? "ms" : "us");
+        }
+    }
+
+    /**
+     * @brief Values recorded by one thread, on cache lines no other thread writes.
+     */
+    struct alignas(64) Metrics::Shard
+    {
+        std::array<std::atomic<uint64_t>, COUNTERS> counters{};          ///< Indexed by Counter.
+        std::array<std::atomic<uint64_t>, MESSAGE_TYPES> messages_in{};  ///< Indexed by MessageType.
+        std::array<std::atomic<uint64_t>, MESSAGE_TYPES> bytes_in{};     ///< Indexed by MessageType.
+        std::array<std::atomic<uint64_t>, MESSAGE_TYPES> messages_out{}; ///< Indexed by MessageType.
+        std::array<std::atomic<uint64_t>, MESSAGE_TYPES> bytes_out{};    ///< Indexed by MessageType.
+        std::array<std::atomic<int64_t>, PHASES> phases{};               ///< Sessions entered minus left, by phase.
+        std::array<HdrHistogram, STAGES> stages{};                       ///< Latencies in nanoseconds, indexed by Stage.
+    };
+
+    Metrics::Metrics() : id_(next_metrics_id.fetch_add(1)) {}
+
+    Metrics::~Metrics() = default;
+
+    Metrics::Shard &Metrics::local_shard()
+    {
+        // Caché por hilo de (métricas, shard); el id evita confundir unas métricas destruidas con otras nuevas.
+        thread_local std::vector<std::pair<uint64_t, Shard *>> cache;
+        for (const auto &[id, shard] : cache)
+        {
+            if (id == id_)
+            {
+                return *shard;
+            }
+        }
+        std::lock_guard<std::mutex> lock(shards_mutex_);
+        shards_.push_back(std::make_unique<Shard>());
+        cache.emplace_back(id_, shards_.back().get());
+        return *shards_.back();
+    }
+
+    void Metrics::add(Counter counter, uint64_t amount)
+    {
+        bump(local_shard().counters[static_cast<size_t>(counter)], amount);
+    }
+
+    void Metrics::message_in(BattleShipProtocol::MessageType type, size_t bytes)
+    {
+        Shard &shard = local_shard();
+        size_t index = static_cast<size_t>(type);
+        bump(shard.messages_in[index], 1);
+        bump(shard.bytes_in[index], bytes);
+    }
+
+    void Metrics::message_out(BattleShipProtocol::MessageType type, size_t bytes)
+    {
+        Shard &shard = local_shard();
+        size_t index = static_cast<size_t>(type);
+        bump(shard.messages_out[index], 1);
+        bump(shard.bytes_out[index], bytes);
+    }
+
+    void Metrics::enter_phase(BattleShipProtocol::PhaseState::Phase phase)
+    {
+        bump(local_shard().phases[static_cast<size_t>(phase)], 1);
+    }
+
+    void Metrics::leave_phase(BattleShipProtocol::PhaseState::Phase phase)
+    {
+        bump(local_shard().phases[static_cast<size_t>(phase)], -1);
+    }
+
+    void Metrics::observe(Stage stage, std::chrono::nanoseconds elapsed)
+    {
+        uint64_t ns = static_cast<uint64_t>(std::max<int64_t>(elapsed.count(), 0));
+        local_shard().stages[static_cast<size_t>(stage)].record(ns);
+    }
+
+    uint64_t Metrics::counter(Counter counter) const
+    {
+        std::lock_guard<std::mutex> lock(shards_mutex_);
+        uint64_t total = 0;
+        for (const auto &shard : shards_)
+        {
+            total += shard->counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    std::pair<uint64_t, uint64_t> Metrics::messages(BattleShipProtocol::MessageType type, bool inbound) const
+    {
+        std::lock_guard<std::mutex> lock(shards_mutex_);
+        size_t index = static_cast<size_t>(type);
+        std::pair<uint64_t, uint64_t> total{0, 0};
+        for (const auto &shard : shards_)
+        {
+            total.first += (inbound ? shard->messages_in : shard->messages_out)[index].load(std::memory_order_relaxed);
+            total.second += (inbound ? shard->bytes_in : shard->bytes_out)[index].load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    int64_t Metrics::sessions_in(BattleShipProtocol::PhaseState::Phase phase) const
+    {
+        std::lock_guard<std::mutex> lock(shards_mutex_);
+        int64_t total = 0;
+        for (const auto &shard : shards_)
+        {
+            total += shard->phases[static_cast<size_t>(phase)].load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    void Metrics::histogram(Stage stage, HdrHistogram &out) const
+    {
+        std::lock_guard<std::mutex> lock(shards_mutex_);
+        for (const auto &shard : shards_)
+        {
+            shard->stages[static_cast<size_t>(stage)].merge_into(out);
+        }
+    }
+
+    std::string Metrics::latency_summary(Stage stage) const
+    {
+        // 16 KB de contadores: se reservan una vez por llamada, fuera de cualquier camino caliente.
+        auto merged = std::make_unique<HdrHistogram>();
+        histogram(stage, *merged);
+        std::string out = "count=";
+        append_number(out, merged->count());
+        append_duration(out, " mean", static_cast<uint64_t>(merged->mean()));
+        append_duration(out, " p50", merged->value_at_percentile(50));
+        append_duration(out, " p90", merged->value_at_percentile(90));
+        append_duration(out, " p99", merged->value_at_percentile(99));
+        append_duration(out, " p99.9", merged->value_at_percentile(99.9));
+        append_duration(out, " max", merged->max());
+        return out;
+    }
+
+    std::string_view Metrics::stage_name(Stage stage) noexcept
+    {
+        size_t index = static_cast<size_t>(stage);
+        return index < STAGES ? STAGE_LABELS[index] : "unknown";
+    }
+
+    std::string_view Metrics::phase_name(BattleShipProtocol::PhaseState::Phase phase) noexcept
+    {
+        size_t index = static_cast<size_t>(phase);
+        return index < PHASES ? PHASE_LABELS[index] : "unknown";
+    }
+
+    void Metrics::render(std::string &out) const
+    {
+        for (size_t i = 0; i < COUNTERS; ++i)
+        {
+            append_header(out, COUNTER_INFO[i].name, COUNTER_INFO[i].help, "counter");
+            out.append(COUNTER_INFO[i].name).append(" ");
+            append_number(out, counter(static_cast<Counter>(i)));
+            out += '\n';
+        }
+
+        append_header(out, "battleship_sessions_by_phase", "Sessions in each phase of the match.", "gauge");
+        for (size_t i = 0; i < PHASES; ++i)
+        {
+            out.append("battleship_sessions_by_phase{phase=\"").append(PHASE_LABELS[i]).append("\"} ");
+            append_number(out, sessions_in(static_cast<BattleShipProtocol::PhaseState::Phase>(i)));
+            out += '\n';
+        }
+
+        struct MessageFamily
+        {
+            std::string_view name;
+            std::string_view help;
+            bool inbound;
+            bool bytes;
+        };
+        constexpr MessageFamily FAMILIES[] = {
+            {"battleship_messages_received_total", "Messages received from players, by type.", true, false},
+            {"battleship_bytes_received_total", "Bytes of the messages received from players, by type.", true, true},
+            {"battleship_messages_sent_total", "Messages sent to players, by type.", false, false},
+            {"battleship_bytes_sent_total", "Bytes of the messages sent to players, by type.", false, true}};
+        for (const auto &family : FAMILIES)
+        {
+            append_header(out, family.name, family.help, "counter");
+            for (size_t i = 0; i < MESSAGE_TYPES; ++i)
+            {
+                auto [count, bytes] = messages(static_cast<BattleShipProtocol::MessageType>(i), family.inbound);
+                out.append(family.name).append("{type=\"").append(MESSAGE_TYPE_LABELS[i]).append("\"} ");
+                append_number(out, family.bytes ? bytes : count);
+                out += '\n';
+            }
+        }
+
+        auto merged = std::make_unique<HdrHistogram>();
+        constexpr std::string_view STAGE_HISTOGRAM = "battleship_stage_duration_seconds";
+        append_header(out, STAGE_HISTOGRAM, "Time spent in each processing stage.", "histogram");
+        std::string label;
+        for (size_t stage = 0; stage < STAGES; ++stage)
+        {
+            if (static_cast<Stage>(stage) == Stage::TURN)
+                continue;
+            merged->reset();
+            histogram(static_cast<Stage>(stage), *merged);
+            label.assign("stage=\"").append(STAGE_LABELS[stage]).append("\"");
+            append_histogram(out, STAGE_HISTOGRAM, label, *merged);
+        }
+
+        constexpr std::string_view TURN_HISTOGRAM = "battleship_turn_round_trip_seconds";
+        append_header(out, TURN_HISTOGRAM, "From a SHOOT frame arriving to both STATUS messages handed to the sockets.", "histogram");
+        merged->reset();
+        histogram(Stage::TURN, *merged);
+        append_histogram(out, TURN_HISTOGRAM, "", *merged);
+    }
+
+    void Metrics::render_gauge(std::string &out, std::string_view name, std::string_view help, int64_t value)
+    {
+        append_header(out, name, help, "gauge");
+        out.append(name).append(" ");
+        append_number(out, value);
+        out += '\n';
+    }
+
+} // namespace BattleshipServer
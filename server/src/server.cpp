@@ -1,648 +1,1903 @@
 #include "server.hpp"
-#include <iostream>
+#include "alloc_stats.hpp"
+#include "trace.hpp"
 #include <set>
 #include <iterator>
 #include <cstring>
+#include <cstdio>
 #include <unistd.h>
+#include <fcntl.h>
+#include <csignal>
+#include <sys/signalfd.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <charconv>
 #include <arpa/inet.h>
+#include <netinet/tcp.h>
 #include <ctime>
 #include <iomanip>
 #include <sstream>
 #include <chrono>
+#include <algorithm>
 
 namespace BattleshipServer
 {
-    GameSession::GameSession(int session_id) : session_id_(session_id), game_(std::make_unique<BattleShipProtocol::GameLogic>()) {}
-    GameSession::~GameSession()
+    namespace
     {
-        for (auto &[id, info] : players_)
+        BattleShipProtocol::JournalRecord journal_event(BattleShipProtocol::JournalEvent type, int player_id)
         {
-            if (info.first > 0)
-            {
-                close(info.first);
-            }
+            BattleShipProtocol::JournalRecord record;
+            record.type = type;
+            record.player = static_cast<uint8_t>(player_id);
+            return record;
         }
-        if (session_thread_.joinable())
+
+        BattleShipProtocol::JournalRecord phase_event(BattleShipProtocol::PhaseState::Phase phase)
         {
-            session_thread_.join();
+            auto record = journal_event(BattleShipProtocol::JournalEvent::PHASE, 0);
+            record.value = static_cast<uint8_t>(phase);
+            return record;
         }
     }
 
-    void GameSession::add_player(int player_id, int client_fd, const std::string &client_ip)
+    GameSession::GameSession(int session_id, EventLoop &loop, WorkerPool &pool, Metrics &metrics, std::chrono::milliseconds turn_timeout)
+        : session_id_(session_id), loop_(loop), strand_(std::make_shared<Strand>(pool)), metrics_(metrics),
+          arena_(arena_buffer_.data(), arena_buffer_.size()), pool_(&arena_), outboxes_(&pool_),
+          outbox_(&outboxes_.emplace_back(&pool_)), players_(&pool_), turn_timeout_(turn_timeout) {}
+
+    void *GameSession::operator new(size_t size)
     {
-        if (is_full())
+        // Una subclase más grande no cabe en los bloques del pool.
+        if (size != memory_pool().block_size())
+            return ::operator new(size);
+        return memory_pool().allocate();
+    }
+
+    void GameSession::operator delete(void *ptr, size_t size) noexcept
+    {
+        if (size != memory_pool().block_size())
         {
-            throw ServerError("Session " + std::to_string(session_id_) + " is already full");
+            ::operator delete(ptr);
+            return;
         }
-        players_[player_id] = {client_fd, client_ip};
+        memory_pool().deallocate(ptr);
+    }
 
-        try
+    SlabPool &GameSession::memory_pool()
+    {
+        // Estático local: vive hasta el final del proceso, después de cualquier Server.
+        static SlabPool pool(sizeof(GameSession), 64);
+        return pool;
+    }
+
+    GameSession::~GameSession()
+    {
+        for (auto &[id, slot] : players_)
         {
-            BattleShipProtocol::Message player_id_msg{
-                BattleShipProtocol::MessageType::PLAYER_ID,
-                BattleShipProtocol::PlayerIdData{player_id}};
-            send_message(client_fd, player_id_msg, protocol_);
-            std::cout << "Enviado PLAYER_ID a " << client_ip << ": " << protocol_.build_message(player_id_msg) << std::endl;
-            if (!log_fn_)
+            // Sin conexión el descriptor nunca llegó al loop y sigue siendo nuestro.
+            if (!slot.connection && slot.fd > 0)
             {
-                std::cerr << "Error: log_fn_ está vacío en add_player" << std::endl;
-                throw ServerError("Logging function is not initialized");
+                close(slot.fd);
             }
-            log_fn_(client_ip, protocol_.build_message(player_id_msg), "Player " + std::to_string(player_id) + " assigned", "INFO");
         }
-        catch (const std::exception &e)
+    }
+
+    void GameSession::add_player(int player_id, int client_fd, const std::string &client_ip)
+    {
+        if (is_full())
         {
-            if (log_fn_)
-            {
-                log_fn_(client_ip, "PLAYER_ID assignment failed", e.what(), "ERROR");
-            }
-            else
-            {
-                std::cerr << "Error: log_fn_ vacío, no se puede loguear: " << e.what() << std::endl;
-            }
-            throw;
+            throw ServerError("Session " + std::to_string(session_id_) + " is already full");
         }
+        auto &slot = players_.try_emplace(player_id, &pool_).first->second;
+        slot.fd = client_fd;
+        slot.ip = client_ip;
     }
 
     int GameSession::get_client_fd(int player_id) const
     {
-        return players_.at(player_id).first;
+        return players_.at(player_id).fd;
     }
 
     std::string GameSession::get_player_ip(int player_id) const
     {
-        return players_.at(player_id).second;
+        return players_.at(player_id).ip;
     }
 
-    void GameSession::start(const BattleShipProtocol::Protocol &protocol,
-                            std::function<void(const std::string &, const std::string &, const std::string &, const std::string &)> log_fn)
+    void GameSession::start(const BattleShipProtocol::Protocol &protocol, LogFn log_fn, JournalFn journal_fn, FinishedFn finished_fn)
     {
         protocol_ = protocol;
         log_fn_ = log_fn;
-        session_thread_ = std::thread(&GameSession::run_session, this, std::cref(protocol), log_fn_);
+        journal_fn_ = std::move(journal_fn);
+        finished_fn_ = std::move(finished_fn);
+        metrics_.add(Counter::SESSIONS_STARTED);
+        metrics_.enter_phase(metered_phase_);
+        loop_.post([this]
+                   { begin(); });
     }
 
-    void GameSession::run_session(const BattleShipProtocol::Protocol &protocol,
-                                  std::function<void(const std::string &, const std::string &, const std::string &, const std::string &)> log_fn)
+    void GameSession::begin()
     {
-        auto send_fn = [&](int fd, const BattleShipProtocol::Message &msg)
-        { send_message(fd, msg, protocol_); };
+        BATTLESHIP_TRACE(SESSION, DEBUG, "Iniciando fase REGISTRATION para sesión ", session_id_);
+        for (auto &[player_id, slot] : players_)
+        {
+            int id = player_id;
+            slot.connection = loop_.make_connection(slot.fd);
+            slot.connection->open(
+                [this, id](std::string_view line)
+                { on_line(id, line); },
+                [this, id](const std::string &reason)
+                { dispatch([this, id, reason]
+                           { handle_disconnect(id, reason); }); });
+        }
+        // Los frames de los jugadores llegan en vueltas posteriores del loop: el saludo va primero en la strand.
+        dispatch([this]
+                 { greet(); });
+    }
 
-        auto handle_disconnect = [&](int player_id, const std::string &client_ip, const std::string &reason)
+    void GameSession::greet()
+    {
+        for (auto &[player_id, slot] : players_)
         {
-            std::cout << "[DEBUG] Jugador " << player_id << " desconectado: " << reason << std::endl;
-            log_fn(client_ip, "Client disconnected", reason, "ERROR");
+            auto joined = journal_event(BattleShipProtocol::JournalEvent::PLAYER_JOINED, player_id);
+            joined.text = slot.ip;
+            journal(std::move(joined));
+        }
 
-            if (players_[player_id].first > 0)
+        for (auto &[player_id, slot] : players_)
+        {
+            if (ending_)
+                return;
+            try
             {
-                close(players_[player_id].first);
-                players_[player_id].first = -1;
+                BattleShipProtocol::Message player_id_msg{
+                    BattleShipProtocol::MessageType::PLAYER_ID,
+                    BattleShipProtocol::PlayerIdData{player_id}};
+                send_message(player_id, player_id_msg);
+                BATTLESHIP_TRACE(WIRE, DEBUG, "Enviado PLAYER_ID a ", slot.ip, ": ", player_id);
+                log_fn_(slot.ip, protocol_.build_message(player_id_msg), "Player " + std::to_string(player_id) + " assigned", "INFO");
             }
-
-            int remaining_player = (player_id == 1) ? 2 : 1;
-            int remaining_fd = players_[remaining_player].first;
-            std::string remaining_ip = players_[remaining_player].second;
-
-            if (remaining_fd > 0)
+            catch (const std::exception &e)
             {
-                try
-                {
-                    send_fn(remaining_fd, {BattleShipProtocol::MessageType::ERROR, BattleShipProtocol::ErrorData{400, "Opponent disconnected"}});
-                    close(remaining_fd);
-                    players_[remaining_player].first = -1;
-                }
-                catch (const std::exception &e)
-                {
-                    log_fn(remaining_ip, "Failed to notify", e.what(), "ERROR");
-                }
+                log_fn_(slot.ip, "PLAYER_ID assignment failed", e.what(), "ERROR");
+                handle_disconnect(player_id, e.what());
+                return;
             }
+        }
+#ifdef BATTLESHIP_COROUTINES
+        // A partir de aquí los mensajes los consume el flujo de la partida, que corre hasta su primer receive().
+        flow_ = run_flow();
+        flow_.start();
+#endif
+    }
 
-            finished_ = true;
-        };
+    void GameSession::journal(BattleShipProtocol::JournalRecord record)
+    {
+        if (!journal_fn_)
+            return;
+        record.session = static_cast<uint32_t>(session_id_);
+        outbox_->journal.push_back(std::move(record));
+    }
 
-        auto send_status = [&](int player_id, int current_turn)
+    // Plantilla definida aquí: solo se instancia en este archivo.
+    template <typename Task>
+    void GameSession::dispatch(Task &&task)
+    {
+        // La tarea se guarda tal cual dentro de la de la strand: un solo std::function por evento.
+        strand_->post([this, task = std::forward<Task>(task), posted = std::chrono::steady_clock::now()]() mutable
+                      {
+                          uint64_t before = AllocStats::thread_allocations();
+                          auto started = std::chrono::steady_clock::now();
+                          metrics_.observe(Stage::STRAND_WAIT, started - posted);
+                          task();
+                          // Solo las tareas de un frame fijan la llegada; un timeout no mide ida y vuelta.
+                          received_ = {};
+                          metrics_.observe(Stage::GAME_LOGIC, std::chrono::steady_clock::now() - started);
+                          meter_phase();
+                          flush_output();
+                          strand_allocations_ += AllocStats::thread_allocations() - before; });
+    }
+
+    void GameSession::meter_phase()
+    {
+        auto phase = game_.get_phase();
+        if (phase != metered_phase_)
         {
-            int client_fd = players_.at(player_id).first;
-            std::string client_ip = players_.at(player_id).second;
-            if (client_fd <= 0)
-                return;
+            metrics_.leave_phase(metered_phase_);
+            metrics_.enter_phase(phase);
+            metered_phase_ = phase;
+        }
+    }
 
-            try
-            {
-                auto status = game_->get_status(player_id);
-                int time_remaining = 0;
-                if (game_->get_phase() == BattleShipProtocol::PhaseState::Phase::PLAYING)
-                {
-                    auto now = std::chrono::steady_clock::now();
-                    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - turn_start_time_).count();
-                    time_remaining = std::max(0, TURN_TIMEOUT_SECONDS - static_cast<int>(elapsed));
-                }
+    void GameSession::flush_output()
+    {
+        if (outbox_->empty())
+            return;
+        // Un solo post por tarea: el loop aplica los envíos en el orden en que la strand los generó.
+        // Se pasa el puntero: la lambda cabe en el std::function sin reservar memoria.
+        Outbox *outbox = outbox_;
+        loop_.post([this, outbox]
+                   { apply_output(*outbox); });
+        outbox_ = next_outbox();
+    }
 
-                BattleShipProtocol::Turn turn_view = (player_id == current_turn)
-                                                         ? BattleShipProtocol::Turn::YOUR_TURN
-                                                         : BattleShipProtocol::Turn::OPPONENT_TURN;
+    GameSession::Outbox *GameSession::next_outbox()
+    {
+        if (free_outboxes_ == nullptr)
+        {
+            // Se toman de una vez todos los que el loop devolvió; solo la strand saca de la lista.
+            free_outboxes_ = spare_outboxes_.exchange(nullptr, std::memory_order_acquire);
+        }
+        if (free_outboxes_ == nullptr)
+        {
+            return &outboxes_.emplace_back(&pool_);
+        }
+        Outbox *outbox = free_outboxes_;
+        free_outboxes_ = outbox->next;
+        outbox->next = nullptr;
+        return outbox;
+    }
 
-                BattleShipProtocol::Message status_msg{
-                    BattleShipProtocol::MessageType::STATUS,
-                    BattleShipProtocol::StatusData{
-                        turn_view,
-                        status.boardOwn,
-                        status.boardOpponent,
-                        status.gameState,
-                        time_remaining}};
+    void GameSession::recycle_output(Outbox &outbox)
+    {
+        // clear() no libera los vectores (son de la arena, que solo toca la strand): conservan su capacidad.
+        outbox.clear();
+        Outbox *head = spare_outboxes_.load(std::memory_order_relaxed);
+        do
+        {
+            outbox.next = head;
+        } while (!spare_outboxes_.compare_exchange_weak(head, &outbox, std::memory_order_release, std::memory_order_relaxed));
+    }
 
-                send_message(client_fd, status_msg, protocol_);
-                log_fn(client_ip, protocol_.build_message(status_msg), "Status sent", "INFO");
-            }
-            catch (const std::exception &e)
+    void GameSession::apply_output(Outbox &outbox)
+    {
+        uint64_t before = AllocStats::thread_allocations();
+        if (journal_fn_)
+        {
+            for (auto &record : outbox.journal)
             {
-                log_fn(client_ip, "Failed to send status", e.what(), "ERROR");
+                journal_fn_(record);
             }
-        };
-
-        try
+        }
+        if (!outbox.sends.empty())
         {
-            // Fase de Registro
-            std::cout << "[DEBUG] Iniciando fase REGISTRATION para sesión " << session_id_ << std::endl;
-            std::set<int> registered_players;
-            while (registered_players.size() < 2 && !finished_)
+            auto started = std::chrono::steady_clock::now();
+            auto sent = started;
+            std::string_view data = outbox.data;
+            for (const auto &send : outbox.sends)
             {
-                for (int i = 1; i <= 2; ++i)
+                auto &connection = players_.at(send.player).connection;
+                if (connection && connection->is_open())
                 {
-                    if (registered_players.count(i))
-                        continue;
-                    int client_fd = players_.at(i).first;
-                    std::string client_ip = players_.at(i).second;
-                    try
-                    {
-                        std::cout << "[DEBUG] Esperando REGISTER de jugador " << i << " (client_fd: " << client_fd << ")" << std::endl;
-                        auto messages = receive_messages(client_fd);
-                        for (const auto &msg : messages)
-                        {
-                            if (game_->get_phase() != BattleShipProtocol::PhaseState::Phase::REGISTRATION)
-                            {
-                                std::cerr << "[ERROR] Fase inválida para mensaje recibido en REGISTRATION" << std::endl;
-                                send_fn(client_fd, {BattleShipProtocol::MessageType::ERROR, BattleShipProtocol::ErrorData{400, "Mensaje recibido en fase incorrecta"}});
-                                continue;
-                            }
-                            if (msg.type != BattleShipProtocol::MessageType::REGISTER)
-                            {
-                                std::cerr << "[ERROR] Mensaje inesperado en REGISTRATION: " << protocol_.build_message(msg) << std::endl;
-                                send_fn(client_fd, {BattleShipProtocol::MessageType::ERROR, BattleShipProtocol::ErrorData{400, "Esperado REGISTER"}});
-                                continue;
-                            }
-                            game_->register_player(i, std::get<BattleShipProtocol::RegisterData>(msg.data));
-                            std::cout << "[DEBUG] Jugador " << i << " registrado correctamente" << std::endl;
-                            log_fn(client_ip, protocol_.build_message(msg), "Player " + std::to_string(i) + " registered", "INFO");
-                            registered_players.insert(i);
-                            break;
-                        }
-                    }
-                    catch (const BattleShipProtocol::ProtocolError &e)
-                    {
-                        handle_disconnect(i, client_ip, e.what());
-                        return;
-                    }
-                    catch (const std::exception &e)
-                    {
-                        std::cerr << "[ERROR] Error inesperado en REGISTRATION para jugador " << i << ": " << e.what() << std::endl;
-                        log_fn(client_ip, "Unexpected error in REGISTRATION", e.what(), "ERROR");
-                        handle_disconnect(i, client_ip, "Unexpected error: " + std::string(e.what()));
-                        return;
-                    }
+                    connection->send(data.substr(send.offset, send.length));
                 }
             }
-
-            // Fase de Colocación de Barcos
-            std::cout << "[DEBUG] Transicionando a fase PLACEMENT para sesión " << session_id_ << std::endl;
-            game_->transition_to_placement();
-            std::set<int> placed_ships;
-            while (placed_ships.size() < 2 && !finished_)
+            sent = std::chrono::steady_clock::now();
+            metrics_.observe(Stage::SEND, sent - started);
+            // Ida y vuelta de cada turno: del SHOOT recibido a los dos STATUS entregados a los sockets.
+            for (auto turn_started : outbox.turns_started)
+            {
+                metrics_.observe(Stage::TURN, sent - turn_started);
+            }
+        }
+        if (outbox.rearm_timer)
+        {
+            uint64_t generation = outbox.turn_generation;
+            auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(outbox.timer_deadline - std::chrono::steady_clock::now());
+            loop_.cancel_timer(turn_timer_);
+            turn_timer_ = loop_.run_after(std::max(delay, std::chrono::milliseconds(0)), [this, generation]
+                                          {
+                                              turn_timer_ = 0;
+                                              dispatch([this, generation]
+                                                       { on_turn_timeout(generation); }); });
+        }
+        bool close = outbox.close;
+        if (close)
+        {
+            closed_ = true;
+            if (turn_timer_ != 0)
             {
-                for (int i = 1; i <= 2; ++i)
+                loop_.cancel_timer(turn_timer_);
+                turn_timer_ = 0;
+            }
+            for (auto &[id, slot] : players_)
+            {
+                if (slot.connection)
                 {
-                    if (placed_ships.count(i))
-                        continue;
-                    int client_fd = players_.at(i).first;
-                    std::string client_ip = players_.at(i).second;
-                    try
-                    {
-                        std::cout << "[DEBUG] Esperando PLACE_SHIPS de jugador " << i << " (client_fd: " << client_fd << ")" << std::endl;
-                        auto messages = receive_messages(client_fd);
-                        for (const auto &msg : messages)
-                        {
-                            if (game_->get_phase() != BattleShipProtocol::PhaseState::Phase::PLACEMENT)
-                            {
-                                std::cerr << "[ERROR] Fase inválida para mensaje recibido en PLACEMENT" << std::endl;
-                                send_fn(client_fd, {BattleShipProtocol::MessageType::ERROR, BattleShipProtocol::ErrorData{400, "Mensaje recibido en fase incorrecta"}});
-                                continue;
-                            }
-                            if (msg.type != BattleShipProtocol::MessageType::PLACE_SHIPS)
-                            {
-                                std::cerr << "[ERROR] Mensaje inesperado en PLACEMENT: " << protocol_.build_message(msg) << std::endl;
-                                send_fn(client_fd, {BattleShipProtocol::MessageType::ERROR, BattleShipProtocol::ErrorData{400, "Esperado PLACE_SHIPS"}});
-                                continue;
-                            }
-                            game_->place_ships(i, std::get<BattleShipProtocol::PlaceShipsData>(msg.data));
-                            std::cout << "[DEBUG] Jugador " << i << " colocó barcos correctamente" << std::endl;
-                            log_fn(client_ip, protocol_.build_message(msg), "Ships placed", "INFO");
-                            placed_ships.insert(i);
-                            break;
-                        }
-                    }
-                    catch (const BattleShipProtocol::ProtocolError &e)
-                    {
-                        handle_disconnect(i, client_ip, e.what());
-                        return;
-                    }
-                    catch (const std::exception &e)
-                    {
-                        std::cerr << "[ERROR] Error inesperado en PLACEMENT para jugador " << i << ": " << e.what() << std::endl;
-                        log_fn(client_ip, "Unexpected error in PLACEMENT", e.what(), "ERROR");
-                        handle_disconnect(i, client_ip, "Unexpected error: " + std::string(e.what()));
-                        return;
-                    }
+                    slot.connection->close();
                 }
             }
+        }
+        // Se devuelve y se cuenta antes del aviso final: después la sesión puede destruirse en cualquier momento.
+        recycle_output(outbox);
+        loop_allocations_ += AllocStats::thread_allocations() - before;
+        if (close)
+        {
+            // Ya no llegan frames ni timers: lo último que la strand ejecuta para esta sesión es marcarla terminada.
+            strand_->post([this]
+                          {
+                              // Copia local: el aviso puede destruir la sesión, y con ella finished_fn_, antes de volver.
+                              FinishedFn done = finished_fn_;
+                              metrics_.leave_phase(metered_phase_);
+                              metrics_.add(Counter::SESSIONS_FINISHED);
+                              uint64_t allocations = strand_allocations_ + loop_allocations_;
+                              log_fn_("0.0.0.0", "Session " + std::to_string(session_id_) + " finished",
+                                      std::to_string(allocations) + " heap allocations (" + std::to_string(strand_allocations_) +
+                                          " state machine, " + std::to_string(loop_allocations_) + " event loop) over " +
+                                          std::to_string(turn_generation_) + " turns",
+                                      "INFO");
+                              finished_ = true;
+                              if (done)
+                                  done(); });
+        }
+    }
+
+    void GameSession::on_line(int player_id, std::string_view line)
+    {
+        uint64_t before = AllocStats::thread_allocations();
+        parse_line(player_id, line);
+        loop_allocations_ += AllocStats::thread_allocations() - before;
+    }
 
-            // Transición a PLAYING
-            std::cout << "[DEBUG] Transicionando a fase PLAYING para sesión " << session_id_ << std::endl;
-            game_->transition_to_playing();
+    void GameSession::parse_line(int player_id, std::string_view line)
+    {
+        auto &slot = players_.at(player_id);
+        BattleShipProtocol::Message msg;
+        auto started = std::chrono::steady_clock::now();
+        try
+        {
+            msg = slot.binary_in ? protocol_.parse_binary_message(line) : protocol_.parse_message(line);
+        }
+        catch (const std::exception &e)
+        {
+            metrics_.add(Counter::PARSE_ERRORS);
+            BATTLESHIP_TRACE(WIRE, ERROR, "Failed to parse message: [", slot.binary_in ? std::string_view("<binary>") : std::string_view(line), "] Error: ", e.what());
+            std::string reason = "Failed to parse message: " + std::string(e.what());
+            dispatch([this, player_id, reason]
+                     { handle_disconnect(player_id, reason); });
+            return;
+        }
+        metrics_.observe(Stage::PARSE, std::chrono::steady_clock::now() - started);
+        // Los frames binarios llegan sin su prefijo de longitud: se cuenta lo que ocupó en el socket.
+        metrics_.message_in(msg.type, line.size() + (slot.binary_in ? BattleShipProtocol::Protocol::BINARY_HEADER_SIZE : 0));
+        BATTLESHIP_TRACE(WIRE, DEBUG, "Received message from client_fd ", slot.fd);
 
-            int current_player = 1;
-            for (int i = 1; i <= 2; ++i)
+        if (msg.type == BattleShipProtocol::MessageType::HELLO)
+        {
+            // El corte del próximo frame depende del formato: se cambia aquí, antes de que la strand responda.
+            const auto &hello = std::get<BattleShipProtocol::HelloData>(msg.data);
+            if (hello.version == BattleShipProtocol::Protocol::TEXT_VERSION ||
+                hello.version == BattleShipProtocol::Protocol::BINARY_VERSION)
             {
-                send_status(i, current_player);
+                slot.binary_in = hello.version == BattleShipProtocol::Protocol::BINARY_VERSION;
+                slot.connection->set_framing(slot.binary_in ? BattleShipProtocol::Framer::Mode::LENGTH_PREFIXED
+                                                            : BattleShipProtocol::Framer::Mode::LINES);
             }
+        }
+        dispatch([this, player_id, msg = std::move(msg), started]() mutable
+                 { on_message(player_id, msg, started); });
+    }
 
-            // Fase de Juego
-            std::cout << "[DEBUG] Iniciando fase PLAYING, turno inicial: Jugador " << current_player << std::endl;
+    void GameSession::on_message(int player_id, BattleShipProtocol::Message &msg, std::chrono::steady_clock::time_point received)
+    {
+        if (ending_)
+            return;
 
-            while (!finished_)
+        received_ = received;
+        auto &slot = players_.at(player_id);
+        try
+        {
+            if (msg.type == BattleShipProtocol::MessageType::HELLO)
             {
-                int client_fd = players_.at(current_player).first;
-                std::string client_ip = players_.at(current_player).second;
-                turn_start_time_ = std::chrono::steady_clock::now();
-
-                bool turn_finished = false;
-
-                while (!turn_finished && !finished_)
+                negotiate(player_id, std::get<BattleShipProtocol::HelloData>(msg.data));
+                return;
+            }
+            if (msg.type == BattleShipProtocol::MessageType::RESYNC)
+            {
+                // El próximo estado sale completo; fuera de PLAYING el primero ya lo es.
+                slot.status_synced = false;
+                if (game_.get_phase() == BattleShipProtocol::PhaseState::Phase::PLAYING)
                 {
-                    try
-                    {
-                        auto now = std::chrono::steady_clock::now();
-                        int elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - turn_start_time_).count();
-
-                        // ⏳ Verificamos timeout manualmente
-                        if (elapsed >= TURN_TIMEOUT_SECONDS)
-                        {
-                            std::cout << "[TIMEOUT] Jugador " << current_player << " perdió el turno\n";
-                            log_fn(client_ip, "Turn timeout", "Turno perdido", "INFO");
-
-                            current_player = (current_player == 1) ? 2 : 1;
-                            turn_start_time_ = std::chrono::steady_clock::now();
+                    send_status(player_id);
+                }
+                return;
+            }
 
-                            for (int i = 1; i <= 2; ++i)
-                                send_status(i, current_player);
+            // La rendición no espera turno: termina la partida en cuanto llega.
+            if (msg.type == BattleShipProtocol::MessageType::SURRENDER &&
+                game_.get_phase() == BattleShipProtocol::PhaseState::Phase::PLAYING)
+            {
+                BATTLESHIP_TRACE(SESSION, INFO, "Jugador ", player_id, " se rinde");
+                journal(journal_event(BattleShipProtocol::JournalEvent::SURRENDER, player_id));
+                end_game(player_id == 1 ? 2 : 1);
+                return;
+            }
 
-                            turn_finished = true;
-                            break;
-                        }
+            players_.at(player_id).inbox.push_back(Queued{std::move(msg), received});
+            process_inboxes();
+        }
+        catch (const std::exception &e)
+        {
+            BATTLESHIP_TRACE(SESSION, ERROR, "Error crítico en la sesión ", session_id_, ": ", e.what());
+            log_fn_("0.0.0.0", "Critical error in session", e.what(), "ERROR");
+            handle_disconnect(player_id, "Unexpected error: " + std::string(e.what()));
+        }
+    }
 
-                        // 🔍 Verificamos si hay datos del jugador actual
-                        fd_set read_fds;
-                        FD_ZERO(&read_fds);
-                        FD_SET(client_fd, &read_fds);
+    void GameSession::negotiate(int player_id, const BattleShipProtocol::HelloData &hello)
+    {
+        auto &slot = players_.at(player_id);
+        if (hello.version != BattleShipProtocol::Protocol::TEXT_VERSION &&
+            hello.version != BattleShipProtocol::Protocol::BINARY_VERSION)
+        {
+            // El cliente ya escribe en un formato que no entendemos: no hay forma de seguir.
+            send_message(player_id, {BattleShipProtocol::MessageType::ERROR, BattleShipProtocol::ErrorData{400, "Unsupported protocol version"}});
+            handle_disconnect(player_id, "Unsupported protocol version " + std::to_string(hello.version));
+            return;
+        }
 
-                        struct timeval timeout;
-                        timeout.tv_sec = 1;
-                        timeout.tv_usec = 0;
+        bool binary = hello.version == BattleShipProtocol::Protocol::BINARY_VERSION;
+        slot.deltas = hello.deltas;
+        // La respuesta sale aún en el formato anterior; lo siguiente ya va en el nuevo.
+        send_message(player_id, {BattleShipProtocol::MessageType::HELLO, hello});
+        slot.binary_out = binary;
+        log_fn_(slot.ip, "HELLO|" + std::to_string(hello.version) + (hello.deltas ? ",DELTA" : ""),
+                binary ? "Binary protocol" : "Text protocol", "INFO");
+    }
 
-                        int result = select(client_fd + 1, &read_fds, nullptr, nullptr, &timeout);
-                        if (result < 0 && errno != EINTR)
-                        {
-                            std::cerr << "[ERROR] select() falló: " << strerror(errno) << std::endl;
-                            handle_disconnect(current_player, client_ip, "select() failed: " + std::string(strerror(errno)));
-                            return;
-                        }
+#ifndef BATTLESHIP_COROUTINES
+    void GameSession::process_inboxes()
+    {
+        using Phase = BattleShipProtocol::PhaseState::Phase;
 
-                        if (result == 0)
-                        {
-                            continue;
-                        }
+        bool progress = true;
+        while (progress && !ending_)
+        {
+            progress = false;
+            switch (game_.get_phase())
+            {
+            case Phase::REGISTRATION:
+                for (int i = 1; i <= 2 && !ending_; ++i)
+                {
+                    auto &inbox = players_.at(i).inbox;
+                    while (!inbox.empty() && !ending_ && game_.get_player_nickname(i).empty())
+                    {
+                        auto msg = std::move(inbox.front().msg);
+                        received_ = inbox.front().received;
+                        inbox.pop_front();
+                        handle_registration(i, msg);
+                    }
+                }
+                if (!ending_ && game_.are_both_registered())
+                {
+                    BATTLESHIP_TRACE(SESSION, DEBUG, "Transicionando a fase PLACEMENT para sesión ", session_id_);
+                    game_.transition_to_placement();
+                    journal(phase_event(Phase::PLACEMENT));
+                    progress = true;
+                }
+                break;
 
-                        if (FD_ISSET(client_fd, &read_fds))
-                        {
-                            auto messages = receive_messages(client_fd);
-                            for (const auto &msg : messages)
-                            {
-                                if (msg.type == BattleShipProtocol::MessageType::SURRENDER)
-                                {
-                                    std::cout << "[DEBUG] Jugador " << current_player << " se rinde\n";
-                                    game_->transition_to_finished();
-
-                                    int winner = (current_player == 1) ? 2 : 1;
-                                    send_message(players_.at(winner).first, {BattleShipProtocol::MessageType::GAME_OVER, BattleShipProtocol::GameOverData{"YOU_WIN"}}, protocol_);
-                                    send_message(players_.at(current_player).first, {BattleShipProtocol::MessageType::GAME_OVER, BattleShipProtocol::GameOverData{"YOU_LOSE"}}, protocol_);
-                                    finished_ = true;
-                                    return;
-                                }
-
-                                if (msg.type != BattleShipProtocol::MessageType::SHOOT)
-                                {
-                                    send_message(client_fd, {BattleShipProtocol::MessageType::ERROR, BattleShipProtocol::ErrorData{400, "Esperado SHOOT"}}, protocol_);
-                                    continue;
-                                }
-
-                                try
-                                {
-                                    auto shoot_data = std::get<BattleShipProtocol::ShootData>(msg.data);
-                                    game_->process_shot(current_player, shoot_data);
-                                    current_player = (current_player == 1) ? 2 : 1;
-                                    turn_start_time_ = std::chrono::steady_clock::now();
-
-                                    for (int i = 1; i <= 2; ++i)
-                                    {
-                                        send_status(i, current_player);
-                                    }
-
-                                    if (game_->is_game_over())
-                                    {
-                                        game_->transition_to_finished();
-                                        int winner_id = current_player;
-                                        int loser_id = (current_player == 1) ? 2 : 1;
-
-                                        send_message(players_.at(winner_id).first, {BattleShipProtocol::MessageType::GAME_OVER, BattleShipProtocol::GameOverData{"YOU_WIN"}}, protocol_);
-                                        send_message(players_.at(loser_id).first, {BattleShipProtocol::MessageType::GAME_OVER, BattleShipProtocol::GameOverData{"YOU_LOSE"}}, protocol_);
-                                        finished_ = true;
-                                        return;
-                                    }
-
-                                    turn_finished = true;
-                                    break;
-                                }
-                                catch (const BattleShipProtocol::GameLogicError &e)
-                                {
-                                    send_message(client_fd, {BattleShipProtocol::MessageType::ERROR, BattleShipProtocol::ErrorData{400, e.what()}}, protocol_);
-                                }
-                            }
-                        }
+            case Phase::PLACEMENT:
+                for (int i = 1; i <= 2 && !ending_; ++i)
+                {
+                    auto &inbox = players_.at(i).inbox;
+                    while (!inbox.empty() && !ending_ && game_.ships_placed(i) < 9)
+                    {
+                        auto msg = std::move(inbox.front().msg);
+                        received_ = inbox.front().received;
+                        inbox.pop_front();
+                        handle_placement(i, msg);
                     }
-                    catch (const BattleShipProtocol::ProtocolError &e)
+                }
+                if (!ending_ && game_.are_both_ships_placed())
+                {
+                    BATTLESHIP_TRACE(SESSION, DEBUG, "Transicionando a fase PLAYING para sesión ", session_id_);
+                    game_.transition_to_playing();
+                    journal(phase_event(Phase::PLAYING));
+                    start_turn(1);
+                    for (int i = 1; i <= 2; ++i)
                     {
-                        handle_disconnect(current_player, client_ip, e.what());
-                        return;
+                        send_status(i);
                     }
-                    catch (const std::exception &e)
+                    BATTLESHIP_TRACE(SESSION, DEBUG, "Iniciando fase PLAYING, turno inicial: Jugador ", current_player_);
+                    progress = true;
+                }
+                break;
+
+            case Phase::PLAYING:
+            {
+                // Solo se atiende al jugador en turno; el otro conserva sus mensajes hasta que le toque.
+                auto &inbox = players_.at(current_player_).inbox;
+                while (!inbox.empty() && !ending_)
+                {
+                    int shooter = current_player_;
+                    auto msg = std::move(inbox.front().msg);
+                    received_ = inbox.front().received;
+                    inbox.pop_front();
+                    handle_playing(shooter, msg);
+                    if (current_player_ != shooter)
                     {
-                        std::cerr << "[ERROR] Error inesperado en PLAYING para jugador " << current_player << ": " << e.what() << std::endl;
-                        log_fn(client_ip, "Unexpected error in PLAYING", e.what(), "ERROR");
-                        handle_disconnect(current_player, client_ip, "Unexpected error: " + std::string(e.what()));
-                        return;
+                        progress = true;
+                        break;
                     }
                 }
+                break;
+            }
+
+            case Phase::FINISHED:
+                break;
             }
-        }
-        catch (const std::exception &e)
-        {
-            std::cerr << "[ERROR] Error crítico en run_session: " << e.what() << std::endl;
-            log_fn("0.0.0.0", "Critical error in run_session", e.what(), "ERROR");
-            finished_ = true;
         }
     }
+#endif
 
-    Server::Server(const std::string &ip, int port, const std::string &log_path)
-        : ip_(ip), port_(port), server_fd_(-1)
+    void GameSession::handle_registration(int player_id, const BattleShipProtocol::Message &msg)
     {
-        address_.sin_family = AF_INET;
-        if (inet_pton(AF_INET, ip.c_str(), &address_.sin_addr) <= 0)
+        const std::string &client_ip = players_.at(player_id).ip;
+        if (msg.type != BattleShipProtocol::MessageType::REGISTER)
         {
-            throw ServerError("Invalid IP address: " + ip);
+            BATTLESHIP_TRACE(SESSION, ERROR, "Mensaje inesperado en REGISTRATION (tipo ", static_cast<int>(msg.type), ")");
+            send_message(player_id, {BattleShipProtocol::MessageType::ERROR, BattleShipProtocol::ErrorData{400, "Esperado REGISTER"}});
+            return;
         }
-
-        address_.sin_port = htons(port);
-
-        log_file_.open(log_path, std::ios::app);
-        if (!log_file_.is_open())
+        try
         {
-            throw ServerError("Failed to open log file: " + log_path);
+            game_.register_player(player_id, std::get<BattleShipProtocol::RegisterData>(msg.data));
+        }
+        catch (const std::exception &e)
+        {
+            BATTLESHIP_TRACE(SESSION, ERROR, "Error inesperado en REGISTRATION para jugador ", player_id, ": ", e.what());
+            log_fn_(client_ip, "Unexpected error in REGISTRATION", e.what(), "ERROR");
+            handle_disconnect(player_id, "Unexpected error: " + std::string(e.what()));
+            return;
         }
+        BATTLESHIP_TRACE(SESSION, DEBUG, "Jugador ", player_id, " registrado correctamente");
+        auto registered = journal_event(BattleShipProtocol::JournalEvent::REGISTERED, player_id);
+        registered.text = BattleShipProtocol::Journal::message_text(protocol_, msg);
+        journal(std::move(registered));
+        log_fn_(client_ip, protocol_.build_message(msg), "Player " + std::to_string(player_id) + " registered", "INFO");
     }
 
-    Server::~Server()
+    void GameSession::handle_placement(int player_id, const BattleShipProtocol::Message &msg)
     {
-        running_ = false;
-        if (server_fd_ != -1)
-            close(server_fd_);
-        if (log_file_.is_open())
-            log_file_.close();
+        const std::string &client_ip = players_.at(player_id).ip;
+        if (msg.type != BattleShipProtocol::MessageType::PLACE_SHIPS)
+        {
+            BATTLESHIP_TRACE(SESSION, ERROR, "Mensaje inesperado en PLACEMENT (tipo ", static_cast<int>(msg.type), ")");
+            send_message(player_id, {BattleShipProtocol::MessageType::ERROR, BattleShipProtocol::ErrorData{400, "Esperado PLACE_SHIPS"}});
+            return;
+        }
+        try
+        {
+            game_.place_ships(player_id, std::get<BattleShipProtocol::PlaceShipsData>(msg.data));
+        }
+        catch (const std::exception &e)
+        {
+            BATTLESHIP_TRACE(SESSION, ERROR, "Error inesperado en PLACEMENT para jugador ", player_id, ": ", e.what());
+            log_fn_(client_ip, "Unexpected error in PLACEMENT", e.what(), "ERROR");
+            handle_disconnect(player_id, "Unexpected error: " + std::string(e.what()));
+            return;
+        }
+        BATTLESHIP_TRACE(SESSION, DEBUG, "Jugador ", player_id, " colocó barcos correctamente");
+        auto placed = journal_event(BattleShipProtocol::JournalEvent::SHIPS_PLACED, player_id);
+        placed.text = BattleShipProtocol::Journal::message_text(protocol_, msg);
+        journal(std::move(placed));
+        log_fn_(client_ip, protocol_.build_message(msg), "Ships placed", "INFO");
     }
 
-    void Server::run()
+    void GameSession::handle_playing(int player_id, const BattleShipProtocol::Message &msg)
     {
-        server_fd_ = create_socket();
-        bind_socket();
-        listen_connections();
+        if (msg.type != BattleShipProtocol::MessageType::SHOOT)
+        {
+            send_message(player_id, {BattleShipProtocol::MessageType::ERROR, BattleShipProtocol::ErrorData{400, "Esperado SHOOT"}});
+            return;
+        }
 
-        log("0.0.0.0", "Server started", ip_ + ":" + std::to_string(port_));
-        std::thread acceptor_thread(&Server::accept_clients, this);
-        std::thread cleanup_thread(&Server::cleanup_finished_sessions, this);
+        const auto &shoot_data = std::get<BattleShipProtocol::ShootData>(msg.data);
+        try
+        {
+            auto started = std::chrono::steady_clock::now();
+            game_.process_shot(player_id, shoot_data);
+            metrics_.observe(Stage::PROCESS_SHOT, std::chrono::steady_clock::now() - started);
+        }
+        catch (const BattleShipProtocol::GameLogicError &e)
+        {
+            send_message(player_id, {BattleShipProtocol::MessageType::ERROR, BattleShipProtocol::ErrorData{400, e.what()}});
+            return;
+        }
 
-        acceptor_thread.join();
-        cleanup_thread.join();
-    }
+        auto shot = journal_event(BattleShipProtocol::JournalEvent::SHOT, player_id);
+        shot.target = shoot_data.coordinate;
+        shot.result = game_.cell_state((player_id == 1) ? 2 : 1, shoot_data.coordinate.index());
+        journal(std::move(shot));
 
-    int Server::create_socket()
-    {
-        int fd = socket(AF_INET, SOCK_STREAM, 0);
-        if (fd == -1)
+        start_turn((player_id == 1) ? 2 : 1);
+        for (int i = 1; i <= 2; ++i)
         {
-            throw ServerError("Failed to create socket: " + std::string(strerror(errno)));
+            send_status(i);
         }
-        int opt = 1;
-        if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0)
+        // Un SHOOT encolado del otro jugador puede resolverse en la misma tarea y el mismo Outbox:
+        // cada turno se mide desde la llegada de su propio frame.
+        outbox_->turns_started.push_back(received_);
+
+        if (game_.is_game_over())
         {
-            close(fd);
-            throw ServerError("Failed to set socket options: " + std::string(strerror(errno)));
+            end_game(player_id);
         }
-        return fd;
     }
 
-    void Server::bind_socket()
+    void GameSession::start_turn(int player_id)
     {
-        if (bind(server_fd_, (struct sockaddr *)&address_, sizeof(address_)) < 0)
-        {
-            throw ServerError("Bind failed: " + std::string(strerror(errno)));
-        }
+        current_player_ = player_id;
+        turn_deadline_ = std::chrono::steady_clock::now() + turn_timeout_;
+        arm_timer(turn_deadline_);
     }
 
-    void Server::listen_connections()
+    void GameSession::arm_timer(std::chrono::steady_clock::time_point deadline)
     {
-        if (listen(server_fd_, 10) < 0)
+        // El mismo plazo ya está armado (o vencido): un receive() repetido dentro del turno no lo toca.
+        if (turn_generation_ != 0 && timer_deadline_ == deadline)
+            return;
+        // El timer vive en el loop; se rearma al aplicar la salida de esta tarea.
+        timer_deadline_ = deadline;
+        outbox_->rearm_timer = true;
+        outbox_->timer_deadline = deadline;
+        outbox_->turn_generation = ++turn_generation_;
+    }
+
+#ifndef BATTLESHIP_COROUTINES
+    void GameSession::on_turn_timeout(uint64_t generation)
+    {
+        // Un timeout que salió del loop justo antes de un disparo llega tarde: el turno ya es otro.
+        if (ending_ || generation != turn_generation_ ||
+            game_.get_phase() != BattleShipProtocol::PhaseState::Phase::PLAYING)
+            return;
+
+        expire_turn();
+        process_inboxes();
+    }
+#endif
+
+    void GameSession::expire_turn()
+    {
+        BATTLESHIP_TRACE(TIMER, INFO, "Jugador ", current_player_, " perdió el turno");
+        metrics_.add(Counter::TURN_TIMEOUTS);
+        log_fn_(players_.at(current_player_).ip, "Turn timeout", "Turno perdido", "INFO");
+        journal(journal_event(BattleShipProtocol::JournalEvent::TURN_TIMEOUT, current_player_));
+
+        game_.skip_turn();
+        start_turn((current_player_ == 1) ? 2 : 1);
+        for (int i = 1; i <= 2; ++i)
         {
-            throw ServerError("Listen failed: " + std::string(strerror(errno)));
+            send_status(i);
         }
     }
 
-    void Server::accept_clients()
+    void GameSession::send_status(int player_id)
     {
-        while (running_)
+        auto &slot = players_.at(player_id);
+        const std::string &client_ip = slot.ip;
+        try
         {
-            struct sockaddr_in client_addr;
-            socklen_t addr_len = sizeof(client_addr);
-            int client_fd = accept(server_fd_, (struct sockaddr *)&client_addr, &addr_len);
-            if (client_fd < 0)
+            int time_remaining = 0;
+            if (game_.get_phase() == BattleShipProtocol::PhaseState::Phase::PLAYING)
             {
-                if (running_)
-                    log("0.0.0.0", "Accept failed", strerror(errno), "ERROR");
-                continue;
+                // Segundos restantes redondeados hacia arriba: 0 solo cuando el turno ya venció.
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(turn_deadline_ - std::chrono::steady_clock::now());
+                time_remaining = static_cast<int>(std::max<int64_t>(0, (left.count() + 999) / 1000));
             }
-            char client_ip[INET_ADDRSTRLEN];
-            inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
-            log(client_ip, "Client connected", "Assigning to session");
-
-            std::lock_guard<std::mutex> lock(pending_mutex_);
-            pending_clients_.push(client_fd);
-            if (pending_clients_.size() >= 2)
-            {
-                int fd1 = pending_clients_.front();
-                pending_clients_.pop();
-                int fd2 = pending_clients_.front();
-                pending_clients_.pop();
 
-                struct sockaddr_in addr1, addr2;
-                socklen_t len1 = sizeof(addr1), len2 = sizeof(addr2);
-                getpeername(fd1, (struct sockaddr *)&addr1, &len1);
-                getpeername(fd2, (struct sockaddr *)&addr2, &len2);
-                char ip1[INET_ADDRSTRLEN], ip2[INET_ADDRSTRLEN];
-                inet_ntop(AF_INET, &addr1.sin_addr, ip1, INET_ADDRSTRLEN);
-                inet_ntop(AF_INET, &addr2.sin_addr, ip2, INET_ADDRSTRLEN);
+            BattleShipProtocol::Turn turn_view = (player_id == current_player_)
+                                                     ? BattleShipProtocol::Turn::YOUR_TURN
+                                                     : BattleShipProtocol::Turn::OPPONENT_TURN;
 
-                std::lock_guard<std::mutex> session_lock(sessions_mutex_);
-                auto session = std::make_unique<GameSession>(next_session_id_++);
-
-                session->start(protocol_, [this](const auto &ip, const auto &q, const auto &r, const auto &l)
-                               { log(ip, q, r, l); });
-                session->add_player(1, fd1, ip1);
-                session->add_player(2, fd2, ip2);
-
-                sessions_[session->get_session_id()] = std::move(session);
+            if (slot.deltas && slot.status_synced)
+            {
+                send_status_delta(player_id, turn_view, time_remaining);
+                return;
             }
-        }
-    }
 
-    void Server::cleanup_finished_sessions()
-    {
-        while (running_)
-        {
+            // Los tableros del último STATUS se sobrescriben: su memoria se reutiliza turno a turno.
+            auto started = std::chrono::steady_clock::now();
+            game_.get_status(player_id, slot.status);
+            slot.status.turn = turn_view;
+            slot.status.time_remaining = time_remaining;
+            if (slot.deltas)
             {
-                std::lock_guard<std::mutex> lock(sessions_mutex_);
-                for (auto it = sessions_.begin(); it != sessions_.end();)
+                // Punto de partida de los deltas siguientes: los tableros vienen en orden A1..J10.
+                for (size_t i = 0; i < slot.sent_own.size(); ++i)
                 {
-                    if (it->second->is_finished())
-                    {
-                        it = sessions_.erase(it);
-                    }
-                    else
-                    {
-                        ++it;
-                    }
+                    slot.sent_own[i] = slot.status.boardOwn[i].cellState;
+                    slot.sent_opponent[i] = slot.status.boardOpponent[i].cellState;
                 }
+                slot.status_seq = 0;
+                slot.status_synced = true;
             }
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-        }
-    }
-
-    void GameSession::send_message(int client_fd, const BattleShipProtocol::Message &msg, const BattleShipProtocol::Protocol &protocol) const
-    {
-        std::string data = protocol_.build_message(msg);
-        std::cout << "-------------------- SERVER ENVIO ------------------------" << std::endl;
-        std::cout << data << std::endl;
-        std::cout << "-------------------- SERVER ENVIO ------------------------" << std::endl;
-
-        size_t num_bytes = data.size();
-        size_t total_sent = 0;
-        size_t buffer_size = 4096;
-        char buffer[buffer_size];
-
-        while (total_sent < num_bytes)
-        {
-            size_t remaining = num_bytes - total_sent;
-            size_t to_send = remaining > buffer_size ? buffer_size : remaining;
+            metrics_.observe(Stage::GET_STATUS, std::chrono::steady_clock::now() - started);
 
-            data.copy(buffer, to_send, total_sent);
-
-            ssize_t sent = send(client_fd, buffer, to_send, 0);
-            if (sent < 0)
+            BattleShipProtocol::Message status_msg{BattleShipProtocol::MessageType::STATUS, std::move(slot.status)};
+            send_message(player_id, status_msg);
+            if (journal_fn_)
+            {
+                journal_status(player_id, false, turn_view, time_remaining);
+            }
+            else
             {
-                throw ServerError("Send failed: " + std::string(strerror(errno)));
+                log_fn_(client_ip, protocol_.build_message(status_msg), "Status sent", "INFO");
             }
-            total_sent += sent;
+            slot.status = std::move(std::get<BattleShipProtocol::StatusData>(status_msg.data));
+        }
+        catch (const std::exception &e)
+        {
+            log_fn_(client_ip, "Failed to send status", e.what(), "ERROR");
         }
     }
 
-    std::vector<BattleShipProtocol::Message> GameSession::receive_messages(int client_fd) const
+    void GameSession::send_status_delta(int player_id, BattleShipProtocol::Turn turn, int time_remaining)
     {
-        char buffer[4096] = {0};
-        std::string response;
-        ssize_t received;
-
-        while ((received = recv(client_fd, buffer, sizeof(buffer) - 1, 0)) > 0)
+        auto &slot = players_.at(player_id);
+        int opponent_id = (player_id == 1) ? 2 : 1;
+
+        // Igual que el STATUS completo: los vectores de cambios conservan su capacidad entre turnos.
+        BattleShipProtocol::StatusDeltaData &delta = slot.delta;
+        auto started = std::chrono::steady_clock::now();
+        delta.seq = ++slot.status_seq;
+        delta.turn = turn;
+        delta.ownChanges.clear();
+        delta.opponentChanges.clear();
+        delta.gameState = game_.get_game_state();
+        delta.time_remaining = time_remaining;
+        // Un disparo cambia una celda (o un barco al hundirse): se comparan estados, no se copian tableros.
+        for (int i = 0; i < static_cast<int>(slot.sent_own.size()); ++i)
         {
-            response.append(buffer, received);
-            std::vector<BattleShipProtocol::Message> messages;
-            size_t pos = 0;
-            while ((pos = response.find('\n')) != std::string::npos)
+            auto own = game_.cell_state(player_id, i);
+            if (own != slot.sent_own[i])
             {
-                std::string msg_str = response.substr(0, pos + 1);
-                if (!msg_str.empty())
+                slot.sent_own[i] = own;
+                delta.ownChanges.push_back({BattleShipProtocol::Coordinate::from_index(static_cast<uint8_t>(i)), own});
+            }
+            auto opponent = game_.cell_state(opponent_id, i);
+            if (opponent != slot.sent_opponent[i])
+            {
+                slot.sent_opponent[i] = opponent;
+                delta.opponentChanges.push_back({BattleShipProtocol::Coordinate::from_index(static_cast<uint8_t>(i)), opponent});
+            }
+        }
+
+        metrics_.observe(Stage::GET_STATUS, std::chrono::steady_clock::now() - started);
+
+        BattleShipProtocol::Message delta_msg{BattleShipProtocol::MessageType::STATUS_DELTA, std::move(delta)};
+        send_message(player_id, delta_msg);
+        if (journal_fn_)
+        {
+            journal_status(player_id, true, turn, time_remaining);
+        }
+        else
+        {
+            log_fn_(slot.ip, protocol_.build_message(delta_msg), "Status sent", "INFO");
+        }
+        delta = std::move(std::get<BattleShipProtocol::StatusDeltaData>(delta_msg.data));
+    }
+
+    void GameSession::journal_status(int player_id, bool delta, BattleShipProtocol::Turn turn, int time_remaining)
+    {
+        using BattleShipProtocol::Journal;
+        auto status = journal_event(BattleShipProtocol::JournalEvent::STATUS, player_id);
+        status.value = static_cast<uint8_t>((delta ? Journal::STATUS_DELTA : 0) |
+                                            (turn == BattleShipProtocol::Turn::YOUR_TURN ? Journal::STATUS_YOUR_TURN : 0));
+        status.time_remaining = static_cast<uint32_t>(time_remaining);
+        journal(std::move(status));
+    }
+
+    void GameSession::end_game(int winner_id)
+    {
+        int loser_id = (winner_id == 1) ? 2 : 1;
+        game_.transition_to_finished();
+        journal(phase_event(BattleShipProtocol::PhaseState::Phase::FINISHED));
+        journal(journal_event(BattleShipProtocol::JournalEvent::GAME_OVER, winner_id));
+        send_message(winner_id, {BattleShipProtocol::MessageType::GAME_OVER, BattleShipProtocol::GameOverData{"YOU_WIN"}});
+        send_message(loser_id, {BattleShipProtocol::MessageType::GAME_OVER, BattleShipProtocol::GameOverData{"YOU_LOSE"}});
+        finish();
+    }
+
+    void GameSession::handle_disconnect(int player_id, const std::string &reason)
+    {
+        if (ending_)
+            return;
+
+        auto &slot = players_.at(player_id);
+        BATTLESHIP_TRACE(SESSION, INFO, "Jugador ", player_id, " desconectado: ", reason);
+        metrics_.add(Counter::DISCONNECTS);
+        log_fn_(slot.ip, "Client disconnected", reason, "ERROR");
+        auto disconnect = journal_event(BattleShipProtocol::JournalEvent::DISCONNECT, player_id);
+        disconnect.text = reason;
+        journal(std::move(disconnect));
+
+        int remaining_player = (player_id == 1) ? 2 : 1;
+        send_message(remaining_player, {BattleShipProtocol::MessageType::ERROR, BattleShipProtocol::ErrorData{400, "Opponent disconnected"}});
+        finish();
+    }
+
+    void GameSession::finish()
+    {
+        if (ending_)
+            return;
+        ending_ = true;
+        // El loop cierra las conexiones después de los envíos de esta tarea y luego marca la sesión terminada.
+        outbox_->close = true;
+    }
+
+    bool GameSession::admin(AdminRequest request, AdminReply reply)
+    {
+        // Tras aplicar el cierre la última tarea de la strand ya está encolada: la sesión puede desaparecer.
+        if (closed_)
+            return false;
+        dispatch([this, request, reply = std::move(reply)]
+                 { reply(admin_text(request)); });
+        return true;
+    }
+
+    std::string GameSession::admin_text(AdminRequest request)
+    {
+        using Phase = BattleShipProtocol::PhaseState::Phase;
+        std::string text;
+        switch (request)
+        {
+        case AdminRequest::SUMMARY:
+        {
+            auto phase = game_.get_phase();
+            text = "session " + std::to_string(session_id_) + " phase=" + std::string(Metrics::phase_name(phase)) + " players=";
+            for (auto &[player_id, slot] : players_)
+            {
+                std::string nickname = game_.get_player_nickname(player_id);
+                text += (player_id == 1 ? "" : ",") + (nickname.empty() ? std::string("-") : nickname) + "@" + slot.ip;
+            }
+            text += " turns=" + std::to_string(turn_generation_);
+            if (phase == Phase::PLAYING && !ending_)
+            {
+                auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - (turn_deadline_ - turn_timeout_));
+                text += " turn=" + std::to_string(current_player_) + " turn_age_ms=" + std::to_string(age.count());
+            }
+            if (ending_)
+                text += " ending";
+            text += "\n";
+            break;
+        }
+        case AdminRequest::BOARDS:
+        {
+            // Tablero propio de cada jugador tal como lo guarda GameLogic: . agua, S barco, X tocado, # hundido, o fallo.
+            constexpr char CELLS[] = {'.', 'X', '#', 'S', 'o'};
+            for (int player_id = 1; player_id <= 2; ++player_id)
+            {
+                std::string nickname = game_.get_player_nickname(player_id);
+                text += "player " + std::to_string(player_id) + " " + (nickname.empty() ? std::string("-") : nickname) +
+                        " ships_placed=" + std::to_string(game_.ships_placed(player_id)) + "\n";
+                text += "   1 2 3 4 5 6 7 8 9 10\n";
+                for (int row = 0; row < 10; ++row)
                 {
-                    try
+                    text += static_cast<char>('A' + row);
+                    text += ' ';
+                    for (int column = 0; column < 10; ++column)
                     {
-                        messages.push_back(protocol_.parse_message(msg_str));
-                    }
-                    catch (const std::exception &e)
-                    {
-                        std::cerr << "[ERROR] Failed to parse message: [" << msg_str << "] Error: " << e.what() << std::endl;
-                        throw BattleShipProtocol::ProtocolError("Failed to parse message: " + std::string(e.what()));
+                        text += ' ';
+                        text += CELLS[static_cast<size_t>(game_.cell_state(player_id, row * 10 + column))];
                     }
+                    text += '\n';
                 }
-                response.erase(0, pos + 1);
             }
-            if (!messages.empty())
+            break;
+        }
+        case AdminRequest::TERMINATE:
+            if (ending_)
+            {
+                text = "session " + std::to_string(session_id_) + " is already ending\n";
+                break;
+            }
+            log_fn_("0.0.0.0", "Session " + std::to_string(session_id_) + " terminated", "Ended from the admin socket", "INFO");
+            for (int player_id = 1; player_id <= 2; ++player_id)
             {
-                std::cout << "[DEBUG] Received " << messages.size() << " messages from client_fd " << client_fd << std::endl;
-                return messages;
+                send_message(player_id, {BattleShipProtocol::MessageType::ERROR, BattleShipProtocol::ErrorData{503, "Session ended by the server"}});
             }
+            finish();
+            text = "session " + std::to_string(session_id_) + " ending\n";
+            break;
         }
+        return text;
+    }
 
-        if (received < 0)
+    Server::Server(const std::string &ip, int port, const std::string &log_path, const ServerOptions &options)
+        : ip_(ip), port_(port), options_(options)
+    {
+        address_.sin_family = AF_INET;
+        if (inet_pton(AF_INET, ip.c_str(), &address_.sin_addr) <= 0)
         {
-            throw BattleShipProtocol::ProtocolError("Receive failed: " + std::string(strerror(errno)));
+            throw ServerError("Invalid IP address: " + ip);
         }
-        if (received == 0)
+
+        address_.sin_port = htons(port);
+
+        // Antes de crear cualquier hilo: todos heredan la máscara y SIGUSR1 y SIGTERM solo se leen por el signalfd.
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGUSR1);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        int log_fd = ::open(log_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (log_fd < 0)
         {
-            throw BattleShipProtocol::ProtocolError("Client disconnected");
+            throw ServerError("Failed to open log file: " + log_path);
+        }
+        logger_ = std::make_unique<AsyncLogger>(log_fd, options_.logging);
+        Trace::set_sink(logger_.get());
+
+        if (!options_.journal_path.empty())
+        {
+            int journal_fd = ::open(options_.journal_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+            if (journal_fd < 0)
+            {
+                throw ServerError("Failed to open journal file: " + options_.journal_path);
+            }
+            LoggerOptions journal_options = options_.logging;
+            journal_options.echo_stdout = false;
+            journal_options.report_drops = false;
+            journal_ = std::make_unique<AsyncLogger>(journal_fd, journal_options);
+
+            // Los registros guardan el tiempo relativo a este punto; la hora de pared va una sola vez.
+            journal_start_ = std::chrono::steady_clock::now();
+            BattleShipProtocol::JournalRecord start;
+            start.time_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                                      std::chrono::system_clock::now().time_since_epoch())
+                                                      .count());
+            std::string encoded;
+            BattleShipProtocol::Journal::append(encoded, start);
+            journal_->append(encoded);
         }
 
-        return {};
+        if (options_.event_loops == 0)
+        {
+            options_.event_loops = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned i = 0; i < options_.event_loops; ++i)
+        {
+            loops_.push_back(EventLoop::create(options_.backend));
+        }
+        workers_ = std::make_unique<WorkerPool>(options_.workers);
+        // Lo último: si algo de lo anterior falla, no queda un descriptor sin cerrar.
+        signal_fd_ = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+        if (signal_fd_ < 0)
+        {
+            throw ServerError("Failed to create signalfd: " + std::string(strerror(errno)));
+        }
     }
 
-    void Server::log(const std::string &client_ip, const std::string &query, const std::string &response,
-                     const std::string &level) const
+    Server::~Server()
+    {
+        running_ = false;
+        for (auto &loop : loops_)
+            loop->stop();
+        for (auto &thread : loop_threads_)
+        {
+            if (thread.joinable())
+                thread.join();
+        }
+        // Sin loops no hay nada que aplicar la salida de las sesiones: los workers paran antes de destruirlas.
+        workers_->stop();
+        // Ya no queda ningún hilo del servidor que trace: las líneas siguientes van a stderr.
+        Trace::set_sink(nullptr);
+        // Avisos que no llegó a procesar ninguna tarea; las sesiones se destruyen con sessions_.
+        for (Completion *entry = finished_sessions_.exchange(nullptr); entry != nullptr;)
+        {
+            std::unique_ptr<Completion> owned(entry);
+            entry = entry->next;
+        }
+        // Clientes aceptados que nunca llegaron a una sesión.
+        PendingClient client;
+        while (matchmaking_.try_pop(client))
+        {
+            close(client.fd);
+        }
+        if (waiting_client_.fd >= 0)
+            close(waiting_client_.fd);
+        for (int fd : listen_fds_)
+            close(fd);
+        if (metrics_fd_ >= 0)
+            close(metrics_fd_);
+        if (signal_fd_ >= 0)
+            close(signal_fd_);
+        if (admin_fd_ >= 0)
+        {
+            close(admin_fd_);
+            // Tras un relevo la ruta ya es del sucesor: solo se borra si sigue siendo el socket propio.
+            struct stat info;
+            if (lstat(options_.admin_path.c_str(), &info) == 0 && info.st_ino == admin_inode_)
+                unlink(options_.admin_path.c_str());
+        }
+    }
+
+    void Server::run()
+    {
+        // Con --inherit-from los listeners (y su cola de conexiones) vienen del servidor anterior.
+        std::vector<int> inherited_clients;
+        if (!options_.inherit_path.empty())
+        {
+            take_over(inherited_clients);
+        }
+        // Un listener por loop sobre el mismo puerto: el kernel reparte las conexiones entre ellos.
+        // Los heredados que sobran se reparten entre los loops; si faltan, se añaden al mismo grupo SO_REUSEPORT.
+        while (listen_fds_.size() < loops_.size())
+        {
+            int fd = create_socket();
+            listen_fds_.push_back(fd);
+            bind_socket(fd);
+            listen_connections(fd);
+        }
+        for (size_t i = 0; i < listen_fds_.size(); ++i)
+        {
+            accept_clients(i);
+        }
+        // Clientes que el servidor anterior aceptó y no llegó a emparejar.
+        for (int client_fd : inherited_clients)
+        {
+            on_client_accepted(0, client_fd);
+        }
+
+        if (options_.metrics_port != 0)
+        {
+            // Las consultas de métricas son pocas y cortas: las atiende el primer loop junto a sus partidas.
+            if (metrics_fd_ < 0)
+                metrics_fd_ = open_metrics_listener();
+            loops_[0]->accept_on(metrics_fd_, [this](int client_fd)
+                                 { on_metrics_client(client_fd); });
+            log("0.0.0.0", "Metrics endpoint", "http://127.0.0.1:" + std::to_string(options_.metrics_port) + "/metrics");
+        }
+
+        if (!options_.admin_path.empty())
+        {
+            // Igual que las métricas: pocas órdenes y cortas, en el primer loop.
+            admin_fd_ = open_admin_listener();
+            loops_[0]->accept_on(admin_fd_, [this](int client_fd)
+                                 { on_admin_client(client_fd); });
+            log("0.0.0.0", "Admin socket", options_.admin_path);
+        }
+
+        // Percentiles de latencia en el log (periódicos y con SIGUSR1) y drenado con SIGTERM.
+        loops_[0]->watch(signal_fd_, EPOLLIN, [this](uint32_t)
+                         { on_signal(); });
+        if (options_.stats_interval.count() > 0)
+        {
+            loops_[0]->post([this]
+                            { schedule_latency_dump(); });
+        }
+
+        log("0.0.0.0", "Server started", ip_ + ":" + std::to_string(port_) + " (" + std::to_string(loops_.size()) + " event loops with SO_REUSEPORT listeners, backlog " + std::to_string(options_.backlog) + ", " + std::to_string(workers_->size()) + " workers, " + io_backend_to_string(options_.backend) + ")");
+        for (auto &loop : loops_)
+        {
+            loop_threads_.emplace_back(&EventLoop::run, loop.get());
+        }
+
+        for (auto &thread : loop_threads_)
+            thread.join();
+    }
+
+    int Server::create_socket()
+    {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd == -1)
+        {
+            throw ServerError("Failed to create socket: " + std::string(strerror(errno)));
+        }
+        int opt = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0 ||
+            setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0)
+        {
+            close(fd);
+            throw ServerError("Failed to set socket options: " + std::string(strerror(errno)));
+        }
+        return fd;
+    }
+
+    void Server::bind_socket(int fd)
+    {
+        if (bind(fd, (struct sockaddr *)&address_, sizeof(address_)) < 0)
+        {
+            throw ServerError("Bind failed: " + std::string(strerror(errno)));
+        }
+    }
+
+    void Server::listen_connections(int fd)
+    {
+        if (listen(fd, options_.backlog) < 0)
+        {
+            throw ServerError("Listen failed: " + std::string(strerror(errno)));
+        }
+    }
+
+    int Server::open_metrics_listener()
+    {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd == -1)
+        {
+            throw ServerError("Failed to create metrics socket: " + std::string(strerror(errno)));
+        }
+        int opt = 1;
+        struct sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<uint16_t>(options_.metrics_port));
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0 ||
+            bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0 ||
+            listen(fd, 16) < 0)
+        {
+            std::string error = strerror(errno);
+            close(fd);
+            throw ServerError("Failed to open metrics port " + std::to_string(options_.metrics_port) + ": " + error);
+        }
+        return fd;
+    }
+
+    void Server::on_metrics_client(int client_fd)
+    {
+        if (client_fd < 0)
+        {
+            log("0.0.0.0", "Metrics accept failed", strerror(-client_fd), "ERROR");
+            return;
+        }
+        // Mientras está abierta la conexión la retiene el loop: basta con el puntero en los callbacks.
+        auto connection = loops_[0]->make_connection(client_fd);
+        Connection *client = connection.get();
+        // Un cliente que no termina las cabeceras no puede retener la conexión ni su buffer para siempre.
+        EventLoop::TimerId deadline = loops_[0]->run_after(METRICS_READ_TIMEOUT, [client = std::weak_ptr<Connection>(connection)]
+                                                           {
+                                                               if (auto expired = client.lock())
+                                                                   expired->close(); });
+        connection->open([this, client, deadline, request = std::string()](std::string_view line) mutable
+                         {
+                             // Se guarda la línea de petición y se responde al final de las cabeceras.
+                             if (request.empty())
+                             {
+                                 request.assign(line);
+                                 return;
+                             }
+                             if (line != "\r\n" && line != "\n")
+                                 return;
+                             loops_[0]->cancel_timer(deadline);
+                             client->send(metrics_response(request));
+                             client->close(); },
+                         [this, deadline](const std::string &)
+                         { loops_[0]->cancel_timer(deadline); });
+    }
+
+    std::string Server::metrics_response(std::string_view request)
+    {
+        std::string_view status = "200 OK";
+        std::string body;
+        size_t path_end = request.find(' ', 4);
+        if (request.rfind("GET ", 0) != 0 || path_end == std::string_view::npos)
+        {
+            status = "405 Method Not Allowed";
+            body = "Only GET is supported\n";
+        }
+        else if (request.substr(4, path_end - 4) != "/metrics")
+        {
+            status = "404 Not Found";
+            body = "Metrics are served at /metrics\n";
+        }
+        else
+        {
+            body = render_metrics();
+        }
+        std::string response = "HTTP/1.1 ";
+        response.append(status).append("\r\n");
+        response += "Content-Type: text/plain; version=0.0.4\r\n";
+        response += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+        response += "Connection: close\r\n\r\n";
+        response += body;
+        return response;
+    }
+
+    std::string Server::render_metrics()
+    {
+        size_t active;
+        {
+            std::lock_guard<std::mutex> lock(sessions_mutex_);
+            active = sessions_.size();
+        }
+        std::string body;
+        Metrics::render_gauge(body, "battleship_sessions_active", "Sessions in the session table.", static_cast<int64_t>(active));
+        Metrics::render_gauge(body, "battleship_matchmaking_pending", "Accepted clients waiting for the pairing task.",
+                              static_cast<int64_t>(queued_clients_.load(std::memory_order_relaxed)));
+        metrics_.render(body);
+        return body;
+    }
+
+    int Server::open_admin_listener()
+    {
+        const std::string &path = options_.admin_path;
+        struct sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            throw ServerError("Admin socket path too long: " + path);
+        }
+        path.copy(address.sun_path, path.size());
+
+        // Un socket que dejó un proceso anterior se reemplaza; cualquier otro archivo se respeta.
+        struct stat info;
+        if (lstat(path.c_str(), &info) == 0)
+        {
+            if (!S_ISSOCK(info.st_mode))
+            {
+                throw ServerError("Admin socket path exists and is not a socket: " + path);
+            }
+            unlink(path.c_str());
+        }
+
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd == -1)
+        {
+            throw ServerError("Failed to create admin socket: " + std::string(strerror(errno)));
+        }
+        if (bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0 ||
+            chmod(path.c_str(), 0600) < 0 ||
+            lstat(path.c_str(), &info) < 0 ||
+            listen(fd, 16) < 0)
+        {
+            std::string error = strerror(errno);
+            close(fd);
+            throw ServerError("Failed to open admin socket " + path + ": " + error);
+        }
+        admin_inode_ = info.st_ino;
+        return fd;
+    }
+
+    void Server::on_admin_client(int client_fd)
+    {
+        if (client_fd < 0)
+        {
+            log("0.0.0.0", "Admin accept failed", strerror(-client_fd), "ERROR");
+            return;
+        }
+        // Las respuestas pueden llegar desde los workers: se guarda una referencia débil, no el puntero.
+        auto connection = loops_[0]->make_connection(client_fd);
+        connection->open([this, client = std::weak_ptr<Connection>(connection)](std::string_view line)
+                         { admin_command(client, line); },
+                         [](const std::string &) {});
+    }
+
+    void Server::admin_command(const std::weak_ptr<Connection> &client, std::string_view line)
+    {
+        while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+            line.remove_suffix(1);
+        size_t space = line.find(' ');
+        std::string_view command = line.substr(0, space);
+        std::string_view argument = space == std::string_view::npos ? std::string_view() : line.substr(space + 1);
+
+        if (command.empty())
+            return;
+        if (command == "help")
+        {
+            admin_send(client, "sessions            list sessions: phase, players, turns played and turn age\n"
+                               "boards ID           show both boards of a session\n"
+                               "end ID              tell both players and end a session\n"
+                               "trace [SPEC]        show or set trace levels (debug, wire=debug,session=info, ...)\n"
+                               "drain               stop taking clients and exit once every session has finished\n"
+                               "handoff             drain and pass the listeners to the server asking (see --inherit-from)\n"
+                               "quit                close this connection\n"
+                               "OK\n");
+        }
+        else if (command == "sessions")
+        {
+            admin_list(client);
+        }
+        else if (command == "boards" || command == "end")
+        {
+            int session_id = 0;
+            auto [end, error] = std::from_chars(argument.data(), argument.data() + argument.size(), session_id);
+            if (argument.empty() || error != std::errc() || end != argument.data() + argument.size())
+            {
+                admin_send(client, "ERR usage: " + std::string(command) + " SESSION_ID\n");
+                return;
+            }
+            SlotMap<std::unique_ptr<GameSession>>::Key key = 0;
+            EventLoop *loop = nullptr;
+            {
+                // Búsqueda O(1) por ID: el lock es el mismo que toman start_session() y reclaim_sessions().
+                std::lock_guard<std::mutex> lock(sessions_mutex_);
+                auto it = session_keys_.find(session_id);
+                if (it != session_keys_.end())
+                {
+                    key = it->second;
+                    loop = &(*sessions_.find(key))->loop();
+                }
+            }
+            if (loop == nullptr)
+            {
+                admin_send(client, "ERR no session " + std::to_string(session_id) + "\n");
+                return;
+            }
+            auto request = command == "boards" ? GameSession::AdminRequest::BOARDS : GameSession::AdminRequest::TERMINATE;
+            admin_session(key, *loop, request, [this, client, session_id](std::string text)
+                          { admin_send(client, text.empty() ? "ERR session " + std::to_string(session_id) + " already finished\n"
+                                                            : text + "OK\n"); });
+        }
+        else if (command == "trace")
+        {
+            if (!argument.empty())
+            {
+                try
+                {
+                    Trace::configure(argument);
+                }
+                catch (const std::invalid_argument &e)
+                {
+                    admin_send(client, "ERR " + std::string(e.what()) + "\n");
+                    return;
+                }
+                log("0.0.0.0", "Trace levels changed", std::string(argument));
+            }
+            std::string text;
+            for (size_t i = 0; i < Trace::CATEGORY_COUNT; ++i)
+            {
+                auto category = static_cast<TraceCategory>(i);
+                text.append(i == 0 ? "" : " ").append(Trace::category_name(category)).append("=").append(Trace::level_name(Trace::level(category)));
+            }
+            admin_send(client, text + "\nOK\n");
+        }
+        else if (command == "drain")
+        {
+            size_t active;
+            {
+                std::lock_guard<std::mutex> lock(sessions_mutex_);
+                active = sessions_.size();
+            }
+            // La respuesta se encola antes de que el drenado pueda detener los loops.
+            admin_send(client, "OK draining, " + std::to_string(active) + " sessions in progress\n");
+            drain();
+        }
+        else if (command == "handoff")
+        {
+            // Lo pide un servidor nuevo arrancado con --inherit-from: recibe los sockets cuando el drenado se asienta.
+            auto connection = client.lock();
+            if (connection && !begin_drain(client))
+                admin_send(client, "ERR already draining\n");
+        }
+        else if (command == "quit")
+        {
+            if (auto connection = client.lock())
+                connection->close();
+        }
+        else
+        {
+            admin_send(client, "ERR unknown command: " + std::string(command) + " (try help)\n");
+        }
+    }
+
+    void Server::admin_send(const std::weak_ptr<Connection> &client, std::string text)
+    {
+        loops_[0]->post([client, text = std::move(text)]
+                        {
+                            auto connection = client.lock();
+                            if (connection && connection->is_open())
+                                connection->send(text); });
+    }
+
+    void Server::admin_session(SlotMap<std::unique_ptr<GameSession>>::Key key, EventLoop &loop,
+                               GameSession::AdminRequest request, GameSession::AdminReply reply)
     {
-        std::lock_guard<std::mutex> lock(log_mutex_);
-        std::time_t now = std::time(nullptr);
-        std::tm *local_time = std::localtime(&now);
-        std::ostringstream oss;
-        oss << std::put_time(local_time, "%Y-%m-%d %H:%M:%S") << " " << client_ip << " " << query << " " << response;
-        std::string log_entry = oss.str();
-        std::cout << "[" << level << "] " << log_entry << std::endl;
-        if (log_file_.is_open())
+        // En el loop de la sesión: allí se sabe si ya aplicó su cierre (ver GameSession::admin()).
+        loop.post([this, key, request, reply = std::move(reply)]() mutable
+                  {
+                      std::lock_guard<std::mutex> lock(sessions_mutex_);
+                      auto *session = sessions_.find(key);
+                      if (session == nullptr || !(*session)->admin(request, reply))
+                          reply(std::string()); });
+    }
+
+    void Server::admin_list(const std::weak_ptr<Connection> &client)
+    {
+        struct Target
         {
-            log_file_ << "[" << level << "] " << log_entry << "\n";
-            log_file_.flush();
+            SlotMap<std::unique_ptr<GameSession>>::Key key;
+            EventLoop *loop;
+            int session_id;
+        };
+        std::vector<Target> targets;
+        {
+            std::lock_guard<std::mutex> lock(sessions_mutex_);
+            sessions_.for_each([&](SlotMap<std::unique_ptr<GameSession>>::Key key, std::unique_ptr<GameSession> &session)
+                               { targets.push_back({key, &session->loop(), session->get_session_id()}); });
         }
+        if (targets.empty())
+        {
+            admin_send(client, "OK 0 sessions\n");
+            return;
+        }
+
+        // Cada sesión responde desde su strand; la última en responder envía la lista completa.
+        struct Listing
+        {
+            std::mutex mutex;
+            std::vector<std::pair<int, std::string>> lines;
+            size_t pending;
+        };
+        auto listing = std::make_shared<Listing>();
+        listing->pending = targets.size();
+        for (const auto &target : targets)
+        {
+            admin_session(target.key, *target.loop, GameSession::AdminRequest::SUMMARY,
+                          [this, client, listing, session_id = target.session_id](std::string text)
+                          {
+                              std::lock_guard<std::mutex> lock(listing->mutex);
+                              if (!text.empty())
+                                  listing->lines.emplace_back(session_id, std::move(text));
+                              if (--listing->pending != 0)
+                                  return;
+                              std::sort(listing->lines.begin(), listing->lines.end());
+                              std::string out;
+                              for (const auto &line : listing->lines)
+                                  out += line.second;
+                              out += "OK " + std::to_string(listing->lines.size()) + " sessions\n";
+                              admin_send(client, std::move(out)); });
+        }
+    }
+
+    void Server::drain()
+    {
+        begin_drain({});
+    }
+
+    bool Server::begin_drain(const std::weak_ptr<Connection> &heir)
+    {
+        if (draining_.exchange(true))
+            return false;
+        heir_ = heir;
+        handing_off_ = !heir.expired();
+        size_t active;
+        {
+            std::lock_guard<std::mutex> lock(sessions_mutex_);
+            active = sessions_.size();
+        }
+        log("0.0.0.0", "Drain started", std::to_string(active) + " sessions in progress" + (handing_off_ ? ", handing the listeners off" : ""));
+        // Cada listener lo deja su propio loop; las conexiones aún no aceptadas quedan en su cola.
+        // La marca espera a que el último listener no pueda entregar ningún cliente más.
+        auto remaining = std::make_shared<std::atomic<size_t>>(listen_fds_.size());
+        auto stopped = [this, remaining]
+        {
+            if (remaining->fetch_sub(1) != 1)
+                return;
+            // Ya no se acepta nada: la marca va detrás de todos los clientes aceptados.
+            while (!matchmaking_.try_push(PendingClient{}))
+                std::this_thread::yield();
+            if (queued_clients_.fetch_add(1, std::memory_order_acq_rel) == 0)
+            {
+                workers_->submit([this]
+                                 { pair_clients(); });
+            }
+        };
+        for (size_t i = 0; i < listen_fds_.size(); ++i)
+        {
+            EventLoop &loop = *loops_[i % loops_.size()];
+            loop.post([this, &loop, i, stopped]
+                      { loop.stop_accepting(listen_fds_[i], stopped); });
+        }
+        return true;
+    }
+
+    void Server::settle_drain(PendingClient leftover)
+    {
+        if (handing_off_)
+        {
+            auto heir = heir_.lock();
+            if (!heir || !heir->is_open() || !hand_off(*heir, leftover))
+            {
+                // Sin sucesor los listeners no pueden quedar cerrados: se vuelve a aceptar.
+                resume_accepting(std::move(leftover));
+                admin_send(heir_, "ERR handoff failed\n");
+                heir_.reset();
+                return;
+            }
+        }
+        else if (leftover.fd >= 0)
+        {
+            log(leftover.ip, "Client rejected", "Server draining", "INFO");
+            close(leftover.fd);
+        }
+        drain_settled_ = true;
+        finish_drain();
+    }
+
+    void Server::resume_accepting(PendingClient leftover)
+    {
+        log("0.0.0.0", "Drain cancelled", "Handoff failed, accepting clients again", "ERROR");
+        handing_off_ = false;
+        draining_ = false;
+        for (size_t i = 0; i < listen_fds_.size(); ++i)
+        {
+            loops_[i % loops_.size()]->post([this, i]
+                                            { accept_clients(i); });
+        }
+        // El cliente que esperaba rival vuelve a la cola de emparejamiento.
+        if (leftover.fd >= 0)
+            on_client_accepted(leftover.shard, leftover.fd);
+    }
+
+    void Server::accept_clients(size_t index)
+    {
+        size_t shard = index % loops_.size();
+        loops_[shard]->accept_on(listen_fds_[index], [this, shard](int client_fd)
+                                 { on_client_accepted(shard, client_fd); });
+    }
+
+    bool Server::hand_off(Connection &heir, PendingClient &leftover)
+    {
+        // Las métricas también pasan al sucesor; este proceso deja de servirlas.
+        std::vector<int> fds = listen_fds_;
+        if (metrics_fd_ >= 0)
+        {
+            loops_[0]->stop_accepting(metrics_fd_, {});
+            fds.push_back(metrics_fd_);
+        }
+        if (leftover.fd >= 0)
+            fds.push_back(leftover.fd);
+        std::string line = "OK handoff " + std::to_string(listen_fds_.size()) + " " + std::to_string(metrics_fd_ >= 0 ? 1 : 0) +
+                           " " + std::to_string(leftover.fd >= 0 ? 1 : 0) + "\n";
+
+        // Los descriptores viajan como SCM_RIGHTS junto con la línea, en un solo sendmsg.
+        struct iovec data{line.data(), line.size()};
+        std::vector<char> control(CMSG_SPACE(sizeof(int) * fds.size()));
+        struct msghdr message{};
+        message.msg_iov = &data;
+        message.msg_iovlen = 1;
+        message.msg_control = control.data();
+        message.msg_controllen = control.size();
+        struct cmsghdr *header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+        std::memcpy(CMSG_DATA(header), fds.data(), sizeof(int) * fds.size());
+        if (sendmsg(heir.fd(), &message, MSG_NOSIGNAL) != static_cast<ssize_t>(line.size()))
+        {
+            log("0.0.0.0", "Handoff failed", strerror(errno), "ERROR");
+            if (metrics_fd_ >= 0)
+            {
+                loops_[0]->accept_on(metrics_fd_, [this](int client_fd)
+                                     { on_metrics_client(client_fd); });
+            }
+            return false;
+        }
+        log("0.0.0.0", "Listeners handed off", std::to_string(listen_fds_.size()) + " listeners, " +
+                                                   std::to_string(leftover.fd >= 0 ? 1 : 0) + " unpaired clients");
+        // El sucesor tiene su propia copia de cada descriptor.
+        if (leftover.fd >= 0)
+            close(leftover.fd);
+        return true;
+    }
+
+    void Server::take_over(std::vector<int> &clients)
+    {
+        const std::string &path = options_.inherit_path;
+        struct sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            throw ServerError("Inherit path too long: " + path);
+        }
+        path.copy(address.sun_path, path.size());
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd == -1 || connect(fd, (struct sockaddr *)&address, sizeof(address)) < 0)
+        {
+            std::string error = strerror(errno);
+            if (fd >= 0)
+                close(fd);
+            throw ServerError("Failed to reach the server to take over at " + path + ": " + error);
+        }
+
+        // El anterior responde cuando ha dejado de aceptar y ha emparejado lo que ya tenía aceptado.
+        std::string line;
+        std::vector<int> fds;
+        static constexpr char REQUEST[] = "handoff\n";
+        bool sent = ::send(fd, REQUEST, sizeof(REQUEST) - 1, MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(REQUEST) - 1);
+        while (sent && line.find('\n') == std::string::npos)
+        {
+            char buffer[256];
+            alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int) * 253)];
+            struct iovec data{buffer, sizeof(buffer)};
+            struct msghdr message{};
+            message.msg_iov = &data;
+            message.msg_iovlen = 1;
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+            ssize_t received = recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+            if (received <= 0)
+                break;
+            line.append(buffer, static_cast<size_t>(received));
+            for (struct cmsghdr *header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header))
+            {
+                if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS)
+                {
+                    size_t count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                    size_t offset = fds.size();
+                    fds.resize(offset + count);
+                    std::memcpy(fds.data() + offset, CMSG_DATA(header), sizeof(int) * count);
+                }
+            }
+        }
+        close(fd);
+
+        size_t listeners = 0, metrics = 0, unpaired = 0;
+        int fields = std::sscanf(line.c_str(), "OK handoff %zu %zu %zu", &listeners, &metrics, &unpaired);
+        if (fields != 3 || listeners == 0 || listeners + metrics + unpaired != fds.size())
+        {
+            for (int received : fds)
+                close(received);
+            line = line.substr(0, line.find('\n'));
+            throw ServerError("Handoff from " + path + " failed: " + (line.empty() ? std::string("no answer") : line));
+        }
+
+        // Los listeners deben ser los del puerto que este proceso va a servir.
+        for (size_t i = 0; i < listeners; ++i)
+        {
+            struct sockaddr_in bound{};
+            socklen_t length = sizeof(bound);
+            if (getsockname(fds[i], (struct sockaddr *)&bound, &length) < 0 || bound.sin_family != AF_INET ||
+                ntohs(bound.sin_port) != port_)
+            {
+                for (int received : fds)
+                    close(received);
+                throw ServerError("Inherited listener is not bound to port " + std::to_string(port_));
+            }
+        }
+        listen_fds_.assign(fds.begin(), fds.begin() + static_cast<std::ptrdiff_t>(listeners));
+        if (metrics == 1)
+        {
+            // Se reutiliza si apunta al mismo puerto de métricas; si no, se abre el propio.
+            struct sockaddr_in bound{};
+            socklen_t length = sizeof(bound);
+            int inherited = fds[listeners];
+            if (options_.metrics_port != 0 && getsockname(inherited, (struct sockaddr *)&bound, &length) == 0 &&
+                ntohs(bound.sin_port) == options_.metrics_port)
+                metrics_fd_ = inherited;
+            else
+                close(inherited);
+        }
+        clients.assign(fds.begin() + static_cast<std::ptrdiff_t>(listeners + metrics), fds.end());
+        log("0.0.0.0", "Listeners taken over", std::to_string(listeners) + " listeners, " + std::to_string(unpaired) +
+                                                   " unpaired clients from " + path);
+    }
+
+    void Server::finish_drain()
+    {
+        if (!draining_ || !drain_settled_)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(sessions_mutex_);
+            if (sessions_.size() != 0)
+                return;
+        }
+        // Solo quien cambia running_ detiene los loops; run() vuelve cuando terminan.
+        if (!running_.exchange(false))
+            return;
+        log("0.0.0.0", "Drain complete", "Every session finished");
+        // Detrás de lo ya encolado en el primer loop (como la respuesta de la orden drain).
+        loops_[0]->post([this]
+                        {
+                            for (auto &loop : loops_)
+                                loop->stop(); });
+    }
+
+    void Server::dump_latencies()
+    {
+        for (size_t i = 0; i < Metrics::STAGES; ++i)
+        {
+            auto stage = static_cast<Stage>(i);
+            log("0.0.0.0", "Latency " + std::string(Metrics::stage_name(stage)), metrics_.latency_summary(stage), "STATS");
+        }
+    }
+
+    void Server::schedule_latency_dump()
+    {
+        loops_[0]->run_after(std::chrono::duration_cast<std::chrono::milliseconds>(options_.stats_interval), [this]
+                             {
+                                 dump_latencies();
+                                 schedule_latency_dump(); });
+    }
+
+    void Server::on_signal()
+    {
+        // Varias señales seguidas se leen juntas: basta un volcado.
+        struct signalfd_siginfo info;
+        bool dump = false;
+        bool terminate = false;
+        while (::read(signal_fd_, &info, sizeof(info)) == static_cast<ssize_t>(sizeof(info)))
+        {
+            dump |= info.ssi_signo == SIGUSR1;
+            terminate |= info.ssi_signo == SIGTERM;
+        }
+        if (dump)
+            dump_latencies();
+        if (terminate)
+            drain();
+    }
+
+    void Server::on_client_accepted(size_t shard, int client_fd)
+    {
+        if (client_fd < 0)
+        {
+            log("0.0.0.0", "Accept failed", strerror(-client_fd), "ERROR");
+            return;
+        }
+        if (!running_)
+        {
+            close(client_fd);
+            return;
+        }
+        // Cada turno es un mensaje pequeño: sin Nagle el STATUS no espera al ACK retardado del cliente.
+        int nodelay = 1;
+        setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+        struct sockaddr_in client_addr;
+        socklen_t addr_len = sizeof(client_addr);
+        char client_ip[INET_ADDRSTRLEN] = "unknown";
+        if (getpeername(client_fd, (struct sockaddr *)&client_addr, &addr_len) == 0)
+        {
+            inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
+        }
+        log(client_ip, "Client connected", "Assigning to session");
+
+        if (!matchmaking_.try_push(PendingClient{client_fd, client_ip, shard}))
+        {
+            log(client_ip, "Client rejected", "Matchmaking queue full", "ERROR");
+            close(client_fd);
+            return;
+        }
+        // El cliente que lleva la cuenta de 0 a 1 programa el emparejador; mientras corre, los demás solo se encolan.
+        if (queued_clients_.fetch_add(1, std::memory_order_acq_rel) == 0)
+        {
+            workers_->submit([this]
+                             { pair_clients(); });
+        }
+    }
+
+    void Server::pair_clients()
+    {
+        size_t pending = queued_clients_.load(std::memory_order_acquire);
+        while (pending > 0)
+        {
+            size_t taken = 0;
+            PendingClient client;
+            while (taken < pending)
+            {
+                // Un productor que reclamó una celda anterior y aún no la escribió la oculta un instante.
+                if (!matchmaking_.try_pop(client))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                ++taken;
+                if (client.fd < 0)
+                {
+                    // Marca del drenado: todo lo aceptado ya se emparejó; el impar que quede se entrega o se rechaza.
+                    PendingClient leftover = std::move(waiting_client_);
+                    waiting_client_ = PendingClient{};
+                    loops_[0]->post([this, leftover = std::move(leftover)]() mutable
+                                    { settle_drain(std::move(leftover)); });
+                    continue;
+                }
+                if (waiting_client_.fd < 0)
+                {
+                    waiting_client_ = std::move(client);
+                    continue;
+                }
+                start_session(waiting_client_, client);
+                waiting_client_ = PendingClient{};
+            }
+            // Si llegaron clientes mientras tanto la cuenta no baja a 0 y esta misma tarea los atiende.
+            pending = queued_clients_.fetch_sub(taken, std::memory_order_acq_rel) - taken;
+        }
+    }
+
+    void Server::start_session(PendingClient &first, PendingClient &second)
+    {
+        // La sesión vive en el shard del primer jugador: el reparto entre loops lo hace el kernel al aceptar.
+        EventLoop &loop = *loops_[first.shard];
+        auto session = std::make_unique<GameSession>(next_session_id_++, loop, *workers_, metrics_, options_.turn_timeout);
+
+        session->add_player(1, first.fd, first.ip);
+        session->add_player(2, second.fd, second.ip);
+        GameSession::JournalFn journal_fn;
+        if (journal_)
+        {
+            journal_fn = [this](BattleShipProtocol::JournalRecord &record)
+            { journal(record); };
+        }
+        // Se registra antes de arrancar: la sesión no puede terminar sin estar en la tabla.
+        GameSession &started = *session;
+        SlotMap<std::unique_ptr<GameSession>>::Key key;
+        {
+            std::lock_guard<std::mutex> lock(sessions_mutex_);
+            key = sessions_.insert(std::move(session));
+            session_keys_.emplace(started.get_session_id(), key);
+        }
+        started.start(protocol_, [this](const auto &ip, const auto &q, const auto &r, const auto &l)
+                      { log(ip, q, r, l); }, std::move(journal_fn), [this, key]
+                      { on_session_finished(key); });
+    }
+
+    void Server::on_session_finished(SlotMap<std::unique_ptr<GameSession>>::Key key)
+    {
+        auto *entry = new Completion{key, finished_sessions_.load(std::memory_order_relaxed)};
+        while (!finished_sessions_.compare_exchange_weak(entry->next, entry, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+        // Solo quien encuentra la pila vacía programa la recogida; las demás entradas viajan en ese mismo lote.
+        if (entry->next == nullptr)
+        {
+            workers_->submit([this]
+                             { reclaim_sessions(); });
+        }
+    }
+
+    void Server::reclaim_sessions()
+    {
+        Completion *entry = finished_sessions_.exchange(nullptr, std::memory_order_acquire);
+        while (entry != nullptr)
+        {
+            std::unique_ptr<Completion> owned(entry);
+            entry = entry->next;
+
+            std::unique_ptr<GameSession> session;
+            {
+                std::lock_guard<std::mutex> lock(sessions_mutex_);
+                if (sessions_.take(owned->key, session))
+                    session_keys_.erase(session->get_session_id());
+            }
+            // El destructor (y el cierre de descriptores que nunca llegaron al loop) corre fuera del lock.
+            session.reset();
+        }
+        finish_drain();
+    }
+
+    void GameSession::send_message(int player_id, const BattleShipProtocol::Message &msg)
+    {
+        auto &slot = players_.at(player_id);
+        // Se codifica directamente en el buffer del Outbox, que se reutiliza de una tarea a otra.
+        std::string &data = outbox_->data;
+        size_t offset = data.size();
+        auto started = std::chrono::steady_clock::now();
+        if (slot.binary_out)
+        {
+            protocol_.build_binary_message(msg, data);
+            metrics_.observe(Stage::BUILD_MESSAGE, std::chrono::steady_clock::now() - started);
+            outbox_->sends.push_back(Send{player_id, offset, data.size() - offset});
+            metrics_.message_out(msg.type, data.size() - offset);
+            return;
+        }
+
+        protocol_.build_message(msg, data);
+        metrics_.observe(Stage::BUILD_MESSAGE, std::chrono::steady_clock::now() - started);
+        BATTLESHIP_TRACE(WIRE, DEBUG, "Enviado a jugador ", player_id, ": ",
+                         std::string_view(data).substr(offset, data.size() - offset - 1));
+
+        outbox_->sends.push_back(Send{player_id, offset, data.size() - offset});
+        metrics_.message_out(msg.type, data.size() - offset);
+    }
+
+    void Server::log(const std::string &client_ip, const std::string &query, const std::string &response,
+                     const std::string &level) const
+    {
+        logger_->log(level, client_ip, query, response);
+    }
+
+    void Server::journal(BattleShipProtocol::JournalRecord &record) const
+    {
+        // Buffer por hilo: codificar un evento no reserva memoria una vez caliente.
+        thread_local std::string encoded;
+        encoded.clear();
+        record.time_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                                   std::chrono::steady_clock::now() - journal_start_)
+                                                   .count());
+        BattleShipProtocol::Journal::append(encoded, record);
+        journal_->append(encoded);
     }
 
 } // namespace BattleshipServer
\ No newline at end of file
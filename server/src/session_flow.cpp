@@ -0,0 +1,159 @@
+#include "server.hpp"
+#include "trace.hpp"
+
+namespace BattleshipServer
+{
+    namespace
+    {
+        using Phase = BattleShipProtocol::PhaseState::Phase;
+
+        constexpr unsigned player_bit(int player_id)
+        {
+            return 1u << player_id;
+        }
+
+        BattleShipProtocol::JournalRecord phase_event(Phase phase)
+        {
+            BattleShipProtocol::JournalRecord record;
+            record.type = BattleShipProtocol::JournalEvent::PHASE;
+            record.value = static_cast<uint8_t>(phase);
+            return record;
+        }
+    }
+
+    Flow GameSession::run_flow()
+    {
+        co_await registration();
+        co_await placement();
+        co_await playing();
+    }
+
+    Flow GameSession::registration()
+    {
+        while (!game_.are_both_registered())
+        {
+            unsigned pending = 0;
+            for (int i = 1; i <= 2; ++i)
+            {
+                if (game_.get_player_nickname(i).empty())
+                    pending |= player_bit(i);
+            }
+            auto in = co_await receive(pending);
+            handle_registration(in.player, in.msg);
+        }
+        BATTLESHIP_TRACE(SESSION, DEBUG, "Transicionando a fase PLACEMENT para sesión ", session_id_);
+        game_.transition_to_placement();
+        journal(phase_event(Phase::PLACEMENT));
+    }
+
+    Flow GameSession::placement()
+    {
+        while (!game_.are_both_ships_placed())
+        {
+            unsigned pending = 0;
+            for (int i = 1; i <= 2; ++i)
+            {
+                if (game_.ships_placed(i) < 9)
+                    pending |= player_bit(i);
+            }
+            auto in = co_await receive(pending);
+            handle_placement(in.player, in.msg);
+        }
+        BATTLESHIP_TRACE(SESSION, DEBUG, "Transicionando a fase PLAYING para sesión ", session_id_);
+        game_.transition_to_playing();
+        journal(phase_event(Phase::PLAYING));
+        start_turn(1);
+        for (int i = 1; i <= 2; ++i)
+        {
+            send_status(i);
+        }
+        BATTLESHIP_TRACE(SESSION, DEBUG, "Iniciando fase PLAYING, turno inicial: Jugador ", current_player_);
+    }
+
+    Flow GameSession::playing()
+    {
+        // end_game() y la rendición marcan la sesión como terminada: el siguiente receive() ya no vuelve.
+        while (true)
+        {
+            auto in = co_await receive(player_bit(current_player_), turn_deadline_);
+            if (in.player == 0)
+            {
+                expire_turn();
+                continue;
+            }
+            handle_playing(in.player, in.msg);
+        }
+    }
+
+    GameSession::Receive GameSession::receive(unsigned players)
+    {
+        return Receive{*this, players, false};
+    }
+
+    GameSession::Receive GameSession::receive(unsigned players, std::chrono::steady_clock::time_point deadline)
+    {
+        arm_timer(deadline);
+        return Receive{*this, players, true};
+    }
+
+    void GameSession::Receive::await_suspend(std::coroutine_handle<> flow)
+    {
+        // Sesión terminando: el flujo queda aparcado sin que nadie lo reanude; su marco se libera con la sesión.
+        if (session.ending_)
+            return;
+        session.waiter_ = flow;
+        session.waiting_players_ = players;
+        session.waiting_timed_ = timed;
+    }
+
+    bool GameSession::take(unsigned players)
+    {
+        // Igual que la máquina de estados: el jugador 1 se atiende antes que el 2.
+        for (int i = 1; i <= 2; ++i)
+        {
+            auto &inbox = players_.at(i).inbox;
+            if ((players & player_bit(i)) && !inbox.empty())
+            {
+                resumed_ = Inbound{i, std::move(inbox.front().msg)};
+                received_ = inbox.front().received;
+                inbox.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void GameSession::resume_flow()
+    {
+        std::exchange(waiter_, {}).resume();
+        flow_.rethrow();
+    }
+
+    void GameSession::process_inboxes()
+    {
+        if (waiter_ && !ending_ && take(waiting_players_))
+        {
+            resume_flow();
+        }
+    }
+
+    void GameSession::on_turn_timeout(uint64_t generation)
+    {
+        // Un timeout que salió del loop justo antes de un disparo llega tarde: el turno ya es otro.
+        if (ending_ || generation != turn_generation_ || !waiter_ || !waiting_timed_)
+            return;
+
+        resumed_ = Inbound{};
+        try
+        {
+            resume_flow();
+        }
+        catch (const std::exception &e)
+        {
+            BATTLESHIP_TRACE(SESSION, ERROR, "Error crítico en la sesión ", session_id_, ": ", e.what());
+            log_fn_("0.0.0.0", "Critical error in session", e.what(), "ERROR");
+            handle_disconnect(current_player_, "Unexpected error: " + std::string(e.what()));
+        }
+    }
+
+} // namespace BattleshipServer
@@ -0,0 +1,58 @@
+#include "slab_pool.hpp"
+
+namespace BattleshipServer
+{
+    SlabPool::SlabPool(size_t block_size, size_t blocks_per_slab)
+        : blocks_per_slab_(blocks_per_slab == 0 ? 1 : blocks_per_slab)
+    {
+        // Cada bloque libre guarda un puntero y todos quedan alineados como lo haría malloc.
+        constexpr size_t alignment = alignof(std::max_align_t);
+        size_t size = block_size < sizeof(FreeBlock) ? sizeof(FreeBlock) : block_size;
+        block_size_ = (size + alignment - 1) / alignment * alignment;
+    }
+
+    void *SlabPool::allocate()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_ == nullptr)
+        {
+            // new[] de std::byte devuelve memoria alineada a max_align_t.
+            auto slab = std::make_unique<std::byte[]>(block_size_ * blocks_per_slab_);
+            for (size_t i = blocks_per_slab_; i-- > 0;)
+            {
+                auto *block = reinterpret_cast<FreeBlock *>(slab.get() + i * block_size_);
+                block->next = free_;
+                free_ = block;
+            }
+            slabs_.push_back(std::move(slab));
+        }
+        FreeBlock *block = free_;
+        free_ = block->next;
+        ++in_use_;
+        return block;
+    }
+
+    void SlabPool::deallocate(void *block) noexcept
+    {
+        if (block == nullptr)
+            return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto *free_block = static_cast<FreeBlock *>(block);
+        free_block->next = free_;
+        free_ = free_block;
+        --in_use_;
+    }
+
+    size_t SlabPool::in_use() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return in_use_;
+    }
+
+    size_t SlabPool::capacity() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return slabs_.size() * blocks_per_slab_;
+    }
+
+} // namespace BattleshipServer
@@ -0,0 +1,206 @@
+#include "timer_wheel.hpp"
+
+namespace BattleshipServer
+{
+    namespace
+    {
+        unsigned lowest_bit(uint64_t mask)
+        {
+            return static_cast<unsigned>(__builtin_ctzll(mask));
+        }
+    } // namespace
+
+    TimerWheel::TimerWheel(uint64_t now_ms) : current_(now_ms)
+    {
+        heads_.fill(NIL);
+    }
+
+    TimerWheel::TimerId TimerWheel::schedule(uint64_t deadline_ms, Callback callback)
+    {
+        uint32_t index;
+        if (free_head_ != NIL)
+        {
+            index = free_head_;
+            free_head_ = nodes_[index].next;
+        }
+        else
+        {
+            index = static_cast<uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+        }
+        Node &node = nodes_[index];
+        node.deadline = deadline_ms;
+        node.callback = std::move(callback);
+        insert(index);
+        ++size_;
+        return (static_cast<uint64_t>(node.generation) << 32) | (index + 1);
+    }
+
+    bool TimerWheel::cancel(TimerId id)
+    {
+        uint64_t slot = id & 0xFFFFFFFFu;
+        if (slot == 0 || slot > nodes_.size())
+        {
+            return false;
+        }
+        uint32_t index = static_cast<uint32_t>(slot - 1);
+        Node &node = nodes_[index];
+        if (node.list == NIL || node.generation != static_cast<uint32_t>(id >> 32))
+        {
+            return false;
+        }
+        unlink(index);
+        release(index);
+        return true;
+    }
+
+    size_t TimerWheel::advance(uint64_t now_ms)
+    {
+        size_t fired = 0;
+        while (true)
+        {
+            auto next = next_expiry();
+            if (!next || *next > now_ms)
+            {
+                break;
+            }
+
+            uint64_t previous = current_;
+            current_ = *next;
+
+            // Al cruzar el inicio de un bloque se baja su contenido de nivel, empezando por el más alto.
+            if ((current_ >> (SLOT_BITS * LEVELS)) != (previous >> (SLOT_BITS * LEVELS)))
+            {
+                redistribute(OVERFLOW_SLOT);
+            }
+            for (unsigned level = LEVELS - 1; level >= 1; --level)
+            {
+                unsigned shift = SLOT_BITS * level;
+                if ((current_ >> shift) != (previous >> shift))
+                {
+                    redistribute(level * SLOTS + ((current_ >> shift) & (SLOTS - 1)));
+                }
+            }
+
+            // El slot actual del nivel 0 solo contiene timers que vencen exactamente ahora.
+            unsigned list = current_ & (SLOTS - 1);
+            while (heads_[list] != NIL)
+            {
+                uint32_t index = heads_[list];
+                unlink(index);
+                Callback callback = std::move(nodes_[index].callback);
+                release(index);
+                ++fired;
+                callback();
+            }
+        }
+        if (now_ms > current_)
+        {
+            current_ = now_ms;
+        }
+        return fired;
+    }
+
+    std::optional<uint64_t> TimerWheel::next_expiry() const
+    {
+        if (size_ == 0)
+        {
+            return std::nullopt;
+        }
+
+        uint64_t mask = occupied_[0] & (~0ull << (current_ & (SLOTS - 1)));
+        if (mask)
+        {
+            return (current_ & ~static_cast<uint64_t>(SLOTS - 1)) | lowest_bit(mask);
+        }
+        for (unsigned level = 1; level < LEVELS; ++level)
+        {
+            unsigned shift = SLOT_BITS * level;
+            unsigned position = (current_ >> shift) & (SLOTS - 1);
+            mask = (position == SLOTS - 1) ? 0 : occupied_[level] & (~0ull << (position + 1));
+            if (mask)
+            {
+                uint64_t block = (current_ >> (shift + SLOT_BITS)) << (shift + SLOT_BITS);
+                return block | (static_cast<uint64_t>(lowest_bit(mask)) << shift);
+            }
+        }
+        // Solo quedan timers en la lista de desborde: se revisan al empezar el siguiente bloque superior.
+        return ((current_ >> (SLOT_BITS * LEVELS)) + 1) << (SLOT_BITS * LEVELS);
+    }
+
+    void TimerWheel::insert(uint32_t index)
+    {
+        Node &node = nodes_[index];
+        uint64_t deadline = node.deadline < current_ ? current_ : node.deadline;
+
+        unsigned list = OVERFLOW_SLOT;
+        for (unsigned level = 0; level < LEVELS; ++level)
+        {
+            unsigned shift = SLOT_BITS * level;
+            // Nivel más bajo cuyo bloque padre comparte con el instante actual.
+            if ((deadline >> (shift + SLOT_BITS)) == (current_ >> (shift + SLOT_BITS)))
+            {
+                unsigned slot = (deadline >> shift) & (SLOTS - 1);
+                list = level * SLOTS + slot;
+                occupied_[level] |= 1ull << slot;
+                break;
+            }
+        }
+
+        node.list = list;
+        node.prev = NIL;
+        node.next = heads_[list];
+        if (heads_[list] != NIL)
+        {
+            nodes_[heads_[list]].prev = index;
+        }
+        heads_[list] = index;
+    }
+
+    void TimerWheel::unlink(uint32_t index)
+    {
+        Node &node = nodes_[index];
+        unsigned list = node.list;
+        if (node.prev != NIL)
+            nodes_[node.prev].next = node.next;
+        else
+            heads_[list] = node.next;
+        if (node.next != NIL)
+            nodes_[node.next].prev = node.prev;
+
+        if (heads_[list] == NIL && list != OVERFLOW_SLOT)
+        {
+            occupied_[list / SLOTS] &= ~(1ull << (list % SLOTS));
+        }
+        node.list = NIL;
+        node.prev = node.next = NIL;
+    }
+
+    void TimerWheel::redistribute(unsigned list)
+    {
+        uint32_t index = heads_[list];
+        heads_[list] = NIL;
+        if (list != OVERFLOW_SLOT)
+        {
+            occupied_[list / SLOTS] &= ~(1ull << (list % SLOTS));
+        }
+        while (index != NIL)
+        {
+            uint32_t next = nodes_[index].next;
+            insert(index);
+            index = next;
+        }
+    }
+
+    void TimerWheel::release(uint32_t index)
+    {
+        Node &node = nodes_[index];
+        node.callback = nullptr;
+        node.list = NIL;
+        ++node.generation;
+        node.next = free_head_;
+        free_head_ = index;
+        --size_;
+    }
+
+} // namespace BattleshipServer
@@ -0,0 +1,123 @@
+#include "trace.hpp"
+#include "async_logger.hpp"
+#include <stdexcept>
+#include <unistd.h>
+
+namespace BattleshipServer
+{
+    namespace
+    {
+        std::atomic<AsyncLogger *> sink{nullptr};
+
+        constexpr std::string_view CATEGORY_NAMES[Trace::CATEGORY_COUNT] = {"session", "wire", "timer"};
+        constexpr std::string_view LEVEL_NAMES[] = {"off", "error", "info", "debug"};
+        // Nivel tal como aparece en la línea del log.
+        constexpr std::string_view LEVEL_TAGS[] = {"OFF", "ERROR", "INFO", "DEBUG"};
+
+        TraceLevel parse_level(std::string_view name)
+        {
+            for (size_t i = 0; i < std::size(LEVEL_NAMES); ++i)
+            {
+                if (LEVEL_NAMES[i] == name)
+                    return static_cast<TraceLevel>(i);
+            }
+            throw std::invalid_argument("Unknown trace level: " + std::string(name));
+        }
+
+        TraceCategory parse_category(std::string_view name)
+        {
+            for (size_t i = 0; i < Trace::CATEGORY_COUNT; ++i)
+            {
+                if (CATEGORY_NAMES[i] == name)
+                    return static_cast<TraceCategory>(i);
+            }
+            throw std::invalid_argument("Unknown trace category: " + std::string(name));
+        }
+    }
+
+    namespace Trace
+    {
+        void set_level(TraceCategory category, TraceLevel level) noexcept
+        {
+            levels[static_cast<size_t>(category)].store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+        }
+
+        void set_level(TraceLevel level) noexcept
+        {
+            for (auto &category_level : levels)
+            {
+                category_level.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+            }
+        }
+
+        TraceLevel level(TraceCategory category) noexcept
+        {
+            return static_cast<TraceLevel>(levels[static_cast<size_t>(category)].load(std::memory_order_relaxed));
+        }
+
+        void configure(std::string_view spec)
+        {
+            if (spec.find('=') == std::string_view::npos)
+            {
+                set_level(parse_level(spec));
+                return;
+            }
+            // Se valida todo antes de aplicar: una especificación inválida no deja cambios a medias.
+            uint8_t wanted[CATEGORY_COUNT];
+            for (size_t i = 0; i < CATEGORY_COUNT; ++i)
+            {
+                wanted[i] = levels[i].load(std::memory_order_relaxed);
+            }
+            while (!spec.empty())
+            {
+                size_t comma = spec.find(',');
+                std::string_view item = spec.substr(0, comma);
+                size_t equals = item.find('=');
+                if (equals == std::string_view::npos)
+                {
+                    throw std::invalid_argument("Expected category=level: " + std::string(item));
+                }
+                TraceCategory category = parse_category(item.substr(0, equals));
+                wanted[static_cast<size_t>(category)] = static_cast<uint8_t>(parse_level(item.substr(equals + 1)));
+                spec = comma == std::string_view::npos ? std::string_view() : spec.substr(comma + 1);
+            }
+            for (size_t i = 0; i < CATEGORY_COUNT; ++i)
+            {
+                levels[i].store(wanted[i], std::memory_order_relaxed);
+            }
+        }
+
+        std::string_view category_name(TraceCategory category) noexcept
+        {
+            size_t index = static_cast<size_t>(category);
+            return index < CATEGORY_COUNT ? CATEGORY_NAMES[index] : "unknown";
+        }
+
+        std::string_view level_name(TraceLevel level) noexcept
+        {
+            size_t index = static_cast<size_t>(level);
+            return index < std::size(LEVEL_NAMES) ? LEVEL_NAMES[index] : "unknown";
+        }
+
+        void set_sink(AsyncLogger *logger) noexcept
+        {
+            sink.store(logger, std::memory_order_release);
+        }
+
+        void emit(TraceCategory category, TraceLevel level, std::string_view text)
+        {
+            std::string_view tag = LEVEL_TAGS[static_cast<size_t>(level) < std::size(LEVEL_TAGS) ? static_cast<size_t>(level) : 0];
+            if (AsyncLogger *logger = sink.load(std::memory_order_acquire))
+            {
+                logger->log(tag, "0.0.0.0", category_name(category), text);
+                return;
+            }
+            // Sin logger (pruebas, arranque): una sola escritura por línea para que no se mezclen.
+            thread_local std::string line;
+            line.assign("[").append(tag).append("] ").append(category_name(category)).append(" ").append(text).append("\n");
+            ssize_t ignored = ::write(STDERR_FILENO, line.data(), line.size());
+            (void)ignored;
+        }
+    }
+
+} // namespace BattleshipServer
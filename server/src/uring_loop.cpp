@@ -0,0 +1,677 @@
+#include "uring_loop.hpp"
+#include "server.hpp"
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+
+namespace BattleshipServer
+{
+    namespace
+    {
+        int io_uring_setup(unsigned entries, struct io_uring_params *params)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+        }
+
+        int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+        }
+
+        int io_uring_register(int fd, unsigned opcode, void *arg, unsigned nr_args)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+        }
+
+        template <typename T>
+        T *ring_field(void *base, uint32_t offset)
+        {
+            return reinterpret_cast<T *>(static_cast<char *>(base) + offset);
+        }
+
+        // En C++ __DECLARE_FLEX_ARRAY desplaza io_uring_buf_ring::bufs 8 bytes; se indexa a mano.
+        struct io_uring_buf &ring_buffer(struct io_uring_buf_ring *ring, unsigned index)
+        {
+            return reinterpret_cast<struct io_uring_buf *>(ring)[index];
+        }
+    } // namespace
+
+    /**
+     * @brief Multishot poll registration used by watch().
+     */
+    struct UringLoop::Watch : UringLoop::Completion
+    {
+        UringLoop &loop;
+        int fd;
+        uint32_t events;
+        EventHandler handler;
+        bool active = true;
+
+        Watch(UringLoop &l, int f, uint32_t e, EventHandler h) : loop(l), fd(f), events(e), handler(std::move(h)) {}
+
+        void complete(int res, uint32_t flags) override
+        {
+            if (active && res >= 0)
+            {
+                handler(static_cast<uint32_t>(res));
+            }
+            if (flags & IORING_CQE_F_MORE)
+                return;
+            if (!active)
+            {
+                loop.retire(this);
+            }
+            else if (res < 0 && res != -ECANCELED)
+            {
+                // Un error del poll (p. ej. -EBADF) se repetiría en cada rearme: se deja de vigilar y se avisa.
+                loop.drop(this);
+                handler(EPOLLERR);
+            }
+            else
+            {
+                // El multishot terminó sin error: se rearma.
+                loop.arm_poll(this);
+            }
+        }
+    };
+
+    /**
+     * @brief Multishot accept registration used by accept_on().
+     */
+    struct UringLoop::Acceptor : UringLoop::Completion
+    {
+        UringLoop &loop;
+        int fd;
+        AcceptHandler handler;
+        StoppedHandler stopped;
+        AcceptRetry retry;
+        bool active = true;
+
+        Acceptor(UringLoop &l, int f, AcceptHandler h) : loop(l), fd(f), handler(std::move(h)) {}
+
+        void complete(int res, uint32_t flags) override
+        {
+            // Una conexión aceptada antes de que llegue la cancelación se entrega igual: no se pierde.
+            if (res >= 0)
+            {
+                retry.succeeded();
+                handler(res);
+            }
+            if (flags & IORING_CQE_F_MORE)
+                return;
+            if (active)
+            {
+                if (!loop.running_)
+                    return;
+                if (res < 0 && res != -ECANCELED && res != -EINTR && res != -ECONNABORTED)
+                {
+                    // EMFILE, ENFILE...: la conexión sigue en la cola y un accept nuevo fallaría en el acto.
+                    loop.defer_accept(retry, -res, handler, [this]
+                                      {
+                                          if (active && loop.running_)
+                                              loop.arm_accept(this); });
+                }
+                else
+                {
+                    loop.arm_accept(this);
+                }
+            }
+            else if (stopped)
+            {
+                // Última CQE del accept cancelado: ya no llegará ninguna conexión más.
+                StoppedHandler done = std::move(stopped);
+                stopped = nullptr;
+                done();
+            }
+        }
+    };
+
+    UringLoop::UringLoop()
+    {
+        struct io_uring_params params{};
+        params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_COOP_TASKRUN;
+        params.cq_entries = RING_ENTRIES * 2;
+        ring_fd_ = io_uring_setup(RING_ENTRIES, &params);
+        if (ring_fd_ < 0 && errno == EINVAL)
+        {
+            // Kernels anteriores a 5.19 no conocen COOP_TASKRUN.
+            params = {};
+            params.flags = IORING_SETUP_CQSIZE;
+            params.cq_entries = RING_ENTRIES * 2;
+            ring_fd_ = io_uring_setup(RING_ENTRIES, &params);
+        }
+        if (ring_fd_ < 0)
+        {
+            throw ServerError("io_uring_setup failed: " + std::string(strerror(errno)));
+        }
+        if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP))
+        {
+            teardown();
+            throw ServerError("io_uring backend requires a newer kernel (single mmap and no-drop CQ)");
+        }
+
+        size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        ring_size_ = std::max(sq_size, cq_size);
+        ring_ptr_ = mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+        if (ring_ptr_ == MAP_FAILED)
+        {
+            ring_ptr_ = nullptr;
+            std::string error = strerror(errno);
+            teardown();
+            throw ServerError("io_uring ring mmap failed: " + error);
+        }
+        sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+        void *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED)
+        {
+            std::string error = strerror(errno);
+            teardown();
+            throw ServerError("io_uring SQE mmap failed: " + error);
+        }
+        sqes_ = static_cast<struct io_uring_sqe *>(sqes);
+
+        sq_head_ = ring_field<unsigned>(ring_ptr_, params.sq_off.head);
+        sq_tail_ = ring_field<unsigned>(ring_ptr_, params.sq_off.tail);
+        sq_array_ = ring_field<unsigned>(ring_ptr_, params.sq_off.array);
+        sq_mask_ = *ring_field<unsigned>(ring_ptr_, params.sq_off.ring_mask);
+        sq_entries_ = *ring_field<unsigned>(ring_ptr_, params.sq_off.ring_entries);
+        sqe_tail_ = sqe_submitted_ = *sq_tail_;
+        cq_head_ = ring_field<unsigned>(ring_ptr_, params.cq_off.head);
+        cq_tail_ = ring_field<unsigned>(ring_ptr_, params.cq_off.tail);
+        cq_mask_ = *ring_field<unsigned>(ring_ptr_, params.cq_off.ring_mask);
+        cqes_ = ring_field<struct io_uring_cqe>(ring_ptr_, params.cq_off.cqes);
+
+        // Anillo de buffers provistos: el kernel elige uno por cada recv completado.
+        buf_ring_size_ = BUFFER_COUNT * sizeof(struct io_uring_buf);
+        void *buf_ring = mmap(nullptr, buf_ring_size_, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+        if (buf_ring == MAP_FAILED)
+        {
+            std::string error = strerror(errno);
+            teardown();
+            throw ServerError("io_uring buffer ring mmap failed: " + error);
+        }
+        buf_ring_ = static_cast<struct io_uring_buf_ring *>(buf_ring);
+
+        struct io_uring_buf_reg reg{};
+        reg.ring_addr = reinterpret_cast<uint64_t>(buf_ring_);
+        reg.ring_entries = BUFFER_COUNT;
+        reg.bgid = BUFFER_GROUP;
+        if (io_uring_register(ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+        {
+            std::string error = strerror(errno);
+            teardown();
+            throw ServerError("io_uring provided buffer ring unavailable: " + error);
+        }
+
+        buffers_.resize(static_cast<size_t>(BUFFER_COUNT) * BUFFER_SIZE);
+        for (unsigned bid = 0; bid < BUFFER_COUNT; ++bid)
+        {
+            struct io_uring_buf &buf = ring_buffer(buf_ring_, (buf_tail_ + bid) & (BUFFER_COUNT - 1));
+            buf.addr = reinterpret_cast<uint64_t>(buffers_.data() + static_cast<size_t>(bid) * BUFFER_SIZE);
+            buf.len = BUFFER_SIZE;
+            buf.bid = static_cast<uint16_t>(bid);
+        }
+        buf_tail_ += BUFFER_COUNT;
+        __atomic_store_n(&buf_ring_->tail, buf_tail_, __ATOMIC_RELEASE);
+
+        watch_internal_fds();
+    }
+
+    UringLoop::~UringLoop()
+    {
+        teardown();
+    }
+
+    void UringLoop::teardown()
+    {
+        // Cerrar el anillo cancela todo lo pendiente; los objetos de completion se liberan después.
+        if (sqes_)
+        {
+            munmap(sqes_, sqes_size_);
+            sqes_ = nullptr;
+        }
+        if (ring_ptr_)
+        {
+            munmap(ring_ptr_, ring_size_);
+            ring_ptr_ = nullptr;
+        }
+        if (ring_fd_ >= 0)
+        {
+            close(ring_fd_);
+            ring_fd_ = -1;
+        }
+        if (buf_ring_)
+        {
+            munmap(buf_ring_, buf_ring_size_);
+            buf_ring_ = nullptr;
+        }
+    }
+
+    struct io_uring_sqe *UringLoop::get_sqe(Completion *target)
+    {
+        if (sqe_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_)
+        {
+            submit(0);
+            if (sqe_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_)
+            {
+                throw ServerError("io_uring submission queue is full");
+            }
+        }
+        unsigned index = sqe_tail_ & sq_mask_;
+        struct io_uring_sqe *sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->user_data = reinterpret_cast<uint64_t>(target);
+        sq_array_[index] = index;
+        ++sqe_tail_;
+        return sqe;
+    }
+
+    void UringLoop::submit(unsigned wait_nr)
+    {
+        __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+        unsigned to_submit = sqe_tail_ - sqe_submitted_;
+        if (to_submit == 0 && wait_nr == 0)
+        {
+            return;
+        }
+        int ret = io_uring_enter(ring_fd_, to_submit, wait_nr, wait_nr ? IORING_ENTER_GETEVENTS : 0);
+        if (ret < 0)
+        {
+            // EINTR/EBUSY: se reintenta en la siguiente vuelta tras vaciar la CQ.
+            if (errno == EINTR || errno == EBUSY || errno == EAGAIN)
+                return;
+            throw ServerError("io_uring_enter failed: " + std::string(strerror(errno)));
+        }
+        sqe_submitted_ += static_cast<unsigned>(ret);
+    }
+
+    void UringLoop::reap()
+    {
+        unsigned head = *cq_head_;
+        while (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE))
+        {
+            struct io_uring_cqe cqe = cqes_[head & cq_mask_];
+            ++head;
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+            if (cqe.user_data != 0)
+            {
+                reinterpret_cast<Completion *>(cqe.user_data)->complete(cqe.res, cqe.flags);
+            }
+        }
+    }
+
+    void UringLoop::run()
+    {
+        loop_thread_ = std::this_thread::get_id();
+        running_ = true;
+
+        while (running_)
+        {
+            rearm_timer();
+            // Un único io_uring_enter entrega todo lo preparado en la vuelta anterior y espera.
+            submit(1);
+            reap();
+            if (buffers_recycled_)
+            {
+                buffers_recycled_ = false;
+                resume_starved();
+            }
+            retired_watches_.clear();
+            retired_connections_.clear();
+        }
+    }
+
+    void UringLoop::watch(int fd, uint32_t events, EventHandler handler)
+    {
+        auto entry = std::make_unique<Watch>(*this, fd, events | EPOLLET, std::move(handler));
+        arm_poll(entry.get());
+        watches_[fd] = std::move(entry);
+    }
+
+    void UringLoop::unwatch(int fd)
+    {
+        auto it = watches_.find(fd);
+        if (it == watches_.end())
+        {
+            return;
+        }
+        Watch *entry = it->second.get();
+        entry->active = false;
+        struct io_uring_sqe *sqe = get_sqe(nullptr);
+        sqe->opcode = IORING_OP_POLL_REMOVE;
+        sqe->fd = -1;
+        sqe->addr = reinterpret_cast<uint64_t>(entry);
+        // El registro vive hasta que llegue su última CQE.
+        cancelled_[entry] = std::move(it->second);
+        watches_.erase(it);
+    }
+
+    void UringLoop::arm_poll(Watch *watch)
+    {
+        struct io_uring_sqe *sqe = get_sqe(watch);
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->fd = watch->fd;
+        sqe->poll32_events = watch->events;
+        sqe->len = IORING_POLL_ADD_MULTI;
+    }
+
+    void UringLoop::retire(Watch *watch)
+    {
+        auto it = cancelled_.find(watch);
+        if (it != cancelled_.end())
+        {
+            retired_watches_.push_back(std::move(it->second));
+            cancelled_.erase(it);
+        }
+    }
+
+    void UringLoop::drop(Watch *watch)
+    {
+        auto it = watches_.find(watch->fd);
+        if (it != watches_.end() && it->second.get() == watch)
+        {
+            watch->active = false;
+            retired_watches_.push_back(std::move(it->second));
+            watches_.erase(it);
+        }
+    }
+
+    void UringLoop::accept_on(int listen_fd, AcceptHandler handler)
+    {
+        acceptors_.push_back(std::make_unique<Acceptor>(*this, listen_fd, std::move(handler)));
+        arm_accept(acceptors_.back().get());
+    }
+
+    void UringLoop::arm_accept(Acceptor *acceptor)
+    {
+        struct io_uring_sqe *sqe = get_sqe(acceptor);
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->fd = acceptor->fd;
+        sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+        sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    }
+
+    void UringLoop::stop_accepting(int listen_fd, StoppedHandler stopped)
+    {
+        for (auto &acceptor : acceptors_)
+        {
+            if (acceptor->fd != listen_fd || !acceptor->active)
+                continue;
+            acceptor->active = false;
+            if (acceptor->retry.timer != 0)
+            {
+                // Esperaba para reintentar tras un error: no hay accept en vuelo que cancelar.
+                cancel_timer(acceptor->retry.timer);
+                acceptor->retry.timer = 0;
+                continue;
+            }
+            acceptor->stopped = std::move(stopped);
+            stopped = nullptr;
+            // El Acceptor sigue en acceptors_: puede llegar todavía alguna CQE suya.
+            struct io_uring_sqe *sqe = get_sqe(nullptr);
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = -1;
+            sqe->addr = reinterpret_cast<uint64_t>(static_cast<Completion *>(acceptor.get()));
+        }
+        // Ningún accept activo en ese socket: no hay nada que esperar.
+        if (stopped)
+            stopped();
+    }
+
+    std::shared_ptr<Connection> UringLoop::make_connection(int fd)
+    {
+        return std::make_shared<UringConnection>(*this, fd);
+    }
+
+    void UringLoop::prepare_recv(int fd, Completion *target)
+    {
+        struct io_uring_sqe *sqe = get_sqe(target);
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = fd;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = BUFFER_GROUP;
+    }
+
+    void UringLoop::prepare_send(int fd, const char *data, size_t size, Completion *target)
+    {
+        struct io_uring_sqe *sqe = get_sqe(target);
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(data);
+        sqe->len = static_cast<uint32_t>(size);
+        sqe->msg_flags = MSG_NOSIGNAL;
+    }
+
+    void UringLoop::prepare_cancel(Completion *target)
+    {
+        struct io_uring_sqe *sqe = get_sqe(nullptr);
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = reinterpret_cast<uint64_t>(target);
+    }
+
+    const char *UringLoop::selected_buffer(uint32_t flags) const
+    {
+        size_t bid = flags >> IORING_CQE_BUFFER_SHIFT;
+        return buffers_.data() + bid * BUFFER_SIZE;
+    }
+
+    void UringLoop::recycle_buffer(uint32_t flags)
+    {
+        uint16_t bid = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+        struct io_uring_buf &buf = ring_buffer(buf_ring_, buf_tail_ & (BUFFER_COUNT - 1));
+        buf.addr = reinterpret_cast<uint64_t>(buffers_.data() + static_cast<size_t>(bid) * BUFFER_SIZE);
+        buf.len = BUFFER_SIZE;
+        buf.bid = bid;
+        ++buf_tail_;
+        __atomic_store_n(&buf_ring_->tail, buf_tail_, __ATOMIC_RELEASE);
+        buffers_recycled_ = true;
+    }
+
+    void UringLoop::wait_for_buffers(const std::shared_ptr<UringConnection> &connection)
+    {
+        starved_.push_back(connection);
+        // Si los buffers volvieron al anillo antes de que llegara el ENOBUFS puede no reciclarse ninguno más: respaldo con timer.
+        if (starved_retry_ == 0)
+        {
+            starved_retry_ = run_after(BUFFER_RETRY, [this]
+                                       {
+                                           starved_retry_ = 0;
+                                           resume_starved(); });
+        }
+    }
+
+    void UringLoop::resume_starved()
+    {
+        if (starved_.empty())
+        {
+            return;
+        }
+        if (starved_retry_ != 0)
+        {
+            cancel_timer(starved_retry_);
+            starved_retry_ = 0;
+        }
+        std::vector<std::weak_ptr<UringConnection>> starved;
+        starved.swap(starved_);
+        for (auto &weak : starved)
+        {
+            if (auto connection = weak.lock())
+                connection->resume_recv();
+        }
+    }
+
+    void UringLoop::retain(std::shared_ptr<UringConnection> connection)
+    {
+        UringConnection *key = connection.get();
+        connections_[key] = std::move(connection);
+    }
+
+    void UringLoop::release(UringConnection *connection)
+    {
+        auto it = connections_.find(connection);
+        if (it != connections_.end())
+        {
+            // Puede estar ejecutándose un método de la conexión: se destruye al terminar el lote.
+            retired_connections_.push_back(std::move(it->second));
+            connections_.erase(it);
+        }
+    }
+
+    UringConnection::UringConnection(UringLoop &loop, int fd)
+        : Connection(fd), loop_(loop),
+          recv_request_(this, &UringConnection::on_recv),
+          send_request_(this, &UringConnection::on_send) {}
+
+    void UringConnection::start()
+    {
+        loop_.retain(std::static_pointer_cast<UringConnection>(shared_from_this()));
+        loop_.prepare_recv(fd_, &recv_request_);
+        recv_armed_ = true;
+    }
+
+    void UringConnection::send(std::string_view data)
+    {
+        if (fd_ < 0 || closing_)
+        {
+            return;
+        }
+        output_.append(data.data(), data.size());
+        flush();
+    }
+
+    void UringConnection::close()
+    {
+        if (fd_ < 0)
+        {
+            return;
+        }
+        closing_ = true;
+        if (!send_in_flight_ && output_.empty())
+        {
+            shutdown("Closed");
+        }
+    }
+
+    void UringConnection::flush()
+    {
+        if (send_in_flight_ || fd_ < 0 || output_.empty())
+        {
+            return;
+        }
+        // Todo lo acumulado mientras había un envío en curso sale en una sola petición.
+        sending_.swap(output_);
+        output_.clear();
+        sending_offset_ = 0;
+        loop_.prepare_send(fd_, sending_.data(), sending_.size(), &send_request_);
+        send_in_flight_ = true;
+    }
+
+    void UringConnection::on_recv(int res, uint32_t flags)
+    {
+        if (!(flags & IORING_CQE_F_MORE))
+        {
+            recv_armed_ = false;
+        }
+        if (res > 0)
+        {
+            deliver(loop_.selected_buffer(flags), static_cast<size_t>(res));
+            loop_.recycle_buffer(flags);
+            if (!recv_armed_ && fd_ >= 0)
+            {
+                loop_.prepare_recv(fd_, &recv_request_);
+                recv_armed_ = true;
+            }
+        }
+        else if (res == 0)
+        {
+            shutdown("Client disconnected");
+        }
+        else if (res == -ENOBUFS && fd_ >= 0)
+        {
+            // Sin buffers libres el multishot se detiene; la conexión espera a que se reciclen para rearmarlo.
+            if (!recv_armed_)
+            {
+                loop_.wait_for_buffers(std::static_pointer_cast<UringConnection>(shared_from_this()));
+            }
+        }
+        else if (res != -ECANCELED)
+        {
+            shutdown("Receive failed: " + std::string(strerror(-res)));
+        }
+        release_if_idle();
+    }
+
+    void UringConnection::resume_recv()
+    {
+        if (recv_armed_ || fd_ < 0)
+        {
+            return;
+        }
+        loop_.prepare_recv(fd_, &recv_request_);
+        recv_armed_ = true;
+    }
+
+    void UringConnection::on_send(int res, uint32_t)
+    {
+        send_in_flight_ = false;
+        if (fd_ < 0)
+        {
+            release_if_idle();
+            return;
+        }
+        if (res < 0)
+        {
+            shutdown("Send failed: " + std::string(strerror(-res)));
+            release_if_idle();
+            return;
+        }
+
+        sending_offset_ += static_cast<size_t>(res);
+        if (sending_offset_ < sending_.size())
+        {
+            // Envío parcial: se completa el resto antes de lo que se haya acumulado.
+            loop_.prepare_send(fd_, sending_.data() + sending_offset_, sending_.size() - sending_offset_, &send_request_);
+            send_in_flight_ = true;
+            return;
+        }
+        sending_.clear();
+        flush();
+        if (closing_ && !send_in_flight_)
+        {
+            shutdown("Closed");
+        }
+        release_if_idle();
+    }
+
+    void UringConnection::shutdown(const std::string &reason)
+    {
+        if (fd_ < 0)
+        {
+            return;
+        }
+        if (recv_armed_)
+        {
+            loop_.prepare_cancel(&recv_request_);
+        }
+        ::close(fd_);
+        fd_ = -1;
+        output_.clear();
+        notify_closed(reason);
+        release_if_idle();
+    }
+
+    void UringConnection::release_if_idle()
+    {
+        if (fd_ < 0 && !recv_armed_ && !send_in_flight_)
+        {
+            loop_.release(this);
+        }
+    }
+
+} // namespace BattleshipServer
@@ -0,0 +1,191 @@
+#include "worker_pool.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+namespace BattleshipServer
+{
+    namespace
+    {
+        // Posición del worker que ejecuta el hilo actual en su pool (nullptr fuera de los workers).
+        thread_local const WorkerPool *current_pool = nullptr;
+        thread_local size_t current_index = 0;
+
+        void run_task(WorkerPool::Task &task)
+        {
+            try
+            {
+                task();
+            }
+            catch (const std::exception &e)
+            {
+                // Va al log como cualquier error de sesión: nunca se escribe desde el worker directamente.
+                BATTLESHIP_TRACE(SESSION, ERROR, "Uncaught exception in worker task: ", e.what());
+            }
+        }
+    }
+
+    WorkerPool::WorkerPool(unsigned workers)
+    {
+        if (workers == 0)
+        {
+            workers = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned i = 0; i < workers; ++i)
+        {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+        // Los hilos arrancan cuando todas las colas existen: pueden robar desde el primer momento.
+        for (size_t i = 0; i < workers_.size(); ++i)
+        {
+            workers_[i]->thread = std::thread([this, i]
+                                              { worker_loop(i); });
+        }
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        stop();
+    }
+
+    void WorkerPool::submit(Task task)
+    {
+        size_t index = current_pool == this ? current_index
+                                            : next_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+        {
+            std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+            workers_[index]->tasks.push_back(std::move(task));
+        }
+        pending_.fetch_add(1);
+        if (sleeping_.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            wake_.notify_one();
+        }
+    }
+
+    void WorkerPool::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            if (stopping_.exchange(true))
+            {
+                return;
+            }
+        }
+        wake_.notify_all();
+        for (auto &worker : workers_)
+        {
+            if (worker->thread.joinable())
+            {
+                worker->thread.join();
+            }
+        }
+    }
+
+    void WorkerPool::worker_loop(size_t index)
+    {
+        current_pool = this;
+        current_index = index;
+        Task task;
+        while (!stopping_.load(std::memory_order_relaxed))
+        {
+            if (pop_local(index, task) || steal(index, task))
+            {
+                pending_.fetch_sub(1);
+                run_task(task);
+                task = nullptr;
+                continue;
+            }
+
+            // sleeping_ se publica antes de releer pending_; submit() lo hace al revés, así que uno de los dos ve al otro,
+            // y su notify_one() toma sleep_mutex_, que este worker suelta solo al dormirse: el aviso no se pierde.
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            sleeping_.fetch_add(1);
+            // Sin plazo real: wait() sin tiempo es un símbolo de GLIBCXX_3.4.30 (GCC 12) que falta en las libstdc++
+            // anteriores con las que también se enlazan las pruebas; wait_until() se resuelve en la cabecera.
+            wake_.wait_until(lock, std::chrono::steady_clock::time_point::max(), [this]
+                             { return pending_.load() != 0 || stopping_.load(); });
+            sleeping_.fetch_sub(1);
+        }
+    }
+
+    bool WorkerPool::pop_local(size_t index, Task &task)
+    {
+        Worker &worker = *workers_[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty())
+        {
+            return false;
+        }
+        task = std::move(worker.tasks.back());
+        worker.tasks.pop_back();
+        return true;
+    }
+
+    bool WorkerPool::steal(size_t index, Task &task)
+    {
+        for (size_t offset = 1; offset < workers_.size(); ++offset)
+        {
+            Worker &victim = *workers_[(index + offset) % workers_.size()];
+            std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+            // Una cola ocupada se salta en lugar de esperar: la siguiente vuelta la vuelve a intentar.
+            if (!lock.owns_lock() || victim.tasks.empty())
+            {
+                continue;
+            }
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void Strand::post(WorkerPool::Task task)
+    {
+        bool schedule = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(task));
+            if (!scheduled_)
+            {
+                scheduled_ = schedule = true;
+            }
+        }
+        if (schedule)
+        {
+            pool_.submit([self = shared_from_this()]
+                         { self->run(); });
+        }
+    }
+
+    void Strand::run()
+    {
+        WorkerPool::Task task;
+        for (size_t done = 0;; ++done)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (queue_.empty())
+                {
+                    scheduled_ = false;
+                    return;
+                }
+                if (done == BATCH)
+                {
+                    break;
+                }
+                task = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            run_task(task);
+            task = nullptr;
+        }
+        // Quedan tareas: se cede el worker y la strand vuelve a la cola, sigue marcada como programada.
+        pool_.submit([self = shared_from_this()]
+                     { self->run(); });
+    }
+
+} // namespace BattleshipServer
@@ -0,0 +1,86 @@
+#!/bin/bash
+# Deja al servidor sin descriptores (ulimit -n bajo) con más conexiones ociosas de las que
+# puede aceptar, de modo que cada accept falla con EMFILE mientras la cola sigue llena.
+# Falla si el servidor gira reintentando (CPU o líneas "Accept failed" de más) o si, cuando
+# se liberan los descriptores, no vuelve a aceptar y jugar partidas.
+# Uso: accept_exhaustion.sh <server> <bsload> [opciones del servidor, p. ej. --backend io_uring]
+set -u
+SERVER=$1
+BSLOAD=$2
+shift 2
+OPTIONS=("$@")
+DIR=$(mktemp -d)
+PORT=$((20000 + RANDOM % 20000))
+PID=
+
+cleanup()
+{
+    [ -n "$PID" ] && kill -KILL "$PID" 2>/dev/null
+    rm -rf "$DIR"
+}
+trap cleanup EXIT
+
+fail()
+{
+    echo "FAIL: $*"
+    for log in "$DIR"/*.log "$DIR"/*.txt; do
+        [ -f "$log" ] && { echo "--- $log"; tail -n 20 "$log"; }
+    done
+    exit 1
+}
+
+# Ticks de CPU (usuario + sistema) consumidos por el servidor.
+cpu_ticks()
+{
+    awk '{ print $14 + $15 }' "/proc/$PID/stat"
+}
+
+(
+    ulimit -n 40
+    exec "$SERVER" 127.0.0.1 "$PORT" "$DIR/server.log" --loops 2 --workers 2 --stats-interval 0 --journal none \
+        --admin-socket "$DIR/admin.sock" "${OPTIONS[@]}" > "$DIR/server.txt" 2>&1
+) &
+PID=$!
+for _ in $(seq 50); do
+    [ -S "$DIR/admin.sock" ] && break
+    sleep 0.1
+done
+[ -S "$DIR/admin.sock" ] || fail "server did not start"
+
+# Conexiones que no envían nada: ocupan todos los descriptores y el resto queda en la cola.
+CLIENTS=()
+for _ in $(seq 60); do
+    exec {fd}<>"/dev/tcp/127.0.0.1/$PORT" || fail "connect refused"
+    CLIENTS+=("$fd")
+done
+sleep 0.5
+grep -q "Accept failed" "$DIR/server.log" || fail "accepts never failed; raise the number of idle clients"
+
+BEFORE=$(cpu_ticks)
+FAILURES=$(grep -c "Accept failed" "$DIR/server.log")
+sleep 2
+TICKS=$(($(cpu_ticks) - BEFORE))
+FAILURES=$(($(grep -c "Accept failed" "$DIR/server.log") - FAILURES))
+# Un núcleo girando suma unos 200 ticks en 2 s; los reintentos con espera apenas se notan.
+[ "$TICKS" -le 20 ] || fail "server used $TICKS CPU ticks in 2 s while out of descriptors"
+[ "$FAILURES" -le 10 ] || fail "server logged $FAILURES accept failures in 2 s"
+
+for fd in "${CLIENTS[@]}"; do
+    exec {fd}>&-
+done
+
+# Con los descriptores libres el reintento vuelve a aceptar y se juegan partidas. Algún jugador
+# de bsload puede quedar emparejado con un cliente ocioso ya cerrado: esas desconexiones se toleran.
+"$BSLOAD" 127.0.0.1 "$PORT" --connections 10 --threads 1 --duration 3 > "$DIR/bsload.txt" 2>&1 || fail "bsload exited with status $?"
+MATCHES=$(awk '/^matches:/ { print $2 }' "$DIR/bsload.txt")
+[ "${MATCHES:-0}" -gt 0 ] || fail "no match was played after the descriptors were freed"
+
+kill -TERM "$PID"
+for _ in $(seq 100); do
+    kill -0 "$PID" 2>/dev/null || break
+    sleep 0.1
+done
+kill -0 "$PID" 2>/dev/null && fail "server did not exit"
+wait "$PID" || fail "server exited with status $?"
+PID=
+echo "out of descriptors: $TICKS CPU ticks and $FAILURES accept failures in 2 s; $MATCHES matches afterwards"
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include "../include/async_logger.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace BattleshipServer
+{
+    class AsyncLoggerTest : public ::testing::Test
+    {
+    protected:
+        char path[32] = "/tmp/async_logger_XXXXXX";
+        int fd = -1;
+
+        void SetUp() override
+        {
+            fd = mkstemp(path);
+            ASSERT_GE(fd, 0);
+        }
+
+        void TearDown() override
+        {
+            std::remove(path);
+        }
+
+        std::vector<std::string> read_lines()
+        {
+            std::string content;
+            int in = ::open(path, O_RDONLY);
+            char buffer[4096];
+            ssize_t n;
+            while ((n = ::read(in, buffer, sizeof(buffer))) > 0)
+            {
+                content.append(buffer, static_cast<size_t>(n));
+            }
+            ::close(in);
+            std::vector<std::string> lines;
+            std::istringstream stream(content);
+            for (std::string line; std::getline(stream, line);)
+            {
+                lines.push_back(line);
+            }
+            return lines;
+        }
+
+        static LoggerOptions quiet(size_t buffer_bytes = 64 * 1024)
+        {
+            LoggerOptions options;
+            options.echo_stdout = false;
+            options.flush_interval = std::chrono::milliseconds(10);
+            options.buffer_bytes = buffer_bytes;
+            return options;
+        }
+    };
+
+    TEST_F(AsyncLoggerTest, FormatsLinesLikeTheServerLog)
+    {
+        AsyncLogger logger(fd, quiet());
+        logger.log("INFO", "10.0.0.1", "SHOOT|A1", "Shot processed");
+        logger.flush();
+
+        auto lines = read_lines();
+        ASSERT_EQ(lines.size(), 1u);
+        EXPECT_EQ(lines[0].rfind("[INFO] ", 0), 0u);
+        // "[INFO] " + "YYYY-mm-dd HH:MM:SS" + " "
+        EXPECT_EQ(lines[0].substr(27), "10.0.0.1 SHOOT|A1 Shot processed");
+        EXPECT_EQ(logger.written(), 1u);
+    }
+
+    TEST_F(AsyncLoggerTest, KeepsPerThreadOrderAcrossProducers)
+    {
+        constexpr int THREADS = 4;
+        constexpr int LINES = 2000;
+        {
+            AsyncLogger logger(fd, quiet());
+            std::vector<std::thread> producers;
+            for (int t = 0; t < THREADS; ++t)
+            {
+                producers.emplace_back([&, t]
+                                       {
+                    for (int i = 0; i < LINES; ++i)
+                    {
+                        logger.write(std::to_string(t) + " " + std::to_string(i));
+                    } });
+            }
+            for (auto &producer : producers)
+            {
+                producer.join();
+            }
+            logger.flush();
+            EXPECT_EQ(logger.dropped(), 0u);
+        }
+
+        std::vector<int> next(THREADS, 0);
+        auto lines = read_lines();
+        ASSERT_EQ(lines.size(), static_cast<size_t>(THREADS * LINES));
+        for (const auto &line : lines)
+        {
+            int thread = std::stoi(line.substr(0, line.find(' ')));
+            int index = std::stoi(line.substr(line.find(' ') + 1));
+            EXPECT_EQ(index, next[thread]++) << line;
+        }
+    }
+
+    TEST_F(AsyncLoggerTest, DropsAndReportsWhenTheQueueIsFull)
+    {
+        LoggerOptions options = quiet(4096);
+        options.flush_interval = std::chrono::hours(1);
+        AsyncLogger logger(fd, options);
+        std::string line(1000, 'x');
+        // 4 líneas de 1001 bytes caben en 4096; la quinta no.
+        for (int i = 0; i < 5; ++i)
+        {
+            logger.write(line);
+        }
+        EXPECT_EQ(logger.dropped(), 1u);
+        logger.flush();
+
+        auto lines = read_lines();
+        ASSERT_EQ(lines.size(), 5u);
+        EXPECT_EQ(lines.back(), "[WARN] Logger dropped 1 lines (queue full)");
+    }
+
+    TEST_F(AsyncLoggerTest, AppendsBinaryRecordsWithoutDropReports)
+    {
+        LoggerOptions options = quiet(4096);
+        options.report_drops = false;
+        options.flush_interval = std::chrono::hours(1);
+        std::string record("\x05\x00\n\x01", 4);
+        {
+            AsyncLogger logger(fd, options);
+            logger.append(record);
+            logger.append(std::string(4096, 'x'));
+            logger.append(record);
+            EXPECT_EQ(logger.dropped(), 1u);
+        }
+
+        int in = ::open(path, O_RDONLY);
+        char buffer[64];
+        ssize_t n = ::read(in, buffer, sizeof(buffer));
+        ::close(in);
+        EXPECT_EQ(std::string(buffer, static_cast<size_t>(n)), record + record);
+    }
+
+    TEST_F(AsyncLoggerTest, DestructorWritesPendingLines)
+    {
+        {
+            LoggerOptions options = quiet();
+            options.flush_interval = std::chrono::hours(1);
+            AsyncLogger logger(fd, options);
+            logger.write("last words");
+        }
+        auto lines = read_lines();
+        ASSERT_EQ(lines.size(), 1u);
+        EXPECT_EQ(lines[0], "last words");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include "../include/flow.hpp"
+#include <coroutine>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace BattleshipServer
+{
+    namespace
+    {
+        // Buzón mínimo: la corrutina espera un valor y el test se lo entrega desde fuera.
+        struct Mailbox
+        {
+            std::coroutine_handle<> waiter;
+            int value = 0;
+
+            struct Awaiter
+            {
+                Mailbox &box;
+                bool await_ready() const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<> flow) noexcept { box.waiter = flow; }
+                int await_resume() const noexcept { return box.value; }
+            };
+
+            Awaiter receive() { return Awaiter{*this}; }
+
+            void deliver(int v)
+            {
+                value = v;
+                auto flow = waiter;
+                waiter = {};
+                flow.resume();
+            }
+        };
+
+        // Cuenta las destrucciones para comprobar que el marco suspendido se libera.
+        struct Sentinel
+        {
+            int &destroyed;
+            ~Sentinel() { ++destroyed; }
+        };
+
+        Flow collect(Mailbox &box, std::vector<int> &seen, int count)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                seen.push_back(co_await box.receive());
+            }
+        }
+
+        Flow phases(Mailbox &box, std::vector<int> &seen)
+        {
+            seen.push_back(-1);
+            co_await collect(box, seen, 2);
+            seen.push_back(-2);
+            co_await collect(box, seen, 1);
+            seen.push_back(-3);
+        }
+
+        Flow failing(Mailbox &box)
+        {
+            int value = co_await box.receive();
+            throw std::runtime_error("bad value " + std::to_string(value));
+        }
+
+        Flow outer_of_failing(Mailbox &box, std::string &caught)
+        {
+            try
+            {
+                co_await failing(box);
+            }
+            catch (const std::runtime_error &e)
+            {
+                caught = e.what();
+            }
+        }
+
+        Flow parked(Mailbox &box, int &destroyed)
+        {
+            Sentinel sentinel{destroyed};
+            co_await box.receive();
+        }
+
+        Flow nested_parked(Mailbox &box, int &destroyed)
+        {
+            Sentinel sentinel{destroyed};
+            co_await parked(box, destroyed);
+        }
+    }
+
+    TEST(FlowTest, DoesNotRunUntilStarted)
+    {
+        Mailbox box;
+        std::vector<int> seen;
+        Flow flow = phases(box, seen);
+        EXPECT_TRUE(seen.empty());
+        flow.start();
+        EXPECT_EQ(seen, (std::vector<int>{-1}));
+        EXPECT_FALSE(flow.done());
+    }
+
+    TEST(FlowTest, NestedFlowsResumeInOrder)
+    {
+        Mailbox box;
+        std::vector<int> seen;
+        Flow flow = phases(box, seen);
+        flow.start();
+        box.deliver(10);
+        box.deliver(20);
+        EXPECT_EQ(seen, (std::vector<int>{-1, 10, 20, -2}));
+        box.deliver(30);
+        EXPECT_EQ(seen, (std::vector<int>{-1, 10, 20, -2, 30, -3}));
+        EXPECT_TRUE(flow.done());
+        EXPECT_FALSE(box.waiter);
+    }
+
+    TEST(FlowTest, ExceptionReachesTheAwaitingFlow)
+    {
+        Mailbox box;
+        std::string caught;
+        Flow flow = outer_of_failing(box, caught);
+        flow.start();
+        box.deliver(7);
+        EXPECT_EQ(caught, "bad value 7");
+        EXPECT_TRUE(flow.done());
+        EXPECT_NO_THROW(flow.rethrow());
+    }
+
+    TEST(FlowTest, UncaughtExceptionIsRethrownToTheResumer)
+    {
+        Mailbox box;
+        Flow flow = failing(box);
+        flow.start();
+        box.deliver(3);
+        EXPECT_TRUE(flow.done());
+        EXPECT_THROW(flow.rethrow(), std::runtime_error);
+    }
+
+    TEST(FlowTest, DestroyingASuspendedFlowReleasesEveryFrame)
+    {
+        Mailbox box;
+        int destroyed = 0;
+        {
+            Flow flow = nested_parked(box, destroyed);
+            flow.start();
+            EXPECT_EQ(destroyed, 0);
+        }
+        EXPECT_EQ(destroyed, 2);
+    }
+
+    TEST(FlowTest, MoveTransfersOwnership)
+    {
+        Mailbox box;
+        int destroyed = 0;
+        Flow first = parked(box, destroyed);
+        first.start();
+        Flow second = std::move(first);
+        EXPECT_TRUE(first.done());
+        EXPECT_FALSE(second.done());
+        second = Flow();
+        EXPECT_EQ(destroyed, 1);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include "../include/hdr_histogram.hpp"
+#include <cstdint>
+#include <memory>
+
+namespace BattleshipServer
+{
+    TEST(HdrHistogramTest, SmallValuesAreExact)
+    {
+        for (uint64_t value = 0; value < 128; ++value)
+        {
+            size_t index = HdrHistogram::index_of(value);
+            EXPECT_EQ(HdrHistogram::lowest_equivalent(index), value);
+            EXPECT_EQ(HdrHistogram::highest_equivalent(index), value);
+        }
+    }
+
+    TEST(HdrHistogramTest, RelativeErrorBelowOneSixtyFourth)
+    {
+        for (uint64_t value = 128; value < HdrHistogram::MAX_VALUE; value = value * 3 / 2 + 7)
+        {
+            size_t index = HdrHistogram::index_of(value);
+            ASSERT_LT(index, HdrHistogram::COUNTS);
+            uint64_t low = HdrHistogram::lowest_equivalent(index);
+            uint64_t high = HdrHistogram::highest_equivalent(index);
+            EXPECT_LE(low, value);
+            EXPECT_GE(high, value);
+            EXPECT_LT(high - low, value / 64 + 1);
+        }
+        EXPECT_EQ(HdrHistogram::index_of(HdrHistogram::MAX_VALUE), HdrHistogram::COUNTS - 1);
+    }
+
+    TEST(HdrHistogramTest, PercentilesUpToP999)
+    {
+        auto histogram = std::make_unique<HdrHistogram>();
+        // 1..1000 us: el percentil p corresponde a la muestra p * 10 us.
+        for (uint64_t us = 1; us <= 1000; ++us)
+        {
+            histogram->record(us * 1000);
+        }
+        EXPECT_EQ(histogram->count(), 1000u);
+        EXPECT_EQ(histogram->max(), 1000000u);
+        EXPECT_DOUBLE_EQ(histogram->mean(), 500500.0);
+
+        auto near = [](uint64_t value, uint64_t expected)
+        {
+            return value >= expected && value - expected <= expected / 64;
+        };
+        EXPECT_TRUE(near(histogram->value_at_percentile(50), 500000));
+        EXPECT_TRUE(near(histogram->value_at_percentile(99), 990000));
+        EXPECT_TRUE(near(histogram->value_at_percentile(99.9), 999000));
+        EXPECT_EQ(histogram->value_at_percentile(100), 1000000u);
+        EXPECT_EQ(histogram->value_at_percentile(0), HdrHistogram::highest_equivalent(HdrHistogram::index_of(1000)));
+    }
+
+    TEST(HdrHistogramTest, MergeAddsEverySample)
+    {
+        auto first = std::make_unique<HdrHistogram>();
+        auto second = std::make_unique<HdrHistogram>();
+        auto merged = std::make_unique<HdrHistogram>();
+        first->record(10);
+        first->record(2000);
+        second->record(10);
+        second->record(90000);
+        first->merge_into(*merged);
+        second->merge_into(*merged);
+
+        EXPECT_EQ(merged->count(), 4u);
+        EXPECT_EQ(merged->sum(), 10u + 2000u + 10u + 90000u);
+        EXPECT_EQ(merged->max(), 90000u);
+        EXPECT_EQ(merged->count_at_or_below(10), 2u);
+        EXPECT_EQ(merged->count_at_or_below(50000), 3u);
+
+        merged->reset();
+        EXPECT_EQ(merged->count(), 0u);
+        EXPECT_EQ(merged->value_at_percentile(99.9), 0u);
+    }
+
+    TEST(HdrHistogramTest, ClampsLargeValues)
+    {
+        auto histogram = std::make_unique<HdrHistogram>();
+        histogram->record(UINT64_MAX);
+        EXPECT_EQ(histogram->max(), HdrHistogram::MAX_VALUE);
+        EXPECT_EQ(histogram->count_at_or_below(UINT64_MAX), 1u);
+        EXPECT_EQ(histogram->value_at_percentile(50), HdrHistogram::MAX_VALUE);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "../include/metrics.hpp"
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace BattleshipServer
+{
+    using BattleShipProtocol::MessageType;
+    using Phase = BattleShipProtocol::PhaseState::Phase;
+
+    TEST(MetricsTest, CountersSumEveryThread)
+    {
+        Metrics metrics;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&metrics]
+                                 {
+                                     for (int i = 0; i < 1000; ++i)
+                                     {
+                                         metrics.add(Counter::TURN_TIMEOUTS);
+                                         metrics.message_in(MessageType::SHOOT, 9);
+                                     } });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        metrics.add(Counter::DISCONNECTS, 3);
+
+        EXPECT_EQ(metrics.counter(Counter::TURN_TIMEOUTS), 4000u);
+        EXPECT_EQ(metrics.counter(Counter::DISCONNECTS), 3u);
+        EXPECT_EQ(metrics.counter(Counter::PARSE_ERRORS), 0u);
+        auto [shots, bytes] = metrics.messages(MessageType::SHOOT, true);
+        EXPECT_EQ(shots, 4000u);
+        EXPECT_EQ(bytes, 36000u);
+        EXPECT_EQ(metrics.messages(MessageType::SHOOT, false).first, 0u);
+    }
+
+    TEST(MetricsTest, PhaseGaugeBalancesAcrossThreads)
+    {
+        Metrics metrics;
+        metrics.enter_phase(Phase::REGISTRATION);
+        metrics.enter_phase(Phase::REGISTRATION);
+        // La sesión cambia de fase en un worker distinto del hilo que la creó.
+        std::thread worker([&metrics]
+                           {
+                               metrics.leave_phase(Phase::REGISTRATION);
+                               metrics.enter_phase(Phase::PLAYING); });
+        worker.join();
+
+        EXPECT_EQ(metrics.sessions_in(Phase::REGISTRATION), 1);
+        EXPECT_EQ(metrics.sessions_in(Phase::PLAYING), 1);
+        EXPECT_EQ(metrics.sessions_in(Phase::FINISHED), 0);
+    }
+
+    TEST(MetricsTest, HistogramsMergeEveryThread)
+    {
+        Metrics metrics;
+        metrics.observe(Stage::PARSE, std::chrono::nanoseconds(800));
+        metrics.observe(Stage::PARSE, std::chrono::microseconds(3));
+        std::thread worker([&metrics]
+                           {
+                               metrics.observe(Stage::PARSE, std::chrono::seconds(5));
+                               metrics.observe(Stage::TURN, std::chrono::microseconds(40)); });
+        worker.join();
+
+        HdrHistogram parse;
+        metrics.histogram(Stage::PARSE, parse);
+        EXPECT_EQ(parse.count(), 3u);
+        EXPECT_EQ(parse.sum(), 800u + 3000u + 5000000000u);
+        EXPECT_EQ(parse.max(), 5000000000u);
+        EXPECT_EQ(parse.count_at_or_below(1000), 1u);
+        EXPECT_EQ(parse.count_at_or_below(5000), 2u);
+
+        HdrHistogram send;
+        metrics.histogram(Stage::SEND, send);
+        EXPECT_EQ(send.count(), 0u);
+        EXPECT_NE(metrics.latency_summary(Stage::TURN).find("count=1 "), std::string::npos);
+        EXPECT_EQ(Metrics::stage_name(Stage::PROCESS_SHOT), "process_shot");
+    }
+
+    TEST(MetricsTest, RendersPrometheusText)
+    {
+        Metrics metrics;
+        metrics.add(Counter::SESSIONS_STARTED, 2);
+        metrics.enter_phase(Phase::PLACEMENT);
+        metrics.message_out(MessageType::STATUS_DELTA, 40);
+        metrics.observe(Stage::GAME_LOGIC, std::chrono::microseconds(15));
+
+        std::string text;
+        Metrics::render_gauge(text, "battleship_sessions_active", "Sessions.", 7);
+        metrics.render(text);
+
+        EXPECT_NE(text.find("# TYPE battleship_sessions_active gauge\nbattleship_sessions_active 7\n"), std::string::npos);
+        EXPECT_NE(text.find("# TYPE battleship_sessions_started_total counter\nbattleship_sessions_started_total 2\n"), std::string::npos);
+        EXPECT_NE(text.find("battleship_sessions_by_phase{phase=\"placement\"} 1\n"), std::string::npos);
+        EXPECT_NE(text.find("battleship_bytes_sent_total{type=\"STATUS_DELTA\"} 40\n"), std::string::npos);
+        EXPECT_NE(text.find("battleship_messages_received_total{type=\"RESYNC\"} 0\n"), std::string::npos);
+        // Cubos acumulativos: la muestra de 15 us aparece desde el límite de 20 us en adelante.
+        EXPECT_NE(text.find("battleship_stage_duration_seconds_bucket{stage=\"game_logic\",le=\"1e-05\"} 0\n"), std::string::npos);
+        EXPECT_NE(text.find("battleship_stage_duration_seconds_bucket{stage=\"game_logic\",le=\"2e-05\"} 1\n"), std::string::npos);
+        EXPECT_NE(text.find("battleship_stage_duration_seconds_bucket{stage=\"game_logic\",le=\"+Inf\"} 1\n"), std::string::npos);
+        EXPECT_NE(text.find("battleship_stage_duration_seconds_count{stage=\"game_logic\"} 1\n"), std::string::npos);
+        EXPECT_NE(text.find("battleship_turn_round_trip_seconds_count 0\n"), std::string::npos);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
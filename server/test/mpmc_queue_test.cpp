@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "../include/mpmc_queue.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace BattleshipServer
+{
+    TEST(MpmcQueueTest, CapacityIsRoundedUpToAPowerOfTwo)
+    {
+        EXPECT_EQ(MpmcQueue<int>(0).capacity(), 2u);
+        EXPECT_EQ(MpmcQueue<int>(5).capacity(), 8u);
+        EXPECT_EQ(MpmcQueue<int>(64).capacity(), 64u);
+    }
+
+    TEST(MpmcQueueTest, KeepsFifoOrderAndReportsFullAndEmpty)
+    {
+        MpmcQueue<int> queue(4);
+        int value = -1;
+        EXPECT_FALSE(queue.try_pop(value));
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT_TRUE(queue.try_push(int(i)));
+        }
+        EXPECT_FALSE(queue.try_push(99));
+        for (int i = 0; i < 4; ++i)
+        {
+            ASSERT_TRUE(queue.try_pop(value));
+            EXPECT_EQ(value, i);
+        }
+        EXPECT_FALSE(queue.try_pop(value));
+    }
+
+    TEST(MpmcQueueTest, WrapsAroundManyTimes)
+    {
+        MpmcQueue<std::string> queue(2);
+        std::string value;
+        for (int i = 0; i < 1000; ++i)
+        {
+            ASSERT_TRUE(queue.try_push(std::to_string(i)));
+            ASSERT_TRUE(queue.try_pop(value));
+            EXPECT_EQ(value, std::to_string(i));
+        }
+    }
+
+    TEST(MpmcQueueTest, FailedPushLeavesTheValueWithTheCaller)
+    {
+        MpmcQueue<std::unique_ptr<int>> queue(2);
+        ASSERT_TRUE(queue.try_push(std::make_unique<int>(1)));
+        ASSERT_TRUE(queue.try_push(std::make_unique<int>(2)));
+        auto third = std::make_unique<int>(3);
+        EXPECT_FALSE(queue.try_push(std::move(third)));
+        ASSERT_TRUE(third);
+        EXPECT_EQ(*third, 3);
+    }
+
+    TEST(MpmcQueueTest, EveryValueIsPoppedExactlyOnceUnderContention)
+    {
+        constexpr int PRODUCERS = 4;
+        constexpr int CONSUMERS = 4;
+        constexpr int PER_PRODUCER = 20000;
+        MpmcQueue<int> queue(64);
+        std::vector<std::atomic<int>> seen(PRODUCERS * PER_PRODUCER);
+        std::atomic<int> popped{0};
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < PRODUCERS; ++p)
+        {
+            threads.emplace_back([&, p]
+                                 {
+                for (int i = 0; i < PER_PRODUCER; ++i)
+                {
+                    // Cola pequeña a propósito: los productores la llenan y reintentan.
+                    while (!queue.try_push(p * PER_PRODUCER + i))
+                    {
+                        std::this_thread::yield();
+                    }
+                } });
+        }
+        for (int c = 0; c < CONSUMERS; ++c)
+        {
+            threads.emplace_back([&]
+                                 {
+                int value;
+                while (popped.load() < PRODUCERS * PER_PRODUCER)
+                {
+                    if (queue.try_pop(value))
+                    {
+                        seen[value].fetch_add(1);
+                        popped.fetch_add(1);
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                } });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        for (auto &count : seen)
+        {
+            EXPECT_EQ(count.load(), 1);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,81 @@
+#!/bin/bash
+# Reinicia el servidor dos veces mientras bsload juega partidas: cada servidor nuevo toma los
+# sockets de escucha del anterior (--inherit-from) y el anterior termina sus partidas y sale.
+# Falla si bsload ve un error (conexión rechazada, desconexión, partida cortada) o si un
+# servidor no sale por sí solo.
+# Uso: restart_under_load.sh <server> <bsload> [opciones del servidor, p. ej. --backend io_uring]
+set -u
+SERVER=$1
+BSLOAD=$2
+shift 2
+OPTIONS=("$@")
+DIR=$(mktemp -d)
+PORT=$((20000 + RANDOM % 20000))
+PIDS=()
+
+cleanup()
+{
+    for pid in "${PIDS[@]}"; do
+        kill -KILL "$pid" 2>/dev/null
+    done
+    rm -rf "$DIR"
+}
+trap cleanup EXIT
+
+fail()
+{
+    echo "FAIL: $*"
+    for log in "$DIR"/*.log "$DIR"/*.txt; do
+        [ -f "$log" ] && { echo "--- $log"; tail -n 20 "$log"; }
+    done
+    exit 1
+}
+
+# Arranca el servidor número $1; el resto de argumentos se le pasan tal cual.
+start_server()
+{
+    local n=$1
+    shift
+    "$SERVER" 127.0.0.1 "$PORT" "$DIR/server$n.log" --loops 2 --workers 2 --stats-interval 0 --journal none \
+        --admin-socket "$DIR/admin.sock" "${OPTIONS[@]}" "$@" > "$DIR/server$n.txt" 2>&1 &
+    PIDS+=($!)
+}
+
+# Espera a que el proceso $1 salga por sí solo (máximo $2 décimas de segundo) y comprueba que sale con 0.
+wait_exit()
+{
+    local pid=$1 ticks=$2
+    while kill -0 "$pid" 2>/dev/null; do
+        ((ticks-- > 0)) || fail "server $pid did not exit"
+        sleep 0.1
+    done
+    wait "$pid" || fail "server $pid exited with status $?"
+}
+
+start_server 0
+for _ in $(seq 50); do
+    [ -S "$DIR/admin.sock" ] && break
+    sleep 0.1
+done
+[ -S "$DIR/admin.sock" ] || fail "first server did not start"
+
+"$BSLOAD" 127.0.0.1 "$PORT" --connections 40 --threads 1 --duration 6 --binary --deltas > "$DIR/bsload.txt" 2>&1 &
+LOAD=$!
+
+for n in 1 2; do
+    sleep 2
+    OLD=${PIDS[-1]}
+    start_server "$n" --inherit-from "$DIR/admin.sock"
+    wait_exit "$OLD" 100
+    grep -q "Listeners taken over" "$DIR/server$n.log" || fail "server $n did not take the listeners over"
+done
+
+wait "$LOAD" || fail "bsload exited with status $?"
+grep -q "^errors: *0 " "$DIR/bsload.txt" || fail "bsload reported errors"
+MATCHES=$(awk '/^matches:/ { print $2 }' "$DIR/bsload.txt")
+[ "${MATCHES:-0}" -gt 0 ] || fail "no match was played"
+
+# SIGTERM drena el último servidor: sale en cuanto terminan sus partidas.
+kill -TERM "${PIDS[-1]}"
+wait_exit "${PIDS[-1]}" 100
+echo "restarted twice under load: $MATCHES matches, no errors"
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "../include/slab_pool.hpp"
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace BattleshipServer
+{
+    TEST(SlabPoolTest, BlocksAreAlignedAndDistinct)
+    {
+        SlabPool pool(20, 4);
+        EXPECT_EQ(pool.block_size() % alignof(std::max_align_t), 0u);
+        EXPECT_GE(pool.block_size(), 20u);
+
+        std::set<void *> blocks;
+        for (int i = 0; i < 10; ++i)
+        {
+            void *block = pool.allocate();
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % alignof(std::max_align_t), 0u);
+            // El bloque entero es utilizable.
+            std::memset(block, 0xab, pool.block_size());
+            blocks.insert(block);
+        }
+        EXPECT_EQ(blocks.size(), 10u);
+        EXPECT_EQ(pool.in_use(), 10u);
+        EXPECT_EQ(pool.capacity(), 12u);
+
+        for (void *block : blocks)
+        {
+            pool.deallocate(block);
+        }
+        EXPECT_EQ(pool.in_use(), 0u);
+    }
+
+    TEST(SlabPoolTest, ReturnedBlocksAreReusedBeforeGrowing)
+    {
+        SlabPool pool(64, 2);
+        void *a = pool.allocate();
+        void *b = pool.allocate();
+        EXPECT_EQ(pool.capacity(), 2u);
+
+        pool.deallocate(a);
+        EXPECT_EQ(pool.allocate(), a);
+        pool.deallocate(b);
+        EXPECT_EQ(pool.allocate(), b);
+        EXPECT_EQ(pool.capacity(), 2u);
+
+        pool.deallocate(nullptr);
+        EXPECT_EQ(pool.in_use(), 2u);
+    }
+
+    TEST(SlabPoolTest, ConcurrentAllocateAndDeallocate)
+    {
+        SlabPool pool(48, 16);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&pool, t]
+                                 {
+                                     std::vector<unsigned char *> held;
+                                     for (int round = 0; round < 2000; ++round)
+                                     {
+                                         auto *block = static_cast<unsigned char *>(pool.allocate());
+                                         std::memset(block, t, pool.block_size());
+                                         held.push_back(block);
+                                         if (held.size() == 8)
+                                         {
+                                             for (auto *h : held)
+                                             {
+                                                 // Nadie más escribió en un bloque que seguía en uso.
+                                                 ASSERT_EQ(h[0], static_cast<unsigned char>(t));
+                                                 pool.deallocate(h);
+                                             }
+                                             held.clear();
+                                         }
+                                     }
+                                     for (auto *h : held)
+                                     {
+                                         pool.deallocate(h);
+                                     } });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        EXPECT_EQ(pool.in_use(), 0u);
+        EXPECT_LE(pool.capacity(), 48u);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "../include/slot_map.hpp"
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace BattleshipServer
+{
+    TEST(SlotMapTest, FindsInsertedValuesUntilTheyAreTaken)
+    {
+        SlotMap<std::string> map;
+        auto a = map.insert("a");
+        auto b = map.insert("b");
+        EXPECT_NE(a, 0u);
+        EXPECT_NE(a, b);
+        EXPECT_EQ(map.size(), 2u);
+        ASSERT_NE(map.find(a), nullptr);
+        EXPECT_EQ(*map.find(a), "a");
+
+        std::string taken;
+        EXPECT_TRUE(map.take(a, taken));
+        EXPECT_EQ(taken, "a");
+        EXPECT_EQ(map.find(a), nullptr);
+        EXPECT_FALSE(map.take(a, taken));
+        EXPECT_EQ(map.size(), 1u);
+        EXPECT_EQ(*map.find(b), "b");
+    }
+
+    TEST(SlotMapTest, StaleKeysDoNotFindTheValueThatReusedTheirSlot)
+    {
+        SlotMap<int> map;
+        auto old_key = map.insert(1);
+        int value = 0;
+        ASSERT_TRUE(map.take(old_key, value));
+        auto new_key = map.insert(2);
+        // Mismo slot, otra generación.
+        EXPECT_EQ(old_key & 0xffffffffu, new_key & 0xffffffffu);
+        EXPECT_NE(old_key, new_key);
+        EXPECT_EQ(map.find(old_key), nullptr);
+        EXPECT_FALSE(map.take(old_key, value));
+        ASSERT_NE(map.find(new_key), nullptr);
+        EXPECT_EQ(*map.find(new_key), 2);
+    }
+
+    TEST(SlotMapTest, TakeReleasesTheSlotForMoveOnlyValues)
+    {
+        SlotMap<std::unique_ptr<int>> map;
+        std::vector<SlotMap<std::unique_ptr<int>>::Key> keys;
+        for (int i = 0; i < 100; ++i)
+        {
+            keys.push_back(map.insert(std::make_unique<int>(i)));
+        }
+        std::unique_ptr<int> value;
+        for (int i = 0; i < 100; i += 2)
+        {
+            ASSERT_TRUE(map.take(keys[i], value));
+            EXPECT_EQ(*value, i);
+        }
+        EXPECT_EQ(map.size(), 50u);
+
+        // Los slots libres se reutilizan antes de crecer.
+        std::set<uint64_t> slots;
+        for (int i = 0; i < 50; ++i)
+        {
+            slots.insert(map.insert(std::make_unique<int>(-i)) & 0xffffffffu);
+        }
+        EXPECT_EQ(map.size(), 100u);
+        EXPECT_LT(*slots.rbegin(), 100u);
+        for (int i = 1; i < 100; i += 2)
+        {
+            EXPECT_EQ(**map.find(keys[i]), i);
+        }
+    }
+
+    TEST(SlotMapTest, ForEachVisitsStoredValuesWithTheirKeys)
+    {
+        SlotMap<int> map;
+        auto first = map.insert(10);
+        auto second = map.insert(20);
+        auto third = map.insert(30);
+        int value;
+        ASSERT_TRUE(map.take(second, value));
+
+        std::vector<std::pair<SlotMap<int>::Key, int>> visited;
+        map.for_each([&](SlotMap<int>::Key key, int &stored)
+                     { visited.emplace_back(key, stored); });
+        ASSERT_EQ(visited.size(), 2u);
+        EXPECT_EQ(visited[0], std::make_pair(first, 10));
+        EXPECT_EQ(visited[1], std::make_pair(third, 30));
+        EXPECT_EQ(map.find(visited[1].first), map.find(third));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include "../include/timer_wheel.hpp"
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace BattleshipServer
+{
+
+    TEST(TimerWheelTest, FiresAtDeadline)
+    {
+        TimerWheel wheel(1000);
+        int fired = 0;
+        wheel.schedule(1030, [&]
+                       { ++fired; });
+
+        // 1024 inicia el bloque de 64 ms del plazo: ahí se baja al nivel 0.
+        EXPECT_EQ(wheel.next_expiry(), 1024u);
+        EXPECT_EQ(wheel.advance(1029), 0u);
+        EXPECT_EQ(wheel.next_expiry(), 1030u);
+        EXPECT_EQ(fired, 0);
+        EXPECT_EQ(wheel.advance(1030), 1u);
+        EXPECT_EQ(fired, 1);
+        EXPECT_EQ(wheel.size(), 0u);
+        EXPECT_FALSE(wheel.next_expiry().has_value());
+    }
+
+    TEST(TimerWheelTest, CancelPreventsFiring)
+    {
+        TimerWheel wheel;
+        bool fired = false;
+        auto id = wheel.schedule(30000, [&]
+                                 { fired = true; });
+
+        EXPECT_TRUE(wheel.cancel(id));
+        EXPECT_FALSE(wheel.cancel(id));
+        wheel.advance(60000);
+        EXPECT_FALSE(fired);
+        EXPECT_EQ(wheel.size(), 0u);
+    }
+
+    TEST(TimerWheelTest, StaleHandleDoesNotCancelReusedSlot)
+    {
+        TimerWheel wheel;
+        auto old_id = wheel.schedule(10, [] {});
+        wheel.advance(10);
+
+        bool fired = false;
+        wheel.schedule(20, [&]
+                       { fired = true; });
+        EXPECT_FALSE(wheel.cancel(old_id));
+        wheel.advance(20);
+        EXPECT_TRUE(fired);
+    }
+
+    TEST(TimerWheelTest, PastDeadlineFiresOnNextAdvance)
+    {
+        TimerWheel wheel(500);
+        int fired = 0;
+        wheel.schedule(100, [&]
+                       { ++fired; });
+        EXPECT_EQ(wheel.advance(500), 1u);
+        EXPECT_EQ(fired, 1);
+    }
+
+    TEST(TimerWheelTest, CascadesAcrossLevelsInDeadlineOrder)
+    {
+        TimerWheel wheel(7);
+        std::vector<uint64_t> order;
+        // Un plazo por nivel y otro en la lista de desborde.
+        for (uint64_t deadline : {uint64_t{20000000}, uint64_t{300000}, uint64_t{5000}, uint64_t{50}, uint64_t{1u << 25}})
+        {
+            wheel.schedule(deadline, [&order, &wheel]
+                           { order.push_back(wheel.now()); });
+        }
+
+        wheel.advance(uint64_t{1} << 26);
+        EXPECT_EQ(order, (std::vector<uint64_t>{50, 5000, 300000, 20000000, 1u << 25}));
+    }
+
+    TEST(TimerWheelTest, NextExpiryNeverSkipsADeadline)
+    {
+        std::mt19937_64 rng(42);
+        TimerWheel wheel(123);
+        std::vector<uint64_t> expected;
+        std::vector<uint64_t> fired;
+        for (int i = 0; i < 500; ++i)
+        {
+            uint64_t deadline = 123 + rng() % 5000000;
+            expected.push_back(deadline);
+            wheel.schedule(deadline, [&fired, &wheel]
+                           { fired.push_back(wheel.now()); });
+        }
+        std::sort(expected.begin(), expected.end());
+
+        // Se avanza solo hasta cada next_expiry(), como hace el event loop con su timerfd.
+        while (auto next = wheel.next_expiry())
+        {
+            wheel.advance(*next);
+        }
+        EXPECT_EQ(fired, expected);
+    }
+
+    TEST(TimerWheelTest, CallbackCanRescheduleAndCancel)
+    {
+        TimerWheel wheel;
+        int ticks = 0;
+        TimerWheel::TimerId victim = wheel.schedule(250, [&]
+                                                    { ticks += 100; });
+        std::function<void()> tick = [&]
+        {
+            ++ticks;
+            wheel.cancel(victim);
+            if (ticks < 3)
+                wheel.schedule(wheel.now() + 100, tick);
+        };
+        wheel.schedule(100, tick);
+
+        wheel.advance(1000);
+        EXPECT_EQ(ticks, 3);
+        EXPECT_EQ(wheel.size(), 0u);
+    }
+
+} // namespace BattleshipServer
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
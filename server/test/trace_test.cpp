@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "../include/trace.hpp"
+#include "../include/async_logger.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+namespace BattleshipServer
+{
+    class TraceTest : public ::testing::Test
+    {
+    protected:
+        void TearDown() override
+        {
+            Trace::set_sink(nullptr);
+            Trace::set_level(TraceLevel::ERROR);
+        }
+    };
+
+    TEST_F(TraceTest, ConfigureSetsEveryOrSomeCategories)
+    {
+        Trace::configure("debug");
+        EXPECT_EQ(Trace::level(TraceCategory::SESSION), TraceLevel::DEBUG);
+        EXPECT_EQ(Trace::level(TraceCategory::WIRE), TraceLevel::DEBUG);
+        EXPECT_EQ(Trace::level(TraceCategory::TIMER), TraceLevel::DEBUG);
+
+        Trace::configure("wire=off,timer=info");
+        EXPECT_EQ(Trace::level(TraceCategory::SESSION), TraceLevel::DEBUG);
+        EXPECT_EQ(Trace::level(TraceCategory::WIRE), TraceLevel::OFF);
+        EXPECT_EQ(Trace::level(TraceCategory::TIMER), TraceLevel::INFO);
+
+        EXPECT_TRUE(Trace::enabled(TraceCategory::TIMER, TraceLevel::ERROR));
+        EXPECT_TRUE(Trace::enabled(TraceCategory::TIMER, TraceLevel::INFO));
+        EXPECT_FALSE(Trace::enabled(TraceCategory::TIMER, TraceLevel::DEBUG));
+        EXPECT_FALSE(Trace::enabled(TraceCategory::WIRE, TraceLevel::ERROR));
+    }
+
+    TEST_F(TraceTest, InvalidSpecificationChangesNothing)
+    {
+        EXPECT_THROW(Trace::configure("verbose"), std::invalid_argument);
+        EXPECT_THROW(Trace::configure("session=debug,disk=info"), std::invalid_argument);
+        EXPECT_THROW(Trace::configure("session=debug,wire"), std::invalid_argument);
+        EXPECT_EQ(Trace::level(TraceCategory::SESSION), TraceLevel::ERROR);
+        EXPECT_EQ(Trace::level(TraceCategory::WIRE), TraceLevel::ERROR);
+    }
+
+    TEST_F(TraceTest, DisabledLinesDoNotEvaluateTheirArguments)
+    {
+        int evaluated = 0;
+        auto expensive = [&evaluated]
+        {
+            ++evaluated;
+            return std::string("payload");
+        };
+        Trace::set_level(TraceCategory::WIRE, TraceLevel::INFO);
+        BATTLESHIP_TRACE(WIRE, DEBUG, "Enviado: ", expensive());
+        EXPECT_EQ(evaluated, 0);
+    }
+
+    TEST_F(TraceTest, EnabledLinesGoThroughTheLogger)
+    {
+        char path[32] = "/tmp/trace_test_XXXXXX";
+        int fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        {
+            LoggerOptions options;
+            options.flush_interval = std::chrono::milliseconds(10);
+            AsyncLogger logger(fd, options);
+            Trace::set_sink(&logger);
+            Trace::set_level(TraceCategory::SESSION, TraceLevel::INFO);
+            BATTLESHIP_TRACE(SESSION, INFO, "Jugador ", 2, " se rinde");
+            BATTLESHIP_TRACE(SESSION, DEBUG, "Jugador ", 2, " registrado correctamente");
+            logger.flush();
+            Trace::set_sink(nullptr);
+        }
+
+        std::string content;
+        int in = ::open(path, O_RDONLY);
+        char buffer[1024];
+        ssize_t n;
+        while ((n = ::read(in, buffer, sizeof(buffer))) > 0)
+        {
+            content.append(buffer, static_cast<size_t>(n));
+        }
+        ::close(in);
+        std::remove(path);
+
+        EXPECT_EQ(content.rfind("[INFO] ", 0), 0u);
+        EXPECT_NE(content.find(" session Jugador 2 se rinde\n"), std::string::npos);
+        EXPECT_EQ(content.find("registrado"), std::string::npos);
+    }
+
+    TEST(TraceFormatTest, AppendsStringsCharactersAndIntegers)
+    {
+        std::string line;
+        Trace::append(line, "fd ");
+        Trace::append(line, -17);
+        Trace::append(line, ' ');
+        Trace::append(line, std::string_view("ok"));
+        Trace::append(line, true);
+        EXPECT_EQ(line, "fd -17 oktrue");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
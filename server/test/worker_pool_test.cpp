@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include "../include/worker_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace BattleshipServer
+{
+    namespace
+    {
+        // Espera activa acotada: los workers terminan en otro hilo.
+        template <typename Predicate>
+        bool wait_until(Predicate done, std::chrono::milliseconds limit = std::chrono::seconds(5))
+        {
+            auto deadline = std::chrono::steady_clock::now() + limit;
+            while (!done())
+            {
+                if (std::chrono::steady_clock::now() > deadline)
+                {
+                    return false;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return true;
+        }
+    }
+
+    TEST(WorkerPoolTest, RunsEverySubmittedTask)
+    {
+        WorkerPool pool(4);
+        EXPECT_EQ(pool.size(), 4u);
+        std::atomic<int> done{0};
+        for (int i = 0; i < 10000; ++i)
+        {
+            pool.submit([&]
+                        { done.fetch_add(1); });
+        }
+        EXPECT_TRUE(wait_until([&]
+                               { return done.load() == 10000; }));
+    }
+
+    TEST(WorkerPoolTest, IdleWorkersStealFromABusyOne)
+    {
+        WorkerPool pool(4);
+        std::atomic<int> done{0};
+        // Todas las tareas nacen en la cola de un único worker: el resto solo puede obtenerlas robando.
+        pool.submit([&]
+                    {
+            for (int i = 0; i < 64; ++i)
+            {
+                pool.submit([&]
+                            {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    done.fetch_add(1); });
+            } });
+        EXPECT_TRUE(wait_until([&]
+                               { return done.load() == 64; }));
+        EXPECT_GT(pool.steals(), 0u);
+    }
+
+    TEST(WorkerPoolTest, StopIsIdempotent)
+    {
+        WorkerPool pool(2);
+        pool.stop();
+        pool.stop();
+    }
+
+    TEST(StrandTest, RunsTasksInOrderWithoutOverlap)
+    {
+        WorkerPool pool(4);
+        auto strand = std::make_shared<Strand>(pool);
+        std::atomic<bool> inside{false};
+        std::atomic<bool> overlapped{false};
+        std::vector<int> order;
+        constexpr int PRODUCERS = 4;
+        constexpr int TASKS = 2000;
+
+        std::vector<std::thread> producers;
+        for (int p = 0; p < PRODUCERS; ++p)
+        {
+            producers.emplace_back([&, p]
+                                   {
+                for (int i = 0; i < TASKS; ++i)
+                {
+                    strand->post([&, p, i]
+                                 {
+                        if (inside.exchange(true))
+                        {
+                            overlapped = true;
+                        }
+                        // Sin atomics ni mutex: la strand es la única sincronización.
+                        order.push_back(p * TASKS + i);
+                        inside = false; });
+                } });
+        }
+        for (auto &producer : producers)
+        {
+            producer.join();
+        }
+
+        std::atomic<bool> drained{false};
+        strand->post([&]
+                     { drained = true; });
+        ASSERT_TRUE(wait_until([&]
+                               { return drained.load(); }));
+        EXPECT_FALSE(overlapped.load());
+        ASSERT_EQ(order.size(), static_cast<size_t>(PRODUCERS * TASKS));
+
+        // Cada productor conserva su orden.
+        std::vector<int> next(PRODUCERS, 0);
+        for (int value : order)
+        {
+            int p = value / TASKS;
+            EXPECT_EQ(value % TASKS, next[p]++);
+        }
+    }
+
+    TEST(StrandTest, IndependentStrandsRunInParallel)
+    {
+        WorkerPool pool(2);
+        auto first = std::make_shared<Strand>(pool);
+        auto second = std::make_shared<Strand>(pool);
+        std::atomic<int> arrived{0};
+        std::atomic<bool> both{false};
+
+        // Cada tarea espera a la otra: solo terminan si las dos strands corren a la vez.
+        auto rendezvous = [&]
+        {
+            arrived.fetch_add(1);
+            if (wait_until([&]
+                           { return arrived.load() == 2; }))
+            {
+                both = true;
+            }
+        };
+        first->post(rendezvous);
+        second->post(rendezvous);
+        EXPECT_TRUE(wait_until([&]
+                               { return both.load(); }));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}